@@ -0,0 +1,307 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+    .AddAttribute ("Threshold",
+                   "Largest bucket sorted into Bottom, larger ones are "
+                   "split into a new rung.",
+                   UintegerValue (50),
+                   MakeUintegerAccessor (&LadderScheduler::m_threshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxRungs",
+                   "Maximum number of rungs of the ladder.",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&LadderScheduler::m_maxRungs),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topMin (std::numeric_limits<uint64_t>::max ()),
+    m_topMax (0),
+    m_topStart (0),
+    m_nRungs (0),
+    m_nowTs (0),
+    m_qSize (0),
+    m_threshold (50),
+    m_maxRungs (8)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  m_qSize++;
+  if (ev.key.m_ts == m_nowTs
+      && (m_now.empty () || m_now.back () < ev))
+    {
+      // Scheduled for now: uids only grow, the lane stays in order.
+      m_now.push_back (ev);
+      return;
+    }
+  if (ev.key.m_ts >= m_topStart)
+    {
+      m_top.push_back (ev);
+      m_topMin = std::min (m_topMin, ev.key.m_ts);
+      m_topMax = std::max (m_topMax, ev.key.m_ts);
+      return;
+    }
+  InsertLadder (ev);
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+
+  Settle ();
+  if (m_bottom.empty ())
+    {
+      return m_now.front ();
+    }
+  if (m_now.empty () || m_bottom.back () < m_now.front ())
+    {
+      return m_bottom.back ();
+    }
+  return m_now.front ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+
+  Settle ();
+  Event ev;
+  if (!m_bottom.empty ()
+      && (m_now.empty () || m_bottom.back () < m_now.front ()))
+    {
+      ev = m_bottom.back ();
+      m_bottom.pop_back ();
+    }
+  else
+    {
+      ev = m_now.front ();
+      m_now.pop_front ();
+    }
+  m_nowTs = ev.key.m_ts;
+  m_qSize--;
+  NS_LOG_DEBUG ("remove " << ev.impl << ", ts " << ev.key.m_ts << ", uid " << ev.key.m_uid);
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+
+  // Dropped once it reaches the head of Bottom or of the FIFO lane.
+  m_removed.insert (ev.key.m_uid);
+  m_qSize--;
+}
+
+bool
+LadderScheduler::TakeRemoved (const Event &ev) const
+{
+  if (m_removed.empty ())
+    {
+      return false;
+    }
+  return m_removed.erase (ev.key.m_uid) > 0;
+}
+
+void
+LadderScheduler::Settle (void) const
+{
+  while (!m_now.empty () && TakeRemoved (m_now.front ()))
+    {
+      m_now.pop_front ();
+    }
+
+  while (true)
+    {
+      while (!m_bottom.empty () && TakeRemoved (m_bottom.back ()))
+        {
+          m_bottom.pop_back ();
+        }
+      if (!m_bottom.empty ())
+        {
+          return;
+        }
+
+      if (m_nRungs == 0)
+        {
+          if (m_top.empty ())
+            {
+              return;
+            }
+          uint64_t start = m_topMin;
+          uint64_t range = m_topMax - m_topMin + 1;
+          m_topStart = SpawnRung (m_top, start, range);
+          m_topMin = std::numeric_limits<uint64_t>::max ();
+          m_topMax = 0;
+          continue;
+        }
+
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.m_current < rung.m_nBuckets
+             && rung.m_buckets[rung.m_current].empty ())
+        {
+          rung.m_current++;
+        }
+      if (rung.m_current == rung.m_nBuckets)
+        {
+          m_nRungs--;
+          continue;
+        }
+
+      uint32_t rungIndex = m_nRungs - 1;
+      uint32_t bucketIndex = rung.m_current;
+      uint64_t start = rung.CurrentStart ();
+      uint64_t width = rung.m_width;
+      rung.m_current++;
+
+      Bucket &bucket = rung.m_buckets[bucketIndex];
+      if (bucket.size () > m_threshold && width > 1 && m_nRungs < m_maxRungs)
+        {
+          // SpawnRung may grow m_rungs: split from scratch space, then
+          // give the bucket its storage back.
+          m_spill.swap (bucket);
+          SpawnRung (m_spill, start, width);
+          m_spill.swap (m_rungs[rungIndex].m_buckets[bucketIndex]);
+          continue;
+        }
+
+      m_bottom.swap (bucket);
+      std::sort (m_bottom.begin (), m_bottom.end (), std::greater<Event> ());
+    }
+}
+
+uint64_t
+LadderScheduler::SpawnRung (Bucket &events, uint64_t start, uint64_t range) const
+{
+  NS_LOG_FUNCTION (this << events.size () << start << range);
+  NS_ASSERT (!events.empty ());
+
+  // About one event per bucket.
+  uint64_t n = events.size ();
+  uint64_t width = (range + n - 1) / n;
+  uint64_t nBuckets = (range + width - 1) / width;
+
+  if (m_rungs.size () == m_nRungs)
+    {
+      m_rungs.push_back (Rung ());
+    }
+  Rung &rung = m_rungs[m_nRungs++];
+  rung.m_start = start;
+  rung.m_width = width;
+  rung.m_current = 0;
+  rung.m_nBuckets = static_cast<uint32_t> (nBuckets);
+  if (rung.m_buckets.size () < nBuckets)
+    {
+      rung.m_buckets.resize (nBuckets);
+    }
+
+  for (const Event &ev : events)
+    {
+      uint64_t i = (ev.key.m_ts - start) / width;
+      NS_ASSERT (i < nBuckets);
+      rung.m_buckets[i].push_back (ev);
+    }
+  events.clear ();
+  return start + nBuckets * width;
+}
+
+void
+LadderScheduler::InsertLadder (const Event &ev) const
+{
+  for (uint32_t r = 0; r < m_nRungs; r++)
+    {
+      Rung &rung = m_rungs[r];
+      if (ev.key.m_ts >= rung.CurrentStart ())
+        {
+          uint64_t i = (ev.key.m_ts - rung.m_start) / rung.m_width;
+          NS_ASSERT (i < rung.m_nBuckets);
+          rung.m_buckets[i].push_back (ev);
+          return;
+        }
+    }
+  InsertBottom (ev);
+}
+
+void
+LadderScheduler::InsertBottom (const Event &ev) const
+{
+  Bucket::iterator pos = std::lower_bound (m_bottom.begin (), m_bottom.end (),
+                                           ev, std::greater<Event> ());
+  m_bottom.insert (pos, ev);
+
+  if (m_bottom.size () > m_threshold && m_nRungs < m_maxRungs
+      && m_bottom.front ().key.m_ts > m_bottom.back ().key.m_ts)
+    {
+      // Too many early events: give them a rung of their own, up to
+      // where the lowest rung (or Top) takes over.
+      uint64_t start = m_bottom.back ().key.m_ts;
+      uint64_t end = m_nRungs > 0 ? m_rungs[m_nRungs - 1].CurrentStart () : m_topStart;
+      SpawnRung (m_bottom, start, end - start);
+    }
+}
+
+} // namespace ns3
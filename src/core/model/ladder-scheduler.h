@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <deque>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue published in 2005 in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh and
+ * Ian Li-Jin Thng][Tang], plus a FIFO lane for events scheduled at the
+ * current time.
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * Events are kept in three tiers:
+ *  - Top: an unsorted vector of the events beyond the ladder's range.
+ *  - Ladder: up to \c MaxRungs rungs of buckets.  Rung 0 is built from
+ *    Top when the ladder runs empty, with a bucket width such that Top's
+ *    events spread over about one bucket each.  A bucket holding more
+ *    than \c Threshold events is split into a finer rung below it.
+ *  - Bottom: a small vector sorted in decreasing order, the events of
+ *    the next ladder bucket; the earliest event is popped from its end.
+ *    Events earlier than the lowest rung are inserted in place; past
+ *    \c Threshold events, Bottom becomes a rung itself.
+ *
+ * Events are sorted only once they reach Bottom, so their ordering cost
+ * is proportional to the bucket size, not to the queue size.
+ *
+ * Models schedule many events at the current time
+ * (Simulator::ScheduleNow) or a few microseconds ahead.  Events at the
+ * current time get uids in increasing order, so they're appended to a
+ * FIFO lane, without touching the ladder.
+ *
+ * Remove() is lazy: the uid is recorded and the event is skipped once
+ * it reaches the head of Bottom or of the FIFO lane.  The EventImpl of
+ * a removed event isn't dereferenced after Remove().
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | Constant        | Append to Top, a bucket or the FIFO lane; sorted insert into the small Bottom otherwise
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Each event moves down the tiers a bounded number of times
+ * Remove()     | Constant        | Lazy, hash set of removed uids
+ * RemoveNext() | Constant        | Same as PeekNext()
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | ~500 bytes                       | Tiers, rungs are kept for reuse
+ * Per Event | 0                                | Events are stored by value in `std::vector`s
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** A bucket: unsorted events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A rung of the ladder: equal width buckets starting at m_start. */
+  struct Rung
+  {
+    uint64_t m_start;             //!< Timestamp at the start of the first bucket.
+    uint64_t m_width;             //!< Duration of a bucket, in dimensionless time units.
+    uint32_t m_current;           //!< First bucket not yet moved down.
+    std::vector<Bucket> m_buckets;  //!< Buckets, only the first m_nBuckets are used.
+    uint32_t m_nBuckets;          //!< Number of buckets in use.
+
+    /**
+     * Start of the first bucket not yet moved down.
+     * \returns The timestamp.
+     */
+    uint64_t CurrentStart (void) const
+    {
+      return m_start + m_current * m_width;
+    }
+  };
+
+  /**
+   * Move the next events into Bottom, if it's empty, and drop the
+   * removed events at the heads of Bottom and the FIFO lane.
+   * Only the tiers change, not the set of events held.
+   */
+  void Settle (void) const;
+  /**
+   * Spread events over a new rung below the current lowest one.
+   *
+   * The events must all be earlier than the current start of the
+   * lowest rung, and must not be stored in a rung.
+   *
+   * \param [in,out] events The events, emptied.
+   * \param [in] start Timestamp at or before the earliest event.
+   * \param [in] range Duration covered from \p start, so that every
+   *            event is before <tt>start + range</tt>.
+   * \returns The end of the new rung.
+   */
+  uint64_t SpawnRung (Bucket &events, uint64_t start, uint64_t range) const;
+  /**
+   * Insert into the sorted Bottom.
+   *
+   * \param [in] ev The event.
+   */
+  void InsertBottom (const Scheduler::Event &ev) const;
+  /**
+   * Insert below Top: into the first rung covering the event, else Bottom.
+   *
+   * \param [in] ev The event.
+   */
+  void InsertLadder (const Scheduler::Event &ev) const;
+  /**
+   * Check whether the event was removed, forget it if so.
+   *
+   * \param [in] ev The event.
+   * \returns \c true if the event was removed.
+   */
+  bool TakeRemoved (const Scheduler::Event &ev) const;
+
+  // The tiers are rearranged by PeekNext, which is const.
+  /** Events beyond the ladder, unsorted. */
+  mutable Bucket m_top;
+  /** Smallest timestamp in Top. */
+  mutable uint64_t m_topMin;
+  /** Largest timestamp in Top. */
+  mutable uint64_t m_topMax;
+  /** Events at or after this timestamp go to Top. */
+  mutable uint64_t m_topStart;
+  /** Rungs, index 0 is the coarsest; only the first m_nRungs are in use. */
+  mutable std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  mutable uint32_t m_nRungs;
+  /** Next events, sorted in decreasing order. */
+  mutable Bucket m_bottom;
+  /** Scratch space to split a bucket without aliasing m_rungs. */
+  mutable Bucket m_spill;
+  /** Events at the current time, in insertion (uid) order. */
+  mutable std::deque<Scheduler::Event> m_now;
+  /** Uids removed but still held in a tier. */
+  mutable std::unordered_set<uint32_t> m_removed;
+  /** Timestamp of the last event removed, the current time. */
+  uint64_t m_nowTs;
+  /** Number of events held, removed ones excluded. */
+  uint32_t m_qSize;
+  /** Max size of a bucket moved to Bottom, larger ones are split. */
+  uint32_t m_threshold;
+  /** Max number of rungs. */
+  uint32_t m_maxRungs;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
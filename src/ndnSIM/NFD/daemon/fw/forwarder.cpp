@@ -53,6 +53,17 @@ getDefaultStrategyName()
   return fw::BestRouteStrategy::getStrategyName();
 }
 
+/** \brief Data made by the forwarder for aggregation, with the same fake signature as the apps
+ */
+static shared_ptr<Data>
+makeAggregationData(const Name& name)
+{
+  auto data = make_shared<Data>(name);
+  data->setSignatureInfo(ndn::SignatureInfo(static_cast<tlv::SignatureTypeValue>(255)));
+  data->setSignatureValue(make_shared<ndn::Buffer>(1));
+  return data;
+}
+
 Forwarder::Forwarder(FaceTable& faceTable)
   : m_faceTable(faceTable)
   , m_unsolicitedDataPolicy(make_unique<fw::DefaultUnsolicitedDataPolicy>())
@@ -60,6 +71,7 @@ Forwarder::Forwarder(FaceTable& faceTable)
   , m_pit(m_nameTree)
   , m_measurements(m_nameTree)
   , m_strategyChoice(*this)
+  , m_deadNonceList(make_unique<DeadNonceList>())
   , m_csFace(face::makeNullFace(FaceUri("contentstore://")))
 {
   m_faceTable.addReserved(m_csFace, face::FACEID_CONTENT_STORE);
@@ -103,9 +115,9 @@ void
 Forwarder::onIncomingInterest(const Interest& interest, const FaceEndpoint& ingress)
 {
   //! Debugging
-  if (ns3::Simulator::Now() >= ns3::Seconds(1) && forwarder_recorder.empty()) {
+  if (ns3::Simulator::Now() >= ns3::Seconds(1) && forwarder_recorder.empty() && !fwdFolderPath.empty()) {
     forwarder_recorder = fwdFolderPath + "/fwd_" + getNodeName() + ".txt";
-    OpenFile(forwarder_recorder);
+    m_throughputLog = ns3::utils::LogSink::Instance().Open(forwarder_recorder, {"Time", "Throughput"});
     NFD_LOG_INFO("Forwarder " << getNodeName() << ": recorder path - " << forwarder_recorder<< " is created");
   }
 
@@ -138,7 +150,7 @@ Forwarder::onIncomingInterest(const Interest& interest, const FaceEndpoint& ingr
   }
 
   // detect duplicate Nonce with Dead Nonce List
-  bool hasDuplicateNonceInDnl = m_deadNonceList.has(interest.getName(), interest.getNonce());
+  bool hasDuplicateNonceInDnl = m_deadNonceList->has(interest.getName(), interest.getNonce());
   if (hasDuplicateNonceInDnl) {
     // goto Interest loop pipeline
     this->onInterestLoop(interest, ingress);
@@ -225,6 +237,12 @@ Forwarder::onContentStoreMiss(const Interest& interest, const FaceEndpoint& ingr
   auto lastExpiryFromNow = lastExpiring->getExpiry() - time::steady_clock::now();
   this->setExpiryTimer(pitEntry, time::duration_cast<time::milliseconds>(lastExpiryFromNow));
 
+  // aggregated by the forwarder itself?
+  if (m_reductionTable.isLocal(interest.getName())) {
+    this->onAggregationInterest(interest, pitEntry);
+    return;
+  }
+
   // has NextHopFaceId?
   auto nextHopTag = interest.getTag<lp::NextHopFaceIdTag>();
   if (nextHopTag != nullptr) {
@@ -370,6 +388,15 @@ Forwarder::onIncomingData(const Data& data, const FaceEndpoint& ingress)
   for (const auto& pitEntry : pitMatches) {
     NFD_LOG_DEBUG("onIncomingData matching=" << pitEntry->getName());
 
+    // answer to a child Interest of forwarder-level aggregation, the same Interest may also be
+    // pending for downstreams of its own, which are satisfied as usual
+    if (pitEntry->getStrategyInfo<reduction::ChildInfo>() != nullptr) {
+      this->onAggregationData(data, ingress, pitEntry);
+      if (!pitEntry->hasInRecords()) {
+        continue;
+      }
+    }
+
     // invoke PIT satisfy callback
     beforeSatisfyInterest(*pitEntry, ingress.face, data);
 
@@ -605,6 +632,125 @@ Forwarder::onNewNextHop(const Name& prefix, const fib::NextHop& nextHop)
   }
 }
 
+void
+Forwarder::onAggregationInterest(const Interest& interest, const shared_ptr<pit::Entry>& pitEntry)
+{
+  const Name& name = interest.getName();
+
+  if (ReductionTable::isInitializationName(name)) {
+    if (!m_reductionTable.installTree(interest)) {
+      NFD_LOG_DEBUG("onAggregationInterest interest=" << name << " invalid-tree drop");
+      return;
+    }
+    NFD_LOG_DEBUG("onAggregationInterest interest=" << name
+                  << " tree-chunk children=" << m_reductionTable.size());
+
+    // acknowledge the tree broadcast like the Aggregator app does
+    auto data = makeAggregationData(name);
+    data->wireEncode();
+    this->satisfyAggregation(pitEntry, *data);
+    return;
+  }
+
+  if (!ReductionTable::isDataName(name) || m_reductionTable.size() == 0) {
+    NFD_LOG_DEBUG("onAggregationInterest interest=" << name << " no-tree drop");
+    return;
+  }
+
+  auto accumulator = pitEntry->insertStrategyInfo<reduction::Accumulator>(m_reductionTable.size());
+  NFD_LOG_DEBUG("onAggregationInterest interest=" << name
+                << (accumulator.second ? " split" : " retransmission"));
+
+  for (size_t i = 0; i < m_reductionTable.size(); ++i) {
+    if (!accumulator.first->hasArrived(i)) {
+      this->sendAggregationInterest(interest, pitEntry, i);
+    }
+  }
+}
+
+void
+Forwarder::onAggregationData(const Data& data, const FaceEndpoint& ingress,
+                             const shared_ptr<pit::Entry>& pitEntry)
+{
+  auto childInfo = pitEntry->getStrategyInfo<reduction::ChildInfo>();
+  shared_ptr<pit::Entry> parent = childInfo->parent.lock();
+  size_t index = childInfo->index;
+
+  // the child Interest is done, whatever happens to the model request
+  this->insertDeadNonceList(*pitEntry, &ingress.face);
+  pitEntry->deleteOutRecord(ingress.face);
+  pitEntry->isSatisfied = true;
+  pitEntry->dataFreshnessPeriod = data.getFreshnessPeriod();
+  this->setExpiryTimer(pitEntry, 0_ms);
+
+  auto accumulator = parent == nullptr ? nullptr : parent->getStrategyInfo<reduction::Accumulator>();
+  if (accumulator == nullptr || parent->isSatisfied) {
+    NFD_LOG_DEBUG("onAggregationData data=" << data.getName() << " no-pending-request");
+    return;
+  }
+
+  ModelDataView model;
+  if (!model.parse(data.getContent())) {
+    NFD_LOG_WARN("onAggregationData data=" << data.getName() << " malformed-model");
+    return;
+  }
+  if (!accumulator->add(index, model)) {
+    NFD_LOG_DEBUG("onAggregationData data=" << data.getName() << " duplicate");
+    return;
+  }
+  if (!accumulator->isComplete()) {
+    return;
+  }
+
+  NFD_LOG_DEBUG("onAggregationData interest=" << parent->getName() << " aggregated");
+  auto aggregated = makeAggregationData(parent->getName());
+  aggregated->setContent(accumulator->encode());
+  aggregated->setFreshnessPeriod(data.getFreshnessPeriod());
+  aggregated->wireEncode();
+  parent->eraseStrategyInfo<reduction::Accumulator>();
+  this->satisfyAggregation(parent, *aggregated);
+}
+
+void
+Forwarder::sendAggregationInterest(const Interest& interest, const shared_ptr<pit::Entry>& pitEntry,
+                                   size_t index)
+{
+  auto childInterest = make_shared<Interest>(m_reductionTable.makeChildName(index, pitEntry->getName()));
+  childInterest->setCanBePrefix(false);
+  childInterest->setInterestLifetime(interest.getInterestLifetime());
+
+  const fib::Entry& fibEntry = m_fib.findLongestPrefixMatch(childInterest->getName());
+  if (!fibEntry.hasNextHops()) {
+    NFD_LOG_DEBUG("sendAggregationInterest interest=" << childInterest->getName() << " no-route");
+    return;
+  }
+
+  // a retransmission refreshes the PIT entry of the previous attempt, if still there
+  shared_ptr<pit::Entry> childEntry = m_pit.insert(*childInterest).first;
+  auto childInfo = childEntry->insertStrategyInfo<reduction::ChildInfo>().first;
+  childInfo->parent = pitEntry;
+  childInfo->index = index;
+  this->setExpiryTimer(childEntry, childInterest->getInterestLifetime());
+
+  // next hops are sorted by cost
+  this->onOutgoingInterest(*childInterest, fibEntry.getNextHops().front().getFace(), childEntry);
+}
+
+void
+Forwarder::satisfyAggregation(const shared_ptr<pit::Entry>& pitEntry, const Data& data)
+{
+  // cached, so that a request arriving after this one is gone is served from the CS
+  m_cs.insert(data);
+
+  pitEntry->isSatisfied = true;
+  pitEntry->dataFreshnessPeriod = data.getFreshnessPeriod();
+  for (const auto& inRecord : pitEntry->getInRecords()) {
+    this->onOutgoingData(data, inRecord.getFace());
+  }
+  pitEntry->clearInRecords();
+  this->setExpiryTimer(pitEntry, 0_ms);
+}
+
 void
 Forwarder::setExpiryTimer(const shared_ptr<pit::Entry>& pitEntry, time::milliseconds duration)
 {
@@ -623,7 +769,7 @@ Forwarder::insertDeadNonceList(pit::Entry& pitEntry, const Face* upstream)
   if (pitEntry.isSatisfied) {
     BOOST_ASSERT(pitEntry.dataFreshnessPeriod >= 0_ms);
     needDnl = pitEntry.getInterest().getMustBeFresh() &&
-              pitEntry.dataFreshnessPeriod < m_deadNonceList.getLifetime();
+              pitEntry.dataFreshnessPeriod < m_deadNonceList->getLifetime();
   }
 
   if (!needDnl) {
@@ -635,14 +781,14 @@ Forwarder::insertDeadNonceList(pit::Entry& pitEntry, const Face* upstream)
     // insert all outgoing Nonces
     const auto& outRecords = pitEntry.getOutRecords();
     std::for_each(outRecords.begin(), outRecords.end(), [&] (const auto& outRecord) {
-      m_deadNonceList.add(pitEntry.getName(), outRecord.getLastNonce());
+      m_deadNonceList->add(pitEntry.getName(), outRecord.getLastNonce());
     });
   }
   else {
     // insert outgoing Nonce of a specific face
     auto outRecord = pitEntry.getOutRecord(*upstream);
     if (outRecord != pitEntry.getOutRecords().end()) {
-      m_deadNonceList.add(pitEntry.getName(), outRecord->getLastNonce());
+      m_deadNonceList->add(pitEntry.getName(), outRecord->getLastNonce());
     }
   }
 }
@@ -697,41 +843,15 @@ Forwarder::GetDataRate()
 
 
 
-void
-Forwarder::OpenFile(const std::string& filename)
-{
-    std::ofstream file(filename, std::ofstream::out | std::ofstream::trunc);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << filename << std::endl;
-    }
-    // ToDo: for testing, delete later
-    else {
-        //std::cout << "Open " << filename << " successfully!" << std::endl;
-    }
-    file.close();
-}
-
-
-
 void
 Forwarder::ThroughputRecorder()
 {
-    // Open throughput recorder
-    std::ofstream file(forwarder_recorder, std::ios::app);
-
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << forwarder_recorder << std::endl;
+    if (m_throughputLog == nullptr) {
         return;
     }
 
-    // Write the throughput to the file, followed by a newline
     //* Note that throughput is transferred into Mbps
-    file << ns3::Simulator::Now().GetMicroSeconds() << " " 
-         << GetDataRate() * 1000000 * 8 * 8 * 150 / 1000000 << " " 
-         << std::endl;
-
-    // Close the file
-    file.close();
+    m_throughputLog->Write(ns3::Simulator::Now().GetMicroSeconds(), GetDataRate() * 1000000 * 8 * 8 * 150 / 1000000);
 }
 
 } // namespace nfd
@@ -38,8 +38,10 @@
 #include "table/strategy-choice.hpp"
 #include "table/dead-nonce-list.hpp"
 #include "table/network-region-table.hpp"
+#include "table/reduction-table.hpp"
 
 #include "sliding-window.hpp" //! Added by Yitong
+#include "ns3/ndnSIM/utils/log-sink.hpp"
 
 namespace nfd {
 
@@ -78,14 +80,18 @@ public:
     return m_nodeName;
   }
 
-  //! Added by Yitong, for forwarder's throughput measurement
   /**
-   * Open and clear the file
-   * @param filename
+   * \brief Set the directory of the simulation results, the throughput log goes to its fwd/ folder
+   *
+   * The forwarder doesn't record anything until it's set.
    */
   void
-  OpenFile(const std::string& filename);
+  setResultsDir(const std::string& resultsDir)
+  {
+    fwdFolderPath = resultsDir + "/fwd";
+  }
 
+  //! Added by Yitong, for forwarder's throughput measurement
   /**
    * Get the current data rate
    * @return data rate
@@ -157,10 +163,19 @@ public:
     return m_strategyChoice;
   }
 
-  DeadNonceList&
+  DeadNonceTable&
   getDeadNonceList()
   {
-    return m_deadNonceList;
+    return *m_deadNonceList;
+  }
+
+  /** \brief Replaces the Dead Nonce List, discarding the nonces in the current one
+   */
+  void
+  setDeadNonceList(unique_ptr<DeadNonceTable> dnl)
+  {
+    BOOST_ASSERT(dnl != nullptr);
+    m_deadNonceList = std::move(dnl);
   }
 
   NetworkRegionTable&
@@ -169,6 +184,12 @@ public:
     return m_networkRegionTable;
   }
 
+  ReductionTable&
+  getReductionTable()
+  {
+    return m_reductionTable;
+  }
+
   /** \brief register handler for forwarder section of NFD configuration file
    */
   void
@@ -268,7 +289,35 @@ NFD_PUBLIC_WITH_TESTS_ELSE_PRIVATE: // pipelines
   NFD_VIRTUAL_WITH_TESTS void
   onNewNextHop(const Name& prefix, const fib::NextHop& nextHop);
 
+  /** \brief aggregation Interest pipeline, for Interests under the ReductionTable's local prefix
+   *
+   *  Answers tree broadcasts, and splits model requests into one Interest per child.
+   *  A retransmitted model request only re-expresses the children which haven't answered yet.
+   */
+  NFD_VIRTUAL_WITH_TESTS void
+  onAggregationInterest(const Interest& interest, const shared_ptr<pit::Entry>& pitEntry);
+
+  /** \brief aggregation Data pipeline, for Data answering a child Interest
+   *
+   *  Sums the model into the accumulator of the model request, and sends the aggregated Data
+   *  downstream when it's complete.
+   */
+  NFD_VIRTUAL_WITH_TESTS void
+  onAggregationData(const Data& data, const FaceEndpoint& ingress,
+                    const shared_ptr<pit::Entry>& pitEntry);
+
 private:
+  /** \brief express the Interest to child \p index of the model request \p pitEntry
+   */
+  void
+  sendAggregationInterest(const Interest& interest, const shared_ptr<pit::Entry>& pitEntry,
+                          size_t index);
+
+  /** \brief satisfy a PIT entry with Data made by the forwarder itself
+   */
+  void
+  satisfyAggregation(const shared_ptr<pit::Entry>& pitEntry, const Data& data);
+
   /** \brief set a new expiry timer (now + \p duration) on a PIT entry
    */
   void
@@ -301,8 +350,9 @@ private:
   //! Added by Yitong
   std::string m_nodeName; // Store the node name
   utils::SlidingWindow<double> m_qsSlidingWindows;
-  std::string fwdFolderPath = "src/ndnSIM/results/logs/fwd";
+  std::string fwdFolderPath; // Empty until setResultsDir()
   std::string forwarder_recorder;
+  ns3::utils::LogFile* m_throughputLog = nullptr; // Buffered by the shared log sink
 
 
   ForwarderCounters m_counters;
@@ -316,8 +366,9 @@ private:
   Cs                 m_cs;
   Measurements       m_measurements;
   StrategyChoice     m_strategyChoice;
-  DeadNonceList      m_deadNonceList;
+  unique_ptr<DeadNonceTable> m_deadNonceList;
   NetworkRegionTable m_networkRegionTable;
+  ReductionTable     m_reductionTable;
   shared_ptr<Face>   m_csFace;
 
   // allow Strategy (base class) to enter pipelines
@@ -1,5 +1,5 @@
-#ifndef SLIDING_WINDOW_HPP
-#define SLIDING_WINDOW_HPP
+#ifndef NFD_DAEMON_FW_SLIDING_WINDOW_HPP
+#define NFD_DAEMON_FW_SLIDING_WINDOW_HPP
 
 #include <deque>
 #include <numeric>
@@ -89,4 +89,4 @@ private:
 } // namespace utils
 } // namespace nfd
 
-#endif // SLIDING_WINDOW_HPP
\ No newline at end of file
+#endif // NFD_DAEMON_FW_SLIDING_WINDOW_HPP
\ No newline at end of file
@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cs-policy-hashed.hpp"
+#include "cs.hpp"
+
+namespace nfd {
+namespace cs {
+namespace hashed {
+
+HashedPolicy::HashedPolicy(const std::string& policyName)
+  : Policy(policyName)
+  , m_buckets(16)
+{
+}
+
+HashedPolicy::~HashedPolicy()
+{
+  while (m_front != nullptr) {
+    Node* node = m_front;
+    m_front = node->next;
+    delete node;
+  }
+}
+
+void
+HashedPolicy::doAfterInsert(EntryRef i)
+{
+  name_tree::HashValue h = name_tree::computeHash(i->getName());
+  size_t bucket = computeBucketIndex(h);
+
+  Node* node = new Node{i, h, m_buckets[bucket], nullptr, nullptr};
+  m_buckets[bucket] = node;
+  this->pushBack(node);
+
+  if (++m_size > m_buckets.size()) {
+    this->grow();
+  }
+  this->evictEntries();
+}
+
+void
+HashedPolicy::doBeforeErase(EntryRef i)
+{
+  Node* node = this->findNode(i);
+  BOOST_ASSERT(node != nullptr);
+  this->eraseNode(node);
+}
+
+void
+HashedPolicy::evictEntries()
+{
+  BOOST_ASSERT(this->getCs() != nullptr);
+  while (this->getCs()->size() > this->getLimit()) {
+    BOOST_ASSERT(m_front != nullptr);
+    EntryRef i = m_front->entry;
+    this->eraseNode(m_front);
+    this->emitSignal(beforeEvict, i);
+  }
+}
+
+bool
+HashedPolicy::doFindExact(const Interest& interest, EntryRef& match) const
+{
+  const Name& name = interest.getName();
+  name_tree::HashValue h = name_tree::computeHash(name);
+
+  match = this->getCs()->end();
+  m_lastFound = nullptr;
+  for (Node* node = m_buckets[computeBucketIndex(h)]; node != nullptr; node = node->chainNext) {
+    if (node->hash != h || node->entry->getName() != name || !node->entry->canSatisfy(interest)) {
+      continue;
+    }
+    // Data with the same name but different digests: pick the first in Table order, as CS would
+    if (m_lastFound == nullptr || node->entry < match) {
+      match = node->entry;
+      m_lastFound = node;
+    }
+  }
+  return true;
+}
+
+void
+HashedPolicy::moveToBack(EntryRef i)
+{
+  Node* node = this->findNode(i);
+  BOOST_ASSERT(node != nullptr);
+  if (node != m_back) {
+    this->unlink(node);
+    this->pushBack(node);
+  }
+}
+
+HashedPolicy::Node*
+HashedPolicy::findNode(EntryRef i) const
+{
+  if (m_lastFound != nullptr && m_lastFound->entry == i) {
+    return m_lastFound;
+  }
+
+  name_tree::HashValue h = name_tree::computeHash(i->getName());
+  for (Node* node = m_buckets[computeBucketIndex(h)]; node != nullptr; node = node->chainNext) {
+    if (node->entry == i) {
+      return node;
+    }
+  }
+  return nullptr;
+}
+
+void
+HashedPolicy::eraseNode(Node* node)
+{
+  this->unlink(node);
+
+  Node** link = &m_buckets[computeBucketIndex(node->hash)];
+  while (*link != node) {
+    link = &(*link)->chainNext;
+  }
+  *link = node->chainNext;
+
+  if (m_lastFound == node) {
+    m_lastFound = nullptr;
+  }
+  --m_size;
+  delete node;
+}
+
+void
+HashedPolicy::pushBack(Node* node)
+{
+  node->prev = m_back;
+  node->next = nullptr;
+  if (m_back != nullptr) {
+    m_back->next = node;
+  }
+  else {
+    m_front = node;
+  }
+  m_back = node;
+}
+
+void
+HashedPolicy::unlink(Node* node)
+{
+  if (node->prev != nullptr) {
+    node->prev->next = node->next;
+  }
+  else {
+    m_front = node->next;
+  }
+  if (node->next != nullptr) {
+    node->next->prev = node->prev;
+  }
+  else {
+    m_back = node->prev;
+  }
+}
+
+void
+HashedPolicy::grow()
+{
+  std::vector<Node*> buckets(m_buckets.size() * 2);
+  for (Node* node = m_front; node != nullptr; node = node->next) {
+    size_t bucket = node->hash & (buckets.size() - 1);
+    node->chainNext = buckets[bucket];
+    buckets[bucket] = node;
+  }
+  m_buckets.swap(buckets);
+}
+
+const std::string HashedLruPolicy::POLICY_NAME = "hashed_lru";
+NFD_REGISTER_CS_POLICY(HashedLruPolicy);
+
+HashedLruPolicy::HashedLruPolicy()
+  : HashedPolicy(POLICY_NAME)
+{
+}
+
+void
+HashedLruPolicy::doAfterRefresh(EntryRef i)
+{
+  this->moveToBack(i);
+}
+
+void
+HashedLruPolicy::doBeforeUse(EntryRef i)
+{
+  this->moveToBack(i);
+}
+
+const std::string HashedFifoPolicy::POLICY_NAME = "hashed_fifo";
+NFD_REGISTER_CS_POLICY(HashedFifoPolicy);
+
+HashedFifoPolicy::HashedFifoPolicy()
+  : HashedPolicy(POLICY_NAME)
+{
+}
+
+void
+HashedFifoPolicy::doAfterRefresh(EntryRef)
+{
+}
+
+void
+HashedFifoPolicy::doBeforeUse(EntryRef)
+{
+}
+
+} // namespace hashed
+} // namespace cs
+} // namespace nfd
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_CS_POLICY_HASHED_HPP
+#define NFD_DAEMON_TABLE_CS_POLICY_HASHED_HPP
+
+#include "cs-policy.hpp"
+#include "name-tree-hashtable.hpp"
+
+namespace nfd {
+namespace cs {
+namespace hashed {
+
+/** \brief base of the replacement policies indexing CS entries by Data name hash
+ *
+ *  Each entry has one index node, which is chained in a hashtable bucket and linked into the
+ *  replacement queue. Exact-match lookups hash the Interest name once and compare names only
+ *  within its bucket, instead of O(log n) name comparisons along the Table; queue updates
+ *  relink nodes without any name comparison.
+ *
+ *  Eviction takes the front of the queue. Subclasses decide whether a use or a refresh moves
+ *  an entry to the back.
+ */
+class HashedPolicy : public Policy
+{
+public:
+  ~HashedPolicy() override;
+
+protected:
+  explicit
+  HashedPolicy(const std::string& policyName);
+
+  /** \brief moves an entry to the back of the queue, to be evicted last
+   */
+  void
+  moveToBack(EntryRef i);
+
+private:
+  void
+  doAfterInsert(EntryRef i) final;
+
+  void
+  doBeforeErase(EntryRef i) final;
+
+  void
+  evictEntries() final;
+
+  bool
+  doFindExact(const Interest& interest, EntryRef& match) const final;
+
+private:
+  struct Node
+  {
+    EntryRef entry;
+    name_tree::HashValue hash;
+    Node* chainNext; ///< next node in the same bucket
+    Node* prev; ///< previous node in the queue, toward the front
+    Node* next; ///< next node in the queue, toward the back
+  };
+
+  size_t
+  computeBucketIndex(name_tree::HashValue h) const
+  {
+    return h & (m_buckets.size() - 1);
+  }
+
+  Node*
+  findNode(EntryRef i) const;
+
+  /** \brief unlinks and deletes a node
+   */
+  void
+  eraseNode(Node* node);
+
+  void
+  pushBack(Node* node);
+
+  void
+  unlink(Node* node);
+
+  /** \brief doubles the number of buckets
+   */
+  void
+  grow();
+
+private:
+  std::vector<Node*> m_buckets; ///< size is a power of two
+  size_t m_size = 0;
+  Node* m_front = nullptr;
+  Node* m_back = nullptr;
+
+  /** \brief node of the last exact-match hit, which CS uses right after the lookup
+   */
+  mutable Node* m_lastFound = nullptr;
+};
+
+/** \brief Least-Recently-Used (LRU) replacement policy with an exact-match index
+ *
+ *  Evicts in the same order as \c LruPolicy.
+ */
+class HashedLruPolicy final : public HashedPolicy
+{
+public:
+  HashedLruPolicy();
+
+public:
+  static const std::string POLICY_NAME;
+
+private:
+  void
+  doAfterRefresh(EntryRef i) final;
+
+  void
+  doBeforeUse(EntryRef i) final;
+};
+
+/** \brief First-In-First-Out (FIFO) replacement policy with an exact-match index
+ *
+ *  Entries are evicted in insertion order, regardless of use or refresh.
+ */
+class HashedFifoPolicy final : public HashedPolicy
+{
+public:
+  HashedFifoPolicy();
+
+public:
+  static const std::string POLICY_NAME;
+
+private:
+  void
+  doAfterRefresh(EntryRef i) final;
+
+  void
+  doBeforeUse(EntryRef i) final;
+};
+
+} // namespace hashed
+
+using hashed::HashedLruPolicy;
+using hashed::HashedFifoPolicy;
+
+} // namespace cs
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_CS_POLICY_HASHED_HPP
@@ -100,5 +100,12 @@ Policy::beforeUse(EntryRef i)
   this->doBeforeUse(i);
 }
 
+bool
+Policy::findExact(const Interest& interest, EntryRef& match) const
+{
+  BOOST_ASSERT(m_cs != nullptr);
+  return this->doFindExact(interest, match);
+}
+
 } // namespace cs
 } // namespace nfd
@@ -146,6 +146,15 @@ public:
   void
   beforeUse(EntryRef i);
 
+  /** \brief finds an entry satisfying the Interest among the entries named exactly like it
+   *  \param interest an Interest that can only be satisfied by Data with the same name
+   *  \param[out] match the entry, or CS end if there's none
+   *  \retval false the policy keeps no index of Data names; \p match is not set,
+   *                CS must search its Table instead
+   */
+  bool
+  findExact(const Interest& interest, EntryRef& match) const;
+
 protected:
   /** \brief invoked after a new entry is created in CS
    *
@@ -189,6 +198,18 @@ protected:
   virtual void
   evictEntries() = 0;
 
+  /** \brief finds an entry satisfying the Interest among the entries named exactly like it
+   *
+   *  When overridden in a subclass, a policy implementation that indexes entries by Data name
+   *  may serve exact-match lookups without CS comparing names along its Table.
+   *  The default implementation returns false.
+   */
+  virtual bool
+  doFindExact(const Interest&, EntryRef&) const
+  {
+    return false;
+  }
+
 protected:
   DECLARE_SIGNAL_EMIT(beforeEvict)
 
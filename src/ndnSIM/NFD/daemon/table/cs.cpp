@@ -118,11 +118,21 @@ Cs::findImpl(const Interest& interest) const
   }
 
   const Name& prefix = interest.getName();
-  auto range = findPrefixRange(prefix);
-  auto match = std::find_if(range.first, range.second,
-                            [&interest] (const auto& entry) { return entry.canSatisfy(interest); });
+  const_iterator match;
+  // an Interest naming neither a prefix nor a full name is satisfied by Data with the same name,
+  // the policy may find those through its own index
+  bool isExact = !interest.getCanBePrefix() &&
+                 (prefix.empty() || !prefix[-1].isImplicitSha256Digest());
+  if (!isExact || !m_policy->findExact(interest, match)) {
+    auto range = findPrefixRange(prefix);
+    match = std::find_if(range.first, range.second,
+                         [&interest] (const auto& entry) { return entry.canSatisfy(interest); });
+    if (match == range.second) {
+      match = m_table.end();
+    }
+  }
 
-  if (match == range.second) {
+  if (match == m_table.end()) {
     NFD_LOG_DEBUG("find " << prefix << " no-match");
     return m_table.end();
   }
@@ -40,6 +40,8 @@ namespace cs {
  *  and a few additional attributes such as when the Data becomes non-fresh.
  *
  *  The replacement policy is implemented in a subclass of \c Policy.
+ *  A policy may also index entries by Data name (e.g. \c HashedLruPolicy), in which case
+ *  lookups of Interests that cannot be satisfied by a longer name bypass the Table.
  */
 class Cs : noncopyable
 {
@@ -0,0 +1,260 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dead-nonce-filter.hpp"
+#include "common/global.hpp"
+#include "common/logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace nfd {
+
+NFD_LOG_INIT(DeadNonceFilter);
+
+const size_t DeadNonceFilter::Generation::BUCKET_SIZE;
+const size_t DeadNonceFilter::Generation::MAX_KICKS;
+const double DeadNonceFilter::MAX_LOAD;
+
+DeadNonceFilter::DeadNonceFilter(const Options& options)
+  : m_options(options)
+  , m_rotateInterval(options.lifetime / (std::max<size_t>(options.nGenerations, 2) - 1))
+{
+  if (m_options.lifetime < DeadNonceList::MIN_LIFETIME) {
+    NDN_THROW(std::invalid_argument("lifetime is less than MIN_LIFETIME"));
+  }
+  if (m_options.capacity == 0) {
+    NDN_THROW(std::invalid_argument("capacity must be positive"));
+  }
+  if (!(m_options.falsePositiveRate > 0.0 && m_options.falsePositiveRate < 1.0)) {
+    NDN_THROW(std::invalid_argument("falsePositiveRate must be within (0,1)"));
+  }
+  if (m_options.nGenerations < 2) {
+    NDN_THROW(std::invalid_argument("nGenerations must be at least 2"));
+  }
+
+  // a lookup compares against every slot of two buckets in each generation
+  double nComparisons = 2.0 * Generation::BUCKET_SIZE * m_options.nGenerations;
+  double bits = std::ceil(std::log2(nComparisons / m_options.falsePositiveRate));
+  m_fingerprintBits = static_cast<size_t>(std::min(std::max(bits, 8.0), 32.0));
+
+  size_t nPerGeneration = (m_options.capacity + m_options.nGenerations - 2) / (m_options.nGenerations - 1);
+  size_t nBuckets = 2;
+  while (nBuckets * Generation::BUCKET_SIZE * MAX_LOAD < nPerGeneration) {
+    nBuckets *= 2;
+  }
+  m_bucketMask = nBuckets - 1;
+
+  for (size_t i = 0; i < m_options.nGenerations; ++i) {
+    m_generations.emplace_back(nBuckets, m_fingerprintBits);
+  }
+  NFD_LOG_DEBUG("fingerprintBits=" << m_fingerprintBits << " nBuckets=" << nBuckets
+                << " nGenerations=" << m_options.nGenerations << " bytes=" << getTableBytes());
+
+  m_rotateEvent = getScheduler().schedule(m_rotateInterval, [this] { rotate(); });
+}
+
+bool
+DeadNonceFilter::has(const Name& name, Interest::Nonce nonce) const
+{
+  uint64_t h = computeHash(name, nonce);
+  uint32_t fingerprint = this->getFingerprint(h);
+  size_t bucket = h & m_bucketMask;
+
+  return std::any_of(m_generations.begin(), m_generations.end(),
+                     [=] (const Generation& g) { return g.contains(fingerprint, bucket); });
+}
+
+void
+DeadNonceFilter::add(const Name& name, Interest::Nonce nonce)
+{
+  uint64_t h = computeHash(name, nonce);
+  uint32_t fingerprint = this->getFingerprint(h);
+  size_t bucket = h & m_bucketMask;
+
+  Generation& current = m_generations[m_current];
+  if (current.contains(fingerprint, bucket)) {
+    return;
+  }
+
+  NFD_LOG_TRACE("adding " << name << " nonce=" << nonce);
+  if (!current.insert(fingerprint, bucket)) {
+    NFD_LOG_DEBUG("generation full size=" << current.size() << ", rotating early");
+    this->rotate();
+  }
+}
+
+size_t
+DeadNonceFilter::size() const
+{
+  size_t n = 0;
+  for (const Generation& g : m_generations) {
+    n += g.size();
+  }
+  return n;
+}
+
+size_t
+DeadNonceFilter::getTableBytes() const
+{
+  size_t n = 0;
+  for (const Generation& g : m_generations) {
+    n += g.getTableBytes();
+  }
+  return n;
+}
+
+uint32_t
+DeadNonceFilter::getFingerprint(uint64_t h) const
+{
+  // bucket index is taken from the low bits, fingerprint from the high bits
+  uint32_t fingerprint = static_cast<uint32_t>(h >> 32) >> (32 - m_fingerprintBits);
+  return fingerprint == 0 ? 1 : fingerprint; // 0 marks an empty slot
+}
+
+void
+DeadNonceFilter::rotate()
+{
+  m_current = (m_current + 1) % m_generations.size();
+  m_generations[m_current].clear();
+  NFD_LOG_TRACE("rotate current=" << m_current << " size=" << size());
+
+  m_rotateEvent = getScheduler().schedule(m_rotateInterval, [this] { rotate(); });
+}
+
+DeadNonceFilter::Generation::Generation(size_t nBuckets, size_t fingerprintBits)
+  : m_nBuckets(nBuckets)
+  , m_fingerprintBits(fingerprintBits)
+  , m_fingerprintMask(fingerprintBits == 32 ? ~uint32_t(0) : (uint32_t(1) << fingerprintBits) - 1)
+  // one extra word, so that a slot can always be accessed as two adjacent words
+  , m_words((nBuckets * BUCKET_SIZE * fingerprintBits + 63) / 64 + 1)
+{
+  BOOST_ASSERT((m_nBuckets & (m_nBuckets - 1)) == 0);
+}
+
+bool
+DeadNonceFilter::Generation::contains(uint32_t fingerprint, size_t bucket) const
+{
+  size_t altBucket = this->getAltBucket(bucket, fingerprint);
+  for (size_t i = 0; i < BUCKET_SIZE; ++i) {
+    if (this->getSlot(bucket * BUCKET_SIZE + i) == fingerprint ||
+        this->getSlot(altBucket * BUCKET_SIZE + i) == fingerprint) {
+      return true;
+    }
+  }
+  return m_victim == fingerprint && (m_victimBucket == bucket || m_victimBucket == altBucket);
+}
+
+bool
+DeadNonceFilter::Generation::insert(uint32_t fingerprint, size_t bucket)
+{
+  BOOST_ASSERT(fingerprint != 0);
+  BOOST_ASSERT(m_victim == 0);
+
+  ++m_size;
+  if (this->insertIntoBucket(bucket, fingerprint) ||
+      this->insertIntoBucket(this->getAltBucket(bucket, fingerprint), fingerprint)) {
+    return true;
+  }
+
+  // move a random fingerprint of the bucket to its alternate bucket, and repeat from there
+  for (size_t n = 0; n < MAX_KICKS; ++n) {
+    m_kickState ^= m_kickState << 13;
+    m_kickState ^= m_kickState >> 17;
+    m_kickState ^= m_kickState << 5;
+
+    size_t slot = bucket * BUCKET_SIZE + m_kickState % BUCKET_SIZE;
+    uint32_t displaced = this->getSlot(slot);
+    this->setSlot(slot, fingerprint);
+    fingerprint = displaced;
+
+    bucket = this->getAltBucket(bucket, fingerprint);
+    if (this->insertIntoBucket(bucket, fingerprint)) {
+      return true;
+    }
+  }
+
+  m_victim = fingerprint;
+  m_victimBucket = bucket;
+  return false;
+}
+
+void
+DeadNonceFilter::Generation::clear()
+{
+  std::fill(m_words.begin(), m_words.end(), 0);
+  m_size = 0;
+  m_victim = 0;
+}
+
+size_t
+DeadNonceFilter::Generation::getAltBucket(size_t bucket, uint32_t fingerprint) const
+{
+  return (bucket ^ (fingerprint * 0x5bd1e995)) & (m_nBuckets - 1);
+}
+
+uint32_t
+DeadNonceFilter::Generation::getSlot(size_t slot) const
+{
+  size_t bit = slot * m_fingerprintBits;
+  size_t word = bit / 64;
+  size_t offset = bit % 64;
+
+  uint64_t value = m_words[word] >> offset;
+  if (offset + m_fingerprintBits > 64) {
+    value |= m_words[word + 1] << (64 - offset);
+  }
+  return static_cast<uint32_t>(value) & m_fingerprintMask;
+}
+
+void
+DeadNonceFilter::Generation::setSlot(size_t slot, uint32_t fingerprint)
+{
+  size_t bit = slot * m_fingerprintBits;
+  size_t word = bit / 64;
+  size_t offset = bit % 64;
+  uint64_t mask = m_fingerprintMask;
+
+  m_words[word] = (m_words[word] & ~(mask << offset)) | (uint64_t(fingerprint) << offset);
+  if (offset + m_fingerprintBits > 64) {
+    size_t shift = 64 - offset;
+    m_words[word + 1] = (m_words[word + 1] & ~(mask >> shift)) | (uint64_t(fingerprint) >> shift);
+  }
+}
+
+bool
+DeadNonceFilter::Generation::insertIntoBucket(size_t bucket, uint32_t fingerprint)
+{
+  for (size_t i = 0; i < BUCKET_SIZE; ++i) {
+    size_t slot = bucket * BUCKET_SIZE + i;
+    if (this->getSlot(slot) == 0) {
+      this->setSlot(slot, fingerprint);
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace nfd
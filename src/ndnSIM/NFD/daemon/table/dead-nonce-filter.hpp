@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_DEAD_NONCE_FILTER_HPP
+#define NFD_DAEMON_TABLE_DEAD_NONCE_FILTER_HPP
+
+#include "dead-nonce-list.hpp"
+
+namespace nfd {
+
+/** \brief Provides options for DeadNonceFilter
+ */
+class DeadNonceFilterOptions
+{
+public:
+  /** \brief Expected lifetime of each nonce, must be no less than DeadNonceList::MIN_LIFETIME
+   */
+  time::nanoseconds lifetime = DeadNonceList::DEFAULT_LIFETIME;
+
+  /** \brief Number of distinct nonces added per lifetime that the filter is sized for
+   */
+  size_t capacity = 1 << 16;
+
+  /** \brief Upper bound of the probability that has() is true for a name+nonce never added
+   */
+  double falsePositiveRate = 1e-4;
+
+  /** \brief Number of lifetime buckets, at least 2
+   */
+  size_t nGenerations = 4;
+};
+
+/**
+ * \brief Represents the Dead Nonce List as rotating cuckoo filters.
+ *
+ * Each name+nonce is reduced to a short fingerprint stored in a cuckoo filter, so an entry
+ * costs a few bytes and memory usage is fixed when the filter is constructed.
+ * Fingerprints are long enough to keep the false positive rate under the configured bound;
+ * a false positive is recoverable in the same way as a hash collision in DeadNonceList.
+ *
+ * The lifetime is divided into generations, each a cuckoo filter receiving the nonces added
+ * during one rotation interval of lifetime / (nGenerations - 1). At each rotation, the oldest
+ * generation is cleared and receives the subsequent nonces, so a nonce is kept for at least
+ * lifetime and at most lifetime * nGenerations / (nGenerations - 1).
+ *
+ * If more nonces than the capacity are added, the current generation fills up before the end
+ * of its interval and rotation happens early, which shortens the lifetime of older nonces
+ * instead of growing memory usage.
+ */
+class DeadNonceFilter final : public DeadNonceTable
+{
+public:
+  using Options = DeadNonceFilterOptions;
+
+  /**
+   * \brief Constructs the filter
+   * \throw std::invalid_argument if an option is out of range
+   */
+  explicit
+  DeadNonceFilter(const Options& options = Options());
+
+  bool
+  has(const Name& name, Interest::Nonce nonce) const final;
+
+  void
+  add(const Name& name, Interest::Nonce nonce) final;
+
+  /**
+   * \brief Returns the number of stored fingerprints
+   * \note A nonce re-added after a rotation is counted in each generation that holds it.
+   */
+  size_t
+  size() const final;
+
+  time::nanoseconds
+  getLifetime() const final
+  {
+    return m_options.lifetime;
+  }
+
+  /**
+   * \brief Returns the number of bits in each fingerprint
+   */
+  size_t
+  getFingerprintBits() const
+  {
+    return m_fingerprintBits;
+  }
+
+  /**
+   * \brief Returns the number of bytes used by the filter tables
+   */
+  size_t
+  getTableBytes() const;
+
+private:
+  /** \brief A cuckoo filter of bit-packed fingerprints
+   */
+  class Generation
+  {
+  public:
+    Generation(size_t nBuckets, size_t fingerprintBits);
+
+    bool
+    contains(uint32_t fingerprint, size_t bucket) const;
+
+    /** \brief Inserts \p fingerprint, in bucket \p bucket or its alternate bucket
+     *  \retval false the filter is full; the fingerprint displaced last is kept aside and
+     *                no further insertion should be made until the filter is cleared
+     */
+    bool
+    insert(uint32_t fingerprint, size_t bucket);
+
+    void
+    clear();
+
+    size_t
+    size() const
+    {
+      return m_size;
+    }
+
+    size_t
+    getTableBytes() const
+    {
+      return m_words.size() * sizeof(uint64_t);
+    }
+
+  private:
+    size_t
+    getAltBucket(size_t bucket, uint32_t fingerprint) const;
+
+    uint32_t
+    getSlot(size_t slot) const;
+
+    void
+    setSlot(size_t slot, uint32_t fingerprint);
+
+    /** \brief Stores \p fingerprint in a free slot of \p bucket if there is one
+     */
+    bool
+    insertIntoBucket(size_t bucket, uint32_t fingerprint);
+
+  public:
+    /// Number of fingerprints per bucket
+    static constexpr size_t BUCKET_SIZE = 4;
+    /// Maximum number of displacements before the filter is considered full
+    static constexpr size_t MAX_KICKS = 500;
+
+  private:
+    size_t m_nBuckets; ///< a power of two
+    size_t m_fingerprintBits;
+    uint32_t m_fingerprintMask;
+    std::vector<uint64_t> m_words;
+    size_t m_size = 0;
+    uint32_t m_victim = 0; ///< displaced fingerprint that found no slot, 0 if none
+    size_t m_victimBucket = 0;
+    uint32_t m_kickState = 1;
+  };
+
+  /** \brief Returns the fingerprint of a name+nonce hash, never 0
+   */
+  uint32_t
+  getFingerprint(uint64_t h) const;
+
+  void
+  rotate();
+
+private:
+  const Options m_options;
+  size_t m_fingerprintBits;
+  size_t m_bucketMask;
+  std::vector<Generation> m_generations;
+  size_t m_current = 0;
+
+  const time::nanoseconds m_rotateInterval;
+  scheduler::ScopedEventId m_rotateEvent;
+
+NFD_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /// Maximum load factor used to size each generation
+  static constexpr double MAX_LOAD = 0.9;
+};
+
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_DEAD_NONCE_FILTER_HPP
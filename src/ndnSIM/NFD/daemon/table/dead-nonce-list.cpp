@@ -24,7 +24,6 @@
  */
 
 #include "dead-nonce-list.hpp"
-#include "common/city-hash.hpp"
 #include "common/global.hpp"
 #include "common/logger.hpp"
 
@@ -106,10 +105,7 @@ DeadNonceList::add(const Name& name, Interest::Nonce nonce)
 DeadNonceList::Entry
 DeadNonceList::makeEntry(const Name& name, Interest::Nonce nonce)
 {
-  const auto& nameWire = name.wireEncode();
-  uint32_t n;
-  std::memcpy(&n, nonce.data(), sizeof(n));
-  return CityHash64WithSeed(reinterpret_cast<const char*>(nameWire.wire()), nameWire.size(), n);
+  return computeHash(name, nonce);
 }
 
 size_t
@@ -26,7 +26,7 @@
 #ifndef NFD_DAEMON_TABLE_DEAD_NONCE_LIST_HPP
 #define NFD_DAEMON_TABLE_DEAD_NONCE_LIST_HPP
 
-#include "core/common.hpp"
+#include "dead-nonce-table.hpp"
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -51,7 +51,7 @@ namespace nfd {
  * The number of MARKs stored in the container reflects the lifetime of the entries,
  * because MARKs are inserted at fixed intervals.
  */
-class DeadNonceList : noncopyable
+class DeadNonceList final : public DeadNonceTable
 {
 public:
   /**
@@ -69,26 +69,26 @@ public:
    * \return true if name+nonce exists, false otherwise
    */
   bool
-  has(const Name& name, Interest::Nonce nonce) const;
+  has(const Name& name, Interest::Nonce nonce) const final;
 
   /**
    * \brief Adds name+nonce to the list
    */
   void
-  add(const Name& name, Interest::Nonce nonce);
+  add(const Name& name, Interest::Nonce nonce) final;
 
   /**
    * \brief Returns the number of stored nonces
    * \note The return value does not contain non-Nonce entries in the index, if any.
    */
   size_t
-  size() const;
+  size() const final;
 
   /**
    * \brief Returns the expected nonce lifetime
    */
   time::nanoseconds
-  getLifetime() const
+  getLifetime() const final
   {
     return m_lifetime;
   }
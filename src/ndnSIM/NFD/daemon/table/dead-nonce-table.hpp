@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_DEAD_NONCE_TABLE_HPP
+#define NFD_DAEMON_TABLE_DEAD_NONCE_TABLE_HPP
+
+#include "core/common.hpp"
+
+namespace nfd {
+
+/**
+ * \brief Represents a Dead Nonce List implementation.
+ *
+ * The forwarder consults the Dead Nonce List to detect looping Interests whose Nonce is no
+ * longer recorded in a PIT entry, see DeadNonceList for the default implementation.
+ * Implementations differ in memory usage and in how accurately has() reflects the added nonces.
+ */
+class DeadNonceTable : noncopyable
+{
+public:
+  virtual
+  ~DeadNonceTable() = default;
+
+  /**
+   * \brief Determines if name+nonce is in the list
+   * \return true if name+nonce exists, false otherwise
+   */
+  virtual bool
+  has(const Name& name, Interest::Nonce nonce) const = 0;
+
+  /**
+   * \brief Adds name+nonce to the list
+   */
+  virtual void
+  add(const Name& name, Interest::Nonce nonce) = 0;
+
+  /**
+   * \brief Returns the number of stored nonces
+   */
+  virtual size_t
+  size() const = 0;
+
+  /**
+   * \brief Returns the expected nonce lifetime
+   */
+  virtual time::nanoseconds
+  getLifetime() const = 0;
+
+protected:
+  /**
+   * \brief Computes the 64-bit hash of name+nonce stored by implementations
+   */
+  static uint64_t
+  computeHash(const Name& name, Interest::Nonce nonce);
+};
+
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_DEAD_NONCE_TABLE_HPP
@@ -27,6 +27,8 @@
 #include "common/city-hash.hpp"
 #include "common/logger.hpp"
 
+#include <cstring>
+
 namespace nfd {
 namespace name_tree {
 
@@ -89,6 +91,63 @@ computeHashes(const Name& name, size_t prefixLen)
   return seq;
 }
 
+PrefixHashCache::PrefixHashCache()
+{
+  m_hashes.push_back(0);
+}
+
+const HashSequence&
+PrefixHashCache::get(const Name& name, size_t prefixLen)
+{
+  if (!m_isEnabled) {
+    m_hashes = computeHashes(name, prefixLen);
+    return m_hashes;
+  }
+
+  name.wireEncode(); // ensure wire buffer exists
+
+  size_t last = std::min(prefixLen, name.size());
+  size_t nCached = m_ends.size();
+
+  // leading components shared with the cached name
+  size_t common = 0;
+  for (; common < last && common < nCached; ++common) {
+    const name::Component& comp = name[common];
+    size_t begin = common == 0 ? 0 : m_ends[common - 1];
+    if (m_ends[common] - begin != comp.size() ||
+        std::memcmp(m_wire.data() + begin, comp.wire(), comp.size()) != 0) {
+      break;
+    }
+  }
+  if (common == last) {
+    return m_hashes;
+  }
+
+  m_hashes.truncate(common + 1);
+  m_ends.resize(common);
+  m_wire.resize(common == 0 ? 0 : m_ends[common - 1]);
+
+  HashValue h = m_hashes[common];
+  for (size_t i = common; i < last; ++i) {
+    const name::Component& comp = name[i];
+    h ^= HashFunc::compute(comp.wire(), comp.size());
+    m_hashes.push_back(h);
+    m_wire.insert(m_wire.end(), comp.wire(), comp.wire() + comp.size());
+    m_ends.push_back(m_wire.size());
+  }
+  return m_hashes;
+}
+
+void
+PrefixHashCache::enable(bool isEnabled)
+{
+  m_isEnabled = isEnabled;
+  m_hashes.truncate(0);
+  m_hashes.push_back(0);
+  m_wire.clear();
+  m_ends.clear();
+}
+
 Node::Node(HashValue h, const Name& name)
   : hash(h)
   , prev(nullptr)
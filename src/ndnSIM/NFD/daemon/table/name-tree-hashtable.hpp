@@ -28,6 +28,8 @@
 
 #include "name-tree-entry.hpp"
 
+#include <array>
+
 namespace nfd {
 namespace name_tree {
 
@@ -38,9 +40,110 @@ class Entry;
 using HashValue = size_t;
 
 /** \brief a sequence of hash values
+ *
+ *  Up to \c INLINE_CAPACITY values are stored inline, which covers names of usual depth
+ *  without heap allocation.
  *  \sa computeHashes
  */
-using HashSequence = std::vector<HashValue>;
+class HashSequence
+{
+public:
+  static constexpr size_t INLINE_CAPACITY = 16;
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  bool
+  empty() const
+  {
+    return m_size == 0;
+  }
+
+  void
+  reserve(size_t n)
+  {
+    if (n > INLINE_CAPACITY) {
+      m_heap.reserve(n);
+    }
+  }
+
+  void
+  push_back(HashValue h)
+  {
+    if (!m_heap.empty()) {
+      m_heap.push_back(h);
+    }
+    else if (m_size < INLINE_CAPACITY) {
+      m_inline[m_size] = h;
+    }
+    else {
+      m_heap.assign(m_inline.begin(), m_inline.end());
+      m_heap.push_back(h);
+    }
+    ++m_size;
+  }
+
+  /** \brief keeps the first \p n values
+   *  \pre n <= size()
+   */
+  void
+  truncate(size_t n)
+  {
+    BOOST_ASSERT(n <= m_size);
+    if (!m_heap.empty()) {
+      if (n <= INLINE_CAPACITY) {
+        std::copy_n(m_heap.begin(), n, m_inline.begin());
+        m_heap.clear(); // capacity is kept for the next spill
+      }
+      else {
+        m_heap.resize(n);
+      }
+    }
+    m_size = n;
+  }
+
+  HashValue
+  operator[](size_t i) const
+  {
+    return this->data()[i];
+  }
+
+  HashValue
+  at(size_t i) const
+  {
+    if (i >= m_size) {
+      NDN_THROW(std::out_of_range("HashSequence index out of range"));
+    }
+    return this->data()[i];
+  }
+
+  const HashValue*
+  begin() const
+  {
+    return this->data();
+  }
+
+  const HashValue*
+  end() const
+  {
+    return this->data() + m_size;
+  }
+
+private:
+  const HashValue*
+  data() const
+  {
+    return m_heap.empty() ? m_inline.data() : m_heap.data();
+  }
+
+private:
+  std::array<HashValue, INLINE_CAPACITY> m_inline;
+  std::vector<HashValue> m_heap; ///< all values, once they outgrow m_inline
+  size_t m_size = 0;
+};
 
 /** \brief computes hash value of \p name.getPrefix(prefixLen)
  */
@@ -53,6 +156,42 @@ computeHash(const Name& name, size_t prefixLen = std::numeric_limits<size_t>::ma
 HashSequence
 computeHashes(const Name& name, size_t prefixLen = std::numeric_limits<size_t>::max());
 
+/** \brief hashes of the prefixes of the last name it was given
+ *
+ *  Name tree lookups by name (PIT insertion and find, Data match, FIB and measurements lookups
+ *  by name) hash it, while FIB and measurements lookups by PIT entry walk up from the entry's
+ *  name tree entry and hash nothing. Keeping the hashes of the last name lets consecutive lookups
+ *  of one name hash it once. The cache is rolling: for another name that shares leading
+ *  components with the last one, such as the next sequence number under the same aggregation
+ *  prefix, only the components that differ are hashed.
+ *
+ *  Names are compared by the wire encoding of their components, so the cache stays valid
+ *  whatever happens to the Name objects it was given. Storage is reused across names.
+ */
+class PrefixHashCache : noncopyable
+{
+public:
+  PrefixHashCache();
+
+  /** \return hashes of \p name, where the i-th hash value equals computeHash(name, i)
+   *          for each i <= min(prefixLen, name.size()); the sequence may be longer
+   *  \note The reference is valid until the next call.
+   */
+  const HashSequence&
+  get(const Name& name, size_t prefixLen = std::numeric_limits<size_t>::max());
+
+  /** \brief when disabled, get() hashes every name with computeHashes(), to measure the cache
+   */
+  void
+  enable(bool isEnabled);
+
+private:
+  bool m_isEnabled = true;
+  HashSequence m_hashes; ///< m_hashes[i] is the hash of the i-component prefix
+  std::vector<uint8_t> m_wire; ///< wire encodings of the cached components, concatenated
+  std::vector<size_t> m_ends; ///< end offset of each cached component in m_wire
+};
+
 /** \brief a hashtable node
  *
  *  Zero or more nodes can be added to a hashtable bucket. They are organized as
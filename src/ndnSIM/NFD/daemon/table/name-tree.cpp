@@ -47,7 +47,7 @@ NameTree::lookup(const Name& name, size_t prefixLen)
   BOOST_ASSERT(prefixLen <= name.size());
   BOOST_ASSERT(prefixLen <= getMaxDepth());
 
-  HashSequence hashes = computeHashes(name, prefixLen);
+  const HashSequence& hashes = m_hashCache.get(name, prefixLen);
   const Node* node = nullptr;
   Entry* parent = nullptr;
 
@@ -154,7 +154,7 @@ NameTree::findExactMatch(const Name& name, size_t prefixLen) const
     return nullptr;
   }
 
-  const Node* node = m_ht.find(name, prefixLen);
+  const Node* node = m_ht.find(name, prefixLen, m_hashCache.get(name, prefixLen));
   return node == nullptr ? nullptr : &node->entry;
 }
 
@@ -162,7 +162,7 @@ Entry*
 NameTree::findLongestPrefixMatch(const Name& name, const EntrySelector& entrySelector) const
 {
   size_t depth = std::min(name.size(), getMaxDepth());
-  HashSequence hashes = computeHashes(name, depth);
+  const HashSequence& hashes = m_hashCache.get(name, depth);
 
   for (ssize_t i = depth; i >= 0; --i) {
     const Node* node = m_ht.find(name, i, hashes);
@@ -275,6 +275,9 @@ public: // enumeration
 private:
   Hashtable m_ht;
 
+NFD_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  mutable PrefixHashCache m_hashCache; ///< hashes of the name of the packet being forwarded
+
   friend class EnumerationImpl;
 };
 
@@ -28,8 +28,15 @@
 
 #include "pit-in-record.hpp"
 #include "pit-out-record.hpp"
+#include "pit-record-collection.hpp"
 
-#include <list>
+#ifndef NFD_PIT_INLINE_IN_RECORDS
+#define NFD_PIT_INLINE_IN_RECORDS 4
+#endif
+
+#ifndef NFD_PIT_INLINE_OUT_RECORDS
+#define NFD_PIT_INLINE_OUT_RECORDS 1
+#endif
 
 namespace nfd {
 
@@ -39,13 +46,28 @@ class Entry;
 
 namespace pit {
 
+/** \brief Number of in-records stored inline in a PIT entry
+ *
+ *  Aggregation trees typically have a fan-in of a few faces per entry, so this many downstreams
+ *  are kept without a heap allocation each. 0 keeps in-records in a std::list.
+ *  Set at build time with NFD_PIT_INLINE_IN_RECORDS.
+ */
+const size_t INLINE_IN_RECORD_CAPACITY = NFD_PIT_INLINE_IN_RECORDS;
+
+/** \brief Number of out-records stored inline in a PIT entry
+ *
+ *  An Interest is usually forwarded to a single upstream, further out-records spill to the heap.
+ *  0 keeps out-records in a std::list. Set at build time with NFD_PIT_INLINE_OUT_RECORDS.
+ */
+const size_t INLINE_OUT_RECORD_CAPACITY = NFD_PIT_INLINE_OUT_RECORDS;
+
 /** \brief An unordered collection of in-records
  */
-typedef std::list<InRecord> InRecordCollection;
+typedef RecordCollection<InRecord, INLINE_IN_RECORD_CAPACITY> InRecordCollection;
 
 /** \brief An unordered collection of out-records
  */
-typedef std::list<OutRecord> OutRecordCollection;
+typedef RecordCollection<OutRecord, INLINE_OUT_RECORD_CAPACITY> OutRecordCollection;
 
 /** \brief An Interest table entry
  *
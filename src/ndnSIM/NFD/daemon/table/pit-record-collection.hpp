@@ -0,0 +1,383 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_PIT_RECORD_COLLECTION_HPP
+#define NFD_DAEMON_TABLE_PIT_RECORD_COLLECTION_HPP
+
+#include "core/common.hpp"
+
+#include <iterator>
+#include <list>
+
+namespace nfd {
+namespace pit {
+
+/** \brief An unordered collection of in-records or out-records
+ *  \tparam T record type
+ *  \tparam N number of records stored inline in the collection
+ *
+ *  The first \p N records are stored inside the collection itself, so that a PIT entry
+ *  with few downstreams or upstreams needs no allocation for its records.
+ *  Further records spill into heap chunks of \p N records each.
+ *
+ *  Records never move once inserted: like std::list, an iterator or reference to a record
+ *  stays valid until that record is erased.
+ *  Iteration order is unspecified.
+ *
+ *  With \p N = 0 the records are kept in a std::list, one allocation per record.
+ */
+template<typename T, size_t N>
+class RecordCollection : noncopyable
+{
+  static_assert(N <= 32, "inline capacity must be within [0,32]");
+
+private:
+  struct Chunk
+  {
+    T*
+    slot(size_t i)
+    {
+      return reinterpret_cast<T*>(&slots[i]);
+    }
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[N];
+    uint32_t used = 0; ///< bitmask of constructed slots
+    Chunk* next = nullptr;
+  };
+
+  static constexpr uint32_t FULL = N == 32 ? ~uint32_t(0) : (uint32_t(1) << N) - 1;
+
+  template<bool IsConst>
+  class Iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = typename std::conditional<IsConst, const T*, T*>::type;
+    using reference = typename std::conditional<IsConst, const T&, T&>::type;
+
+    Iterator() = default;
+
+    /** \brief convert iterator to const_iterator
+     */
+    template<bool C = IsConst, typename = typename std::enable_if<C>::type>
+    Iterator(const Iterator<false>& other)
+      : m_chunk(other.m_chunk)
+      , m_index(other.m_index)
+    {
+    }
+
+    reference
+    operator*() const
+    {
+      return *m_chunk->slot(m_index);
+    }
+
+    pointer
+    operator->() const
+    {
+      return m_chunk->slot(m_index);
+    }
+
+    Iterator&
+    operator++()
+    {
+      ++m_index;
+      this->skipUnused();
+      return *this;
+    }
+
+    Iterator
+    operator++(int)
+    {
+      Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    friend bool
+    operator==(const Iterator& lhs, const Iterator& rhs)
+    {
+      return lhs.m_chunk == rhs.m_chunk && lhs.m_index == rhs.m_index;
+    }
+
+    friend bool
+    operator!=(const Iterator& lhs, const Iterator& rhs)
+    {
+      return !(lhs == rhs);
+    }
+
+  private:
+    Iterator(Chunk* chunk, size_t index)
+      : m_chunk(chunk)
+      , m_index(index)
+    {
+      this->skipUnused();
+    }
+
+    /** \brief advance to the first constructed slot at or after the current position
+     */
+    void
+    skipUnused()
+    {
+      while (m_chunk != nullptr) {
+        for (; m_index < N; ++m_index) {
+          if (m_chunk->used & (uint32_t(1) << m_index)) {
+            return;
+          }
+        }
+        m_chunk = m_chunk->next;
+        m_index = 0;
+      }
+    }
+
+  private:
+    Chunk* m_chunk = nullptr;
+    size_t m_index = 0;
+
+    friend class RecordCollection;
+    friend class Iterator<!IsConst>;
+  };
+
+public:
+  using value_type = T;
+  using size_type = size_t;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  RecordCollection() = default;
+
+  ~RecordCollection()
+  {
+    this->clear();
+  }
+
+  iterator
+  begin()
+  {
+    return iterator(&m_inline, 0);
+  }
+
+  const_iterator
+  begin() const
+  {
+    return const_iterator(const_cast<Chunk*>(&m_inline), 0);
+  }
+
+  iterator
+  end()
+  {
+    return iterator();
+  }
+
+  const_iterator
+  end() const
+  {
+    return const_iterator();
+  }
+
+  bool
+  empty() const
+  {
+    return m_size == 0;
+  }
+
+  size_type
+  size() const
+  {
+    return m_size;
+  }
+
+  const T&
+  front() const
+  {
+    BOOST_ASSERT(!this->empty());
+    return *this->begin();
+  }
+
+  /** \brief construct a record in the first free slot
+   *  \return an iterator to the new record
+   */
+  template<typename... Args>
+  iterator
+  emplace(Args&&... args)
+  {
+    Chunk* chunk = &m_inline;
+    while (chunk->used == FULL) {
+      if (chunk->next == nullptr) {
+        chunk->next = new Chunk;
+      }
+      chunk = chunk->next;
+    }
+
+    size_t index = 0;
+    while (chunk->used & (uint32_t(1) << index)) {
+      ++index;
+    }
+    new (chunk->slot(index)) T(std::forward<Args>(args)...);
+    chunk->used |= uint32_t(1) << index;
+    ++m_size;
+    return iterator(chunk, index);
+  }
+
+  /** \brief destroy the record at \p pos
+   *  \return an iterator to the record following \p pos
+   *
+   *  A heap chunk left without records is released.
+   */
+  iterator
+  erase(const_iterator pos)
+  {
+    BOOST_ASSERT(pos != this->end());
+    Chunk* chunk = pos.m_chunk;
+    iterator next(chunk, pos.m_index + 1);
+
+    chunk->slot(pos.m_index)->~T();
+    chunk->used &= ~(uint32_t(1) << pos.m_index);
+    --m_size;
+
+    if (chunk != &m_inline && chunk->used == 0) {
+      Chunk* prev = &m_inline;
+      while (prev->next != chunk) {
+        prev = prev->next;
+      }
+      prev->next = chunk->next;
+      delete chunk;
+    }
+    return next;
+  }
+
+  /** \brief destroy all records and release heap chunks
+   */
+  void
+  clear()
+  {
+    Chunk* chunk = &m_inline;
+    while (chunk != nullptr) {
+      for (size_t i = 0; i < N; ++i) {
+        if (chunk->used & (uint32_t(1) << i)) {
+          chunk->slot(i)->~T();
+        }
+      }
+      chunk->used = 0;
+
+      Chunk* next = chunk->next;
+      if (chunk != &m_inline) {
+        delete chunk;
+      }
+      chunk = next;
+    }
+    m_inline.next = nullptr;
+    m_size = 0;
+  }
+
+private:
+  Chunk m_inline;
+  size_t m_size = 0;
+};
+
+/** \brief A collection of records without inline storage, each record is a std::list node
+ */
+template<typename T>
+class RecordCollection<T, 0> : noncopyable
+{
+public:
+  using value_type = T;
+  using size_type = size_t;
+  using iterator = typename std::list<T>::iterator;
+  using const_iterator = typename std::list<T>::const_iterator;
+
+  iterator
+  begin()
+  {
+    return m_records.begin();
+  }
+
+  const_iterator
+  begin() const
+  {
+    return m_records.begin();
+  }
+
+  iterator
+  end()
+  {
+    return m_records.end();
+  }
+
+  const_iterator
+  end() const
+  {
+    return m_records.end();
+  }
+
+  bool
+  empty() const
+  {
+    return m_records.empty();
+  }
+
+  size_type
+  size() const
+  {
+    return m_records.size();
+  }
+
+  const T&
+  front() const
+  {
+    BOOST_ASSERT(!this->empty());
+    return m_records.front();
+  }
+
+  template<typename... Args>
+  iterator
+  emplace(Args&&... args)
+  {
+    m_records.emplace_front(std::forward<Args>(args)...);
+    return m_records.begin();
+  }
+
+  iterator
+  erase(const_iterator pos)
+  {
+    return m_records.erase(pos);
+  }
+
+  void
+  clear()
+  {
+    m_records.clear();
+  }
+
+private:
+  std::list<T> m_records;
+};
+
+} // namespace pit
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_PIT_RECORD_COLLECTION_HPP
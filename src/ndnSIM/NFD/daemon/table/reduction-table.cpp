@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "reduction-table.hpp"
+
+#include <map>
+
+namespace nfd {
+
+static const name::Component DATA_COMPONENT("data");
+static const name::Component INITIALIZATION_COMPONENT("initialization");
+
+/** \return index of the seq of a tree broadcast name, the tree message carried in the
+ *          ApplicationParameters adds a parameters digest behind it
+ */
+static ssize_t
+getSeqIndex(const Name& name)
+{
+  return !name.empty() && name.get(-1).isParametersSha256Digest() ? -2 : -1;
+}
+
+void
+ReductionTable::setLocalPrefix(const Name& prefix)
+{
+  m_localPrefix = prefix;
+  m_children.clear();
+  m_treeMessage = ns3::ndn::TreeMessageAssembler();
+}
+
+bool
+ReductionTable::isDataName(const Name& name)
+{
+  return name.size() >= 4 && name.get(2) == DATA_COMPONENT;
+}
+
+bool
+ReductionTable::isInitializationName(const Name& name)
+{
+  ssize_t seq = getSeqIndex(name);
+  return static_cast<ssize_t>(name.size()) + seq >= 2 && name.get(seq - 1) == INITIALIZATION_COMPONENT;
+}
+
+bool
+ReductionTable::installTree(const Interest& initInterest)
+{
+  const Name& name = initInterest.getName();
+  const Block& parameters = initInterest.getApplicationParameters();
+  auto result = m_treeMessage.add(name.get(getSeqIndex(name)).toSequenceNumber(),
+                                  parameters.value(), parameters.value_size());
+  if (result != ns3::ndn::TreeMessageAssembler::COMPLETE) {
+    return result != ns3::ndn::TreeMessageAssembler::INVALID;
+  }
+
+  // Children are resolved from node ids once, the leaves of a child form one dotted component
+  std::map<std::string, std::string> leavesOf;
+  for (const auto& [childId, leafIds] : m_treeMessage.assignment()) {
+    std::string child = ns3::ndn::treeNodeName(childId);
+    if (child.empty()) {
+      return false;
+    }
+
+    std::string& leaves = leavesOf[child];
+    for (uint32_t leafId : leafIds) {
+      std::string leaf = ns3::ndn::treeNodeName(leafId);
+      if (leaf.empty()) {
+        return false;
+      }
+      if (!leaves.empty()) {
+        leaves += ".";
+      }
+      leaves += leaf;
+    }
+  }
+
+  m_children.clear();
+  for (const auto& [child, leaves] : leavesOf) {
+    m_children.push_back(Name().append(child).append(leaves).append(DATA_COMPONENT));
+  }
+  return true;
+}
+
+Name
+ReductionTable::makeChildName(size_t index, const Name& dataName) const
+{
+  BOOST_ASSERT(index < m_children.size());
+  // Iteration and, if any, segment are kept as they are
+  return Name(m_children[index]).append(dataName.getSubName(3));
+}
+
+namespace reduction {
+
+Accumulator::Accumulator(size_t nChildren)
+  : m_hasArrived(nChildren, false)
+{
+}
+
+bool
+Accumulator::add(size_t index, const ModelDataView& model)
+{
+  if (index >= m_hasArrived.size() || m_hasArrived[index]) {
+    return false;
+  }
+
+  if (m_nArrived == 0) {
+    m_sum.assign(model.size(), 0.0);
+    m_encoding = model.encoding();
+  }
+  model.accumulateInto(m_sum.data(), m_sum.size());
+  model.mergeContributorsInto(m_contributors);
+
+  m_hasArrived[index] = true;
+  ++m_nArrived;
+  return true;
+}
+
+Block
+Accumulator::encode() const
+{
+  // Same as the Aggregator app: no QSF and, for topk, every non-zero entry of the sum
+  return encodeModelDataContent(m_sum.data(), m_sum.size(), -1.0, {}, m_encoding, 0, m_contributors);
+}
+
+} // namespace reduction
+} // namespace nfd
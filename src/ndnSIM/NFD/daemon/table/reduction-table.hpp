@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NFD_DAEMON_TABLE_REDUCTION_TABLE_HPP
+#define NFD_DAEMON_TABLE_REDUCTION_TABLE_HPP
+
+#include "core/common.hpp"
+#include "fw/strategy-info.hpp"
+
+#include "ns3/ndnSIM/utils/model-data-codec.hpp"
+#include "ns3/ndnSIM/utils/tree-message.hpp"
+
+namespace nfd {
+
+namespace pit {
+class Entry;
+} // namespace pit
+
+/** \brief per-node table of forwarder-level model aggregation
+ *
+ *  When a local prefix is set, the forwarder itself plays the aggregator role of that prefix,
+ *  no Aggregator app is needed on the node:
+ *  - the tree broadcast /<prefix>/initialization/<seq>, whose ApplicationParameters carry a chunk
+ *    of the tree message, is answered right away; the children are installed once every chunk
+ *    arrived;
+ *  - /<prefix>/<leaves>/data/<iteration>[/<segment>] is split into one Interest per child,
+ *    /<child>/<leaves of child>/data/<iteration>[/<segment>], whose Data are summed into a
+ *    reduction::Accumulator attached to the downstream PIT entry. The aggregated Data is sent
+ *    downstream once every child answered.
+ */
+class ReductionTable
+{
+public:
+  /** \return whether the forwarder aggregates on behalf of a local prefix
+   */
+  bool
+  isEnabled() const
+  {
+    return !m_localPrefix.empty();
+  }
+
+  /** \brief make the forwarder aggregate Interests under \p prefix, an empty prefix disables it
+   */
+  void
+  setLocalPrefix(const Name& prefix);
+
+  const Name&
+  getLocalPrefix() const
+  {
+    return m_localPrefix;
+  }
+
+  /** \return whether \p name is addressed to the local aggregator role
+   */
+  bool
+  isLocal(const Name& name) const
+  {
+    return this->isEnabled() && m_localPrefix.isPrefixOf(name);
+  }
+
+  /** \return whether \p name is a model request, /<node>/<leaves>/data/...
+   */
+  static bool
+  isDataName(const Name& name);
+
+  /** \return whether \p name is a tree broadcast, /<node>/initialization/<seq>/<params-sha256>
+   */
+  static bool
+  isInitializationName(const Name& name);
+
+  /** \brief add a chunk of the tree message, the children are replaced once the message is complete
+   *  \return false if the chunk can't be parsed or refers to an unknown node
+   */
+  bool
+  installTree(const Interest& initInterest);
+
+  /** \return number of children of the local aggregator
+   */
+  size_t
+  size() const
+  {
+    return m_children.size();
+  }
+
+  /** \return name of the Interest to child \p index for the model request \p dataName
+   */
+  Name
+  makeChildName(size_t index, const Name& dataName) const;
+
+private:
+  Name m_localPrefix;
+  std::vector<Name> m_children; ///< /<child>/<leaves of child>/data
+  ns3::ndn::TreeMessageAssembler m_treeMessage;
+};
+
+namespace reduction {
+
+/** \brief partial sum of a model request, attached to its downstream PIT entry
+ */
+class Accumulator final : public fw::StrategyInfo
+{
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 1100;
+  }
+
+  explicit
+  Accumulator(size_t nChildren);
+
+  bool
+  hasArrived(size_t index) const
+  {
+    return m_hasArrived[index];
+  }
+
+  bool
+  isComplete() const
+  {
+    return m_nArrived == m_hasArrived.size();
+  }
+
+  /** \brief add the model of child \p index, read straight from the Data packet
+   *  \return false if the child already answered
+   *
+   *  The sum takes the length and encoding of the first child's model.
+   */
+  bool
+  add(size_t index, const ModelDataView& model);
+
+  /** \brief encode the sum, with the union of the children's contributors, as the Content of the aggregated Data
+   */
+  Block
+  encode() const;
+
+private:
+  std::vector<double> m_sum;
+  ModelContributors m_contributors;
+  std::vector<bool> m_hasArrived;
+  size_t m_nArrived = 0;
+  PayloadEncoding m_encoding = PAYLOAD_FP64;
+};
+
+/** \brief links the PIT entry of a child Interest to the model request it was split from
+ */
+class ChildInfo final : public fw::StrategyInfo
+{
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 1101;
+  }
+
+public:
+  weak_ptr<pit::Entry> parent;
+  size_t index = 0;
+};
+
+} // namespace reduction
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_REDUCTION_TABLE_HPP
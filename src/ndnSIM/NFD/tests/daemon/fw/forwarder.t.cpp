@@ -32,6 +32,12 @@
 #include "choose-strategy.hpp"
 #include "dummy-strategy.hpp"
 
+#include "ns3/ndnSIM/utils/model-data-codec.hpp"
+#include "ns3/ndnSIM/utils/tree-message.hpp"
+
+#include "ns3/names.h"
+#include "ns3/node.h"
+
 #include <ndn-cxx/lp/tags.hpp>
 
 namespace nfd {
@@ -800,6 +806,163 @@ BOOST_AUTO_TEST_CASE(NewNextHop)
   BOOST_TEST(strategy.afterNewNextHopCalls[1] == "/A");
 }
 
+class AggregationFixture : public ForwarderFixture
+{
+protected:
+  AggregationFixture()
+  {
+    // producers pro0 and pro1 are the two children of the local aggregator agg0
+    for (const char* producer : {"pro0", "pro1"}) {
+      ns3::Names::Add(producer, ns3::CreateObject<ns3::Node>());
+    }
+    forwarder.getReductionTable().setLocalPrefix("/agg0");
+
+    fib::Entry* entry = forwarder.getFib().insert("/pro0").first;
+    forwarder.getFib().addOrUpdateNextHop(*entry, *face2, 0);
+    entry = forwarder.getFib().insert("/pro1").first;
+    forwarder.getFib().addOrUpdateNextHop(*entry, *face3, 0);
+  }
+
+  ~AggregationFixture()
+  {
+    ns3::Names::Clear();
+  }
+
+  /** \brief deliver the tree broadcast from face1 and check that it is acknowledged
+   */
+  void
+  installTree()
+  {
+    ns3::ndn::TreeAssignment assignment;
+    for (const char* producer : {"pro0", "pro1"}) {
+      uint32_t id = ns3::ndn::treeNodeId(producer);
+      assignment[id].push_back(id);
+    }
+    auto chunks = ns3::ndn::encodeTreeMessage(assignment, 1024);
+    BOOST_REQUIRE_EQUAL(chunks.size(), 1);
+
+    auto interest = makeInterest(Name("/agg0/initialization").appendSequenceNumber(1));
+    interest->setApplicationParameters(chunks.front().data(), chunks.front().size());
+    face1->receiveInterest(*interest, 0);
+    this->advanceClocks(1_ms, 5_ms);
+
+    BOOST_REQUIRE_EQUAL(face1->sentData.size(), 1);
+    BOOST_REQUIRE_EQUAL(forwarder.getReductionTable().size(), 2);
+    face1->sentData.clear();
+  }
+
+  static Name
+  makeModelName(const Name& prefix, uint64_t iteration)
+  {
+    return Name(prefix).append("data").appendSequenceNumber(iteration);
+  }
+
+  static shared_ptr<Data>
+  makeModelData(const Name& name, const std::vector<double>& parameters, const char* producer)
+  {
+    ModelContributors contributors;
+    contributors.add(ns3::ndn::treeNodeId(producer));
+    auto data = makeData(name);
+    data->setContent(encodeModelDataContent(parameters.data(), parameters.size(), 0.0, {},
+                                            PAYLOAD_FP64, 0, contributors));
+    return signData(data);
+  }
+
+protected:
+  shared_ptr<DummyFace> face1 = addFace(); // downstream, the consumer
+  shared_ptr<DummyFace> face2 = addFace(); // towards pro0
+  shared_ptr<DummyFace> face3 = addFace(); // towards pro1
+};
+
+BOOST_FIXTURE_TEST_CASE(AggregationSplit, AggregationFixture)
+{
+  installTree();
+
+  face1->receiveInterest(*makeInterest(makeModelName("/agg0/pro0.pro1", 1)), 0);
+  this->advanceClocks(1_ms, 5_ms);
+
+  BOOST_REQUIRE_EQUAL(face2->sentInterests.size(), 1);
+  BOOST_CHECK_EQUAL(face2->sentInterests[0].getName(), makeModelName("/pro0/pro0", 1));
+  BOOST_REQUIRE_EQUAL(face3->sentInterests.size(), 1);
+  BOOST_CHECK_EQUAL(face3->sentInterests[0].getName(), makeModelName("/pro1/pro1", 1));
+  BOOST_CHECK_EQUAL(face1->sentData.size(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(AggregationComplete, AggregationFixture)
+{
+  installTree();
+
+  face1->receiveInterest(*makeInterest(makeModelName("/agg0/pro0.pro1", 1)), 0);
+  this->advanceClocks(1_ms, 5_ms);
+
+  // partial arrival is held back
+  face2->receiveData(*makeModelData(makeModelName("/pro0/pro0", 1), {1.0, 2.0}, "pro0"), 0);
+  this->advanceClocks(1_ms, 5_ms);
+  BOOST_CHECK_EQUAL(face1->sentData.size(), 0);
+
+  face3->receiveData(*makeModelData(makeModelName("/pro1/pro1", 1), {10.0, 20.0}, "pro1"), 0);
+  this->advanceClocks(1_ms, 5_ms);
+  BOOST_REQUIRE_EQUAL(face1->sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face1->sentData[0].getName(), makeModelName("/agg0/pro0.pro1", 1));
+
+  ModelDataView sum;
+  BOOST_REQUIRE(sum.parse(face1->sentData[0].getContent()));
+  BOOST_REQUIRE_EQUAL(sum.size(), 2);
+  BOOST_CHECK_EQUAL(sum[0], 11.0);
+  BOOST_CHECK_EQUAL(sum[1], 22.0);
+  ModelContributors contributors;
+  sum.mergeContributorsInto(contributors);
+  BOOST_CHECK_EQUAL(contributors.population(), 2);
+  BOOST_CHECK(contributors.has(ns3::ndn::treeNodeId("pro0")));
+  BOOST_CHECK(contributors.has(ns3::ndn::treeNodeId("pro1")));
+
+  this->advanceClocks(100_ms, 5_s);
+  BOOST_CHECK_EQUAL(forwarder.getPit().size(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(AggregationTimeout, AggregationFixture)
+{
+  installTree();
+
+  face1->receiveInterest(*makeInterest(makeModelName("/agg0/pro0.pro1", 1), false, 1_s), 0);
+  this->advanceClocks(1_ms, 5_ms);
+  face2->receiveData(*makeModelData(makeModelName("/pro0/pro0", 1), {1.0}, "pro0"), 0);
+  this->advanceClocks(100_ms, 900_ms);
+
+  // a retransmission only asks the children which did not answer yet
+  face1->receiveInterest(*makeInterest(makeModelName("/agg0/pro0.pro1", 1), false, 1_s), 0);
+  this->advanceClocks(1_ms, 5_ms);
+  BOOST_CHECK_EQUAL(face2->sentInterests.size(), 1);
+  BOOST_CHECK_EQUAL(face3->sentInterests.size(), 2);
+
+  // pro1 never answers, the request expires unsatisfied
+  this->advanceClocks(100_ms, 2_s);
+  BOOST_CHECK_EQUAL(face1->sentData.size(), 0);
+  BOOST_CHECK_EQUAL(forwarder.getPit().size(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(AggregationChildSharedDownstream, AggregationFixture)
+{
+  auto face4 = addFace();
+  installTree();
+
+  face1->receiveInterest(*makeInterest(makeModelName("/agg0/pro0.pro1", 2)), 0);
+  // another consumer requests the same child model through this forwarder
+  face4->receiveInterest(*makeInterest(makeModelName("/pro0/pro0", 2)), 0);
+  this->advanceClocks(1_ms, 5_ms);
+
+  face2->receiveData(*makeModelData(makeModelName("/pro0/pro0", 2), {1.0}, "pro0"), 0);
+  this->advanceClocks(1_ms, 5_ms);
+  BOOST_REQUIRE_EQUAL(face4->sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face4->sentData[0].getName(), makeModelName("/pro0/pro0", 2));
+  BOOST_CHECK_EQUAL(face1->sentData.size(), 0);
+
+  face3->receiveData(*makeModelData(makeModelName("/pro1/pro1", 2), {2.0}, "pro1"), 0);
+  this->advanceClocks(1_ms, 5_ms);
+  BOOST_REQUIRE_EQUAL(face1->sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face4->sentData.size(), 1);
+}
+
 BOOST_AUTO_TEST_SUITE(ProcessConfig)
 
 BOOST_AUTO_TEST_CASE(DefaultHopLimit)
@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2019,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "table/cs-policy-hashed.hpp"
+
+#include "tests/daemon/table/cs-fixture.hpp"
+
+namespace nfd {
+namespace cs {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(Table)
+BOOST_AUTO_TEST_SUITE(TestCsHashed)
+
+BOOST_AUTO_TEST_CASE(Registration)
+{
+  std::set<std::string> policyNames = Policy::getPolicyNames();
+  BOOST_CHECK_EQUAL(policyNames.count("hashed_lru"), 1);
+  BOOST_CHECK_EQUAL(policyNames.count("hashed_fifo"), 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(EvictLru, CsFixture)
+{
+  cs.setPolicy(make_unique<HashedLruPolicy>());
+  cs.setLimit(3);
+
+  insert(1, "/A");
+  insert(2, "/B");
+  insert(3, "/C");
+  BOOST_CHECK_EQUAL(cs.size(), 3);
+
+  // evict A
+  insert(4, "/D");
+  BOOST_CHECK_EQUAL(cs.size(), 3);
+  startInterest("/A");
+  CHECK_CS_FIND(0);
+
+  // use C then B
+  startInterest("/C");
+  CHECK_CS_FIND(3);
+  startInterest("/B");
+  CHECK_CS_FIND(2);
+
+  // evict D then C
+  insert(5, "/E");
+  BOOST_CHECK_EQUAL(cs.size(), 3);
+  startInterest("/D");
+  CHECK_CS_FIND(0);
+  insert(6, "/F");
+  BOOST_CHECK_EQUAL(cs.size(), 3);
+  startInterest("/C");
+  CHECK_CS_FIND(0);
+
+  // refresh B
+  insert(12, "/B");
+  // evict E
+  insert(7, "/G");
+  BOOST_CHECK_EQUAL(cs.size(), 3);
+  startInterest("/E");
+  CHECK_CS_FIND(0);
+}
+
+BOOST_FIXTURE_TEST_CASE(EvictFifo, CsFixture)
+{
+  cs.setPolicy(make_unique<HashedFifoPolicy>());
+  cs.setLimit(3);
+
+  insert(1, "/A");
+  insert(2, "/B");
+  insert(3, "/C");
+
+  // use A, then evict it anyway
+  startInterest("/A");
+  CHECK_CS_FIND(1);
+  insert(4, "/D");
+  BOOST_CHECK_EQUAL(cs.size(), 3);
+  startInterest("/A");
+  CHECK_CS_FIND(0);
+
+  // refresh B, then evict it anyway
+  insert(12, "/B");
+  insert(5, "/E");
+  BOOST_CHECK_EQUAL(cs.size(), 3);
+  startInterest("/B");
+  CHECK_CS_FIND(0);
+  startInterest("/C");
+  CHECK_CS_FIND(3);
+}
+
+BOOST_FIXTURE_TEST_CASE(Lookups, CsFixture)
+{
+  cs.setPolicy(make_unique<HashedLruPolicy>());
+  cs.setLimit(10);
+
+  insert(1, "/A/B");
+  Name fullName = insert(2, "/A/C");
+  insert(3, "/A/C/D");
+
+  // exact match, through the index
+  startInterest("/A/C");
+  CHECK_CS_FIND(2);
+  startInterest("/A");
+  CHECK_CS_FIND(0);
+  startInterest("/A/C/D/E");
+  CHECK_CS_FIND(0);
+
+  // prefix and full name, through the Table
+  startInterest("/A").setCanBePrefix(true);
+  CHECK_CS_FIND(1);
+  startInterest(fullName);
+  CHECK_CS_FIND(2);
+
+  // MustBeFresh
+  insert(4, "/F", [] (Data& data) { data.setFreshnessPeriod(10_ms); });
+  advanceClocks(11_ms);
+  startInterest("/F").setMustBeFresh(true);
+  CHECK_CS_FIND(0);
+  startInterest("/F");
+  CHECK_CS_FIND(4);
+
+  // erased entries leave the index
+  BOOST_CHECK_EQUAL(erase("/A/C", 10), 2);
+  startInterest("/A/C");
+  CHECK_CS_FIND(0);
+  startInterest("/A/B");
+  CHECK_CS_FIND(1);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCsHashed
+BOOST_AUTO_TEST_SUITE_END() // Table
+
+} // namespace tests
+} // namespace cs
+} // namespace nfd
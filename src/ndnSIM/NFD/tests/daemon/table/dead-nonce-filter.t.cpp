@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "table/dead-nonce-filter.hpp"
+
+#include "tests/test-common.hpp"
+#include "tests/daemon/global-io-fixture.hpp"
+
+namespace nfd {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(Table)
+BOOST_FIXTURE_TEST_SUITE(TestDeadNonceFilter, GlobalIoTimeFixture)
+
+BOOST_AUTO_TEST_CASE(Basic)
+{
+  Name nameA("ndn:/A");
+  Name nameB("ndn:/B");
+  const Interest::Nonce nonce1(0x53b4eaa8);
+  const Interest::Nonce nonce2(0x1f46372b);
+
+  DeadNonceFilter dnl;
+  BOOST_CHECK_EQUAL(dnl.size(), 0);
+  BOOST_CHECK_EQUAL(dnl.has(nameA, nonce1), false);
+
+  dnl.add(nameA, nonce1);
+  BOOST_CHECK_EQUAL(dnl.size(), 1);
+  BOOST_CHECK_EQUAL(dnl.has(nameA, nonce1), true);
+  BOOST_CHECK_EQUAL(dnl.has(nameA, nonce2), false);
+  BOOST_CHECK_EQUAL(dnl.has(nameB, nonce1), false);
+
+  dnl.add(nameA, nonce1);
+  BOOST_CHECK_EQUAL(dnl.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidOptions)
+{
+  DeadNonceFilter::Options options;
+  options.lifetime = 0_ms;
+  BOOST_CHECK_THROW(DeadNonceFilter{options}, std::invalid_argument);
+
+  options = {};
+  options.capacity = 0;
+  BOOST_CHECK_THROW(DeadNonceFilter{options}, std::invalid_argument);
+
+  options = {};
+  options.falsePositiveRate = 0.0;
+  BOOST_CHECK_THROW(DeadNonceFilter{options}, std::invalid_argument);
+
+  options = {};
+  options.falsePositiveRate = 1.0;
+  BOOST_CHECK_THROW(DeadNonceFilter{options}, std::invalid_argument);
+
+  options = {};
+  options.nGenerations = 1;
+  BOOST_CHECK_THROW(DeadNonceFilter{options}, std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(FalsePositiveRate)
+{
+  const Name name("/aggregate/ERYIbM3L");
+
+  for (double falsePositiveRate : {1e-2, 1e-4, 1e-6}) {
+    DeadNonceFilter::Options options;
+    options.capacity = 20000;
+    options.falsePositiveRate = falsePositiveRate;
+    DeadNonceFilter dnl(options);
+
+    // fill every generation to capacity
+    uint32_t nonce = 0;
+    for (size_t g = 0; g < options.nGenerations; ++g) {
+      for (size_t i = 0; i < options.capacity / (options.nGenerations - 1); ++i) {
+        dnl.add(name, ++nonce);
+      }
+      advanceClocks(options.lifetime / (options.nGenerations - 1));
+    }
+
+    const size_t nQueries = 100000;
+    size_t nFalsePositives = 0;
+    for (size_t i = 0; i < nQueries; ++i) {
+      if (dnl.has(name, ++nonce)) {
+        ++nFalsePositives;
+      }
+    }
+    BOOST_TEST_MESSAGE("falsePositiveRate=" << falsePositiveRate << " bits=" << dnl.getFingerprintBits()
+                       << " measured=" << static_cast<double>(nFalsePositives) / nQueries
+                       << " bytes=" << dnl.getTableBytes());
+    BOOST_CHECK_LE(nFalsePositives, falsePositiveRate * nQueries * 2 + 1);
+
+    // bit-packed fingerprints cost a few bytes per nonce kept
+    BOOST_CHECK_LT(dnl.getTableBytes(), options.capacity * options.nGenerations * sizeof(uint64_t));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Lifetime)
+{
+  DeadNonceFilter::Options options;
+  options.lifetime = 200_ms;
+  options.nGenerations = 5;
+  DeadNonceFilter dnl(options);
+  BOOST_CHECK_EQUAL(dnl.getLifetime(), 200_ms);
+
+  Name nameC("ndn:/C");
+  const Interest::Nonce nonceC(0x25390656);
+  advanceClocks(10_ms, 30_ms);
+  dnl.add(nameC, nonceC);
+  BOOST_CHECK_EQUAL(dnl.has(nameC, nonceC), true);
+
+  advanceClocks(10_ms, 200_ms); // kept for at least lifetime
+  BOOST_CHECK_EQUAL(dnl.has(nameC, nonceC), true);
+
+  advanceClocks(10_ms, 50_ms); // gone after lifetime * nGenerations / (nGenerations - 1)
+  BOOST_CHECK_EQUAL(dnl.has(nameC, nonceC), false);
+  BOOST_CHECK_EQUAL(dnl.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Overflow)
+{
+  DeadNonceFilter::Options options;
+  options.capacity = 1000;
+  DeadNonceFilter dnl(options);
+  size_t tableBytes = dnl.getTableBytes();
+
+  // far more nonces than the capacity within one lifetime: older generations are rotated out early
+  const Name name("/aggregate/overflow");
+  uint32_t nonce = 0;
+  for (size_t i = 0; i < options.capacity * 100; ++i) {
+    dnl.add(name, ++nonce);
+    BOOST_REQUIRE_EQUAL(dnl.has(name, nonce), true);
+  }
+  BOOST_CHECK_EQUAL(dnl.getTableBytes(), tableBytes);
+  BOOST_CHECK_LT(dnl.size(), options.capacity * 100);
+  BOOST_CHECK_EQUAL(dnl.has(name, nonce - 1), true);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestDeadNonceFilter
+BOOST_AUTO_TEST_SUITE_END() // Table
+
+} // namespace tests
+} // namespace nfd
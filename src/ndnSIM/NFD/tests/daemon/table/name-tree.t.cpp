@@ -53,6 +53,61 @@ BOOST_AUTO_TEST_CASE(ComputeHash)
   BOOST_CHECK_EQUAL(hashes.size(), 3);
 }
 
+BOOST_AUTO_TEST_CASE(LongHashSequence)
+{
+  Name name;
+  for (size_t i = 0; i < HashSequence::INLINE_CAPACITY * 2; ++i) {
+    name.appendNumber(i);
+  }
+  HashSequence hashes = computeHashes(name);
+  BOOST_REQUIRE_EQUAL(hashes.size(), name.size() + 1);
+  for (size_t i = 0; i <= name.size(); ++i) {
+    BOOST_CHECK_EQUAL(hashes[i], computeHash(name, i));
+  }
+  BOOST_CHECK_THROW(hashes.at(name.size() + 1), std::out_of_range);
+
+  hashes.truncate(3);
+  BOOST_CHECK_EQUAL(hashes.size(), 3);
+  BOOST_CHECK_EQUAL(hashes[2], computeHash(name, 2));
+}
+
+BOOST_AUTO_TEST_CASE(PrefixHashes)
+{
+  PrefixHashCache cache;
+
+  auto checkHashes = [&cache] (const Name& name, size_t prefixLen) {
+    const HashSequence& hashes = cache.get(name, prefixLen);
+    size_t last = std::min(prefixLen, name.size());
+    BOOST_REQUIRE_GE(hashes.size(), last + 1);
+    for (size_t i = 0; i <= last; ++i) {
+      BOOST_CHECK_EQUAL(hashes[i], computeHash(name, i));
+    }
+  };
+
+  checkHashes("/agg/flow/data/1", 4);
+  checkHashes("/agg/flow/data/1", 2); // cached
+  checkHashes("/agg/flow/data/2", 4); // shares three components
+  checkHashes("/agg/flow/data/2/extra", 5);
+  checkHashes("/agg/flow", 2);
+  checkHashes("/other", 1); // shares nothing
+  checkHashes("/", 0);
+  checkHashes("/agg/flowX/data/2", 4); // same length, different component
+
+  Name longName;
+  for (size_t i = 0; i < HashSequence::INLINE_CAPACITY * 2; ++i) {
+    longName.appendNumber(i);
+  }
+  checkHashes(longName, longName.size());
+  checkHashes(longName.getPrefix(5).append("x"), 6);
+
+  // a disabled cache hashes every name in full, and forgets what it cached before
+  cache.enable(false);
+  checkHashes("/agg/flow/data/1", 4);
+  checkHashes("/agg/flow/data/2", 4);
+  cache.enable(true);
+  checkHashes("/agg/flow/data/3", 4);
+}
+
 BOOST_AUTO_TEST_SUITE(Hashtable)
 using name_tree::Hashtable;
 
@@ -208,6 +208,64 @@ BOOST_DATA_TEST_CASE(Lifetime, bdata::make(lifetimes), lifetime)
   BOOST_CHECK_LT(time::abs(expiryFromNow - expectedLifetime), 100_ms);
 }
 
+BOOST_AUTO_TEST_CASE(HighFanIn)
+{
+  const size_t nFaces = (std::max(INLINE_IN_RECORD_CAPACITY, INLINE_OUT_RECORD_CAPACITY) + 1) * 3 + 1;
+  std::vector<shared_ptr<DummyFace>> faces;
+  for (size_t i = 0; i < nFaces; ++i) {
+    faces.push_back(make_shared<DummyFace>());
+  }
+
+  auto interest = makeInterest("/aggregate/A8IvOoGg");
+  Entry entry(*interest);
+
+  // records spill from inline storage into heap chunks, and existing records do not move
+  const InRecord* firstIn = &*entry.insertOrUpdateInRecord(*faces[0], *interest);
+  const OutRecord* firstOut = &*entry.insertOrUpdateOutRecord(*faces[0], *interest);
+  for (size_t i = 1; i < nFaces; ++i) {
+    entry.insertOrUpdateInRecord(*faces[i], *interest);
+    entry.insertOrUpdateOutRecord(*faces[i], *interest);
+  }
+  BOOST_CHECK_EQUAL(entry.getInRecords().size(), nFaces);
+  BOOST_CHECK_EQUAL(entry.getOutRecords().size(), nFaces);
+  BOOST_CHECK(&*entry.getInRecord(*faces[0]) == firstIn);
+  BOOST_CHECK(&*entry.getOutRecord(*faces[0]) == firstOut);
+  BOOST_CHECK_EQUAL(std::distance(entry.in_begin(), entry.in_end()), nFaces);
+
+  // updating an existing record does not add another one
+  entry.insertOrUpdateInRecord(*faces[nFaces - 1], *interest);
+  BOOST_CHECK_EQUAL(entry.getInRecords().size(), nFaces);
+
+  // delete every other record, including whole heap chunks
+  for (size_t i = 1; i < nFaces; i += 2) {
+    entry.deleteInRecord(*faces[i]);
+    entry.deleteOutRecord(*faces[i]);
+  }
+  BOOST_CHECK_EQUAL(entry.getInRecords().size(), nFaces / 2 + 1);
+  BOOST_CHECK_EQUAL(entry.getOutRecords().size(), nFaces / 2 + 1);
+  for (size_t i = 0; i < nFaces; ++i) {
+    BOOST_CHECK_EQUAL(entry.getInRecord(*faces[i]) == entry.in_end(), i % 2 == 1);
+    BOOST_CHECK_EQUAL(entry.getOutRecord(*faces[i]) == entry.out_end(), i % 2 == 1);
+  }
+  BOOST_CHECK(&*entry.getInRecord(*faces[0]) == firstIn);
+
+  // freed slots are reused
+  for (size_t i = 1; i < nFaces; i += 2) {
+    entry.insertOrUpdateInRecord(*faces[i], *interest);
+  }
+  BOOST_CHECK_EQUAL(entry.getInRecords().size(), nFaces);
+  std::set<const Face*> inFaces;
+  for (const InRecord& inRecord : entry.getInRecords()) {
+    inFaces.insert(&inRecord.getFace());
+  }
+  BOOST_CHECK_EQUAL(inFaces.size(), nFaces);
+
+  entry.clearInRecords();
+  BOOST_CHECK(!entry.hasInRecords());
+  BOOST_CHECK(entry.in_begin() == entry.in_end());
+  BOOST_CHECK(entry.hasOutRecords());
+}
+
 BOOST_AUTO_TEST_CASE(OutRecordNack)
 {
   auto face1 = make_shared<DummyFace>();
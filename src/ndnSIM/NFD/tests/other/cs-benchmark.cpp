@@ -212,5 +212,35 @@ BOOST_FIXTURE_TEST_CASE(FindCanBePrefixHit, CsBenchmarkFixture)
   std::cout << "find(CanBePrefix-hit) " << (N_INTERESTS * N_CHILDREN * REPEAT) << ": " << d << std::endl;
 }
 
+// find miss, insert, then find hit, on a large CS for each replacement policy
+BOOST_FIXTURE_TEST_CASE(LargeCsPolicies, CsBenchmarkFixture)
+{
+  constexpr size_t LARGE_CAPACITY = 1000000;
+  constexpr size_t N_WORKLOAD = LARGE_CAPACITY * 2;
+
+  auto interestWorkload = makeInterestWorkload(N_WORKLOAD);
+  auto dataWorkload = makeDataWorkload(N_WORKLOAD);
+
+  for (const char* policyName : {"lru", "priority_fifo", "hashed_lru", "hashed_fifo"}) {
+    Cs largeCs(LARGE_CAPACITY);
+    largeCs.setPolicy(cs::Policy::create(policyName));
+
+    auto findIn = [&largeCs] (const Interest& interest) {
+      largeCs.find(interest, [] (auto&&...) {}, [] (auto&&...) {});
+    };
+
+    time::microseconds d = timedRun([&] {
+      for (size_t i = 0; i < N_WORKLOAD; ++i) {
+        findIn(*interestWorkload[i]);
+        largeCs.insert(*dataWorkload[i], false);
+        findIn(*interestWorkload[i]);
+      }
+    });
+
+    std::cout << policyName << " find(miss)-insert-find(hit) " << N_WORKLOAD
+              << " at " << LARGE_CAPACITY << " entries: " << d << std::endl;
+  }
+}
+
 } // namespace tests
 } // namespace nfd
@@ -24,6 +24,7 @@
  */
 
 #include "benchmark-helpers.hpp"
+#include "face/null-face.hpp"
 #include "table/fib.hpp"
 #include "table/pit.hpp"
 
@@ -33,6 +34,11 @@
 #include <valgrind/callgrind.h>
 #endif
 
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define NFD_BENCHMARK_HAVE_MALLINFO2
+#endif
+
 namespace nfd {
 namespace tests {
 
@@ -149,5 +155,132 @@ BOOST_FIXTURE_TEST_CASE(SimpleExchanges, PitFibBenchmarkFixture)
   std::cout << time::duration_cast<time::microseconds>(t2 - t1) << std::endl;
 }
 
+// This test case models the same exchanges with long names, as used by aggregation flows.
+// The exchanges run once with every name tree lookup hashing the name with computeHashes(),
+// then once with the prefix hash cache. Only lookups by name hash: PIT insertion and Data match.
+// The FIB match starts from the PIT entry and hashes nothing.
+BOOST_FIXTURE_TEST_CASE(LongNameExchanges, PitFibBenchmarkFixture)
+{
+  const size_t nRoundTrip = 200000;
+  const size_t replyGap = 20000;
+  const size_t nFibEntries = 2000;
+  const size_t fibPrefixLength = 3;
+  const size_t interestNameLength = 12;
+  const size_t dataNameLength = 12;
+
+  generatePacketsAndPopulateFib(nRoundTrip, nFibEntries, fibPrefixLength,
+                                interestNameLength, dataNameLength);
+
+  auto runExchanges = [&] {
+    auto t1 = time::steady_clock::now();
+    for (size_t i = 0; i < nRoundTrip + replyGap; ++i) {
+      if (i < nRoundTrip) {
+        auto pitEntry = m_pit.insert(*interests[i]).first;
+        m_fib.findLongestPrefixMatch(*pitEntry);
+      }
+      if (i >= replyGap) {
+        auto matches = m_pit.findAllDataMatches(*data[i - replyGap]);
+        for (const auto& pitEntry : matches) {
+          m_pit.erase(pitEntry.get());
+        }
+      }
+    }
+    auto t2 = time::steady_clock::now();
+    BOOST_CHECK_EQUAL(m_pit.size(), 0);
+    return time::duration_cast<time::microseconds>(t2 - t1);
+  };
+
+  // warm up, so that neither measured run pays for growing the name tree hashtable
+  runExchanges();
+
+  m_nameTree.m_hashCache.enable(false);
+  auto withoutCache = runExchanges();
+  m_nameTree.m_hashCache.enable(true);
+  auto withCache = runExchanges();
+
+  std::cout << "exchanges hashing per lookup " << withoutCache
+            << ", with prefix hash cache " << withCache << std::endl;
+}
+
+/** \return bytes of heap in use, including allocator overhead, or 0 if the allocator can't tell
+ */
+static size_t
+getHeapInUse()
+{
+#ifdef NFD_BENCHMARK_HAVE_MALLINFO2
+  return mallinfo2().uordblks;
+#else
+  return 0;
+#endif
+}
+
+// This test case models the PIT of an aggregator with a large number of pending Interests, each
+// aggregated from several downstreams and forwarded to one upstream. Entries are inserted and erased
+// in a sliding window, and the insertion rate and heap used per pending Interest are reported.
+// The record layout is chosen at build time: run it once more built with
+// -DNFD_PIT_INLINE_IN_RECORDS=0 -DNFD_PIT_INLINE_OUT_RECORDS=0 to measure std::list records.
+BOOST_FIXTURE_TEST_CASE(PitChurn, PitFibBenchmarkFixture)
+{
+  // number of pending Interests
+  const size_t nPending = 1000000;
+  // number of inserted Interests, the oldest pending Interest is erased after each insertion
+  const size_t nInserts = 3 * nPending;
+  // number of downstream faces of each PIT entry
+  const size_t fanIn = 3;
+
+  std::vector<shared_ptr<Face>> faces;
+  for (size_t i = 0; i <= fanIn; ++i) {
+    faces.push_back(face::makeNullFace());
+  }
+  Face& upstream = *faces[fanIn];
+
+  interests.reserve(nInserts);
+  for (size_t i = 0; i < nInserts; ++i) {
+    Name name("/aggregate/churn");
+    name.appendNumber(i);
+    interests.push_back(make_shared<Interest>(name));
+    interests.back()->wireEncode();
+  }
+  std::vector<shared_ptr<pit::Entry>> pending(nPending);
+  size_t heapBefore = getHeapInUse();
+
+#ifdef NFD_HAVE_VALGRIND
+  CALLGRIND_START_INSTRUMENTATION;
+#endif
+
+  auto t1 = time::steady_clock::now();
+
+  for (size_t i = 0; i < nInserts; ++i) {
+    shared_ptr<pit::Entry>& pitEntry = pending[i % nPending];
+    if (pitEntry != nullptr) {
+      m_pit.erase(pitEntry.get());
+    }
+    pitEntry = m_pit.insert(*interests[i]).first;
+    for (size_t j = 0; j < fanIn; ++j) {
+      pitEntry->insertOrUpdateInRecord(*faces[j], *interests[i]);
+    }
+    pitEntry->insertOrUpdateOutRecord(upstream, *interests[i]);
+  }
+
+  auto t2 = time::steady_clock::now();
+
+#ifdef NFD_HAVE_VALGRIND
+  CALLGRIND_STOP_INSTRUMENTATION;
+#endif
+
+  size_t heapAfter = getHeapInUse();
+
+  std::cout << "records inline: " << pit::INLINE_IN_RECORD_CAPACITY << " in, "
+            << pit::INLINE_OUT_RECORD_CAPACITY << " out (0 is std::list)" << std::endl;
+  auto d = time::duration_cast<time::microseconds>(t2 - t1);
+  std::cout << "churn " << nInserts << " at " << m_pit.size() << " pending: " << d
+            << ", " << static_cast<uint64_t>(nInserts * 1e6 / d.count()) << " inserts/s" << std::endl;
+  // PIT entries with their records, name tree entries and the name tree hash table
+  if (heapAfter > heapBefore) {
+    std::cout << "heap per pending Interest " << (heapAfter - heapBefore) / nPending << " bytes, "
+              << sizeof(pit::Entry) << " of which pit::Entry" << std::endl;
+  }
+}
+
 } // namespace tests
 } // namespace nfd
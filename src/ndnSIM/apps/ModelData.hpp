@@ -1,18 +1,25 @@
 #pragma once
 
-#include "ns3/log.h"
-#include "ns3/simulator.h"
-#include "ns3/callback.h"
+#include "ns3/ndnSIM/utils/model-data-codec.hpp"
+
 #include <vector>
+#include <string>
 #include <cstdint>
 
 struct ModelData {
     std::vector<double> parameters; // Model parameters
     double qsf;
     std::vector<std::string> congestedNodes; // Meta data
+    ModelContributors contributors; // Meta data
 
     ModelData();
+    explicit ModelData(size_t parameterSize);
 };
 
+/**
+ * Same as encodeModelDataContent() of the codec, for the parameters and meta data of a ModelData
+ */
+::ndn::Block encodeModelDataContent(const ModelData& modelData, PayloadEncoding encoding = PAYLOAD_FP64, size_t topK = 0);
+
 void serializeModelData(const ModelData& modelData, std::vector<uint8_t>& buffer);
-bool deserializeModelData(const std::vector<uint8_t>& buffer, ModelData& modelData);
\ No newline at end of file
+bool deserializeModelData(const std::vector<uint8_t>& buffer, ModelData& modelData);
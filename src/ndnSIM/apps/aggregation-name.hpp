@@ -0,0 +1,117 @@
+#ifndef AGGREGATION_NAME_HPP
+#define AGGREGATION_NAME_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "flow-state.hpp"
+#include "model-segmentation.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * Packet type of an aggregation name, given by the component before iteration and segment
+ */
+enum class AggregationPacketType : uint8_t {
+    UNKNOWN,
+    DATA,           // "data", model updates
+    INITIALIZATION, // "initialization", tree construction messages
+};
+
+/**
+ * Typed fields of /<child>/<leaves>/data/<iteration>[/<segment>] or /<node>/initialization/<seq>
+ */
+struct AggregationName {
+    AggregationPacketType type = AggregationPacketType::UNKNOWN;
+    uint32_t flowId = FlowTable::INVALID; // Flow of the first component, INVALID if it isn't a child
+    uint32_t seq = 0; // Unit of a data name, 0 for other types
+};
+
+/**
+ * Parses incoming aggregation names and builds outgoing ones
+ *
+ * A name is classified once per packet by comparing component bytes in place and looking the flow up
+ * with a string_view key, so no string is built on the packet path. Outgoing names are copies of a
+ * per-flow /<child>/<leaves>/data prefix encoded once, with only the unit appended.
+ */
+class AggregationNameCodec {
+public:
+    /**
+     * Build the interest name prefix /<child>/<leaves>/data of a flow
+     */
+    static Name
+    MakeDataPrefix(const std::string& child, const std::string& leaves)
+    {
+        Name prefix;
+        prefix.append(child).append(leaves).append(DATA_TYPE);
+        prefix.wireEncode();
+        return prefix;
+    }
+
+    /**
+     * Interest name of a unit, from a prefix built by MakeDataPrefix()
+     */
+    static Name
+    MakeDataName(const Name& prefix, uint32_t unit, const ModelSegmentation& segmentation)
+    {
+        Name name(prefix);
+        segmentation.AppendUnit(name, unit);
+        return name;
+    }
+
+    /**
+     * Classify an interest/data name, no allocation is made
+     */
+    static AggregationName
+    Parse(const Name& name, const FlowTable& flows, const ModelSegmentation& segmentation)
+    {
+        AggregationName parsed;
+        // Shortest names are /<node>/initialization/<seq>
+        if (name.size() < 3) {
+            return parsed;
+        }
+
+        parsed.type = ParseType(ModelSegmentation::GetTypeComponent(name));
+        parsed.flowId = flows.Find(name);
+        if (parsed.type == AggregationPacketType::DATA) {
+            parsed.seq = segmentation.ParseUnit(name);
+        }
+        return parsed;
+    }
+
+private:
+    static AggregationPacketType
+    ParseType(const name::Component& component)
+    {
+        if (!component.isGeneric()) {
+            return AggregationPacketType::UNKNOWN;
+        }
+        std::string_view type = ToView(component);
+        if (type == DATA_TYPE) {
+            return AggregationPacketType::DATA;
+        }
+        if (type == INITIALIZATION_TYPE) {
+            return AggregationPacketType::INITIALIZATION;
+        }
+        return AggregationPacketType::UNKNOWN;
+    }
+
+    static std::string_view
+    ToView(const name::Component& component)
+    {
+        return std::string_view(reinterpret_cast<const char*>(component.value()), component.value_size());
+    }
+
+private:
+    static constexpr const char* DATA_TYPE = "data";
+    static constexpr const char* INITIALIZATION_TYPE = "initialization";
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // AGGREGATION_NAME_HPP
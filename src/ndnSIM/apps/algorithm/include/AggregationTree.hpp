@@ -1,3 +1,6 @@
+#ifndef AGGREGATION_TREE_H
+#define AGGREGATION_TREE_H
+
 #include <iostream>
 #include <vector>
 #include <cmath> // For ceil
@@ -14,6 +17,8 @@
 #include <set>
 #include <algorithm>
 
+#include "LinkCostMatrix.hpp"
+
 class AggregationTree {
 public:
     AggregationTree(std::string file);
@@ -28,11 +33,10 @@ public:
     // Prints both local (intra-cluster) costs and the global (aggregate) cost
 // for a given clustering result. 
 // newCluster: Vector of clusters, where each cluster is a vector of node names.
-// linkCostMatrix: A map of node name to another map representing 
-//                 distances between nodes.
+// linkCostMatrix: Shortest-path costs between nodes.
     void PrintClusterCosts(
     const std::vector<std::vector<std::string>>& newCluster,
-    const std::map<std::string, std::map<std::string, int>>& linkCostMatrix);
+    const LinkCostMatrix& linkCostMatrix);
     void writeLinkCostsToFile(
     const std::string& filename);
 
@@ -45,5 +49,7 @@ public:
     std::string globalClient = "con0";
     std::map<std::string, std::vector<std::string>> aggregationAllocation;
     std::vector<std::vector<std::string>> noCHTree;
-    std::map<std::string, std::map<std::string, int>> linkCostMatrix;
-};
\ No newline at end of file
+    LinkCostMatrix linkCostMatrix; // Shared by reference with the clustering algorithms
+};
+
+#endif // AGGREGATION_TREE_H
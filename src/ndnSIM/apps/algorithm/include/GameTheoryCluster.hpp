@@ -5,10 +5,12 @@
 #include <map>
 #include <string>
 
+#include "LinkCostMatrix.hpp"
+
 class GameTheoryCluster {
 public:
     GameTheoryCluster(const std::vector<std::string>& dataPointNames,
-                      const std::map<std::string, std::map<std::string, int>>& linkCostMatrix,
+                      const LinkCostMatrix& linkCostMatrix,
                       int C);
 
     // Main run function: repeated best response
@@ -40,7 +42,7 @@ private:
 
 private:
     std::vector<std::string> dataPointNames_;
-    std::map<std::string, std::map<std::string, int>> linkCostMatrix_;
+    const LinkCostMatrix& linkCostMatrix_;
     int C_ = 0;     // cluster size
     int N_ = 0;     // number of data points
     int numClusters_ = 0;
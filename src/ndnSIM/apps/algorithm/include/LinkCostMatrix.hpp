@@ -0,0 +1,73 @@
+#ifndef LINK_COST_MATRIX_H
+#define LINK_COST_MATRIX_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Dense matrix of shortest-path link costs between the nodes taking part in aggregation (producers,
+// aggregators, consumers). It's computed once per topology and shared by reference by the tree
+// construction and all clustering algorithms.
+class LinkCostMatrix {
+public:
+    LinkCostMatrix() = default;
+
+    // Number of nodes in the matrix.
+    int size() const { return static_cast<int>(names_.size()); }
+
+    // Node names, sorted, a node's index is its position here.
+    const std::vector<std::string>& names() const { return names_; }
+
+    // Index of a node, -1 if it's not in the matrix.
+    int index(const std::string& name) const;
+
+    // Cost between two indices, -1 if there's no route.
+    int cost(int from, int to) const { return costs_[static_cast<size_t>(from) * names_.size() + to]; }
+
+    // Cost between two nodes, -1 if there's no route or a node is unknown.
+    int cost(const std::string& from, const std::string& to) const;
+
+private:
+    friend class LinkCostGraph;
+
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, int> index_;
+    std::vector<int> costs_; // Row-major, size() x size()
+};
+
+// Undirected weighted topology graph with integer node ids and CSR adjacency.
+class LinkCostGraph {
+public:
+    // Read routers and links from a topology file ("router" and "link" sections).
+    // Returns false if the file can't be opened.
+    bool load(const std::string& filename);
+
+    int nodeCount() const { return static_cast<int>(names_.size()); }
+
+    // Id of a node, -1 if unknown.
+    int id(const std::string& name) const;
+
+    // Drop every link between two nodes, e.g. after a link failure.
+    // Returns false if there's no such link.
+    bool removeLink(const std::string& a, const std::string& b);
+
+    // Single-source Dijkstra, dist[v] is INT_MAX if v is unreachable.
+    void shortestPaths(int source, std::vector<int>& dist) const;
+
+    // One Dijkstra per matrix node, sources are spread over threads (-1: one per core).
+    // Nodes which aren't in the graph are only reachable from themselves.
+    LinkCostMatrix allPairs(const std::vector<std::string>& nodes, int threads = -1) const;
+
+private:
+    int addNode(const std::string& name);
+
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, int> ids_;
+
+    // CSR: neighbours of v are targets_[offsets_[v] .. offsets_[v + 1]), with the same weights_
+    std::vector<int> offsets_;
+    std::vector<int> targets_;
+    std::vector<int> weights_;
+};
+
+#endif // LINK_COST_MATRIX_H
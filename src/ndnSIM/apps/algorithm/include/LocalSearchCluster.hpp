@@ -5,12 +5,14 @@
 #include <map>
 #include <string>
 
+#include "LinkCostMatrix.hpp"
+
 class LocalSearchCluster {
 public:
     // Constructor: Accepts input data (node names and link cost matrix) and parameter C.
     // C represents the maximum allowed size of each cluster.
     LocalSearchCluster(const std::vector<std::string>& dataPointNames,
-                       const std::map<std::string, std::map<std::string, int>>& linkCostMatrix,
+                       const LinkCostMatrix& linkCostMatrix,
                        int C);
 
     // Main entry point for clustering.
@@ -76,7 +78,7 @@ private:
 private:
     // Input data: node names and the link cost matrix.
     std::vector<std::string> dataPointNames_;
-    std::map<std::string, std::map<std::string, int>> linkCostMatrix_;
+    const LinkCostMatrix& linkCostMatrix_;
 
     // User-defined parameter: maximum size of each cluster.
     int C_ = 0;
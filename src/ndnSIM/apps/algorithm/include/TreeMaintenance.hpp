@@ -0,0 +1,87 @@
+#ifndef TREE_MAINTENANCE_H
+#define TREE_MAINTENANCE_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "AggregationTree.hpp"
+#include "LinkCostMatrix.hpp"
+
+// Aggregation tree as parent -> children, the consumer is the root.
+using TreeMap = std::map<std::string, std::vector<std::string>>;
+
+// Outcome of a repair, only the parents listed here need to learn their new assignment.
+struct TreeDiff {
+    // Parents whose children, or the leaves below one of their children, changed, with their new children.
+    TreeMap changed;
+
+    // Parents which aren't part of the tree anymore.
+    std::vector<std::string> removed;
+
+    // Producers which aren't aggregated anymore.
+    std::vector<std::string> leftProducers;
+
+    bool empty() const { return changed.empty() && removed.empty(); }
+};
+
+// Keeps a running aggregation tree valid under membership and topology changes. A repair only
+// re-clusters the subtree below the parent of the failed node or link, with the same clustering and
+// CH selection as the initial construction, and reports the minimal set of changed assignments.
+class TreeMaintenance {
+public:
+    // file: topology file the tree was built from. root: consumer. C: max number of children per parent.
+    TreeMaintenance(const std::string& file, const std::string& root, int C, const TreeMap& tree);
+
+    const TreeMap& tree() const { return tree_; }
+
+    // A producer left, it's pruned together with the parents it leaves without children.
+    TreeDiff removeProducer(const std::string& producer);
+
+    // An aggregator failed or is congested. It's never picked again, its children are re-clustered
+    // together with its siblings below its parent.
+    TreeDiff removeAggregator(const std::string& aggregator);
+
+    // A link failed. Costs are recomputed without it, every child whose cost to its parent changed
+    // is dissolved into its own children and the parent's subtree re-clustered.
+    TreeDiff removeLink(const std::string& a, const std::string& b);
+
+private:
+    // Attach members below parent, grouped under new cluster heads until the parent's fan-in fits.
+    void rebuildSubtree(const std::string& parent, const std::vector<std::string>& members);
+
+    // Cluster members under spare aggregators, level by level, until at most fanIn nodes are left.
+    // Returns the nodes to attach to parent.
+    std::vector<std::string> groupBelow(const std::string& parent, std::vector<std::string> members, size_t fanIn);
+
+    // Max number of children of a parent.
+    size_t fanInOf(const std::string& parent) const;
+
+    // Remove parents left without children, walking up towards the root.
+    void pruneEmpty(std::string parent);
+
+    // Aggregators which are reachable, not excluded and not part of the tree.
+    std::vector<std::string> spareAggregators() const;
+
+    // Parent of a node, empty if the node isn't in the tree.
+    std::string parentOf(const std::string& node) const;
+
+    bool isReachable(const std::string& a, const std::string& b) const;
+
+    // Every parent whose assignment (child -> leaves below it) differs from before.
+    TreeDiff diff(const TreeMap& before) const;
+
+    static std::map<std::string, std::set<std::string>> assignmentOf(const std::string& parent, const TreeMap& tree);
+    static void collectLeaves(const std::string& node, const TreeMap& tree, std::set<std::string>& leaves);
+
+private:
+    AggregationTree builder_; // Link costs and CH selection of the initial construction
+    LinkCostGraph graph_; // Topology, links are removed as they fail
+    std::string root_;
+    int C_ = 0;
+    TreeMap tree_;
+    std::set<std::string> excluded_; // Nodes which left or failed
+};
+
+#endif // TREE_MAINTENANCE_H
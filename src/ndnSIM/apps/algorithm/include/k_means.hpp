@@ -6,6 +6,8 @@
 #include <map>
 #include <string>
 
+#include "LinkCostMatrix.hpp"
+
 class KMeans {
 public:
     enum InitMethod { kForgy, kRandomPartition };
@@ -13,17 +15,17 @@ public:
            InitMethod init_method, unsigned int seed);
     const std::vector<std::vector<std::string>>& cluster_centers() const;
     const std::vector<int>& assignments() const;
-    double GetSumSquaredError(const std::map<std::string, std::map<std::string, int>> linkCostMatrix) const;
+    double GetSumSquaredError(const LinkCostMatrix& linkCostMatrix) const;
     std::vector<std::vector<std::string>> clusters;
 
 protected:
     void Init();
     int CalDistance(const std::string& data1,
                     const std::string& data2,
-                    std::map<std::string, std::map<std::string, int>> linkCostMatrix) const;
+                    const LinkCostMatrix& linkCostMatrix) const;
     int CalDistance(const std::string& data1,
                     const std::vector<std::string>& clu,
-                    std::map<std::string, std::map<std::string, int>> linkCostMatrix) const;
+                    const LinkCostMatrix& linkCostMatrix) const;
     void UpdateClusterCenter();
     void InitWithRandomCenter();
     void InitWithRandomAssignment();
@@ -11,7 +11,7 @@
 class RegularizedKMeans : public KMeans {
 public:
     RegularizedKMeans(const std::vector<std::string>& data, int k,
-                      std::map<std::string, std::map<std::string, int>> costMatrix,
+                      const LinkCostMatrix& costMatrix,
                       InitMethod init_method = KMeans::kForgy,
                       bool warm_start = true, int n_jobs = 1,
                       unsigned int seed = std::random_device{}());
@@ -25,7 +25,7 @@ protected:
     const bool warm_start_;
     const int n_jobs_;
     std::vector<std::vector<double>> costs_;
-    std::map<std::string, std::map<std::string, int>> linkCostMatrix;
+    const LinkCostMatrix& linkCostMatrix; // Owned by the caller, read-only so safe to share across jobs
 };
 
 #endif  // REGULARIZED_K_MEANS_H_
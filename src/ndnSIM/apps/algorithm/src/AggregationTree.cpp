@@ -45,11 +45,22 @@ std::string AggregationTree::findCH(std::vector<std::string> clusterNodes, std::
     // Initiate a large enough cost
     int leastCost = 1000;
 
+    // Resolve names to matrix indices once
+    std::vector<int> nodeIds;
+    for (const auto& node : clusterNodes) {
+        nodeIds.push_back(linkCostMatrix.index(node));
+    }
+    int clientId = linkCostMatrix.index(client);
+    auto cost = [this] (int from, int to) {
+        return from < 0 || to < 0 ? 0 : linkCostMatrix.cost(from, to);
+    };
+
     for (const auto& headCandidate : clusterHeadCandidate) {
+        int candidateId = linkCostMatrix.index(headCandidate);
         bool canBeCH = true;
 
-        for (const auto& node : clusterNodes) {
-            if (linkCostMatrix[node][client] < linkCostMatrix[node][headCandidate]) {
+        for (int node : nodeIds) {
+            if (cost(node, clientId) < cost(node, candidateId)) {
                 canBeCH = false;
                 break;
             }
@@ -58,8 +69,8 @@ std::string AggregationTree::findCH(std::vector<std::string> clusterNodes, std::
         // This candidate is closer to client
         long long totalCost = 0;
         if (canBeCH) {
-            for (const auto& node : clusterNodes) {
-                totalCost += linkCostMatrix[node][headCandidate];
+            for (int node : nodeIds) {
+                totalCost += cost(node, candidateId);
             }
             int averageCost = static_cast<int>(totalCost / clusterNodes.size());
 
@@ -194,7 +205,7 @@ bool AggregationTree::aggregationTreeConstruction(std::vector<std::string> dataP
             return true;
         }
     } else {
-        aggregationTreeConstruction(newDataPoints, C);
+        return aggregationTreeConstruction(newDataPoints, C);
     }
 }
 
@@ -204,7 +215,7 @@ bool AggregationTree::aggregationTreeConstruction(std::vector<std::string> dataP
 void 
 AggregationTree::PrintClusterCosts(
     const std::vector<std::vector<std::string>>& newCluster,
-    const std::map<std::string, std::map<std::string, int>>& linkCostMatrix
+    const LinkCostMatrix& linkCostMatrix
 ) {
     int globalCost = 0;
 
@@ -220,10 +231,11 @@ AggregationTree::PrintClusterCosts(
                 const std::string& nodeB = cluster[j];
 
                 // If distance is present, add it
-                if (linkCostMatrix.find(nodeA) != linkCostMatrix.end() 
-                    && linkCostMatrix.at(nodeA).find(nodeB) != linkCostMatrix.at(nodeA).end()) 
+                int indexA = linkCostMatrix.index(nodeA);
+                int indexB = linkCostMatrix.index(nodeB);
+                if (indexA >= 0 && indexB >= 0)
                 {
-                    localCost += linkCostMatrix.at(nodeA).at(nodeB);
+                    localCost += linkCostMatrix.cost(indexA, indexB);
                 } 
                 else {
                     // Optional: handle missing distance (currently assumed 0)
@@ -245,7 +257,7 @@ AggregationTree::PrintClusterCosts(
     std::cout << "Global cost (sum of local costs): " << globalCost << std::endl;
 }
 
-/// This function takes in a link cost matrix (map of maps) and a filename,
+/// This function takes the link cost matrix and a filename,
 /// then writes each (source, target, cost) triplet to the specified file in CSV format.
 /// Only the pairs where the target node name starts with "pro" are processed,
 /// and for each source, the output is sorted so that the smallest distance appears first.
@@ -262,17 +274,18 @@ AggregationTree::writeLinkCostsToFile(const std::string& filename)
     // Write header row (optional).
     outFile << "Source,Target,Cost\n";
 
-    // Iterate over each source node in the link cost matrix.
-    for (const auto& sourcePair : linkCostMatrix) {
-        const std::string& source = sourcePair.first;
+    // Iterate over each source node in the link cost matrix (names are sorted).
+    const std::vector<std::string>& names = linkCostMatrix.names();
+    for (int i = 0; i < linkCostMatrix.size(); ++i) {
+        const std::string& source = names[i];
 
         // Create a vector to hold only the target nodes that start with "pro".
         std::vector<std::pair<std::string, int>> proTargets;
-        for (const auto& targetPair : sourcePair.second) {
-            const std::string& target = targetPair.first;
+        for (int j = 0; j < linkCostMatrix.size(); ++j) {
+            const std::string& target = names[j];
             // Filter: include only targets that start with "pro"
             if (target.compare(0, 3, "pro") == 0) {
-                proTargets.emplace_back(target, targetPair.second);
+                proTargets.emplace_back(target, linkCostMatrix.cost(i, j));
             }
         }
 
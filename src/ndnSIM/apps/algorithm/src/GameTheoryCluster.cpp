@@ -7,7 +7,7 @@
 #include <limits>
 
 GameTheoryCluster::GameTheoryCluster(const std::vector<std::string>& dataPointNames,
-                                     const std::map<std::string, std::map<std::string, int>>& linkCostMatrix,
+                                     const LinkCostMatrix& linkCostMatrix,
                                      int C)
     : dataPointNames_(dataPointNames),
       linkCostMatrix_(linkCostMatrix),
@@ -29,21 +29,20 @@ GameTheoryCluster::GameTheoryCluster(const std::vector<std::string>& dataPointNa
 // 1. Build distance matrix
 //------------------------------------------------------------------------------
 std::vector<std::vector<int>> GameTheoryCluster::buildDistanceMatrix() {
-    // Map from nodeName to index
-    std::map<std::string, int> indexMap;
+    // Matrix row of each data point
+    std::vector<int> ids(N_);
     for (int i = 0; i < N_; ++i) {
-        indexMap[dataPointNames_[i]] = i;
+        ids[i] = linkCostMatrix_.index(dataPointNames_[i]);
     }
 
-    // Build NxN matrix
+    // Build NxN matrix, unknown or unreachable pairs stay 0
     std::vector<std::vector<int>> dist(N_, std::vector<int>(N_, 0));
 
-    for (const auto& [from, costs] : linkCostMatrix_) {
-        int i = indexMap[from];
-        for (const auto& [to, cost] : costs) {
-            int j = indexMap[to];
-            dist[i][j] = cost;
-            dist[j][i] = cost;  // symmetrical
+    for (int i = 0; i < N_; ++i) {
+        if (ids[i] < 0) continue;
+        for (int j = 0; j < N_; ++j) {
+            if (ids[j] < 0) continue;
+            dist[i][j] = std::max(linkCostMatrix_.cost(ids[i], ids[j]), 0);
         }
     }
     return dist;
@@ -0,0 +1,218 @@
+#include "../include/LinkCostMatrix.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+int LinkCostMatrix::index(const std::string& name) const {
+    auto it = index_.find(name);
+    return it == index_.end() ? -1 : it->second;
+}
+
+int LinkCostMatrix::cost(const std::string& from, const std::string& to) const {
+    int i = index(from);
+    int j = index(to);
+    if (i < 0 || j < 0)
+        return -1;
+    return cost(i, j);
+}
+
+
+
+int LinkCostGraph::addNode(const std::string& name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end())
+        return it->second;
+
+    int id = static_cast<int>(names_.size());
+    names_.push_back(name);
+    ids_.emplace(name, id);
+    return id;
+}
+
+int LinkCostGraph::id(const std::string& name) const {
+    auto it = ids_.find(name);
+    return it == ids_.end() ? -1 : it->second;
+}
+
+bool LinkCostGraph::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return false;
+    }
+
+    names_.clear();
+    ids_.clear();
+
+    // Edge list first, turned into CSR once every node is known
+    std::vector<std::pair<int, int>> ends;
+    std::vector<int> costs;
+    std::string line;
+    bool routerSection = false;
+    bool linkSection = false;
+
+    while (std::getline(file, line)) {
+        line.erase(0, line.find_first_not_of(" \t\n\r\f\v")); // Trim leading whitespace
+        if (line == "router") {
+            routerSection = true;
+            continue;
+        } else if (line == "link") {
+            routerSection = false;
+            linkSection = true;
+            continue;
+        }
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream iss(line);
+        if (routerSection) {
+            std::string nodeName;
+            iss >> nodeName;
+            addNode(nodeName);
+        } else if (linkSection) {
+            std::string node1, node2;
+            std::string speed; // Placeholder for speed
+            int cost = 0;
+            iss >> node1 >> node2 >> speed >> cost;
+            ends.emplace_back(addNode(node1), addNode(node2));
+            costs.push_back(cost);
+        }
+    }
+
+    int n = nodeCount();
+    offsets_.assign(n + 1, 0);
+    for (const auto& [a, b] : ends) {
+        offsets_[a + 1]++;
+        offsets_[b + 1]++;
+    }
+    for (int v = 0; v < n; ++v)
+        offsets_[v + 1] += offsets_[v];
+
+    targets_.resize(offsets_[n]);
+    weights_.resize(offsets_[n]);
+    std::vector<int> next(offsets_.begin(), offsets_.end() - 1);
+    for (size_t e = 0; e < ends.size(); ++e) {
+        auto [a, b] = ends[e];
+        targets_[next[a]] = b;
+        weights_[next[a]++] = costs[e];
+        targets_[next[b]] = a;
+        weights_[next[b]++] = costs[e];
+    }
+    return true;
+}
+
+bool LinkCostGraph::removeLink(const std::string& a, const std::string& b) {
+    int u = id(a);
+    int v = id(b);
+    if (u < 0 || v < 0)
+        return false;
+
+    // Compact the CSR arrays in place, both directions of the link go
+    bool found = false;
+    int kept = 0;
+    int n = nodeCount();
+    int begin = offsets_[0];
+    for (int x = 0; x < n; ++x) {
+        int end = offsets_[x + 1];
+        for (int e = begin; e < end; ++e) {
+            int y = targets_[e];
+            if ((x == u && y == v) || (x == v && y == u)) {
+                found = true;
+                continue;
+            }
+            targets_[kept] = y;
+            weights_[kept] = weights_[e];
+            ++kept;
+        }
+        begin = end;
+        offsets_[x + 1] = kept;
+    }
+    targets_.resize(kept);
+    weights_.resize(kept);
+    return found;
+}
+
+void LinkCostGraph::shortestPaths(int source, std::vector<int>& dist) const {
+    dist.assign(nodeCount(), INT_MAX);
+
+    // (cost, node), smallest cost on top
+    using Entry = std::pair<int, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+    dist[source] = 0;
+    pq.emplace(0, source);
+
+    while (!pq.empty()) {
+        auto [currentCost, v] = pq.top();
+        pq.pop();
+        if (currentCost > dist[v])
+            continue; // Stale entry
+
+        for (int e = offsets_[v]; e < offsets_[v + 1]; ++e) {
+            int newCost = currentCost + weights_[e];
+            int w = targets_[e];
+            if (newCost < dist[w]) {
+                dist[w] = newCost;
+                pq.emplace(newCost, w);
+            }
+        }
+    }
+}
+
+LinkCostMatrix LinkCostGraph::allPairs(const std::vector<std::string>& nodes, int threads) const {
+    LinkCostMatrix matrix;
+    matrix.names_ = nodes;
+    std::sort(matrix.names_.begin(), matrix.names_.end());
+    matrix.names_.erase(std::unique(matrix.names_.begin(), matrix.names_.end()), matrix.names_.end());
+
+    int n = matrix.size();
+    std::vector<int> graphIds(n);
+    for (int i = 0; i < n; ++i) {
+        matrix.index_.emplace(matrix.names_[i], i);
+        graphIds[i] = id(matrix.names_[i]);
+    }
+    matrix.costs_.assign(static_cast<size_t>(n) * n, -1);
+
+    // Each source fills its own row, rows are handed out to the workers one at a time
+    std::atomic<int> nextSource(0);
+    std::atomic<int> unreachable(0);
+    auto worker = [&]() {
+        std::vector<int> dist;
+        for (int i = nextSource++; i < n; i = nextSource++) {
+            int* row = &matrix.costs_[static_cast<size_t>(i) * n];
+            row[i] = 0;
+            if (graphIds[i] < 0)
+                continue;
+
+            shortestPaths(graphIds[i], dist);
+            for (int j = 0; j < n; ++j) {
+                if (j == i)
+                    continue;
+                if (graphIds[j] >= 0 && dist[graphIds[j]] != INT_MAX)
+                    row[j] = dist[graphIds[j]];
+                else
+                    unreachable++;
+            }
+        }
+    };
+
+    int workers = threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency());
+    workers = std::max(1, std::min(workers, n));
+    std::vector<std::thread> pool;
+    for (int t = 1; t < workers; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool)
+        thread.join();
+
+    if (unreachable > 0)
+        std::cout << "Error happened, no route is found for " << unreachable / 2 << " node pairs!" << std::endl;
+    return matrix;
+}
@@ -16,7 +16,7 @@ using namespace std;
 // the total number of nodes (N_) and the number of clusters based on N_ and C.
  //------------------------------------------------------------------------------
 LocalSearchCluster::LocalSearchCluster(const std::vector<std::string>& dataPointNames,
-                                       const std::map<std::string, std::map<std::string, int>>& linkCostMatrix,
+                                       const LinkCostMatrix& linkCostMatrix,
                                        int C)
     : dataPointNames_(dataPointNames), linkCostMatrix_(linkCostMatrix), C_(C)
 {
@@ -103,22 +103,20 @@ std::vector<std::vector<std::string>> LocalSearchCluster::getClusters() const {
 // The distance from a node to itself is zero.
 //------------------------------------------------------------------------------
 std::vector<std::vector<int>> LocalSearchCluster::buildDistanceMatrix() {
-    // Map each node name to an index.
-    std::map<std::string, int> nodeIndex;
+    // Resolve each data point to its row in the link cost matrix.
+    std::vector<int> ids(N_);
     for (int i = 0; i < N_; ++i) {
-        nodeIndex[dataPointNames_[i]] = i;
+        ids[i] = linkCostMatrix_.index(dataPointNames_[i]);
     }
 
-    // Create N_ x N_ matrix initialized to 0.
+    // Create N_ x N_ matrix initialized to 0, unknown or unreachable pairs stay 0.
     std::vector<std::vector<int>> dist(N_, std::vector<int>(N_, 0));
 
-    // Fill the matrix using the link cost matrix (assumed symmetric).
-    for (const auto& [from, costs] : linkCostMatrix_) {
-        int i = nodeIndex[from];
-        for (const auto& [to, cost] : costs) {
-            int j = nodeIndex[to];
-            dist[i][j] = cost;
-            dist[j][i] = cost;
+    for (int i = 0; i < N_; ++i) {
+        if (ids[i] < 0) continue;
+        for (int j = 0; j < N_; ++j) {
+            if (ids[j] < 0) continue;
+            dist[i][j] = std::max(linkCostMatrix_.cost(ids[i], ids[j]), 0);
         }
     }
 
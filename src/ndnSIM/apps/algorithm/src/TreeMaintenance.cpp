@@ -0,0 +1,242 @@
+#include "../include/TreeMaintenance.hpp"
+#include "../include/LocalSearchCluster.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+TreeMaintenance::TreeMaintenance(const std::string& file, const std::string& root, int C, const TreeMap& tree)
+    : builder_(file)
+    , root_(root)
+    , C_(C)
+    , tree_(tree)
+{
+    builder_.globalClient = root;
+    graph_.load(file);
+}
+
+TreeDiff TreeMaintenance::removeProducer(const std::string& producer) {
+    std::string parent = parentOf(producer);
+    if (parent.empty()) {
+        std::cerr << "Producer " << producer << " isn't part of the aggregation tree." << std::endl;
+        return TreeDiff();
+    }
+
+    TreeMap before = tree_;
+    excluded_.insert(producer);
+    auto& children = tree_[parent];
+    children.erase(std::remove(children.begin(), children.end(), producer), children.end());
+    pruneEmpty(parent);
+
+    TreeDiff result = diff(before);
+    result.leftProducers.push_back(producer);
+    return result;
+}
+
+TreeDiff TreeMaintenance::removeAggregator(const std::string& aggregator) {
+    std::string parent = parentOf(aggregator);
+    if (parent.empty() || tree_.find(aggregator) == tree_.end()) {
+        std::cerr << "Aggregator " << aggregator << " isn't part of the aggregation tree." << std::endl;
+        return TreeDiff();
+    }
+
+    TreeMap before = tree_;
+    excluded_.insert(aggregator);
+
+    // Orphans are grouped among themselves first, so the siblings keep their place as long as the fan-in allows
+    std::vector<std::string> siblings;
+    for (const auto& sibling : tree_[parent]) {
+        if (sibling != aggregator)
+            siblings.push_back(sibling);
+    }
+    std::vector<std::string> orphans = tree_[aggregator];
+    tree_.erase(aggregator);
+
+    size_t fanIn = fanInOf(parent);
+    std::vector<std::string> members = orphans;
+    if (siblings.size() + orphans.size() > fanIn)
+        members = groupBelow(parent, orphans, fanIn > siblings.size() ? fanIn - siblings.size() : 1);
+    members.insert(members.end(), siblings.begin(), siblings.end());
+
+    rebuildSubtree(parent, members);
+    pruneEmpty(parent);
+    return diff(before);
+}
+
+TreeDiff TreeMaintenance::removeLink(const std::string& a, const std::string& b) {
+    if (!graph_.removeLink(a, b)) {
+        std::cerr << "No link between " << a << " and " << b << " in the topology." << std::endl;
+        return TreeDiff();
+    }
+
+    TreeMap before = tree_;
+    LinkCostMatrix oldCosts = builder_.linkCostMatrix;
+    builder_.linkCostMatrix = graph_.allPairs(oldCosts.names());
+
+    // Parents with a child whose cost changed, collected first since repairs reshape the tree
+    std::vector<std::pair<std::string, std::vector<std::string>>> affected;
+    for (const auto& [parent, children] : tree_) {
+        std::vector<std::string> moved;
+        for (const auto& child : children) {
+            if (oldCosts.cost(parent, child) != builder_.linkCostMatrix.cost(parent, child))
+                moved.push_back(child);
+        }
+        if (!moved.empty())
+            affected.emplace_back(parent, moved);
+    }
+
+    std::vector<std::string> leftProducers;
+    for (const auto& [parent, moved] : affected) {
+        auto it = tree_.find(parent);
+        if (it == tree_.end())
+            continue; // Dissolved while repairing an earlier parent
+
+        // Moved aggregators give their children back to the parent, recursively while they can't be reached
+        std::vector<std::string> members;
+        std::vector<std::string> pending(it->second.begin(), it->second.end());
+        while (!pending.empty()) {
+            std::string node = pending.back();
+            pending.pop_back();
+            bool isMoved = std::find(moved.begin(), moved.end(), node) != moved.end();
+            if (!isMoved && isReachable(parent, node)) {
+                members.push_back(node);
+                continue;
+            }
+
+            auto sub = tree_.find(node);
+            if (sub != tree_.end()) {
+                pending.insert(pending.end(), sub->second.begin(), sub->second.end());
+                tree_.erase(sub);
+            } else if (isReachable(parent, node)) {
+                members.push_back(node);
+            } else {
+                excluded_.insert(node);
+                leftProducers.push_back(node);
+            }
+        }
+
+        rebuildSubtree(parent, members);
+        pruneEmpty(parent);
+    }
+
+    TreeDiff result = diff(before);
+    result.leftProducers = leftProducers;
+    return result;
+}
+
+void TreeMaintenance::rebuildSubtree(const std::string& parent, const std::vector<std::string>& members) {
+    tree_[parent] = groupBelow(parent, members, fanInOf(parent));
+}
+
+std::vector<std::string> TreeMaintenance::groupBelow(const std::string& parent, std::vector<std::string> members, size_t fanIn) {
+    std::vector<std::string> candidates = spareAggregators();
+
+    while (members.size() > fanIn) {
+        std::vector<std::vector<std::string>> clusters = LocalSearchCluster(members, builder_.linkCostMatrix, C_).runClustering();
+
+        std::vector<std::string> next;
+        for (const auto& cluster : clusters) {
+            std::string head = cluster.size() > 1 ? builder_.findCH(cluster, candidates, parent) : parent;
+            if (head == parent) {
+                // Single node, or no CH closer than the parent, the nodes stay on this level
+                next.insert(next.end(), cluster.begin(), cluster.end());
+                continue;
+            }
+            candidates.erase(std::remove(candidates.begin(), candidates.end(), head), candidates.end());
+            tree_[head] = cluster;
+            next.push_back(head);
+        }
+
+        if (next.size() >= members.size()) {
+            std::cerr << "No CH left below " << parent << ", " << next.size() << " nodes are attached to it directly." << std::endl;
+            return next;
+        }
+        members = next;
+    }
+    return members;
+}
+
+size_t TreeMaintenance::fanInOf(const std::string& parent) const {
+    // Same bound as the construction: the root takes less than C children, a CH up to a cluster
+    return static_cast<size_t>(std::max(1, parent == root_ ? C_ - 1 : C_));
+}
+
+void TreeMaintenance::pruneEmpty(std::string parent) {
+    while (parent != root_) {
+        auto it = tree_.find(parent);
+        if (it == tree_.end() || !it->second.empty())
+            return;
+
+        std::string grandParent = parentOf(parent);
+        tree_.erase(it);
+        if (grandParent.empty())
+            return;
+        auto& siblings = tree_[grandParent];
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), parent), siblings.end());
+        parent = grandParent;
+    }
+}
+
+std::vector<std::string> TreeMaintenance::spareAggregators() const {
+    std::set<std::string> inTree;
+    for (const auto& [parent, children] : tree_) {
+        inTree.insert(parent);
+        inTree.insert(children.begin(), children.end());
+    }
+
+    std::vector<std::string> spare;
+    for (const auto& node : builder_.fullList) {
+        if (node.compare(0, 3, "agg") == 0 && !inTree.count(node) && !excluded_.count(node) && isReachable(root_, node))
+            spare.push_back(node);
+    }
+    return spare;
+}
+
+std::string TreeMaintenance::parentOf(const std::string& node) const {
+    for (const auto& [parent, children] : tree_) {
+        if (std::find(children.begin(), children.end(), node) != children.end())
+            return parent;
+    }
+    return std::string();
+}
+
+bool TreeMaintenance::isReachable(const std::string& a, const std::string& b) const {
+    return a == b || builder_.linkCostMatrix.cost(a, b) >= 0;
+}
+
+TreeDiff TreeMaintenance::diff(const TreeMap& before) const {
+    TreeDiff result;
+    for (const auto& [parent, children] : tree_) {
+        if (before.find(parent) == before.end() || assignmentOf(parent, before) != assignmentOf(parent, tree_))
+            result.changed[parent] = children;
+    }
+    for (const auto& [parent, children] : before) {
+        if (tree_.find(parent) == tree_.end())
+            result.removed.push_back(parent);
+    }
+    return result;
+}
+
+std::map<std::string, std::set<std::string>> TreeMaintenance::assignmentOf(const std::string& parent, const TreeMap& tree) {
+    std::map<std::string, std::set<std::string>> assignment;
+    auto it = tree.find(parent);
+    if (it == tree.end())
+        return assignment;
+
+    for (const auto& child : it->second) {
+        if (tree.find(child) != tree.end())
+            collectLeaves(child, tree, assignment[child]);
+        else
+            assignment[child].insert(child);
+    }
+    return assignment;
+}
+
+void TreeMaintenance::collectLeaves(const std::string& node, const TreeMap& tree, std::set<std::string>& leaves) {
+    auto it = tree.find(node);
+    if (it == tree.end()) {
+        leaves.insert(node);
+        return;
+    }
+    for (const auto& child : it->second)
+        collectLeaves(child, tree, leaves);
+}
@@ -1,5 +1,7 @@
 #include "../include/k_means.hpp"
 
+#include <algorithm>
+
 // Pseudo-random number generation
 std::random_device rd;
 
@@ -26,17 +28,18 @@ const std::vector<int>& KMeans::assignments() const {
 // todo: Done!
 int KMeans::CalDistance(const std::string& data1,
                         const std::string& data2,
-                        std::map<std::string, std::map<std::string, int>> linkCostMatrix) const {
-    return linkCostMatrix[data1][data2];
+                        const LinkCostMatrix& linkCostMatrix) const {
+    // Unknown or unreachable pairs count as 0
+    return std::max(linkCostMatrix.cost(data1, data2), 0);
 }
 
 // todo: Done!
 int KMeans::CalDistance(const std::string& data1,
                         const std::vector<std::string>& cluster,
-                        std::map<std::string, std::map<std::string, int>> linkCostMatrix) const {
+                        const LinkCostMatrix& linkCostMatrix) const {
     int distance = 0;
     for (const auto& node : cluster) {
-        distance += linkCostMatrix[node][data1];
+        distance += CalDistance(node, data1, linkCostMatrix);
     }
     distance = distance / cluster.size();
     return distance;
@@ -63,7 +66,7 @@ void KMeans::UpdateClusterCenter() {
     }
 }
 
-double KMeans::GetSumSquaredError(const std::map<std::string, std::map<std::string, int>> linkCostMatrix) const {
+double KMeans::GetSumSquaredError(const LinkCostMatrix& linkCostMatrix) const {
     double sum = 0;
     for (int i = 0; i < n_; ++i) {
         // ToDo: change the code
@@ -4,7 +4,7 @@
 #include <thread>
 
 RegularizedKMeans::RegularizedKMeans(
-        const std::vector<std::string>& data, int k, std::map<std::string, std::map<std::string, int>> costMatrix, InitMethod init_method,
+        const std::vector<std::string>& data, int k, const LinkCostMatrix& costMatrix, InitMethod init_method,
         bool warm_start, int n_jobs, unsigned int seed)
         : KMeans(data, k, init_method, seed),
           warm_start_(warm_start),
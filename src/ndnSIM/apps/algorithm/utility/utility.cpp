@@ -116,55 +116,6 @@ std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> Utilit
 }
 
 
-// Function to find the minimum link cost between any two nodes using Dijkstra's algorithm
-int Utility::findLinkCost(const std::string& start, const std::string& end, const std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> graph) {
-    if (graph.find(start) == graph.end() || graph.find(end) == graph.end())
-        return -1; // Nodes are not present in the graph
-
-    std::priority_queue<std::pair<std::string, int>, std::vector<std::pair<std::string, int>>, Compare> pq;
-    std::unordered_map<std::string, int> distances;
-
-    // Initialize distances to maximum
-    for (const auto& node : graph) {
-        distances[node.first] = INT_MAX;
-    }
-
-    // Start from the source node
-    pq.push({start, 0});
-    distances[start] = 0;
-
-    while (!pq.empty()) {
-        auto current = pq.top();
-        pq.pop();
-
-        std::string currentNode = current.first;
-        int currentCost = current.second;
-
-        // Shortest path to end node found
-        if (currentNode == end) {
-            return currentCost;
-        }
-
-        // Traverse all adjacent nodes
-        for (const auto& neighbor : graph.at(currentNode)) {
-            std::string nextNode = neighbor.first;
-            int nextCost = neighbor.second;
-            int newCost = currentCost + nextCost;
-
-            // Check if a cheaper path is found
-            if (newCost < distances[nextNode]) {
-                distances[nextNode] = newCost;
-                pq.push({nextNode, newCost});
-            }
-        }
-    }
-
-    std::cout << "Error happened, no route is found!!!!!!!!!!!" << std::endl;
-    return -1; // No path found
-}
-
-
-
 // Initialize the nodes from the bottom for first iteration, i.e. get all producers
 std::vector<std::string> Utility::getProducers(std::string filename) {
     std::ifstream file(filename);
@@ -235,16 +186,14 @@ int Utility::countProducers(std::string filename) {
     return producerCount;
 }
 
-std::map<std::string, std::map<std::string, int>> Utility::GetAllLinkCost(std::string filename)
+LinkCostMatrix Utility::GetAllLinkCost(std::string filename)
 {
-    std::map<std::string, std::map<std::string, int>> linkCostMatrix;
     std::vector<std::string> nodeList;
-    std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> graph;
 
     std::ifstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Fail to open file." << filename << std::endl;
-        return linkCostMatrix;
+        return LinkCostMatrix();
     }
     std::string line;
     bool isRouterSection = false;
@@ -256,25 +205,16 @@ std::map<std::string, std::map<std::string, int>> Utility::GetAllLinkCost(std::s
         } else if (line == "link") {
             break;
         } else if (isRouterSection) {
-            if (line.substr(0, 3) == "pro" || line.substr(0, 3) == "agg" || line.substr(0, 3) == "con")
-                nodeList.push_back(line);
+            std::string nodeName;
+            std::istringstream(line) >> nodeName;
+            if (nodeName.substr(0, 3) == "pro" || nodeName.substr(0, 3) == "agg" || nodeName.substr(0, 3) == "con")
+                nodeList.push_back(nodeName);
         }
     }
 
-    // Get graph for further computation
-    graph = initializeGraph(filename);
-
-    // Compute link cost matrix
-    for (const auto& node1: nodeList) {
-        for (const auto& node2 : nodeList) {
-            if (node1 == node2) {
-                linkCostMatrix[node1][node2] = 0;
-            } else if (linkCostMatrix[node1].find(node2) == linkCostMatrix[node1].end()) {
-                int cost = findLinkCost(node1, node2, graph);
-                linkCostMatrix[node1][node2] = cost;
-                linkCostMatrix[node2][node1] = cost;
-            }
-        }
-    }
-    return linkCostMatrix;
-}
\ No newline at end of file
+    // Integer ids and CSR adjacency, then one Dijkstra per node of the matrix, in parallel
+    LinkCostGraph graph;
+    if (!graph.load(filename))
+        return LinkCostMatrix();
+    return graph.allPairs(nodeList);
+}
@@ -13,16 +13,11 @@
 #include <climits>
 #include <set>
 
+#include "../include/LinkCostMatrix.hpp"
 
 
-namespace Utility{
 
-    // Comparator for priority queue
-    struct Compare {
-        bool operator()(const std::pair<std::string, int>& p1, const std::pair<std::string, int>& p2) {
-            return p1.second > p2.second;
-        }
-    };
+namespace Utility{
 
     std::vector <std::string> getContextInfo(std::string filename);
 
@@ -30,12 +25,11 @@ namespace Utility{
 
     std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> initializeGraph(std::string filename);
 
-    int findLinkCost(const std::string& start, const std::string& end, const std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> graph);
-
     std::vector<std::string> getProducers(std::string filename);
 
     int countProducers(std::string filename);
 
-    std::map<std::string, std::map<std::string, int>> GetAllLinkCost(std::string filename);
+    // Shortest-path costs between all producers, aggregators and consumers, one Dijkstra per node
+    LinkCostMatrix GetAllLinkCost(std::string filename);
 
 };
\ No newline at end of file
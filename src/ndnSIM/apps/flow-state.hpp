@@ -0,0 +1,196 @@
+#ifndef FLOW_STATE_HPP
+#define FLOW_STATE_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/utils/log-sink.hpp"
+
+#include "sliding-window.hpp"
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * Congestion control and scheduling state of one flow, i.e. one child (upstream node) of the
+ * consumer or of an aggregator. Values are set by the app's parameter initialization
+ */
+struct FlowState {
+    std::string prefix; // Flow name, first component of the interest name, e.g. "agg0"
+    Name dataPrefix; // First three components of the interest name, e.g. /agg0/pro0.pro1/data, encoded once
+    std::vector<uint32_t> leaves; // Node ids of the producers below the child
+    std::deque<uint32_t> interestQueue;
+    uint32_t seq = 0; // Latest seq sent
+    bool active = true; // Cleared when a tree repair removes the child, late packets of the flow are dropped
+
+    // Interest sending rate pacing
+    EventId scheduleEvent;
+    EventId sendEvent;
+
+    // Window
+    double window = 0;
+    double ssthresh = 0;
+    uint32_t inFlight = 0;
+    Time lastWindowDecreaseTime;
+    double cubicWmax = 0;
+    double cubicLastWmax = 0;
+    uint32_t lastCongestionSeq = 0;
+    int successiveCongestion = 0;
+
+    // RTT based congestion detection
+    int rttCount = 0; // How many RTT samples this flow has received
+    std::deque<int64_t> rttWindowedQueue; // Windowed RTT samples
+    int64_t rttHistoricalEstimation = 0;
+
+    // RTO
+    int64_t srtt = 0;
+    int64_t rttvar = 0;
+    int roundRTT = 0;
+    bool initRTO = false;
+    Time rtoThreshold;
+    int numTimeout = 0;
+
+    // QueueSize-based CC
+    bool firstData = true;
+    utils::SlidingWindow<double> qsSlidingWindow;
+    EventId rateEvent;
+    double rateLimit = 0; // Unit: pkgs/ms
+    double estimatedBW = 0; // Unit: pkgs/ms
+    int64_t rttEstimationQs = 0; // Unit: us
+    bool nackSignal = false;
+    bool timeoutSignal = false;
+    double lastBW = 0;
+    std::string ccState;
+    double inflightLimit = 0;
+
+    // Per-flow logs, nullptr when disabled
+    utils::LogFile* rtoLog = nullptr;
+    utils::LogFile* windowLog = nullptr;
+    utils::LogFile* responseTimeLog = nullptr;
+    utils::LogFile* inFlightLog = nullptr;
+    utils::LogFile* queueLog = nullptr;
+};
+
+/**
+ * Flows of one app, interned into dense ids 0..size()-1 in the order they're added
+ *
+ * All per-flow state sits in one contiguous array indexed by id. A packet's flow is resolved once,
+ * straight from the first name component (no string is built), and the id is what gets passed
+ * around and bound to scheduled events afterwards.
+ */
+class FlowTable {
+public:
+    static constexpr uint32_t INVALID = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * Intern a flow, returns the id it already has if it's known
+     */
+    uint32_t
+    Add(const std::string& prefix)
+    {
+        auto it = LowerBound(prefix);
+        if (it != m_index.end() && it->first == prefix) {
+            return it->second;
+        }
+
+        uint32_t id = static_cast<uint32_t>(m_flows.size());
+        m_flows.emplace_back();
+        m_flows.back().prefix = prefix;
+        m_index.emplace(it, prefix, id);
+        return id;
+    }
+
+    /**
+     * @return Flow id, INVALID if unknown
+     */
+    uint32_t
+    Find(const std::string& prefix) const
+    {
+        return FindKey(prefix);
+    }
+
+    /**
+     * Flow of an interest/data name, keyed by its first component
+     */
+    uint32_t
+    Find(const Name& name) const
+    {
+        if (name.empty()) {
+            return INVALID;
+        }
+        const name::Component& component = name.get(0);
+        return FindKey(std::string_view(reinterpret_cast<const char*>(component.value()), component.value_size()));
+    }
+
+    FlowState&
+    operator[](uint32_t id)
+    {
+        return m_flows[id];
+    }
+
+    const FlowState&
+    operator[](uint32_t id) const
+    {
+        return m_flows[id];
+    }
+
+    uint32_t
+    size() const
+    {
+        return static_cast<uint32_t>(m_flows.size());
+    }
+
+    bool
+    empty() const
+    {
+        return m_flows.empty();
+    }
+
+    std::vector<FlowState>::iterator
+    begin()
+    {
+        return m_flows.begin();
+    }
+
+    std::vector<FlowState>::iterator
+    end()
+    {
+        return m_flows.end();
+    }
+
+private:
+    uint32_t
+    FindKey(std::string_view prefix) const
+    {
+        auto it = LowerBound(prefix);
+        return it != m_index.end() && it->first == prefix ? it->second : INVALID;
+    }
+
+    std::vector<std::pair<std::string, uint32_t>>::const_iterator
+    LowerBound(std::string_view prefix) const
+    {
+        return std::lower_bound(m_index.begin(), m_index.end(), prefix,
+                                [] (const std::pair<std::string, uint32_t>& entry, std::string_view key) {
+                                    return std::string_view(entry.first) < key;
+                                });
+    }
+
+private:
+    std::vector<FlowState> m_flows;
+    std::vector<std::pair<std::string, uint32_t>> m_index; // Sorted by prefix, for lookups without allocation
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // FLOW_STATE_HPP
@@ -0,0 +1,396 @@
+#include "gradient-generator.hpp"
+
+#include "ns3/log.h"
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define GRADIENT_GENERATOR_X86 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GRADIENT_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define GRADIENT_ALWAYS_INLINE inline
+#endif
+
+NS_LOG_COMPONENT_DEFINE("ndn.GradientGenerator");
+
+namespace ns3 {
+namespace ndn {
+
+static constexpr uint32_t PHILOX_M0 = 0xD2511F53;
+static constexpr uint32_t PHILOX_M1 = 0xCD9E8D57;
+static constexpr uint32_t PHILOX_W0 = 0x9E3779B9;
+static constexpr uint32_t PHILOX_W1 = 0xBB67AE85;
+static constexpr int PHILOX_ROUNDS = 10;
+static constexpr size_t PHILOX_LANES = 8; // Blocks computed side by side, one AVX2 register of uint32 per word
+static constexpr size_t FILL_CHUNK_BLOCKS = 64; // Philox output buffered on the stack while converting
+
+static constexpr double TWO_PI = 6.283185307179586476925286766559;
+
+
+
+/**
+ * PHILOX_LANES consecutive blocks, laid out lane by lane so that the compiler turns every round
+ * into a few vector multiplies and xors
+ */
+static GRADIENT_ALWAYS_INLINE void
+philoxLanes(uint32_t* out, uint64_t first, uint32_t stream0, uint32_t stream1, const uint32_t key[2])
+{
+    uint32_t c0[PHILOX_LANES], c1[PHILOX_LANES], c2[PHILOX_LANES], c3[PHILOX_LANES];
+    for (size_t l = 0; l < PHILOX_LANES; ++l) {
+        uint64_t counter = first + l;
+        c0[l] = static_cast<uint32_t>(counter);
+        c1[l] = static_cast<uint32_t>(counter >> 32);
+        c2[l] = stream0;
+        c3[l] = stream1;
+    }
+
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+        if (round > 0) {
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+        for (size_t l = 0; l < PHILOX_LANES; ++l) {
+            uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c0[l];
+            uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c2[l];
+            uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+            uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+            c1[l] = static_cast<uint32_t>(p1);
+            c3[l] = static_cast<uint32_t>(p0);
+            c0[l] = n0;
+            c2[l] = n2;
+        }
+    }
+
+    for (size_t l = 0; l < PHILOX_LANES; ++l) {
+        out[4 * l] = c0[l];
+        out[4 * l + 1] = c1[l];
+        out[4 * l + 2] = c2[l];
+        out[4 * l + 3] = c3[l];
+    }
+}
+
+
+
+static GRADIENT_ALWAYS_INLINE void
+philoxBlocksImpl(uint32_t* out, size_t blocks, uint64_t first, uint64_t stream, const uint32_t key[2])
+{
+    uint32_t stream0 = static_cast<uint32_t>(stream);
+    uint32_t stream1 = static_cast<uint32_t>(stream >> 32);
+
+    size_t b = 0;
+    for (; b + PHILOX_LANES <= blocks; b += PHILOX_LANES) {
+        philoxLanes(out + 4 * b, first + b, stream0, stream1, key);
+    }
+    if (b < blocks) {
+        uint32_t tail[4 * PHILOX_LANES];
+        philoxLanes(tail, first + b, stream0, stream1, key);
+        std::memcpy(out + 4 * b, tail, (blocks - b) * 4 * sizeof(uint32_t));
+    }
+}
+
+
+
+static void
+philoxBlocksScalar(uint32_t* out, size_t blocks, uint64_t first, uint64_t stream, const uint32_t key[2])
+{
+    philoxBlocksImpl(out, blocks, first, stream, key);
+}
+
+
+
+#ifdef GRADIENT_GENERATOR_X86
+__attribute__((target("avx2"))) static void
+philoxBlocksAvx2(uint32_t* out, size_t blocks, uint64_t first, uint64_t stream, const uint32_t key[2])
+{
+    philoxBlocksImpl(out, blocks, first, stream, key);
+}
+#endif
+
+
+
+using PhiloxKernel = void (*)(uint32_t*, size_t, uint64_t, uint64_t, const uint32_t*);
+
+/**
+ * Kernel of PhiloxBlocks(), AVX2 when the CPU has it unless SetPhiloxAvx2(false) was called
+ */
+static PhiloxKernel&
+philoxKernel()
+{
+    static PhiloxKernel kernel = [] {
+#ifdef GRADIENT_GENERATOR_X86
+        if (__builtin_cpu_supports("avx2")) {
+            NS_LOG_INFO("Gradient generator uses AVX2 Philox kernel");
+            return static_cast<PhiloxKernel>(&philoxBlocksAvx2);
+        }
+#endif
+        return static_cast<PhiloxKernel>(&philoxBlocksScalar);
+    }();
+    return kernel;
+}
+
+
+
+void
+PhiloxBlocks(uint32_t* out, size_t blocks, uint64_t first, uint64_t stream, const uint32_t key[2])
+{
+    philoxKernel()(out, blocks, first, stream, key);
+}
+
+
+
+bool
+SetPhiloxAvx2(bool enable)
+{
+    philoxKernel() = &philoxBlocksScalar;
+#ifdef GRADIENT_GENERATOR_X86
+    if (enable && __builtin_cpu_supports("avx2")) {
+        philoxKernel() = &philoxBlocksAvx2;
+        return true;
+    }
+#endif
+    return false;
+}
+
+
+
+/**
+ * Uniform double in [0, 1) from 53 bits of two words
+ */
+static inline double
+toUnit(uint32_t high, uint32_t low)
+{
+    return static_cast<double>(((static_cast<uint64_t>(high) << 32) | low) >> 11) * 0x1.0p-53;
+}
+
+
+
+/**
+ * Run the Philox blocks covering positions [offset, offset + count) through convert, which turns one
+ * block (4 words) into VALUES_PER_BLOCK consecutive values
+ */
+template<size_t VALUES_PER_BLOCK, typename Convert>
+static void
+fillFromBlocks(double* out, size_t count, uint64_t stream, uint64_t offset, const uint32_t key[2], Convert convert)
+{
+    uint32_t words[4 * FILL_CHUNK_BLOCKS];
+    uint64_t last = (offset + count - 1) / VALUES_PER_BLOCK;
+    size_t done = 0;
+    while (done < count) {
+        uint64_t position = offset + done;
+        uint64_t first = position / VALUES_PER_BLOCK;
+        size_t blocks = static_cast<size_t>(std::min<uint64_t>(FILL_CHUNK_BLOCKS, last - first + 1));
+        PhiloxBlocks(words, blocks, first, stream, key);
+
+        size_t skip = static_cast<size_t>(position % VALUES_PER_BLOCK);
+        for (size_t b = 0; b < blocks; ++b) {
+            double values[VALUES_PER_BLOCK];
+            convert(words + 4 * b, values);
+            for (size_t v = (b == 0 ? skip : 0); v < VALUES_PER_BLOCK && done < count; ++v) {
+                out[done++] = values[v];
+            }
+        }
+    }
+}
+
+
+
+GradientGenerator::GradientGenerator()
+    : m_distribution(GRADIENT_UNIFORM)
+    , m_key{0, 0}
+    , m_min(0.0)
+    , m_max(10.0)
+    , m_mean(0.0)
+    , m_stddev(1.0)
+    , m_densityThreshold(static_cast<uint64_t>(1) << 32)
+    , m_modelSize(0)
+{
+}
+
+
+
+void
+GradientGenerator::SetKey(uint64_t key)
+{
+    m_key[0] = static_cast<uint32_t>(key);
+    m_key[1] = static_cast<uint32_t>(key >> 32);
+}
+
+
+
+void
+GradientGenerator::SetDistribution(GradientDistribution distribution)
+{
+    m_distribution = distribution;
+}
+
+
+
+void
+GradientGenerator::SetRange(double min, double max)
+{
+    m_min = min;
+    m_max = max;
+}
+
+
+
+void
+GradientGenerator::SetNormal(double mean, double stddev, double density)
+{
+    m_mean = mean;
+    m_stddev = stddev;
+    density = std::max(0.0, std::min(1.0, density));
+    m_densityThreshold = static_cast<uint64_t>(std::ldexp(density, 32));
+}
+
+
+
+void
+GradientGenerator::SetModelSize(size_t modelSize)
+{
+    m_modelSize = modelSize;
+}
+
+
+
+bool
+GradientGenerator::LoadTrace(const std::string& path)
+{
+    bool isBinary = path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0;
+    std::ifstream file(path, isBinary ? std::ios::binary : std::ios::in);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open the gradient trace: " << path << std::endl;
+        return false;
+    }
+
+    m_trace.clear();
+    if (isBinary) {
+        std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        m_trace.resize(bytes.size() / sizeof(double));
+        for (size_t i = 0; i < m_trace.size(); ++i) {
+            uint64_t bits;
+            std::memcpy(&bits, bytes.data() + i * sizeof(double), sizeof(bits));
+            bits = boost::endian::little_to_native(bits);
+            std::memcpy(&m_trace[i], &bits, sizeof(bits));
+        }
+    } else {
+        double value;
+        while (file >> value) {
+            m_trace.push_back(value);
+        }
+    }
+
+    if (m_trace.empty()) {
+        std::cerr << "Gradient trace " << path << " holds no value" << std::endl;
+        return false;
+    }
+    NS_LOG_INFO("Loaded " << m_trace.size() << " gradient values from " << path);
+    return true;
+}
+
+
+
+void
+GradientGenerator::Fill(double* out, size_t count, uint64_t iteration, uint64_t offset) const
+{
+    if (count == 0) {
+        return;
+    }
+
+    switch (m_distribution) {
+    case GRADIENT_GAUSSIAN:
+        FillGaussian(out, count, iteration, offset);
+        break;
+    case GRADIENT_SPARSE:
+        FillSparse(out, count, iteration, offset);
+        break;
+    case GRADIENT_TRACE:
+        FillTrace(out, count, iteration, offset);
+        break;
+    case GRADIENT_UNIFORM:
+    default:
+        FillUniform(out, count, iteration, offset);
+        break;
+    }
+}
+
+
+
+void
+GradientGenerator::FillUniform(double* out, size_t count, uint64_t iteration, uint64_t offset) const
+{
+    double min = m_min, scale = m_max - m_min;
+    fillFromBlocks<2>(out, count, iteration, offset, m_key, [min, scale] (const uint32_t* w, double* values) {
+        values[0] = min + scale * toUnit(w[0], w[1]);
+        values[1] = min + scale * toUnit(w[2], w[3]);
+    });
+}
+
+
+
+void
+GradientGenerator::FillGaussian(double* out, size_t count, uint64_t iteration, uint64_t offset) const
+{
+    // Box-Muller, both outputs of a pair are used
+    double mean = m_mean, stddev = m_stddev;
+    fillFromBlocks<2>(out, count, iteration, offset, m_key, [mean, stddev] (const uint32_t* w, double* values) {
+        double radius = stddev * std::sqrt(-2.0 * std::log(1.0 - toUnit(w[0], w[1])));
+        double angle = TWO_PI * toUnit(w[2], w[3]);
+        values[0] = mean + radius * std::cos(angle);
+        values[1] = mean + radius * std::sin(angle);
+    });
+}
+
+
+
+void
+GradientGenerator::FillSparse(double* out, size_t count, uint64_t iteration, uint64_t offset) const
+{
+    // One block per entry: first word decides whether it's kept, the others give its value
+    double mean = m_mean, stddev = m_stddev;
+    uint64_t threshold = m_densityThreshold;
+    fillFromBlocks<1>(out, count, iteration, offset, m_key, [mean, stddev, threshold] (const uint32_t* w, double* values) {
+        if (w[0] >= threshold) {
+            values[0] = 0.0;
+            return;
+        }
+        double radius = stddev * std::sqrt(-2.0 * std::log(1.0 - toUnit(w[1], w[2])));
+        values[0] = mean + radius * std::cos(TWO_PI * std::ldexp(static_cast<double>(w[3]), -32));
+    });
+}
+
+
+
+void
+GradientGenerator::FillTrace(double* out, size_t count, uint64_t iteration, uint64_t offset) const
+{
+    if (m_trace.empty()) {
+        std::fill(out, out + count, 0.0);
+        return;
+    }
+
+    // Iterations count from 1, the first one replays the start of the trace
+    uint64_t model = iteration > 0 ? iteration - 1 : 0;
+    size_t position = static_cast<size_t>((model * m_modelSize + offset) % m_trace.size());
+    size_t done = 0;
+    while (done < count) {
+        size_t run = std::min(count - done, m_trace.size() - position);
+        std::memcpy(out + done, m_trace.data() + position, run * sizeof(double));
+        done += run;
+        position = 0;
+    }
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,136 @@
+#ifndef GRADIENT_GENERATOR_HPP
+#define GRADIENT_GENERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * Distribution of the synthetic model parameters sent by producers, selected by the
+ * "GradientDistribution" attribute
+ */
+enum GradientDistribution {
+    GRADIENT_UNIFORM = 0, // Uniform in [min, max), the historical payload
+    GRADIENT_GAUSSIAN,    // Normal(mean, stddev), like dense gradients
+    GRADIENT_SPARSE,      // Normal(mean, stddev) on a random fraction (density) of the entries, 0 elsewhere
+    GRADIENT_TRACE        // Replayed from a file of real gradients
+};
+
+/**
+ * Deterministic, position-addressable generator of model parameters
+ *
+ * Random values come from the counter-based Philox4x32-10 generator: parameter i of iteration k is
+ * a pure function of (key, k, i), there is no state to advance. Producers draw the key from their
+ * ns-3 random stream, so a run is reproducible from RngSeed/RngRun, a retransmitted interest gets
+ * the very same data, and the segments of an iteration put together form one consistent model
+ * whatever the SegmentSize. Philox blocks are computed several at a time (vectorized with AVX2 when
+ * the CPU has it), results don't depend on the instruction set.
+ *
+ * A trace holds one or more models back to back; iteration k replays the k-th model, wrapping
+ * around at the end of the file.
+ */
+class GradientGenerator {
+public:
+    GradientGenerator();
+
+    /**
+     * @param key Philox key, usually drawn from the app's ns-3 random stream
+     */
+    void
+    SetKey(uint64_t key);
+
+    void
+    SetDistribution(GradientDistribution distribution);
+
+    GradientDistribution
+    GetDistribution() const
+    {
+        return m_distribution;
+    }
+
+    /**
+     * UNIFORM range
+     */
+    void
+    SetRange(double min, double max);
+
+    /**
+     * GAUSSIAN and SPARSE parameters
+     * @param density SPARSE only, expected fraction of non-zero entries
+     */
+    void
+    SetNormal(double mean, double stddev, double density = 1.0);
+
+    /**
+     * Number of parameters of one model, the stride between iterations of a trace
+     */
+    void
+    SetModelSize(size_t modelSize);
+
+    /**
+     * Load a gradient trace, whitespace-separated text or, for a ".bin" file, raw little-endian
+     * float64
+     * @return False if the file can't be read or holds no value
+     */
+    bool
+    LoadTrace(const std::string& path);
+
+    /**
+     * Write parameters [offset, offset + count) of the model of an iteration
+     * @param out Destination, e.g. straight into the payload of a Data packet being encoded
+     * @param count
+     * @param iteration
+     * @param offset Position of out[0] within the model
+     */
+    void
+    Fill(double* out, size_t count, uint64_t iteration, uint64_t offset) const;
+
+private:
+    void
+    FillUniform(double* out, size_t count, uint64_t iteration, uint64_t offset) const;
+
+    void
+    FillGaussian(double* out, size_t count, uint64_t iteration, uint64_t offset) const;
+
+    void
+    FillSparse(double* out, size_t count, uint64_t iteration, uint64_t offset) const;
+
+    void
+    FillTrace(double* out, size_t count, uint64_t iteration, uint64_t offset) const;
+
+private:
+    GradientDistribution m_distribution;
+    uint32_t m_key[2];
+    double m_min;
+    double m_max;
+    double m_mean;
+    double m_stddev;
+    uint64_t m_densityThreshold; // SPARSE, an entry is non-zero when a uniform uint32 is below it
+    size_t m_modelSize;
+    std::vector<double> m_trace;
+};
+
+/**
+ * Philox4x32-10 blocks for counters (first .. first + blocks - 1, stream), i.e. counter words
+ * {first + b low, first + b high, stream low, stream high}
+ * @param out 4 * blocks words, block b in out[4 * b .. 4 * b + 3]
+ */
+void
+PhiloxBlocks(uint32_t* out, size_t blocks, uint64_t first, uint64_t stream, const uint32_t key[2]);
+
+/**
+ * Select the Philox kernel of PhiloxBlocks(), which uses AVX2 by default when the CPU has it
+ * @param enable False forces the scalar kernel, e.g. to check that both give the same blocks
+ * @return Whether the AVX2 kernel is used from now on
+ */
+bool
+SetPhiloxAvx2(bool enable);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // GRADIENT_GENERATOR_HPP
@@ -0,0 +1,397 @@
+#include "iteration-pipeline.hpp"
+
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+namespace ndn {
+
+IterationPipeline::~IterationPipeline()
+{
+    for (auto& slot : m_slots) {
+        Simulator::Cancel(slot.deadline);
+    }
+}
+
+
+
+void
+IterationPipeline::Configure(const ModelSegmentation& segmentation, uint32_t depth, const StragglerPolicy& policy, ReadyHandler onDeadline)
+{
+    for (auto& slot : m_slots) {
+        Simulator::Cancel(slot.deadline);
+    }
+
+    m_segmentation = segmentation;
+    m_slots.assign(std::max<uint32_t>(depth, 1), Slot());
+    for (auto& slot : m_slots) {
+        slot.segments.resize(m_segmentation.GetSegmentCount());
+    }
+    m_policy = policy;
+    m_policy.quorum = std::min(std::max(policy.quorum, 0.0), 1.0);
+    m_onDeadline = std::move(onDeadline);
+    m_lastOpened = 0;
+    m_late.clear();
+    m_stats = CompletionStats();
+}
+
+
+
+bool
+IterationPipeline::Open(uint32_t iteration, const std::vector<uint32_t>& children)
+{
+    Slot& slot = SlotOf(iteration);
+    if (slot.open) {
+        return slot.iteration == iteration;
+    }
+
+    slot.iteration = iteration;
+    slot.open = true;
+    slot.start = Simulator::Now();
+    slot.segmentsLeft = m_segmentation.GetSegmentCount();
+    slot.segmentsFailed = 0;
+    m_lastOpened = std::max(m_lastOpened, iteration);
+    for (uint32_t i = 0; i < slot.segments.size(); ++i) {
+        Segment& segment = slot.segments[i];
+        segment.sum.assign(m_segmentation.GetSegmentLength(i), 0.0); // Keeps the capacity of earlier iterations
+        segment.contributors.clear();
+        segment.pending = children;
+        segment.expected = children.size();
+        segment.contributed = 0;
+        segment.summed = 0;
+        segment.open = true;
+        segment.ready = false;
+        segment.failed = false;
+
+        // Late contributions of the previous iteration start the sum
+        auto late = m_late.find(m_segmentation.ToUnit(iteration, i));
+        if (late != m_late.end()) {
+            for (size_t j = 0; j < segment.sum.size() && j < late->second.sum.size(); ++j) {
+                segment.sum[j] += late->second.sum[j];
+            }
+            segment.contributors.merge(late->second.contributors);
+            segment.summed += late->second.summed;
+            m_late.erase(late);
+        }
+    }
+
+    Time deadline = m_policy.GetDeadline();
+    if (!deadline.IsZero()) {
+        slot.deadline = Simulator::Schedule(deadline, &IterationPipeline::OnDeadline, this, iteration);
+    }
+    return true;
+}
+
+
+
+bool
+IterationPipeline::IsOpen(uint32_t unit) const
+{
+    return Find(unit) != nullptr;
+}
+
+
+
+IterationPipeline::Result
+IterationPipeline::Contribute(uint32_t unit, uint32_t flowId, const ModelDataView& data)
+{
+    Segment* segment = Find(unit);
+    if (segment == nullptr || segment->ready) {
+        return Fold(unit, data) ? FOLDED : UNKNOWN;
+    }
+
+    auto it = std::find(segment->pending.begin(), segment->pending.end(), flowId);
+    if (it == segment->pending.end()) {
+        return DUPLICATE;
+    }
+    segment->pending.erase(it);
+    segment->contributed++;
+    if (data.size() > 0) {
+        segment->summed++;
+    }
+    data.accumulateInto(segment->sum.data(), segment->sum.size());
+    data.mergeContributorsInto(segment->contributors);
+
+    return IsReady(*segment) ? READY : ACCEPTED;
+}
+
+
+
+const std::vector<double>&
+IterationPipeline::Sum(uint32_t unit) const
+{
+    const Segment* segment = Find(unit);
+    NS_ASSERT_MSG(segment != nullptr, "Segment " << unit << " isn't open");
+    return segment->sum;
+}
+
+
+
+const ModelContributors&
+IterationPipeline::Contributors(uint32_t unit) const
+{
+    const Segment* segment = Find(unit);
+    NS_ASSERT_MSG(segment != nullptr, "Segment " << unit << " isn't open");
+    return segment->contributors;
+}
+
+
+
+bool
+IterationPipeline::IsFailed(uint32_t unit) const
+{
+    const Segment* segment = Find(unit);
+    NS_ASSERT_MSG(segment != nullptr, "Segment " << unit << " isn't open");
+    return segment->failed;
+}
+
+
+
+bool
+IterationPipeline::Close(uint32_t unit, Time* iterationStart, bool* iterationFailed)
+{
+    Segment* segment = Find(unit);
+    if (segment == nullptr) {
+        return false;
+    }
+    segment->open = false;
+    m_stats.AddSegment(segment->failed ? 0 : segment->contributed, segment->expected);
+
+    Slot& slot = SlotOf(m_segmentation.GetIteration(unit));
+    if (segment->failed) {
+        slot.segmentsFailed++;
+    }
+    if (--slot.segmentsLeft > 0) {
+        return false;
+    }
+
+    slot.open = false;
+    Simulator::Cancel(slot.deadline);
+    // Without every segment there's no complete model, so no completion time either
+    if (slot.segmentsFailed == 0) {
+        m_stats.AddIteration(Simulator::Now() - slot.start);
+    }
+    if (iterationStart != nullptr) {
+        *iterationStart = slot.start;
+    }
+    if (iterationFailed != nullptr) {
+        *iterationFailed = slot.segmentsFailed > 0;
+    }
+    return true;
+}
+
+
+
+std::vector<uint32_t>
+IterationPipeline::AddChild(uint32_t flowId, const std::vector<uint32_t>& leaves)
+{
+    std::vector<uint32_t> units;
+    for (auto& slot : m_slots) {
+        if (!slot.open) {
+            continue;
+        }
+        for (uint32_t i = 0; i < slot.segments.size(); ++i) {
+            Segment& segment = slot.segments[i];
+            if (!segment.open || segment.ready) {
+                continue;
+            }
+            bool summed = std::any_of(leaves.begin(), leaves.end(), [&segment] (uint32_t leaf) {
+                return segment.contributors.has(leaf);
+            });
+            if (summed) {
+                continue;
+            }
+            if (std::find(segment.pending.begin(), segment.pending.end(), flowId) == segment.pending.end()) {
+                segment.pending.push_back(flowId);
+                segment.expected++;
+            }
+            units.push_back(m_segmentation.ToUnit(slot.iteration, i));
+        }
+    }
+    return units;
+}
+
+
+
+std::vector<uint32_t>
+IterationPipeline::RemoveChild(uint32_t flowId)
+{
+    std::vector<uint32_t> ready;
+    for (auto& slot : m_slots) {
+        if (!slot.open) {
+            continue;
+        }
+        for (uint32_t i = 0; i < slot.segments.size(); ++i) {
+            Segment& segment = slot.segments[i];
+            auto it = std::find(segment.pending.begin(), segment.pending.end(), flowId);
+            if (!segment.open || segment.ready || it == segment.pending.end()) {
+                continue;
+            }
+            segment.pending.erase(it);
+            segment.expected--;
+            if (IsReady(segment)) {
+                ready.push_back(m_segmentation.ToUnit(slot.iteration, i));
+            }
+        }
+    }
+    return ready;
+}
+
+
+
+std::vector<uint32_t>
+IterationPipeline::OpenUnits() const
+{
+    std::vector<uint32_t> units;
+    for (const auto& slot : m_slots) {
+        if (!slot.open) {
+            continue;
+        }
+        for (uint32_t i = 0; i < slot.segments.size(); ++i) {
+            if (slot.segments[i].open) {
+                units.push_back(m_segmentation.ToUnit(slot.iteration, i));
+            }
+        }
+    }
+    return units;
+}
+
+
+
+size_t
+IterationPipeline::ContributedCount(uint32_t flowId) const
+{
+    size_t count = 0;
+    for (const auto& slot : m_slots) {
+        if (!slot.open) {
+            continue;
+        }
+        for (const auto& segment : slot.segments) {
+            if (segment.open && std::find(segment.pending.begin(), segment.pending.end(), flowId) == segment.pending.end()) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+
+
+IterationPipeline::Segment*
+IterationPipeline::Find(uint32_t unit)
+{
+    return const_cast<Segment*>(static_cast<const IterationPipeline*>(this)->Find(unit));
+}
+
+
+
+const IterationPipeline::Segment*
+IterationPipeline::Find(uint32_t unit) const
+{
+    if (m_slots.empty() || unit == 0) {
+        return nullptr;
+    }
+
+    uint32_t iteration = m_segmentation.GetIteration(unit);
+    const Slot& slot = SlotOf(iteration);
+    if (!slot.open || slot.iteration != iteration) {
+        return nullptr;
+    }
+    const Segment& segment = slot.segments[m_segmentation.GetSegment(unit)];
+    return segment.open ? &segment : nullptr;
+}
+
+
+
+bool
+IterationPipeline::IsReady(Segment& segment) const
+{
+    // k-of-n: the quorum is rounded up, a segment always needs one summed contribution unless no child is left
+    uint32_t quorum = static_cast<uint32_t>(std::ceil(m_policy.GetQuorum() * segment.expected));
+    if (segment.pending.empty() || (segment.summed > 0 && segment.contributed >= quorum)) {
+        segment.ready = true;
+        segment.failed = segment.summed == 0;
+    }
+    return segment.ready;
+}
+
+
+
+bool
+IterationPipeline::Fold(uint32_t unit, const ModelDataView& data)
+{
+    uint32_t iteration = m_segmentation.GetIteration(unit);
+    if (m_policy.lateUpdates != LATE_UPDATES_FOLD || !m_policy.IsTolerant() || unit == 0 || iteration > m_lastOpened) {
+        return false;
+    }
+
+    uint32_t segmentIndex = m_segmentation.GetSegment(unit);
+    uint32_t next = m_segmentation.ToUnit(iteration + 1, segmentIndex);
+    Segment* segment = Find(next);
+    if (segment != nullptr) {
+        if (segment->ready) {
+            return false;
+        }
+        data.accumulateInto(segment->sum.data(), segment->sum.size());
+        data.mergeContributorsInto(segment->contributors);
+        if (data.size() > 0) {
+            segment->summed++;
+        }
+        return true;
+    }
+
+    // The next iteration either finished already or isn't opened yet
+    if (iteration + 1 <= m_lastOpened) {
+        return false;
+    }
+    Late& late = m_late[next];
+    if (late.sum.empty()) {
+        late.sum.assign(m_segmentation.GetSegmentLength(segmentIndex), 0.0);
+    }
+    data.accumulateInto(late.sum.data(), late.sum.size());
+    data.mergeContributorsInto(late.contributors);
+    if (data.size() > 0) {
+        late.summed++;
+    }
+    return true;
+}
+
+
+
+void
+IterationPipeline::OnDeadline(uint32_t iteration)
+{
+    Slot& slot = SlotOf(iteration);
+    if (!slot.open || slot.iteration != iteration) {
+        return;
+    }
+
+    // Whatever arrived is emitted, the handler closes the segments and so may release the slot.
+    // A segment nothing was summed into would only emit zeros, it waits for the next deadline
+    std::vector<uint32_t> late;
+    bool waiting = false;
+    for (uint32_t i = 0; i < slot.segments.size(); ++i) {
+        Segment& segment = slot.segments[i];
+        if (!segment.open || segment.ready) {
+            continue;
+        }
+        if (segment.summed == 0) {
+            waiting = true;
+            continue;
+        }
+        segment.ready = true;
+        late.push_back(m_segmentation.ToUnit(iteration, i));
+    }
+    if (waiting) {
+        slot.deadline = Simulator::Schedule(m_policy.GetDeadline(), &IterationPipeline::OnDeadline, this, iteration);
+    }
+    for (uint32_t unit : late) {
+        m_onDeadline(unit);
+    }
+}
+
+} // namespace ndn
+} // namespace ns3
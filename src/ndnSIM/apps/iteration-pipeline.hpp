@@ -0,0 +1,245 @@
+#ifndef ITERATION_PIPELINE_HPP
+#define ITERATION_PIPELINE_HPP
+
+#include "ModelData.hpp"
+#include "model-segmentation.hpp"
+#include "straggler-policy.hpp"
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * Iterations an app is aggregating at once, in a ring buffer of depth slots
+ *
+ * Iteration i lives in slot i % depth, so at most depth consecutive iterations are open: a flow
+ * which wants to send the first interest of an iteration whose slot is still held by an older one
+ * has to wait (Open() returns false). This bounds the partial aggregation state while letting
+ * iterations overlap, throughput is then bound by bandwidth rather than by one RTT per iteration.
+ *
+ * Every slot keeps one accumulator per segment. It is allocated when the slot is first used and
+ * only zeroed afterwards, contributions are summed straight from the packet buffer. A segment is
+ * ready once all children it waits for contributed, or, with straggler tolerance, once a quorum of
+ * them did or the iteration's deadline expired. The app emits a ready segment right away and then
+ * closes it, the slot is released with the last segment of its iteration.
+ *
+ * A segment nothing was summed into has no average: the deadline leaves it open until the next one.
+ * If it must be ready anyway (no child left to wait for), it's failed, the app keeps it out of its
+ * results and the iteration out of the completion times.
+ *
+ * A contribution arriving after its segment was emitted is dropped, or with LATE_UPDATES_FOLD summed
+ * into the same segment of the next iteration (held until that iteration is opened).
+ */
+class IterationPipeline {
+public:
+    using ReadyHandler = std::function<void(uint32_t unit)>;
+
+    enum Result {
+        ACCEPTED,  // Contribution summed, the segment still waits for others
+        READY,     // Contribution summed, the segment can be emitted
+        DUPLICATE, // The child already contributed to the segment, or doesn't take part in it
+        FOLDED,    // Late contribution, summed into the next iteration
+        UNKNOWN    // The segment isn't open: finished, possibly early, or never opened
+    };
+
+    IterationPipeline() = default;
+
+    IterationPipeline(const IterationPipeline&) = delete;
+
+    IterationPipeline&
+    operator=(const IterationPipeline&) = delete;
+
+    ~IterationPipeline();
+
+    /**
+     * @param segmentation Split of the model into segments (aggregation units)
+     * @param depth Max number of iterations open at once
+     * @param policy When segments are ready before every child contributed, and what happens to late contributions
+     * @param onDeadline Called for every segment made ready by the deadline
+     */
+    void
+    Configure(const ModelSegmentation& segmentation, uint32_t depth, const StragglerPolicy& policy, ReadyHandler onDeadline);
+
+    /**
+     * Open every segment of an iteration, waiting for the given children; no-op if it's open already
+     * @return False if the slot is still held by an older iteration
+     */
+    bool
+    Open(uint32_t iteration, const std::vector<uint32_t>& children);
+
+    bool
+    IsOpen(uint32_t unit) const;
+
+    /**
+     * Sum the contribution of child flowId to a segment
+     */
+    Result
+    Contribute(uint32_t unit, uint32_t flowId, const ModelDataView& data);
+
+    /**
+     * Sum of a ready segment, valid until it's closed
+     */
+    const std::vector<double>&
+    Sum(uint32_t unit) const;
+
+    /**
+     * Producers summed in a ready segment, valid until it's closed
+     */
+    const ModelContributors&
+    Contributors(uint32_t unit) const;
+
+    /**
+     * Whether a ready segment has nothing summed, valid until it's closed
+     */
+    bool
+    IsFailed(uint32_t unit) const;
+
+    /**
+     * Release a segment once it's emitted
+     * @param iterationStart If the iteration is done, set to the time it was opened
+     * @param iterationFailed If the iteration is done, set if any of its segments failed
+     * @return Whether this was the last segment of its iteration, whose slot is now free
+     */
+    bool
+    Close(uint32_t unit, Time* iterationStart = nullptr, bool* iterationFailed = nullptr);
+
+    /**
+     * A child joins the tree, open segments wait for it as well. Segments which already summed
+     * one of the producers below it (e.g. through the aggregator it was re-parented from) don't,
+     * the child would bring those producers in a second time
+     * @param leaves Node ids of the producers below the child
+     * @return Open segments the child has to contribute to
+     */
+    std::vector<uint32_t>
+    AddChild(uint32_t flowId, const std::vector<uint32_t>& leaves);
+
+    /**
+     * A child leaves the tree, no open segment waits for it anymore
+     * @return Segments which became ready, to be emitted by the app
+     */
+    std::vector<uint32_t>
+    RemoveChild(uint32_t flowId);
+
+    /**
+     * Open segments, in no particular order
+     */
+    std::vector<uint32_t>
+    OpenUnits() const;
+
+    /**
+     * Number of open segments child flowId already contributed to
+     */
+    size_t
+    ContributedCount(uint32_t flowId) const;
+
+    /**
+     * Whether segments may become ready before every child contributed
+     */
+    bool
+    IsStragglerTolerant() const
+    {
+        return m_policy.IsTolerant();
+    }
+
+    const StragglerPolicy&
+    GetPolicy() const
+    {
+        return m_policy;
+    }
+
+    /**
+     * Completion times and coverage of the iterations closed so far
+     */
+    const CompletionStats&
+    GetStats() const
+    {
+        return m_stats;
+    }
+
+private:
+    struct Segment {
+        std::vector<double> sum;
+        ModelContributors contributors;
+        std::vector<uint32_t> pending; // Children which haven't contributed yet
+        uint32_t expected = 0; // Children taking part
+        uint32_t contributed = 0;
+        uint32_t summed = 0; // Contributions carrying parameters, folded ones included
+        bool open = false;
+        bool ready = false;
+        bool failed = false; // Ready with nothing summed
+    };
+
+    struct Slot {
+        uint32_t iteration = 0;
+        bool open = false;
+        Time start;
+        uint32_t segmentsLeft = 0; // Segments not closed yet
+        uint32_t segmentsFailed = 0;
+        std::vector<Segment> segments;
+        EventId deadline;
+    };
+
+    struct Late {
+        std::vector<double> sum;
+        ModelContributors contributors;
+        uint32_t summed = 0;
+    };
+
+    Slot&
+    SlotOf(uint32_t iteration)
+    {
+        return m_slots[iteration % m_slots.size()];
+    }
+
+    const Slot&
+    SlotOf(uint32_t iteration) const
+    {
+        return m_slots[iteration % m_slots.size()];
+    }
+
+    /**
+     * Open segment of a unit, nullptr if it isn't open
+     */
+    Segment*
+    Find(uint32_t unit);
+
+    const Segment*
+    Find(uint32_t unit) const;
+
+    /**
+     * Check the segment against the quorum, mark it ready, and failed if nothing was summed
+     */
+    bool
+    IsReady(Segment& segment) const;
+
+    /**
+     * Sum a late contribution into the next iteration, if the policy folds late updates
+     * @return False if it's dropped
+     */
+    bool
+    Fold(uint32_t unit, const ModelDataView& data);
+
+    void
+    OnDeadline(uint32_t iteration);
+
+private:
+    ModelSegmentation m_segmentation;
+    std::vector<Slot> m_slots;
+    StragglerPolicy m_policy;
+    ReadyHandler m_onDeadline;
+    uint32_t m_lastOpened = 0; // Highest iteration opened so far
+    std::map<uint32_t, Late> m_late; // Folded contributions to segments of an iteration not opened yet
+    CompletionStats m_stats;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // ITERATION_PIPELINE_HPP
@@ -0,0 +1,185 @@
+#ifndef MODEL_SEGMENTATION_HPP
+#define MODEL_SEGMENTATION_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * Split of a model of DataSize parameters into segments of at most SegmentSize parameters,
+ * each segment travelling in its own Data packet
+ *
+ * Every (iteration, segment) pair is one aggregation unit with its own uint32 key, so all per-seq
+ * state of the apps (interest queues, timeouts, partial sums) works per segment, and an aggregator
+ * reduces and forwards a segment as soon as all children's copies of it arrived. Units of one
+ * iteration are consecutive and unit == iteration when the model fits in one segment.
+ *
+ * Names are /<child>/<leaves>/data/<iteration>[/<segment>], the segment component is omitted
+ * for single-segment models so their names stay unchanged.
+ */
+class ModelSegmentation {
+public:
+    ModelSegmentation()
+        : ModelSegmentation(0, 0)
+    {
+    }
+
+    /**
+     * @param dataSize Number of model parameters
+     * @param segmentSize Max parameters per Data packet, 0 keeps the whole model in one packet
+     */
+    ModelSegmentation(size_t dataSize, size_t segmentSize)
+        : m_dataSize(dataSize)
+        , m_segmentSize(segmentSize == 0 || segmentSize > dataSize ? dataSize : segmentSize)
+        , m_segmentCount(m_segmentSize == 0 ? 1 : static_cast<uint32_t>((dataSize + m_segmentSize - 1) / m_segmentSize))
+    {
+    }
+
+    uint32_t
+    GetSegmentCount() const
+    {
+        return m_segmentCount;
+    }
+
+    /**
+     * Index of the first model parameter carried by the segment
+     */
+    size_t
+    GetSegmentOffset(uint32_t segment) const
+    {
+        return static_cast<size_t>(segment) * m_segmentSize;
+    }
+
+    /**
+     * Number of model parameters carried by the segment, the last one may be shorter
+     */
+    size_t
+    GetSegmentLength(uint32_t segment) const
+    {
+        size_t offset = GetSegmentOffset(segment);
+        return offset >= m_dataSize ? 0 : std::min(m_segmentSize, m_dataSize - offset);
+    }
+
+    /**
+     * @param iteration Iteration number, starting from 1
+     * @param segment Segment index, starting from 0
+     */
+    uint32_t
+    ToUnit(uint32_t iteration, uint32_t segment) const
+    {
+        return (iteration - 1) * m_segmentCount + segment + 1;
+    }
+
+    uint32_t
+    GetIteration(uint32_t unit) const
+    {
+        return (unit - 1) / m_segmentCount + 1;
+    }
+
+    uint32_t
+    GetSegment(uint32_t unit) const
+    {
+        return (unit - 1) % m_segmentCount;
+    }
+
+    /**
+     * Number of parameters of the unit's segment
+     */
+    size_t
+    GetUnitLength(uint32_t unit) const
+    {
+        return GetSegmentLength(GetSegment(unit));
+    }
+
+    bool
+    IsLastSegment(uint32_t unit) const
+    {
+        return GetSegment(unit) + 1 == m_segmentCount;
+    }
+
+    /**
+     * Append iteration (sequence number component) and, for multi-segment models, segment
+     */
+    void
+    AppendUnit(Name& name, uint32_t unit) const
+    {
+        name.appendSequenceNumber(GetIteration(unit));
+        if (m_segmentCount > 1) {
+            name.appendSegment(GetSegment(unit));
+        }
+    }
+
+    /**
+     * Extract the unit from a data name built by AppendUnit()
+     */
+    uint32_t
+    ParseUnit(const Name& name) const
+    {
+        ssize_t last = LastIndex(name);
+        if (HasSegment(name)) {
+            return ToUnit(static_cast<uint32_t>(name.get(last - 1).toSequenceNumber()),
+                          static_cast<uint32_t>(name.get(last).toSegment()));
+        }
+        return ToUnit(static_cast<uint32_t>(name.get(last).toSequenceNumber()), 0);
+    }
+
+    /**
+     * Segment index carried by a name, 0 if it has no segment component
+     */
+    static uint32_t
+    ParseSegment(const Name& name)
+    {
+        return HasSegment(name) ? static_cast<uint32_t>(name.get(LastIndex(name)).toSegment()) : 0;
+    }
+
+    /**
+     * Sequence number of an initialization name, /<node>/initialization/<seq>
+     */
+    static uint64_t
+    ParseInitSeq(const Name& name)
+    {
+        return name.get(LastIndex(name)).toSequenceNumber();
+    }
+
+    /**
+     * Packet type component ("data", "initialization"), located before iteration and segment
+     */
+    static const name::Component&
+    GetTypeComponent(const Name& name)
+    {
+        return name.get(LastIndex(name) - (HasSegment(name) ? 2 : 1));
+    }
+
+private:
+    /**
+     * Index of the last component of the name as built by the apps, skips the parameters digest
+     * appended to interests which carry ApplicationParameters (tree distribution)
+     */
+    static ssize_t
+    LastIndex(const Name& name)
+    {
+        return !name.empty() && name.get(-1).isParametersSha256Digest() ? -2 : -1;
+    }
+
+    static bool
+    HasSegment(const Name& name)
+    {
+        ssize_t last = LastIndex(name);
+        return static_cast<ssize_t>(name.size()) + last + 1 >= 3 && name.get(last).isSegment();
+    }
+
+private:
+    size_t m_dataSize;
+    size_t m_segmentSize;
+    uint32_t m_segmentCount;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // MODEL_SEGMENTATION_HPP
@@ -188,6 +188,42 @@ Aggregator::GetTypeId(void)
                         IntegerValue(150),
                         MakeIntegerAccessor(&Aggregator::m_dataSize),
                         MakeIntegerChecker<int>())
+            .AddAttribute("PayloadEncoding",
+                        "Encoding of the aggregated model parameters sent upstream (fp64, fp32, fp16, bf16, int8, topk)",
+                        EnumValue(PAYLOAD_FP64),
+                        MakeEnumAccessor(&Aggregator::m_payloadEncoding),
+                        MakeEnumChecker(PAYLOAD_FP64, "fp64", PAYLOAD_FP32, "fp32", PAYLOAD_FP16, "fp16",
+                                        PAYLOAD_BF16, "bf16", PAYLOAD_INT8, "int8", PAYLOAD_TOPK, "topk"))
+            .AddAttribute("SegmentSize",
+                        "Max number of model parameters per data packet, 0 sends the whole model in one packet",
+                        IntegerValue(0),
+                        MakeIntegerAccessor(&Aggregator::m_segmentSize),
+                        MakeIntegerChecker<int>(0))
+            .AddAttribute("PipelineDepth",
+                        "Max number of iterations aggregated at once, 0 derives it from DataQueueSize",
+                        IntegerValue(0),
+                        MakeIntegerAccessor(&Aggregator::m_pipelineDepth),
+                        MakeIntegerChecker<int>(0))
+            .AddAttribute("StragglerPolicy",
+                        "When a segment is aggregated before every child contributed (wait-all, deadline, quorum)",
+                        EnumValue(STRAGGLER_WAIT_ALL),
+                        MakeEnumAccessor(&Aggregator::m_stragglerMode),
+                        MakeEnumChecker(STRAGGLER_WAIT_ALL, "wait-all", STRAGGLER_DEADLINE, "deadline", STRAGGLER_QUORUM, "quorum"))
+            .AddAttribute("CompletionQuorum",
+                        "Quorum policy: fraction of the children a segment waits for, rounded up",
+                        DoubleValue(1.0),
+                        MakeDoubleAccessor(&Aggregator::m_completionQuorum),
+                        MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("CompletionDeadline",
+                        "Deadline and quorum policies: time after the start of an iteration at which it's aggregated with what arrived, 0 disables it",
+                        StringValue("0s"),
+                        MakeTimeAccessor(&Aggregator::m_completionDeadline),
+                        MakeTimeChecker())
+            .AddAttribute("LateUpdates",
+                        "Contributions arriving after their segment was aggregated are dropped, or folded into the next iteration",
+                        EnumValue(LATE_UPDATES_DROP),
+                        MakeEnumAccessor(&Aggregator::m_lateUpdates),
+                        MakeEnumChecker(LATE_UPDATES_DROP, "drop", LATE_UPDATES_FOLD, "fold"))
             .AddAttribute("AggQueueThreshold",
                         "Data queue threshold",
                         IntegerValue(10),
@@ -229,6 +265,7 @@ Aggregator::Aggregator()
     , downstreamRetxCount(0)
     , interestOverflow(0)
     , dataOverflow(0)
+    , dataOverflowIteration(0)
     , nackCount(0)
     , totalInterestThroughput(0)
     , totalDataThroughput(0)
@@ -240,69 +277,47 @@ Aggregator::Aggregator()
     , round(0)
     , totalAggregateTime(0)
     , iterationCount(0)
+    , failedIterationCount(0)
 {
     m_rtt = CreateObject<RttMeanDeviation>();
+    m_timeouts.SetCallbacks([this] (uint32_t flowId) { return m_flows[flowId].rtoThreshold; },
+                            [this] (uint32_t flowId, uint32_t seq) { OnTimeout(flowId, seq); });
 }
 
 
 
-std::pair<std::string, std::vector<std::string>>
-Aggregator::aggTreeProcessSingleString(const std::string& input)
+bool
+Aggregator::aggTreeProcessMessage(const TreeAssignment& assignment, std::map<std::string, std::vector<std::string>>& result)
 {
-    std::istringstream iss(input);
-    std::string segment;
-    std::vector<std::string> segments;
-
-    // Use getline to split the string by '.'
-    while (getline(iss, segment, '.')) {
-        segments.push_back(segment);
-    }
-
-    // Check if there are enough segments to form a key and a vector
-    if (segments.size() > 1) {
-        std::string key = segments[0];
-        std::vector<std::string> values(segments.begin() + 1, segments.end());
-        return {key, values};
-    }
-
-    return {};  // Return an empty pair if not enough segments
-}
-
+    result.clear();
 
+    for (const auto& [childId, leafIds] : assignment) {
+        std::string child = treeNodeName(childId);
+        if (child.empty()) {
+            return false;
+        }
 
-std::map<std::string, std::vector<std::string>>
-Aggregator::aggTreeProcessStrings(const std::vector<std::string>& inputs)
-{
-    std::map<std::string, std::vector<std::string>> result;
-
-    for (const std::string& input : inputs) {
-        auto entry = aggTreeProcessSingleString(input);
-        if (!entry.first.empty()) {
-            // Append all elements from entry.second to the vector at result[entry.first]
-            result[entry.first].insert(
-                result[entry.first].end(),
-                entry.second.begin(),
-                entry.second.end()
-            );
+        std::vector<std::string>& leaves = result[child];
+        for (uint32_t leafId : leafIds) {
+            leaves.push_back(treeNodeName(leafId));
+            if (leaves.back().empty()) {
+                return false;
+            }
         }
     }
 
-    return result;
+    return true;
 }
 
 
 
 double 
-Aggregator::getDataQueueSize(std::string prefix)
+Aggregator::getDataQueueSize(uint32_t flowId)
 {
-    double queueSize = 0.0;
-    for (const auto& [seq, aggList] : map_agg_oldSeq_newName) {
-        if (std::find(aggList.begin(), aggList.end(), prefix) == aggList.end()) {
-            queueSize += 1.0;
-        }
-    }
+    FlowState& flow = m_flows[flowId];
+    double queueSize = static_cast<double>(m_pipeline.ContributedCount(flowId));
 
-    NS_LOG_DEBUG("Flow: " << prefix << " -> Data queue size: " << queueSize);
+    NS_LOG_DEBUG("Flow: " << flow.prefix << " -> Data queue size: " << queueSize);
     return queueSize;
 }
 
@@ -354,52 +369,33 @@ Aggregator::GetAggregateTimeAverage()
 
 
 
-void
-Aggregator::CheckRetxTimeout()
-{
-    Time now = Simulator::Now();
-
-    for (auto it = m_timeoutCheck.begin(); it != m_timeoutCheck.end();){
-        std::string name = it->first;
-        std::string flow = make_shared<Name>(name)->get(0).toUri();
-        if (now - it->second > RTO_threshold[flow]) {
-            it = m_timeoutCheck.erase(it);
-            OnTimeout(name);
-        } else {
-            ++it;
-        }
-    }
-    m_retxEvent = Simulator::Schedule(m_retxTimer, &Aggregator::CheckRetxTimeout, this);
-}
-
-
-
 bool
-Aggregator::CongestionDetection(std::string prefix, int64_t responseTime)
+Aggregator::CongestionDetection(uint32_t flowId, int64_t responseTime)
 {
+    FlowState& flow = m_flows[flowId];
     //* Normal usage is "push_back" "pop_front"
     // Update RTT windowed queue and historical estimation
-    RTT_windowed_queue[prefix].push_back(responseTime);
-    RTT_count[prefix]++;
+    flow.rttWindowedQueue.push_back(responseTime);
+    flow.rttCount++;
 
-    if (RTT_windowed_queue[prefix].size() > m_smooth_window_size) {
-        int64_t transitionValue = RTT_windowed_queue[prefix].front();
-        RTT_windowed_queue[prefix].pop_front();
+    if (flow.rttWindowedQueue.size() > m_smooth_window_size) {
+        int64_t transitionValue = flow.rttWindowedQueue.front();
+        flow.rttWindowedQueue.pop_front();
 
-        if (RTT_historical_estimation[prefix] == 0) {
-            RTT_historical_estimation[prefix] = transitionValue;
+        if (flow.rttHistoricalEstimation == 0) {
+            flow.rttHistoricalEstimation = transitionValue;
         } else {
-            RTT_historical_estimation[prefix] = m_EWMAFactor * transitionValue + (1 - m_EWMAFactor) * RTT_historical_estimation[prefix];
+            flow.rttHistoricalEstimation = m_EWMAFactor * transitionValue + (1 - m_EWMAFactor) * flow.rttHistoricalEstimation;
         }
     }
     else {
-        NS_LOG_DEBUG("RTT_windowed_queue size: " << RTT_windowed_queue[prefix].size());
+        NS_LOG_DEBUG("RTT_windowed_queue size: " << flow.rttWindowedQueue.size());
     }
 
     // Detect congestion
-    if (RTT_count[prefix] >= 2 * m_smooth_window_size) {
+    if (flow.rttCount >= 2 * m_smooth_window_size) {
         int64_t pastRTTAverage = 0;
-        for (int64_t pastRTT : RTT_windowed_queue[prefix]) {
+        for (int64_t pastRTT : flow.rttWindowedQueue) {
             pastRTTAverage += pastRTT;
         }
         pastRTTAverage /= m_smooth_window_size;
@@ -407,7 +403,7 @@ Aggregator::CongestionDetection(std::string prefix, int64_t responseTime)
         // Enable RTT-estimation for scheduler
         isRTTEstimated = true;
 
-        int64_t rtt_threshold = m_thresholdFactor * RTT_historical_estimation[prefix];
+        int64_t rtt_threshold = m_thresholdFactor * flow.rttHistoricalEstimation;
         if (rtt_threshold < pastRTTAverage) {
             return true;
         } else {
@@ -415,7 +411,7 @@ Aggregator::CongestionDetection(std::string prefix, int64_t responseTime)
         }
     }
     else {
-        NS_LOG_DEBUG("RTT_count: " << RTT_count[prefix]);
+        NS_LOG_DEBUG("RTT_count: " << flow.rttCount);
         return false;
     }
 }
@@ -423,50 +419,54 @@ Aggregator::CongestionDetection(std::string prefix, int64_t responseTime)
 
 
 void
-Aggregator::RTOMeasure(std::string prefix, int64_t resTime)
+Aggregator::RTOMeasure(uint32_t flowId, int64_t resTime)
 {
-    if (roundRTT[prefix] == 0) {
-        RTTVAR[prefix] = resTime / 2;
-        SRTT[prefix] = resTime;
+    FlowState& flow = m_flows[flowId];
+    if (flow.roundRTT == 0) {
+        flow.rttvar = resTime / 2;
+        flow.srtt = resTime;
     } else {
-        RTTVAR[prefix] = 0.75 * RTTVAR[prefix] + 0.25 * std::abs(SRTT[prefix] - resTime); // RTTVAR = (1 - b) * RTTVAR + b * |SRTT - RTTsample|, where b = 0.25
-        SRTT[prefix] = 0.875 * SRTT[prefix] + 0.125 * resTime; // SRTT = (1 - a) * SRTT + a * RTTsample, where a = 0.125
+        flow.rttvar = 0.75 * flow.rttvar + 0.25 * std::abs(flow.srtt - resTime); // RTTVAR = (1 - b) * RTTVAR + b * |SRTT - RTTsample|, where b = 0.25
+        flow.srtt = 0.875 * flow.srtt + 0.125 * resTime; // SRTT = (1 - a) * SRTT + a * RTTsample, where a = 0.125
     }
-    roundRTT[prefix]++;
-    int64_t RTO = SRTT[prefix] + 4 * RTTVAR[prefix]; // RTO = SRTT + K * RTTVAR, where K = 4
+    flow.roundRTT++;
+    int64_t RTO = flow.srtt + 4 * flow.rttvar; // RTO = SRTT + K * RTTVAR, where K = 4
 
-    //RTO_threshold[prefix] = MicroSeconds(4 * RTO);
-    RTO_threshold[prefix] = MicroSeconds(2 * RTO);
+    //flow.rtoThreshold = MicroSeconds(4 * RTO);
+    flow.rtoThreshold = MicroSeconds(2 * RTO);
+    m_timeouts.UpdateTimeout(flowId);
 }
 
 
 
 void
-Aggregator::OnTimeout(std::string nameString)
+Aggregator::OnTimeout(uint32_t flowId, uint32_t seq)
 {
-    shared_ptr<Name> name = make_shared<Name>(nameString);
-    std::string name_sec0 = name->get(0).toUri();
-    uint32_t seq = name->get(-1).toSequenceNumber();
-    NS_LOG_DEBUG("Flow " << name_sec0 << " - name -> " << nameString <<": timeout.");
+    FlowState& flow = m_flows[flowId];
+    NS_LOG_DEBUG("Flow " << flow.prefix << " - seq -> " << seq << ": timeout.");
 
-    if (m_inFlight[name_sec0] > 0) {
-        m_inFlight[name_sec0]--;
+    if (flow.inFlight > 0) {
+        flow.inFlight--;
     } else {
         NS_LOG_DEBUG("Error when timeout, please exit and check!");
         Simulator::Stop();
         return;
     }
 
-    // Handle timeout on next CC round
-    // QueueSize-based CC
-    timeoutSignal[name_sec0] = true;
-    
-    if (interestQueue.find(name_sec0) == interestQueue.end()) {
-        NS_LOG_DEBUG("Error when timeout, please exit and check!");
-        Simulator::Stop();
+    // The child was removed from the tree, the seq isn't expected from it anymore
+    if (!flow.active) {
+        return;
+    }
+
+    // The segment was sent downstream without this child (straggler tolerance)
+    if (m_agg_newDataName.find(seq) == m_agg_newDataName.end()) {
         return;
     }
-    interestQueue[name_sec0].push_front(seq);
+
+    // Handle timeout on next CC round
+    // QueueSize-based CC
+    flow.timeoutSignal = true;
+    flow.interestQueue.push_front(seq);
 
     suspiciousPacketCount++;
 }
@@ -477,11 +477,6 @@ void
 Aggregator::SetRetxTimer(Time retxTimer)
 {
     m_retxTimer = retxTimer;
-    if (m_retxEvent.IsRunning()) {
-        Simulator::Remove(m_retxEvent);
-    }
-
-    m_retxEvent = Simulator::Schedule(m_retxTimer, &Aggregator::CheckRetxTimeout, this);
 }
 
 
@@ -499,6 +494,18 @@ Aggregator::StartApplication()
 {
     //NS_LOG_FUNCTION_NOARGS();
     App::StartApplication();
+    m_segmentation = ModelSegmentation(m_dataSize, m_segmentSize);
+
+    // By default as many iterations as the data queue holds segments
+    uint32_t depth = m_pipelineDepth > 0 ? m_pipelineDepth : m_dataQueue / m_segmentation.GetSegmentCount();
+    StragglerPolicy policy;
+    policy.mode = m_stragglerMode;
+    policy.quorum = m_completionQuorum;
+    policy.deadline = m_completionDeadline;
+    policy.lateUpdates = m_lateUpdates;
+    m_pipeline.Configure(m_segmentation, depth, policy,
+                         [this] (uint32_t seq) { SegmentAggregated(seq); });
+
     FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
 }
 
@@ -509,72 +516,30 @@ Aggregator::StopApplication()
 {
     // Cancel packet generation - can be a way to stop simulation gracefully?
     //Simulator::Cancel(m_sendEvent);
+    m_timeouts.Clear();
     App::StopApplication();
 }
 
 
 
-void Aggregator::Aggregate(const ModelData& data, const uint32_t& seq) {
-    // first initialization
-    if (sumParameters.find(seq) == sumParameters.end()){
-        sumParameters[seq] = std::vector<double>(m_dataSize, 0.0f);
-    }
-
-    // Aggregate data
-    std::transform(sumParameters[seq].begin(), sumParameters[seq].end(), data.parameters.begin(), sumParameters[seq].begin(), std::plus<double>());
-
-    // Aggregate congestion signal
-    congestionSignalList[seq].insert(congestionSignalList[seq].end(), data.congestedNodes.begin(), data.congestedNodes.end());
-}
-
-
-
-ModelData 
-Aggregator::GetMean(const uint32_t& seq)
-{
-    ModelData result;
-    if (sumParameters.find(seq) != sumParameters.end()) {
-        result.parameters = sumParameters[seq];
-
-/*         // Encapsulate qsf as meta data
-        double maxQsf = 0;
-        for (const auto& [key, value] : aggregationMap) {
-            maxQsf = std::max(maxQsf, static_cast<double>(interestQueue[key].size()));
-        }
-
-        maxQsf = std::max(maxQsf, static_cast<double>(sumParameters.size()));
-
-        NS_LOG_INFO("Final QSF: " << maxQsf);
-        result.qsf = maxQsf;
-
-        // Add congestionSignal of current node if necessary, currently disable!
-        if (congestionSignal[seq]) {
-            congestionSignalList[seq].push_back(m_prefix.toUri());
-            NS_LOG_DEBUG("Congestion detected on current node!");
-        }
-        result.congestedNodes = congestionSignalList[seq]; */
-    } else {
-        NS_LOG_DEBUG("Error when get aggregation result, please exit and check!");
-        Simulator::Stop();
-    }
-
-    return result;
-}
-
-
-
 void
 Aggregator::OnNack(shared_ptr<const lp::Nack> nack)
 {
     App::OnNack(nack);
     NS_LOG_INFO("NACK received for: " << nack->getInterest().getName() << ", reason: " << nack->getReason());
 
-    std::string dataName = nack->getInterest().getName().toUri();
-    std::string name_sec0 = nack->getInterest().getName().get(0).toUri();
-    uint32_t seq = nack->getInterest().getName().get(-1).toSequenceNumber();
+    uint32_t flowId = m_flows.Find(nack->getInterest().getName());
+    uint32_t seq = m_segmentation.ParseUnit(nack->getInterest().getName());
 
-    if (m_inFlight[name_sec0] > 0) {
-        m_inFlight[name_sec0]--;
+    if (flowId == FlowTable::INVALID) {
+        NS_LOG_DEBUG("NACK of unknown flow, please exit and check!");
+        Simulator::Stop();
+        return;
+    }
+    FlowState& flow = m_flows[flowId];
+
+    if (flow.inFlight > 0) {
+        flow.inFlight--;
     } else {
         NS_LOG_DEBUG("InFlight number error, please exit and check!");
         Simulator::Stop();
@@ -582,13 +547,12 @@ Aggregator::OnNack(shared_ptr<const lp::Nack> nack)
     }
 
     // Handle nack
-    interestQueue[name_sec0].push_front(seq);
-    nackSignal[name_sec0] = true;
+    flow.interestQueue.push_front(seq);
+    flow.nackSignal = true;
 
 
     // Stop tracing rtt and timeout
-    rttStartTime.erase(dataName);
-    m_timeoutCheck.erase(dataName);
+    m_timeouts.Remove(flowId, seq);
     nackCount++;
 }
 
@@ -628,26 +592,27 @@ Aggregator::GetSeqMax() const
 
 
 void
-Aggregator::WindowIncrease(std::string prefix)
+Aggregator::WindowIncrease(uint32_t flowId)
 {
+    FlowState& flow = m_flows[flowId];
     if (m_ccAlgorithm == CcAlgorithm::AIMD) {
         // If cwnd is larger than 8, check whether current bottleneck is because of downstream slow interest, if so, stop increasing cwnd
-/*         if (m_window[prefix] > 8.0 && m_window[prefix] - m_inFlight[prefix] > 30.0){
+/*         if (flow.window > 8.0 && flow.window - flow.inFlight > 30.0){
             NS_LOG_DEBUG("Current bottleneck is downstream slow interest, stop increasing cwnd.");
         } else  */
         if (m_useWIS){
-            if (m_window[prefix] < m_ssthresh[prefix]) {
-                m_window[prefix] += 1.0;
+            if (flow.window < flow.ssthresh) {
+                flow.window += 1.0;
             } else {
-                m_window[prefix] += (1.0 / m_window[prefix]);
+                flow.window += (1.0 / flow.window);
             }
-            NS_LOG_DEBUG("Window size of flow '" << prefix << "' is increased to " << m_window[prefix]);        
+            NS_LOG_DEBUG("Window size of flow '" << flow.prefix << "' is increased to " << flow.window);        
         } else {
-            m_window[prefix] += 1.0;
-            NS_LOG_DEBUG("Window size of flow '" << prefix << "' is increased to " << m_window[prefix]);
+            flow.window += 1.0;
+            NS_LOG_DEBUG("Window size of flow '" << flow.prefix << "' is increased to " << flow.window);
         }        
     } else if (m_ccAlgorithm == CcAlgorithm::CUBIC) {
-            CubicIncerase(prefix);
+            CubicIncerase(flowId);
     } else {
         NS_LOG_DEBUG("CC alogrithm can't be recognized, please check!");
         Simulator::Stop();
@@ -657,41 +622,42 @@ Aggregator::WindowIncrease(std::string prefix)
 
 
 void
-Aggregator::WindowDecrease(std::string prefix, std::string type)
+Aggregator::WindowDecrease(uint32_t flowId, std::string type)
 {
+    FlowState& flow = m_flows[flowId];
     // Track last window decrease time
-    lastWindowDecreaseTime[prefix] = Simulator::Now();
+    flow.lastWindowDecreaseTime = Simulator::Now();
 
     // AIMD for timeout
     if (m_ccAlgorithm == CcAlgorithm::AIMD) {
         if (type == "timeout") {
-            m_ssthresh[prefix] = m_window[prefix] * m_alpha;
-            m_window[prefix] = m_ssthresh[prefix];
+            flow.ssthresh = flow.window * m_alpha;
+            flow.window = flow.ssthresh;
         }
         else if (type == "nack") {
-            m_ssthresh[prefix] = m_window[prefix] * m_alpha;
-            m_window[prefix] = m_ssthresh[prefix];
+            flow.ssthresh = flow.window * m_alpha;
+            flow.window = flow.ssthresh;
         }
         else if (type == "LocalCongestion") {
-            m_ssthresh[prefix] = m_window[prefix] * m_beta;
-            m_window[prefix] = m_ssthresh[prefix];
+            flow.ssthresh = flow.window * m_beta;
+            flow.window = flow.ssthresh;
         }
         else if (type == "RemoteCongestion") {
-            m_ssthresh[prefix] = m_window[prefix] * m_gamma;
-            m_window[prefix] = m_ssthresh[prefix];
+            flow.ssthresh = flow.window * m_gamma;
+            flow.window = flow.ssthresh;
         }      
     }
     else if (m_ccAlgorithm == CcAlgorithm::CUBIC) {
         if (type == "timeout") {
-            m_ssthresh[prefix] = m_window[prefix] * m_alpha;
-            m_window[prefix] = m_ssthresh[prefix];
+            flow.ssthresh = flow.window * m_alpha;
+            flow.window = flow.ssthresh;
         }
         else if (type == "nack") {
-            m_ssthresh[prefix] = m_window[prefix] * m_alpha;
-            m_window[prefix] = m_ssthresh[prefix];
+            flow.ssthresh = flow.window * m_alpha;
+            flow.window = flow.ssthresh;
         }        
         else if (type == "LocalCongestion") {
-            CubicDecrease(prefix, type);
+            CubicDecrease(flowId, type);
         }
         else if (type == "RemoteCongestion") {
             // Do nothing, currently disabled
@@ -702,28 +668,29 @@ Aggregator::WindowDecrease(std::string prefix, std::string type)
     }
 
     // Window size can't be reduced below 1
-    if (m_window[prefix] < m_minWindow) {
-        m_window[prefix] = m_minWindow;
+    if (flow.window < m_minWindow) {
+        flow.window = m_minWindow;
     }
-    NS_LOG_DEBUG("Window size of flow '" << prefix << "' is decreased to " << m_window[prefix] << ". Reason: " << type); 
+    NS_LOG_DEBUG("Window size of flow '" << flow.prefix << "' is decreased to " << flow.window << ". Reason: " << type); 
 }
 
 
 
 void
-Aggregator::CubicIncerase(std::string prefix) 
+Aggregator::CubicIncerase(uint32_t flowId) 
 {
+    FlowState& flow = m_flows[flowId];
     // 1. Time since last congestion event in Seconds, round the value to 3 decimal places
-    const double t = std::round(1000 * (Simulator::Now().GetMicroSeconds() - lastWindowDecreaseTime[prefix].GetMicroSeconds()) / 1e9) / 1000;
+    const double t = std::round(1000 * (Simulator::Now().GetMicroSeconds() - flow.lastWindowDecreaseTime.GetMicroSeconds()) / 1e9) / 1000;
     NS_LOG_DEBUG("Time since last congestion event: " << t);
 
     // 2. Time it takes to increase the window to cubic_wmax
     // K = cubic_root(W_max*(1-beta_cubic)/C) (Eq. 2)
-    const double k = std::cbrt(m_cubicWmax[prefix] * (1 - m_cubicBeta) / m_cubic_c);
+    const double k = std::cbrt(flow.cubicWmax * (1 - m_cubicBeta) / m_cubic_c);
     NS_LOG_DEBUG("K value: " << k);
 
     // 3. Target: W_cubic(t) = C*(t-K)^3 + W_max (Eq. 1)
-    const double w_cubic = m_cubic_c * std::pow(t - k, 3) + m_cubicWmax[prefix];
+    const double w_cubic = m_cubic_c * std::pow(t - k, 3) + flow.cubicWmax;
     NS_LOG_DEBUG("Cubic increase target: " << w_cubic);
 
     // 4. Estimate of Reno Increase (Currently Disabled)
@@ -734,12 +701,12 @@ Aggregator::CubicIncerase(std::string prefix)
     //constexpr double w_est = 0.0;
 
     //? Original cubic increase
-/*     if (m_cubicWmax[prefix] <= 0) {
+/*     if (flow.cubicWmax <= 0) {
         NS_LOG_DEBUG("Error! Wmax is less than 0, check cubic increase!");
         Simulator::Stop();
     }
 
-    double cubic_increment = std::max(w_cubic, 0.0) - m_window[prefix];
+    double cubic_increment = std::max(w_cubic, 0.0) - flow.window;
     // Cubic increment must be positive:
     // Note: This change is not part of the RFC, but I added it to improve performance.
     if (cubic_increment < 0) {
@@ -747,19 +714,19 @@ Aggregator::CubicIncerase(std::string prefix)
     }
 
     NS_LOG_DEBUG("Cubic increment: " << cubic_increment);
-    m_window[prefix] += cubic_increment / m_window[prefix]; */
+    flow.window += cubic_increment / flow.window; */
 
     //? Customized cubic increase
-    if (m_window[prefix] < m_ssthresh[prefix]) {
-        m_window[prefix] += 1.0;
+    if (flow.window < flow.ssthresh) {
+        flow.window += 1.0;
     }
     else {
-        if (m_cubicWmax[prefix] <= 0) {
+        if (flow.cubicWmax <= 0) {
             NS_LOG_DEBUG("Error! Wmax is less than 0, check cubic increase!");
             Simulator::Stop();
         }
 
-        double cubic_increment = std::max(w_cubic, 0.0) - m_window[prefix];
+        double cubic_increment = std::max(w_cubic, 0.0) - flow.window;
         // Cubic increment must be positive:
         // Note: This change is not part of the RFC, but I added it to improve performance.
         if (cubic_increment < 0) {
@@ -767,22 +734,23 @@ Aggregator::CubicIncerase(std::string prefix)
         }
 
         NS_LOG_DEBUG("Cubic increment: " << cubic_increment);
-        m_window[prefix] += cubic_increment / m_window[prefix];
+        flow.window += cubic_increment / flow.window;
     }
 
-    NS_LOG_DEBUG("Window size of flow '" << prefix << "' is increased to " << m_window[prefix]);
+    NS_LOG_DEBUG("Window size of flow '" << flow.prefix << "' is increased to " << flow.window);
 }
 
 
 
 void
-Aggregator::CubicDecrease(std::string prefix, std::string type)
+Aggregator::CubicDecrease(uint32_t flowId, std::string type)
 {
+    FlowState& flow = m_flows[flowId];
     //? Traditional cubic window decrease
-    m_cubicWmax[prefix] = m_window[prefix];
-    m_ssthresh[prefix] = m_window[prefix] * m_cubicBeta;
-    m_ssthresh[prefix] = std::max<double>(m_ssthresh[prefix], m_minWindow);
-    m_window[prefix] = m_window[prefix] * m_cubicBeta;
+    flow.cubicWmax = flow.window;
+    flow.ssthresh = flow.window * m_cubicBeta;
+    flow.ssthresh = std::max<double>(flow.ssthresh, m_minWindow);
+    flow.window = flow.window * m_cubicBeta;
 
     //? Cubic with fast convergence
 /*     const double FAST_CONV_DIFF = 1.0; // In percent
@@ -813,19 +781,18 @@ Aggregator::OnInterest(shared_ptr<const Interest> interest)
     NS_LOG_DEBUG("The incoming interest packet size is: " << interest->wireEncode().size());
     App::OnInterest(interest);
 
-    std::string interestType = interest->getName().get(-2).toUri();
+    AggregationName parsed = AggregationNameCodec::Parse(interest->getName(), m_flows, m_segmentation);
 
-    if (interestType == "data") {
-        std::string originalName = interest->getName().toUri();
-        uint32_t seq = interest->getName().get(-1).toSequenceNumber();
+    if (parsed.type == AggregationPacketType::DATA) {
+        uint32_t seq = parsed.seq;
         bool isQueueFull = false;
         bool isDownstreamRetx = false;
 
         //? Check whether interest queue is full
-        for (const auto& [key, value] : aggregationMap) {
-            if (interestQueue[key].size() >= m_interestQueue) {
+        for (const auto& flow : m_flows) {
+            if (flow.active && flow.interestQueue.size() >= m_interestQueue) {
                 isQueueFull = true;
-                NS_LOG_DEBUG("Interest queue of flow " << key << " is full, drop it - " << interest->getName().toUri());
+                NS_LOG_DEBUG("Interest queue of flow " << flow.prefix << " is full, drop it - " << interest->getName().toUri());
                 interestOverflow++;
                 
                 // Interest queue overflow, send NACK back to downstream for notification
@@ -835,7 +802,7 @@ Aggregator::OnInterest(shared_ptr<const Interest> interest)
         }
 
         //? Check whether the interest is retransmission from downstream
-        if (m_agg_newDataName.find(seq) != m_agg_newDataName.end() || map_agg_oldSeq_newName.find(seq) != map_agg_oldSeq_newName.end()) {
+        if (m_agg_newDataName.find(seq) != m_agg_newDataName.end()) {
             isDownstreamRetx = true;
             NS_LOG_DEBUG("This is a retransmission interest from downstream, drop it - " << interest->getName().toUri());
             downstreamRetxCount++;
@@ -845,16 +812,22 @@ Aggregator::OnInterest(shared_ptr<const Interest> interest)
         // If queue isn't full, perform interest splitting
         if (!isQueueFull && !isDownstreamRetx) {
             // Store original name into aggMap
-            m_agg_newDataName[seq] = interest->getName().toUri();
+            m_agg_newDataName[seq] = interest->getName();
 
             NS_LOG_DEBUG("New downstream interest's seq: " << seq);
 
+            // Segment already complete, e.g. its iteration's deadline expired before the interest arrived
+            if (m_readyUnrequested.erase(seq) > 0) {
+                SegmentAggregated(seq);
+                return;
+            }
+
             // Split interest
             InterestSplitting(seq);
 
             if (firstInterest) {
-                for (const auto& [key, value] : aggregationMap) {
-                    m_scheduleEvent[key] = Simulator::ScheduleNow(&Aggregator::ScheduleNextPacket, this, key);
+                for (uint32_t flowId = 0; flowId < m_flows.size(); ++flowId) {
+                    m_flows[flowId].scheduleEvent = Simulator::ScheduleNow(&Aggregator::ScheduleNextPacket, this, flowId);
                 }
                 firstInterest = false;
             }
@@ -864,35 +837,77 @@ Aggregator::OnInterest(shared_ptr<const Interest> interest)
             return;
         }
     } 
-    else if (interestType == "initialization") {
-        // Synchronize signal
-        treeSync = true;
-
-        // Record current time as simulation start time on aggregator
-        startSimulation = Simulator::Now();
-
-        // Read aggregation tree from init message
-        std::vector<std::string> inputs;
-        if (interest->getName().size() > 3) {
-            for (size_t i = 1; i < interest->getName().size() - 2; ++i) {
-                inputs.push_back(interest->getName().get(i).toUri());
-            }
+    else if (parsed.type == AggregationPacketType::INITIALIZATION) {
+        // Read aggregation tree from init message, it may be chunked over several interests of the same seq
+        const Block& parameters = interest->getApplicationParameters();
+        auto result = m_treeMessage.add(ModelSegmentation::ParseInitSeq(interest->getName()), parameters.value(), parameters.value_size());
+        if (result == TreeMessageAssembler::INVALID) {
+            NS_LOG_DEBUG("Error when parsing the tree message, please check! - " << interest->getName().toUri());
+            Simulator::Stop();
+            return;
         }
-        aggregationMap = aggTreeProcessStrings(inputs);
 
-        // Define for new congestion control
-        numChild = static_cast<int> (aggregationMap.size());
+        bool isComplete = result == TreeMessageAssembler::COMPLETE;
+        std::map<std::string, std::vector<std::string>> treeMap;
+        if (isComplete && !aggTreeProcessMessage(m_treeMessage.assignment(), treeMap)) {
+            NS_LOG_DEBUG("Tree message refers to an unknown node id, please check! - " << interest->getName().toUri());
+            Simulator::Stop();
+            return;
+        }
+
+        // A repeated initialization is a tree repair, only the flows that changed are touched
+        bool isRepair = treeSync;
+        if (isComplete) {
+            // Synchronize signal
+            treeSync = true;
+            aggregationMap = treeMap;
+
+            // Define for new congestion control
+            numChild = static_cast<int> (aggregationMap.size());
+        }
+
+        if (!isComplete) {
+            NS_LOG_DEBUG("Tree message chunk stored, waiting for the others - " << interest->getName().toUri());
+        } else if (aggregationMap.empty()) {
+            // An empty assignment removes the aggregator from the tree, every flow stops
+            NS_LOG_INFO("Aggregator is removed from the aggregation tree - " << interest->getName().toUri());
+            if (isRepair) {
+                UpdateFlows();
+            }
+        } else if (isRepair) {
+            NS_LOG_INFO("Aggregation tree is repaired, update the flows - " << interest->getName().toUri());
+            UpdateFlows();
+        } else {
+            // Record current time as simulation start time on aggregator
+            startSimulation = Simulator::Now();
+
+            // Intern the children into flow ids, all per-flow state is indexed by them
+            for (const auto& [child, leaves] : aggregationMap) {
+                m_flows.Add(child);
+            }
 
 
-        // After receiving aggregation tree, start basic initialization
-        // Initialize logging session
-        InitializeLogFile();
+            // After receiving aggregation tree, start basic initialization
+            // Initialize logging session
+            InitializeLogFile();
 
-        // Initialize parameteres
-        InitializeParameters();
+            // Initialize parameteres
+            InitializeParameters();
 
-        // Perform interest name splitting
-        InterestGenerator();
+            // Perform interest name splitting
+            InterestGenerator();
+
+            // Interests which overtook the tree (aggregator added by a repair) are split now
+            if (!m_agg_newDataName.empty()) {
+                for (const auto& [seq, name] : m_agg_newDataName) {
+                    InterestSplitting(seq);
+                }
+                for (uint32_t flowId = 0; flowId < m_flows.size(); ++flowId) {
+                    m_flows[flowId].scheduleEvent = Simulator::ScheduleNow(&Aggregator::ScheduleNextPacket, this, flowId);
+                }
+                firstInterest = false;
+            }
+        }
         
         //! nack works
 /*         auto nack = std::make_shared<ndn::lp::Nack>(*interest);
@@ -927,29 +942,35 @@ Aggregator::OnInterest(shared_ptr<const Interest> interest)
 
 
 void
-Aggregator::ScheduleNextPacket(std::string prefix)
+Aggregator::ScheduleNextPacket(uint32_t flowId)
 {
-    if (interestQueue.find(prefix) == interestQueue.end()) {
-        NS_LOG_DEBUG("Flow " << prefix << " is not found in the interest queue.");
+    if (flowId >= m_flows.size()) {
+        NS_LOG_DEBUG("Flow " << flowId << " is not found in the flow table.");
         Simulator::Stop();
         return;
     }
-    
-    if (!interestQueue.at(prefix).empty()) {
-        if (m_sendEvent[prefix].IsRunning()) {
-            Simulator::Remove(m_sendEvent[prefix]);
+
+    FlowState& flow = m_flows[flowId];
+    if (!flow.active) {
+        NS_LOG_DEBUG("Flow " << flow.prefix << " was removed from the tree, stop scheduling it.");
+        return;
+    }
+
+    if (!flow.interestQueue.empty()) {
+        if (flow.sendEvent.IsRunning()) {
+            Simulator::Remove(flow.sendEvent);
             NS_LOG_DEBUG("Suspicious, remove the previous event.");
         } 
-        m_sendEvent[prefix] = Simulator::ScheduleNow(&Aggregator::SendPacket, this, prefix);
+        flow.sendEvent = Simulator::ScheduleNow(&Aggregator::SendPacket, this, flowId);
 
-        double nextTime = 1/m_rateLimit[prefix]; // Unit: us
-        NS_LOG_INFO("Flow " << prefix << " -> Schedule next sending event after " << nextTime / 1000  << " ms.");
-        m_scheduleEvent[prefix] = Simulator::Schedule(MicroSeconds(nextTime), &Aggregator::ScheduleNextPacket, this, prefix);            
+        double nextTime = 1/flow.rateLimit; // Unit: us
+        NS_LOG_INFO("Flow " << flow.prefix << " -> Schedule next sending event after " << nextTime / 1000  << " ms.");
+        flow.scheduleEvent = Simulator::Schedule(MicroSeconds(nextTime), &Aggregator::ScheduleNextPacket, this, flowId);            
     } else{
         // Schedule again after 1/5 rate limit
-        double nextTime = 1/m_rateLimit[prefix]/5; // Unit: us
-        NS_LOG_INFO("Flow " << prefix << " -> Interest queue is empty. Schedule next sending event after " << nextTime / 1000 << " ms.");
-        m_scheduleEvent[prefix] = Simulator::Schedule(MicroSeconds(nextTime), &Aggregator::ScheduleNextPacket, this, prefix);
+        double nextTime = 1/flow.rateLimit/5; // Unit: us
+        NS_LOG_INFO("Flow " << flow.prefix << " -> Interest queue is empty. Schedule next sending event after " << nextTime / 1000 << " ms.");
+        flow.scheduleEvent = Simulator::Schedule(MicroSeconds(nextTime), &Aggregator::ScheduleNextPacket, this, flowId);
     }
 }
 
@@ -959,59 +980,148 @@ void
 Aggregator::InterestGenerator()
 {
     // Divide interests and push them into queue
+    vec_iteration.clear();
     for (const auto& [key, values] : aggregationMap) {
         std::string name_sec1;
-        std::string name_sec0_2;
         
         for (const auto& value : values) {
             name_sec1 += value + ".";
         }
         name_sec1.resize(name_sec1.size() - 1);
-        name_sec0_2 = "/" + key + "/" + name_sec1 + "/data";
-        NameSec0_2[key] = name_sec0_2;
-        vec_iteration.push_back(key); // Will be added to aggregation map later
+        uint32_t flowId = m_flows.Find(key);
+        m_flows[flowId].dataPrefix = AggregationNameCodec::MakeDataPrefix(key, name_sec1);
+        m_flows[flowId].leaves.clear();
+        for (const auto& value : values) {
+            m_flows[flowId].leaves.push_back(treeNodeId(value));
+        }
+        vec_iteration.push_back(flowId); // Will be added to aggregation map later
     }       
 }
 
 
 
+void
+Aggregator::UpdateFlows()
+{
+    std::vector<uint32_t> previous = vec_iteration;
+    uint32_t knownFlows = m_flows.size();
+    for (const auto& [child, leaves] : aggregationMap) {
+        m_flows.Add(child);
+    }
+    InterestGenerator();
+
+    // New children join first, a segment only waiting for a removed child must not be emitted without its
+    // replacement. They fetch the seqs in progress none of their producers was summed into yet, the
+    // downstream interests aren't repeated
+    for (uint32_t flowId : vec_iteration) {
+        FlowState& flow = m_flows[flowId];
+        if (std::find(previous.begin(), previous.end(), flowId) != previous.end() && flow.active) {
+            continue;
+        }
+
+        NS_LOG_INFO("Flow " << flow.prefix << " joins the aggregation tree.");
+        if (flowId >= knownFlows) {
+            OpenFlowLogs(flow);
+        }
+        InitializeFlow(flow);
+        flow.active = true;
+        std::set<uint32_t> seqs;
+        for (const auto& [seq, name] : m_agg_newDataName) {
+            if (!m_pipeline.IsOpen(seq)) {
+                seqs.insert(seq);
+            }
+        }
+        for (uint32_t seq : m_pipeline.AddChild(flowId, flow.leaves)) {
+            seqs.insert(seq);
+        }
+        flow.interestQueue.assign(seqs.begin(), seqs.end());
+        if (!firstInterest) {
+            flow.scheduleEvent = Simulator::ScheduleNow(&Aggregator::ScheduleNextPacket, this, flowId);
+        }
+    }
+
+    // Removed children, none of their seqs is expected anymore
+    std::vector<uint32_t> finished;
+    for (uint32_t flowId : previous) {
+        if (std::find(vec_iteration.begin(), vec_iteration.end(), flowId) != vec_iteration.end()) {
+            continue;
+        }
+
+        FlowState& flow = m_flows[flowId];
+        NS_LOG_INFO("Flow " << flow.prefix << " is removed from the aggregation tree.");
+        flow.active = false;
+        Simulator::Cancel(flow.scheduleEvent);
+        Simulator::Cancel(flow.sendEvent);
+        Simulator::Cancel(flow.rateEvent);
+        flow.interestQueue.clear();
+        for (uint32_t seq : m_pipeline.RemoveChild(flowId)) {
+            finished.push_back(seq);
+        }
+    }
+
+    // Segments which only waited for removed children are done, with a zero sum if nothing arrived
+    for (uint32_t seq : finished) {
+        SegmentAggregated(seq);
+    }
+}
+
+
+
 bool
 Aggregator::InterestSplitting(uint32_t seq)
 {
     // Divide interests and push them into queue
-    for (const auto& [key, value] : aggregationMap) {
-        interestQueue[key].push_back(seq);
+    for (auto& flow : m_flows) {
+        if (flow.active) {
+            flow.interestQueue.push_back(seq);
+        }
     }
+    return true;
 }
 
 
 
 void
-Aggregator::SendPacket(std::string prefix)
+Aggregator::SendPacket(uint32_t flowId)
 {
-    if (!interestQueue.at(prefix).empty()) {
-        uint32_t iteration = interestQueue.at(prefix).front();
-        interestQueue.at(prefix).pop_front();
-        shared_ptr<Name> name = make_shared<Name>(NameSec0_2[prefix]);
-        name->appendSequenceNumber(iteration);
+    FlowState& flow = m_flows[flowId];
+    if (!flow.interestQueue.empty()) {
+        // Segments already sent downstream without this flow (straggler tolerance) aren't requested anymore
+        while (!flow.interestQueue.empty() && m_agg_newDataName.find(flow.interestQueue.front()) == m_agg_newDataName.end()) {
+            flow.interestQueue.pop_front();
+        }
+        if (flow.interestQueue.empty()) {
+            return;
+        }
 
-        SendInterest(name);
+        uint32_t seq = flow.interestQueue.front();
+        uint32_t iteration = m_segmentation.GetIteration(seq);
 
-        // Check whether it's new iteration
-        if (aggregateStartTime.find(iteration) == aggregateStartTime.end()) {
-            aggregateStartTime[iteration] = Simulator::Now();
-            map_agg_oldSeq_newName[iteration] = vec_iteration;
+        // The first interest of an iteration opens it, it waits while the pipeline is full
+        if (!m_pipeline.Open(iteration, vec_iteration)) {
+            NS_LOG_INFO("Pipeline is full, flow " << flow.prefix << " waits before starting iteration " << iteration);
+            // Every flow retries on each pacing tick, the iteration is counted once
+            if (iteration > dataOverflowIteration) {
+                dataOverflowIteration = iteration;
+                dataOverflow++;
+            }
+            return;
         }
 
-        // Stop interest scheduling after reaching the last iteration
-        if (iteration == m_iteNum) {
+        flow.interestQueue.pop_front();
+        shared_ptr<Name> name = make_shared<Name>(AggregationNameCodec::MakeDataName(flow.dataPrefix, seq, m_segmentation));
+
+        SendInterest(name);
+
+        // Stop interest scheduling after reaching the last segment of the last iteration
+        if (iteration == m_iteNum && m_segmentation.IsLastSegment(seq)) {
             NS_LOG_INFO("All iterations have been finished, no need to schedule new interests.");
-            if (m_scheduleEvent[prefix].IsRunning()) {
-                Simulator::Remove(m_scheduleEvent[prefix]);
+            if (flow.scheduleEvent.IsRunning()) {
+                Simulator::Remove(flow.scheduleEvent);
             }
         }
     } else {
-        NS_LOG_DEBUG("Flow - " << prefix << ": interest queue is empty, this should never happen!");
+        NS_LOG_DEBUG("Flow - " << flow.prefix << ": interest queue is empty, this should never happen!");
         Simulator::Stop();
         return;
     }
@@ -1025,16 +1135,14 @@ Aggregator::SendInterest(shared_ptr<Name> newName)
     if (!m_active)
         return;
 
-    std::string nameWithSeq = newName->toUri();
-    std::string name_sec0 = newName->get(0).toUri();
-
-    // Trace timeout
-    m_timeoutCheck[nameWithSeq] = Simulator::Now();
+    uint32_t flowId = m_flows.Find(*newName);
 
-    // Start response time
-    rttStartTime[nameWithSeq] = Simulator::Now();
+    // Trace timeout, the entry also holds the send time for response time measurement
+    if (flowId != FlowTable::INVALID) {
+        m_timeouts.Add(flowId, m_segmentation.ParseUnit(*newName));
+    }
 
-    NS_LOG_INFO("Sending new interest >>>> " << nameWithSeq);
+    NS_LOG_INFO("Sending new interest >>>> " << *newName);
     shared_ptr<Interest> newInterest = make_shared<Interest>();
     newInterest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
     newInterest->setCanBePrefix(false);
@@ -1045,7 +1153,9 @@ Aggregator::SendInterest(shared_ptr<Name> newName)
     m_appLink->onReceiveInterest(*newInterest);
 
     // Designed for congestion control recording
-    m_inFlight[name_sec0]++;
+    if (flowId != FlowTable::INVALID) {
+        m_flows[flowId].inFlight++;
+    }
 
     // Record interest throughput
     // Actual interests sending and retransmission are recorded as well
@@ -1059,19 +1169,26 @@ Aggregator::SendInterest(shared_ptr<Name> newName)
 void
 Aggregator::SendData(uint32_t seq)
 {
-    // Get aggregation result for current iteration
-    std::vector<uint8_t> newbuffer;
-    serializeModelData(GetMean(seq), newbuffer);
+    // Get aggregation result for current iteration, don't get mean for now, consumer does it
+    if (!m_pipeline.IsOpen(seq)) {
+        NS_LOG_DEBUG("Error when get aggregation result, please exit and check!");
+        Simulator::Stop();
+        return;
+    }
+    const std::vector<double>& sum = m_pipeline.Sum(seq);
+    // A failed segment goes without parameters, so upstream doesn't average its zero sum
+    size_t count = m_pipeline.IsFailed(seq) ? 0 : sum.size();
+    // For topk, send every non-zero entry of the sum, i.e. the union of the downstream supports, without re-sparsifying
+    ::ndn::Block content = encodeModelDataContent(sum.data(), count, -1.0, {}, m_payloadEncoding, 0, m_pipeline.Contributors(seq));
 
     // create data packet
     auto data = make_shared<Data>();
 
-    std::string name_string = m_agg_newDataName[seq];
-    NS_LOG_INFO("New aggregated data's name: " << name_string);
+    const Name& newName = m_agg_newDataName[seq];
+    NS_LOG_INFO("New aggregated data's name: " << newName);
 
-    shared_ptr<Name> newName = make_shared<Name>(name_string);
-    data->setName(*newName);
-    data->setContent(make_shared< ::ndn::Buffer>(newbuffer.begin(), newbuffer.end()));
+    data->setName(newName);
+    data->setContent(content);
     data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
     SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
 
@@ -1087,12 +1204,57 @@ Aggregator::SendData(uint32_t seq)
     m_transmittedDatas(data, this, m_face);
     m_appLink->onReceiveData(*data);
 
-    // Clear aggregation mapping and aggregation result for current iteration
-    aggregateTime.erase(seq);
-    map_agg_oldSeq_newName.erase(seq);
+    // Clear aggregation mapping for current segment, the pipeline releases its sum once it's closed
     m_agg_newDataName.erase(seq);
-    sumParameters.erase(seq);
-    partialAggResult.erase(seq);
+    congestionSignalList.erase(seq);
+}
+
+
+
+void
+Aggregator::SegmentAggregated(uint32_t seq)
+{
+    uint32_t iteration = m_segmentation.GetIteration(seq);
+    NS_LOG_INFO("Aggregation of iteration " << iteration << " segment " << m_segmentation.GetSegment(seq) << " finished.");
+
+    // Ready before downstream asked for it (deadline, removed children), it's sent once the interest arrives
+    if (m_agg_newDataName.find(seq) == m_agg_newDataName.end()) {
+        NS_LOG_DEBUG("Segment " << seq << " wasn't requested by downstream yet, hold it.");
+        m_readyUnrequested.insert(seq);
+        return;
+    }
+
+    // Send data right away, the sum is read before the segment is released
+    SendData(seq);
+
+    // The iteration is done once all its segments are
+    Time iterationStart;
+    bool iterationFailed = false;
+    bool iterationDone = m_pipeline.Close(seq, &iterationStart, &iterationFailed);
+    if (iterationDone && iterationFailed) {
+        NS_LOG_INFO("Aggregation of iteration " << iteration << " failed, its aggregation time isn't recorded.");
+        failedIterationCount++;
+    } else if (iterationDone) {
+        NS_LOG_INFO("Aggregation of iteration " << iteration << " finished.");
+
+        // Measure aggregation time
+        aggregateTime[iteration] = Simulator::Now() - iterationStart;
+        AggregateTimeSum(aggregateTime[iteration].GetMicroSeconds());
+        NS_LOG_INFO("Aggregator's aggregate time of sequence " << iteration << " is: " << aggregateTime[iteration].GetMilliSeconds() << " ms");
+
+        // Record aggregation time
+        AggregateTimeRecorder(aggregateTime[iteration], iteration);
+        aggregateTime.erase(iteration);
+    }
+
+    // All iterations finished, record the entire throughput
+    if (iterationDone && iterationCount + failedIterationCount == m_iteNum) {
+        stopSimulation = Simulator::Now();
+
+        // Record throughput and results
+        ThroughputRecorder(totalInterestThroughput, totalDataThroughput, startSimulation);
+        ResultRecorder(GetAggregateTimeAverage());
+    }
 }
 
 
@@ -1119,47 +1281,41 @@ Aggregator::OnData(shared_ptr<const Data> data)
     NS_LOG_INFO ("Received content object: " << boost::cref(*data));
     int dataSize = data->wireEncode().size();
 
-    std::string dataName = data->getName().toUri();
-    std::string name_sec0 = data->getName().get(0).toUri();
-    uint32_t seq = data->getName().at(-1).toSequenceNumber();
-    std::string type = data->getName().get(-2).toUri();
+    const Name& dataName = data->getName();
+    AggregationName parsed = AggregationNameCodec::Parse(dataName, m_flows, m_segmentation); // Parsed once, everything below works on the ids
+    uint32_t flowId = parsed.flowId;
+    uint32_t seq = parsed.seq;
+
+    if (flowId == FlowTable::INVALID) {
+        NS_LOG_DEBUG("Data packet of unknown flow - " << dataName);
+        Simulator::Stop();
+        return;
+    }
+    FlowState& flow = m_flows[flowId];
 
     // Record data throughput
     totalDataThroughput += dataSize;
     NS_LOG_DEBUG("The incoming data packet size is: " << dataSize);
 
     // Stop checking timeout associated with this name
-    if (m_timeoutCheck.find(dataName) != m_timeoutCheck.end())
-        m_timeoutCheck.erase(dataName);
-    else {
+    Time sentTime;
+    bool isTracked = m_timeouts.Remove(flowId, seq, &sentTime);
+    if (!isTracked) {
         NS_LOG_DEBUG("Suspicious data packet, not exists in timeout list.");
         Simulator::Stop();
     }
-          
-    //? Currently pause the interest sending for 5 * current period
-    // Check whether data queue exceeds the limit
-    if (sumParameters.find(seq) == sumParameters.end()) {
-        // New iteration, currently not exist in the partial agg result
-        if (partialAggResult.size() >= m_dataQueue) {
-            // Exceed max data size
-            NS_LOG_INFO("Exceeding the max data queue, stop interest sending for flow " << name_sec0);
-            NS_LOG_INFO("Current partial aggregation table size is: " << partialAggResult.size());
-            dataOverflow++;
-
-            // Schdule next event after 5 * current period
-            if (m_scheduleEvent[name_sec0].IsRunning()) {
-                Simulator::Remove(m_scheduleEvent[name_sec0]);
-            }
-            
-            double nextTime = 5*1/m_rateLimit[name_sec0]; // Unit: us
-            NS_LOG_INFO("Flow " << name_sec0 << " -> Schedule next sending event after " << nextTime / 1000  << " ms.");
-            m_scheduleEvent[name_sec0] = Simulator::Schedule(MicroSeconds(nextTime), &Aggregator::ScheduleNextPacket, this, name_sec0);
+
+    // Late data of a child removed from the tree, its share isn't expected anymore
+    if (!flow.active) {
+        if (flow.inFlight > 0) {
+            flow.inFlight--;
         }
-        partialAggResult[seq] = true;
+        NS_LOG_DEBUG("Data packet of removed flow " << flow.prefix << ", drop it - " << dataName);
+        return;
     }
-
-    if (m_inFlight[name_sec0] > 0) {
-        m_inFlight[name_sec0]--;
+          
+    if (flow.inFlight > 0) {
+        flow.inFlight--;
     } else {
         NS_LOG_DEBUG("Error! In-flight packet is less than 0, please check!");
         Simulator::Stop();
@@ -1167,113 +1323,78 @@ Aggregator::OnData(shared_ptr<const Data> data)
     }
 
     // Check data type
-    if (type == "data") {
+    if (parsed.type == AggregationPacketType::DATA) {
         // Perform data name matching with interest name
-        ModelData upstreamModelData;
-
-        auto data_agg = map_agg_oldSeq_newName.find(seq);
-        auto data_map = m_agg_newDataName.find(seq);
-        if (data_map != m_agg_newDataName.end() && data_agg != map_agg_oldSeq_newName.end())
-        {
-            // Aggregation starts
-            auto& vec = data_agg->second;
-            auto vecIt = std::find(vec.begin(), vec.end(), name_sec0);
-            std::vector<uint8_t> oldbuffer(data->getContent().value(), data->getContent().value() + data->getContent().value_size());
-            if (deserializeModelData(oldbuffer, upstreamModelData)) {
-                if (vecIt != vec.end())
-                {
-                    Aggregate(upstreamModelData, seq);
-                    vec.erase(vecIt);
-                } 
-                else
-                {
-                    NS_LOG_INFO("Data name doesn't exist in aggMap, meaning this data packet is duplicate from upstream!");
-                    Simulator::Stop();
-                    return;
-                }
-            } else {
-                NS_LOG_INFO("Error when deserializing data packet, please check!");
-                Simulator::Stop();
-                return;
-            }            
+        ModelDataView upstreamModelData;
 
-            // RTT measurement
-            if (rttStartTime.find(dataName) != rttStartTime.end()){
-                responseTime[dataName] = Simulator::Now() - rttStartTime[dataName];
-                ResponseTimeSum(responseTime[dataName].GetMicroSeconds());
-                NS_LOG_INFO("ResponseTime for data packet : " << dataName << "=> is: " << responseTime[dataName].GetMicroSeconds() << " us");
-            }
+        if (!upstreamModelData.parse(data->getContent())) {
+            NS_LOG_INFO("Error when deserializing data packet, please check!");
+            Simulator::Stop();
+            return;
+        }
 
-            // RTO/RTT measure
-            RTOMeasure(name_sec0, responseTime[dataName].GetMicroSeconds());
-            RTTMeasure(name_sec0, responseTime[dataName].GetMicroSeconds());
-            
-            // Update estimated bandwidth
-            BandwidthEstimation(name_sec0);
-
-            // Init rate limit update
-            if (firstData.at(name_sec0)) {
-                NS_LOG_DEBUG("Init rate limit update for flow " << name_sec0);
-                m_rateEvent[name_sec0] = Simulator::ScheduleNow(&Aggregator::RateLimitUpdate, this, name_sec0);
-                firstData[name_sec0] = false;
+        IterationPipeline::Result result = m_pipeline.Contribute(seq, flowId, upstreamModelData);
+        if (result == IterationPipeline::UNKNOWN) {
+            if (m_pipeline.IsStragglerTolerant()) {
+                NS_LOG_DEBUG("Late data packet of a segment already sent downstream, drop it - " << dataName);
+            } else {
+                NS_LOG_DEBUG("Error, data name can't be recognized!");
+                Simulator::Stop();
             }
+            return;
+        }
+        if (result == IterationPipeline::DUPLICATE) {
+            NS_LOG_INFO("Data name doesn't exist in aggMap, meaning this data packet is duplicate from upstream!");
+            Simulator::Stop();
+            return;
+        }
+        if (result == IterationPipeline::FOLDED) {
+            NS_LOG_DEBUG("Late data packet folded into the next iteration - " << dataName);
+            return;
+        }
 
-            // Record QueueSize-based CC info
-            QueueRecorder(name_sec0, getDataQueueSize(name_sec0));
-            
-            // Record RTT
-            ResponseTimeRecorder(responseTime[dataName], seq, name_sec0);
-
-            // Record RTO
-            RTORecorder(name_sec0);
-            
-            InFlightRecorder(name_sec0);
-
-            // Check whether the aggregation of current iteration is done
-            if (vec.empty()){
-                NS_LOG_INFO("Aggregation of iteration " << seq << " finished.");
-
-                // Measure aggregation time
-                if (aggregateStartTime.find(seq) != aggregateStartTime.end()) {
-                    aggregateTime[seq] = Simulator::Now() - aggregateStartTime[seq];
-                    AggregateTimeSum(aggregateTime[seq].GetMicroSeconds());
-                    aggregateStartTime.erase(seq);
-                    NS_LOG_INFO("Aggregator's aggregate time of sequence " << seq << " is: " << aggregateTime[seq].GetMilliSeconds() << " ms");
-                } else {
-                    NS_LOG_DEBUG("Error when calculating aggregation time, no reference found for seq " << seq);
-                }
-
-                // Record aggregation time
-                AggregateTimeRecorder(aggregateTime[seq], seq);
-
-                // Send data
-                //! Debug, using 1ms instread of 2ms
-                //NS_LOG_DEBUG("Send data packet after 2 ms.");
-                //Simulator::Schedule(MilliSeconds(2), &Aggregator::SendData, this, seq);
-                NS_LOG_DEBUG("Send data packet after 1 ms.");
-                Simulator::Schedule(MilliSeconds(1), &Aggregator::SendData, this, seq);
+        // Aggregate congestion signal
+        std::vector<std::string> congestedNodes = upstreamModelData.congestedNodes();
+        congestionSignalList[seq].insert(congestionSignalList[seq].end(), congestedNodes.begin(), congestedNodes.end());
 
-                // All iterations finished, record the entire throughput
-                if (iterationCount == m_iteNum) {
-                    stopSimulation = Simulator::Now();
+        // RTT measurement
+        Time responseTime;
+        if (isTracked) {
+            responseTime = Simulator::Now() - sentTime;
+            ResponseTimeSum(responseTime.GetMicroSeconds());
+            NS_LOG_INFO("ResponseTime for data packet : " << dataName << "=> is: " << responseTime.GetMicroSeconds() << " us");
+        }
 
-                    // Record throughput and results
-                    ThroughputRecorder(totalInterestThroughput, totalDataThroughput, startSimulation);
-                    ResultRecorder(GetAggregateTimeAverage());
-                }
+        // RTO/RTT measure
+        RTOMeasure(flowId, responseTime.GetMicroSeconds());
+        RTTMeasure(flowId, responseTime.GetMicroSeconds());
+        
+        // Update estimated bandwidth
+        BandwidthEstimation(flowId);
+
+        // Init rate limit update
+        if (flow.firstData) {
+            NS_LOG_DEBUG("Init rate limit update for flow " << flow.prefix);
+            flow.rateEvent = Simulator::ScheduleNow(&Aggregator::RateLimitUpdate, this, flowId);
+            flow.firstData = false;
+        }
 
-            } else{
-                NS_LOG_DEBUG("Wait for others to aggregate.");
-            }
+        // Record QueueSize-based CC info
+        QueueRecorder(flowId, getDataQueueSize(flowId));
+        
+        // Record RTT
+        ResponseTimeRecorder(responseTime, seq, flowId);
 
-            // Clear rtt mapping of this packet
-            rttStartTime.erase(dataName);
-            responseTime.erase(dataName);
+        // Record RTO
+        RTORecorder(flowId);
+        
+        InFlightRecorder(flowId);
 
+        // Check whether the aggregation of current segment is done, forward it right away
+        if (result == IterationPipeline::READY) {
+            SegmentAggregated(seq);
         } else {
-            NS_LOG_DEBUG("Error, data name can't be recognized!");
-            Simulator::Stop();
-            return;
+            NS_LOG_DEBUG("Wait for others to aggregate.");
         }
     }
 }
@@ -1281,90 +1402,67 @@ Aggregator::OnData(shared_ptr<const Data> data)
 
 
 void
-Aggregator::WindowRecorder(std::string prefix)
+Aggregator::WindowRecorder(uint32_t flowId)
 {
-    // Open file; on first call, truncate it to delete old content
-    std::ofstream file(window_recorder[prefix], std::ios::app);
-
-    if (file.is_open()) {
-        file << Simulator::Now().GetMilliSeconds() << " " << m_window[prefix] << " " << m_ssthresh[prefix] << " " << interestQueue[prefix].size() << std::endl;  // Write text followed by a newline
-        file.close(); // Close the file after writing
-    } else {
-        std::cerr << "Unable to open file: " << window_recorder[prefix] << std::endl;
+    FlowState& flow = m_flows[flowId];
+    utils::LogFile* file = flow.windowLog;
+    if (file == nullptr) {
+        return;
     }
+
+    file->Write(Simulator::Now().GetMilliSeconds(), flow.window, flow.ssthresh, flow.interestQueue.size());
 }
 
 
 
 void
-Aggregator::InFlightRecorder(std::string prefix)
+Aggregator::InFlightRecorder(uint32_t flowId)
 {
-    // Open file; on first call, truncate it to delete old content
-    std::ofstream file(inFlight_recorder[prefix], std::ios::app);
-
-    if (file.is_open()) {
-        file << Simulator::Now().GetMilliSeconds() << " " << m_inFlight[prefix] << std::endl;  // Write text followed by a newline
-        file.close(); // Close the file after writing
-    } else {
-        std::cerr << "Unable to open file: " << inFlight_recorder[prefix] << std::endl;
+    FlowState& flow = m_flows[flowId];
+    utils::LogFile* file = flow.inFlightLog;
+    if (file == nullptr) {
+        return;
     }
+
+    file->Write(Simulator::Now().GetMilliSeconds(), flow.inFlight);
 }
 
 
 
 void
-Aggregator::ResponseTimeRecorder(Time responseTime, uint32_t seq, std::string prefix) {
-    // Open the file using fstream in append mode
-    std::ofstream file(responseTime_recorder[prefix], std::ios::app);
-
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << responseTime_recorder[prefix] << std::endl;
+Aggregator::ResponseTimeRecorder(Time responseTime, uint32_t seq, uint32_t flowId) {
+    utils::LogFile* file = m_flows[flowId].responseTimeLog;
+    if (file == nullptr) {
         return;
     }
 
-    // Write the response_time to the file, followed by a newline
-    file << Simulator::Now().GetMilliSeconds() << " " << seq  << " " << responseTime.GetMicroSeconds() / 1000 << std::endl;
-
-    // Close the file
-    file.close();
+    // Buffered by the log sink, written to disk in large blocks
+    file->Write(Simulator::Now().GetMilliSeconds(), seq, responseTime.GetMicroSeconds() / 1000);
 }
 
 
 
 void
-Aggregator::RTORecorder(std::string prefix)
+Aggregator::RTORecorder(uint32_t flowId)
 {
-    // Open the file using fstream in append mode
-    std::ofstream file(RTO_recorder[prefix], std::ios::app);
-
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << RTO_recorder[prefix] << std::endl;
+    FlowState& flow = m_flows[flowId];
+    utils::LogFile* file = flow.rtoLog;
+    if (file == nullptr) {
         return;
     }
 
-    // Write the response_time to the file, followed by a newline
-    file << Simulator::Now().GetMilliSeconds() << " " << RTO_threshold[prefix].GetMicroSeconds() / 1000 << std::endl;
-
-    // Close the file
-    file.close();
+    file->Write(Simulator::Now().GetMilliSeconds(), flow.rtoThreshold.GetMicroSeconds() / 1000);
 }
 
 
 
 void
 Aggregator::AggregateTimeRecorder(Time aggregateTime, uint32_t seq) {
-    // Open the file using fstream in append mode
-    std::ofstream file(aggregateTime_recorder, std::ios::app);
-
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << aggregateTime_recorder << std::endl;
+    if (aggregateTime_recorder == nullptr) {
         return;
     }
 
-    // Write aggregation time to file, followed by a new line
-    file << Simulator::Now().GetMilliSeconds() << " " << seq << " " << aggregateTime.GetMicroSeconds() / 1000 << std::endl;
-
-    file.close();
+    aggregateTime_recorder->Write(Simulator::Now().GetMilliSeconds(), seq, aggregateTime.GetMicroSeconds() / 1000);
 }
 
 
@@ -1377,22 +1475,13 @@ Aggregator::InitializeLogFile()
 
     // Open the file and clear all contents for all log files
     // Initialize file name for different upstream node, meaning that RTT/cwnd is measured per flow
-    for (const auto& [child, leaves] : aggregationMap) {
-        RTO_recorder[child] = folderPath + m_prefix.toUri() + "_RTO_" + child + ".txt";
-        responseTime_recorder[child] = folderPath + m_prefix.toUri() + "_RTT_" + child + ".txt";
-        //window_recorder[child] = folderPath + m_prefix.toUri() + "_window_" + child + ".txt";
-        inFlight_recorder[child] = folderPath + m_prefix.toUri() + "_inFlight_" + child + ".txt";
-        qsNew_recorder[child] = folderPath + m_prefix.toUri() + "_queue_" + child + ".txt";
-        OpenFile(RTO_recorder[child]);
-        OpenFile(responseTime_recorder[child]);
-        //OpenFile(window_recorder[child]);
-        OpenFile(inFlight_recorder[child]);
-        OpenFile(qsNew_recorder[child]);
+    for (auto& flow : m_flows) {
+        OpenFlowLogs(flow);
     }
 
     // Initialize log file for aggregate time
-    aggregateTime_recorder = folderPath + m_prefix.toUri() + "_aggregationTime.txt";
-    OpenFile(aggregateTime_recorder);
+    utils::LogSink& sink = utils::LogSink::Instance();
+    aggregateTime_recorder = sink.Open(folderPath + m_prefix.toUri() + "_aggregationTime.txt", {"Time", "Seq", "AggregationTime"});
     //aggTable_recorder = folderPath + m_prefix.toUri() + "_aggTable_.txt";
     //OpenFile(aggTable_recorder);
 }
@@ -1400,46 +1489,27 @@ Aggregator::InitializeLogFile()
 
 
 
+void
+Aggregator::OpenFlowLogs(FlowState& flow)
+{
+    utils::LogSink& sink = utils::LogSink::Instance();
+    const std::string& child = flow.prefix;
+    flow.rtoLog = sink.Open(folderPath + m_prefix.toUri() + "_RTO_" + child + ".txt", {"Time", "RTO"});
+    flow.responseTimeLog = sink.Open(folderPath + m_prefix.toUri() + "_RTT_" + child + ".txt", {"Time", "Seq", "RTT"});
+    //flow.windowLog = sink.Open(folderPath + m_prefix.toUri() + "_window_" + child + ".txt", {"Time", "Window", "Ssthresh", "InterestQueue"});
+    flow.inFlightLog = sink.Open(folderPath + m_prefix.toUri() + "_inFlight_" + child + ".txt", {"Time", "InFlight"});
+    flow.queueLog = sink.Open(folderPath + m_prefix.toUri() + "_queue_" + child + ".txt",
+                              {"Time", "SendRate", "BW", "Throughput", "Queue", "InFlight", "RTT"});
+}
+
+
+
 void
 Aggregator::InitializeParameters()
 {
     // Initialize window
-    for (const auto& [key, value] : aggregationMap) {
-        m_window[key] = m_initialWindow;
-        m_inFlight[key] = 0;
-        m_ssthresh[key] = std::numeric_limits<double>::max();
-        //successiveCongestion[key] = 0;
-
-        // Initialize RTO measurement parameters
-        SRTT[key] = 0;
-        RTTVAR[key] = 0;
-        roundRTT[key] = 0;
-
-        // Initialize CUBIC factor
-        m_cubicLastWmax[key] = m_initialWindow;
-        m_cubicWmax[key] = m_initialWindow;
-
-        lastWindowDecreaseTime[key] = Simulator::Now();
-        RTT_historical_estimation[key] = 0;
-        RTT_count[key] = 0;
-
-        // Initialize timeout checking
-        RTO_threshold[key] = 5 * m_retxTimer;
-
-        // Initialize seq
-        SeqMap[key] = 0;
-
-        // Initialize QueueSize-based CC info
-        m_qsSlidingWindows[key] = utils::SlidingWindow<double>(MilliSeconds(m_qsTimeDuration));
-        m_estimatedBW[key] = 0;
-        m_rateLimit[key] = m_qsInitRate;
-        firstData[key] = true;
-        RTT_estimation_qs[key] = 0;
-        nackSignal[key] = false;
-        timeoutSignal[key] = false;
-        m_lastBW[key] = 0;
-        m_ccState[key] = "Startup";
-        m_inflightLimit[key] = 0;
+    for (auto& flow : m_flows) {
+        InitializeFlow(flow);
     }
 
     // Init params for interest sending rate pacing
@@ -1449,10 +1519,53 @@ Aggregator::InitializeParameters()
 
 
 
+void
+Aggregator::InitializeFlow(FlowState& flow)
+{
+    flow.window = m_initialWindow;
+    flow.inFlight = 0;
+    flow.ssthresh = std::numeric_limits<double>::max();
+    //flow.successiveCongestion = 0;
+
+    // Initialize RTO measurement parameters
+    flow.srtt = 0;
+    flow.rttvar = 0;
+    flow.roundRTT = 0;
+
+    // Initialize CUBIC factor
+    flow.cubicLastWmax = m_initialWindow;
+    flow.cubicWmax = m_initialWindow;
+
+    flow.lastWindowDecreaseTime = Simulator::Now();
+    flow.rttHistoricalEstimation = 0;
+    flow.rttCount = 0;
+
+    // Initialize timeout checking
+    flow.rtoThreshold = 5 * m_retxTimer;
+
+    // Initialize seq
+    flow.seq = 0;
+
+    // Initialize QueueSize-based CC info
+    flow.qsSlidingWindow = utils::SlidingWindow<double>(MilliSeconds(m_qsTimeDuration));
+    flow.estimatedBW = 0;
+    flow.rateLimit = m_qsInitRate;
+    flow.firstData = true;
+    flow.rttEstimationQs = 0;
+    flow.nackSignal = false;
+    flow.timeoutSignal = false;
+    flow.lastBW = 0;
+    flow.ccState = "Startup";
+    flow.inflightLimit = 0;
+}
+
+
+
 bool
-Aggregator::CanDecreaseWindow(std::string prefix, int64_t threshold)
+Aggregator::CanDecreaseWindow(uint32_t flowId, int64_t threshold)
 {
-    if (Simulator::Now().GetMilliSeconds() - lastWindowDecreaseTime[prefix].GetMilliSeconds() > threshold) {
+    FlowState& flow = m_flows[flowId];
+    if (Simulator::Now().GetMilliSeconds() - flow.lastWindowDecreaseTime.GetMilliSeconds() > threshold) {
         return true;
     } else {
         return false;
@@ -1499,56 +1612,52 @@ Aggregator::ResultRecorder(int64_t aveAggTime)
     file << "Data queue overflow is triggered for " << dataOverflow << " times" << std::endl;
     file << "Nack(upstream interest queue overflow) is triggered for " << nackCount << " times" << std::endl;
     file << "Average aggregation time: " << aveAggTime / 1000  << " ms" << std::endl;
+    m_pipeline.GetStats().Write(file, m_pipeline.GetPolicy());
     file << "-----------------------------------" << std::endl;
 }
 
 
 
 void
-Aggregator::QueueRecorder(std::string prefix, double queueSize)
+Aggregator::QueueRecorder(uint32_t flowId, double queueSize)
 {
-    // Open the file using fstream in append mode
-    std::ofstream file(qsNew_recorder[prefix], std::ios::app);
-
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << qsNew_recorder[prefix] << std::endl;
+    FlowState& flow = m_flows[flowId];
+    utils::LogFile* file = flow.queueLog;
+    if (file == nullptr) {
         return;
     }
 
-    // Write the response_time to the file, followed by a newline
     //* Note that throughput is transferred into Mbps
-    file << Simulator::Now().GetMilliSeconds() << " " 
-         << m_rateLimit[prefix] * 1000 << " "
-         << m_estimatedBW[prefix] * 1000 << " " 
-         << GetDataRate(prefix) * 1000000 * 8 * 8 * m_dataSize / 1000000 << " "
-         << queueSize << " "
-         << m_inFlight[prefix] << " "
-         << RTT_estimation_qs[prefix] / 1000 << " "  
-         << std::endl;
-
-    // Close the file
-    file.close();
+    file->Write(Simulator::Now().GetMilliSeconds(),
+                flow.rateLimit * 1000,
+                flow.estimatedBW * 1000,
+                GetDataRate(flowId) * 1000000 * 8 * 8 * m_segmentation.GetSegmentLength(0) / 1000000,
+                queueSize,
+                flow.inFlight,
+                flow.rttEstimationQs / 1000);
 }
 
 
 
 void
-Aggregator::RTTMeasure(std::string prefix, int64_t resTime)
+Aggregator::RTTMeasure(uint32_t flowId, int64_t resTime)
 {
+    FlowState& flow = m_flows[flowId];
     // Update RTT estimation
-    if (RTT_estimation_qs[prefix] == 0) {
-        RTT_estimation_qs[prefix] = resTime;
+    if (flow.rttEstimationQs == 0) {
+        flow.rttEstimationQs = resTime;
     } else {
-        RTT_estimation_qs[prefix] = m_EWMAFactor * RTT_estimation_qs[prefix] + (1 - m_EWMAFactor) * resTime;
+        flow.rttEstimationQs = m_EWMAFactor * flow.rttEstimationQs + (1 - m_EWMAFactor) * resTime;
     }
 }
 
 
 
 double
-Aggregator::GetDataRate(std::string prefix)
+Aggregator::GetDataRate(uint32_t flowId)
 {
-    double rawDataRate = m_qsSlidingWindows[prefix].GetDataArrivalRate();
+    FlowState& flow = m_flows[flowId];
+    double rawDataRate = flow.qsSlidingWindow.GetDataArrivalRate();
 
     // "0": sliding window size is less than one, keep init rate as data arrival rate; "-1" indicates error
     if (rawDataRate == -1) {
@@ -1566,85 +1675,87 @@ Aggregator::GetDataRate(std::string prefix)
 
 
 void
-Aggregator::BandwidthEstimation(std::string prefix)
+Aggregator::BandwidthEstimation(uint32_t flowId)
 {
+    FlowState& flow = m_flows[flowId];
     Time arrivalTime = Simulator::Now();
     
     // Update info within sliding window
-    double queueSize = getDataQueueSize(prefix);
-    NS_LOG_INFO("Flow: " << prefix << ", Data queue size: " << queueSize);
-    m_qsSlidingWindows[prefix].AddPacket(arrivalTime, queueSize);
+    double queueSize = getDataQueueSize(flowId);
+    NS_LOG_INFO("Flow: " << flow.prefix << ", Data queue size: " << queueSize);
+    flow.qsSlidingWindow.AddPacket(arrivalTime, queueSize);
 
-    double aveQS = m_qsSlidingWindows[prefix].GetAverageQueue();
+    double aveQS = flow.qsSlidingWindow.GetAverageQueue();
 
-    //double dataArrivalRate = m_qsSlidingWindows[prefix].GetDataRate();
-    double dataArrivalRate = GetDataRate(prefix);
+    //double dataArrivalRate = flow.qsSlidingWindow.GetDataRate();
+    double dataArrivalRate = GetDataRate(flowId);
 
     // Update bandwidth estimation
     if (dataArrivalRate == 0) {
         NS_LOG_INFO("Data rate is 0, don't update bandwidth.");
     } else {
         if (aveQS > m_queueThreshold) {
-            m_estimatedBW[prefix] = dataArrivalRate;
+            flow.estimatedBW = dataArrivalRate;
         }
 
-        if (dataArrivalRate > m_estimatedBW[prefix]) {
-            m_estimatedBW[prefix] = dataArrivalRate;
+        if (dataArrivalRate > flow.estimatedBW) {
+            flow.estimatedBW = dataArrivalRate;
         }        
     }   
 
-    NS_LOG_INFO("Flow: " << prefix << 
+    NS_LOG_INFO("Flow: " << flow.prefix << 
                 " - Average data queue size: " << aveQS << 
                 ", Arrival Rate: " << dataArrivalRate * 1000  << 
-                " pkgs/ms, Bandwidth estimation: " << m_estimatedBW[prefix] * 1000  << " pkgs/ms");
+                " pkgs/ms, Bandwidth estimation: " << flow.estimatedBW * 1000  << " pkgs/ms");
 }
 
 
 
 void
-Aggregator::RateLimitUpdate(std::string prefix)
+Aggregator::RateLimitUpdate(uint32_t flowId)
 {
+    FlowState& flow = m_flows[flowId];
 
-    double aveQS = m_qsSlidingWindows[prefix].GetAverageQueue();
-    NS_LOG_INFO("Flow " << prefix << " - data queue size: " << aveQS);
+    double aveQS = flow.qsSlidingWindow.GetAverageQueue();
+    NS_LOG_INFO("Flow " << flow.prefix << " - data queue size: " << aveQS);
 
     // Congestion control
-    if (m_estimatedBW[prefix] != 0) {
-        if (nackSignal[prefix]) {
-            nackSignal[prefix] = false;
-            m_rateLimit[prefix] = m_estimatedBW[prefix] * m_qsMDFactor;
-            NS_LOG_INFO("Congestion detected. Reason: nack signal detected. Update rate limit: " << m_rateLimit[prefix] * 1000 << " pkgs/ms");
-        } else if (timeoutSignal[prefix]) {
-            timeoutSignal[prefix] = false;
-            m_rateLimit[prefix] = m_estimatedBW[prefix] * m_qsMDFactor;
-            NS_LOG_INFO("Congestion detected. Reason: timeout . Update rate limit: " << m_rateLimit[prefix] * 1000 << " pkgs/ms");
+    if (flow.estimatedBW != 0) {
+        if (flow.nackSignal) {
+            flow.nackSignal = false;
+            flow.rateLimit = flow.estimatedBW * m_qsMDFactor;
+            NS_LOG_INFO("Congestion detected. Reason: nack signal detected. Update rate limit: " << flow.rateLimit * 1000 << " pkgs/ms");
+        } else if (flow.timeoutSignal) {
+            flow.timeoutSignal = false;
+            flow.rateLimit = flow.estimatedBW * m_qsMDFactor;
+            NS_LOG_INFO("Congestion detected. Reason: timeout . Update rate limit: " << flow.rateLimit * 1000 << " pkgs/ms");
         } else if (aveQS > 2 * m_queueThreshold) {
-            m_rateLimit[prefix] = m_estimatedBW[prefix] * m_qsMDFactor;
-            NS_LOG_INFO("Congestion detected. Reason: large data queue. Update rate limit: " << m_rateLimit[prefix] * 1000 << " pkgs/ms");
-        } else if (m_inFlight[prefix] > 1.5 * m_inflightThreshold) {
-            m_rateLimit[prefix] = m_estimatedBW[prefix] * m_qsMDFactor;
-            NS_LOG_INFO("Congestion detected. Reason: inflight interests. Update rate limit: " << m_rateLimit[prefix] * 1000 << " pkgs/ms");
+            flow.rateLimit = flow.estimatedBW * m_qsMDFactor;
+            NS_LOG_INFO("Congestion detected. Reason: large data queue. Update rate limit: " << flow.rateLimit * 1000 << " pkgs/ms");
+        } else if (flow.inFlight > 1.5 * m_inflightThreshold) {
+            flow.rateLimit = flow.estimatedBW * m_qsMDFactor;
+            NS_LOG_INFO("Congestion detected. Reason: inflight interests. Update rate limit: " << flow.rateLimit * 1000 << " pkgs/ms");
         } else {
-            m_rateLimit[prefix] = m_estimatedBW[prefix];
-            NS_LOG_INFO("No congestion. Update rate limit by estimated BW: " << m_rateLimit[prefix] * 1000  << " pkgs/ms");
+            flow.rateLimit = flow.estimatedBW;
+            NS_LOG_INFO("No congestion. Update rate limit by estimated BW: " << flow.rateLimit * 1000  << " pkgs/ms");
         }        
     }
 
     // Rate probing
-    if (aveQS < m_queueThreshold && m_inFlight[prefix] < m_inflightThreshold) {
-        m_rateLimit[prefix] = m_rateLimit[prefix] * m_qsRPFactor;
-        NS_LOG_INFO("Start rate probing. Updated rate limit: " << m_rateLimit[prefix] * 1000  << " pkgs/ms");
+    if (aveQS < m_queueThreshold && flow.inFlight < m_inflightThreshold) {
+        flow.rateLimit = flow.rateLimit * m_qsRPFactor;
+        NS_LOG_INFO("Start rate probing. Updated rate limit: " << flow.rateLimit * 1000  << " pkgs/ms");
     }
     
     // Error handling
-    if (RTT_estimation_qs[prefix] == 0) {
+    if (flow.rttEstimationQs == 0) {
         NS_LOG_INFO("RTT estimation is 0, please check!");
         Simulator::Stop();
         return;
     }
     
-    NS_LOG_INFO("Flow " << prefix << " - Schedule next rate limit update after " << static_cast<double>(RTT_estimation_qs[prefix] / 1000) << " ms");
-    m_rateEvent[prefix] = Simulator::Schedule(MicroSeconds(RTT_estimation_qs[prefix]), &Aggregator::RateLimitUpdate, this, prefix);
+    NS_LOG_INFO("Flow " << flow.prefix << " - Schedule next rate limit update after " << static_cast<double>(flow.rttEstimationQs / 1000) << " ms");
+    flow.rateEvent = Simulator::Schedule(MicroSeconds(flow.rttEstimationQs), &Aggregator::RateLimitUpdate, this, flowId);
 }
 
 
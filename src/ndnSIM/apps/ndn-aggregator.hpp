@@ -10,6 +10,11 @@
 #include "sliding-window.hpp"
 #include "ndn-app.hpp"
 #include "ModelData.hpp"
+#include "model-segmentation.hpp"
+#include "iteration-pipeline.hpp"
+#include "flow-state.hpp"
+#include "aggregation-name.hpp"
+#include "retx-timeout-queue.hpp"
 #include "ndn-cxx/lp/nack.hpp"
 #include "ndn-cxx/lp/nack-header.hpp"
 
@@ -20,6 +25,8 @@
 #include "ns3/log.h"
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 #include "ns3/ndnSIM/utils/ndn-rtt-estimator.hpp"
+#include "ns3/ndnSIM/utils/log-sink.hpp"
+#include "ns3/ndnSIM/utils/tree-message.hpp"
 #include "ns3/ptr.h"
 
 #include <set>
@@ -85,10 +92,10 @@ public:
 
     /**
      * Process incoming data packets
-     * @param prefix
+     * @param flowId
      */
     virtual void 
-    ScheduleNextPacket(std::string prefix);
+    ScheduleNextPacket(uint32_t flowId);
 
 
     /**
@@ -107,11 +114,27 @@ public:
     InterestGenerator();
 
 
+    /**
+     * Apply a repeated initialization (tree repair) to the flows
+     * New children fetch the seqs in progress none of their producers was summed into yet, removed children are dropped from the aggregation map
+     */
+    void
+    UpdateFlows();
+
+
+    /**
+     * All children returned the segment (or were removed from the tree), forward it downstream
+     * @param seq
+     */
+    void
+    SegmentAggregated(uint32_t seq);
+
+
     /**
      * Check whether interest buffer is empty, if not, send new interests
      */
     void 
-    SendPacket(std::string prefix);
+    SendPacket(uint32_t flowId);
 
 
     /**
@@ -140,11 +163,12 @@ public:
 
 
     /**
-     * Triggered when timeout
-     * @param nameString
+     * Triggered when the interest of a flow times out
+     * @param flowId
+     * @param seq
      */
     virtual void 
-    OnTimeout(std::string nameString);
+    OnTimeout(uint32_t flowId, uint32_t seq);
 
 
     /**
@@ -189,88 +213,71 @@ public:
 
     /**
      * Increase cwnd
-     * @param prefix Flow name
+     * @param flowId Flow id
      */
     void 
-    WindowIncrease(std::string prefix);
+    WindowIncrease(uint32_t flowId);
 
 
     /**
      * Decrease cwnd
-     * @param prefix Flow name
+     * @param flowId Flow id
      * @param type Congestion type
      */
     void 
-    WindowDecrease(std::string prefix, std::string type);
+    WindowDecrease(uint32_t flowId, std::string type);
 
 
     /**
      * Cubic increase
-     * @param prefix Flow name
+     * @param flowId Flow id
      */
     void 
-    CubicIncerase(std::string prefix);
+    CubicIncerase(uint32_t flowId);
 
 
     /**
      * Cubic decrease
-     * @param prefix Flow name
+     * @param flowId Flow id
      * @param type Congestion type
      */
     void 
-    CubicDecrease(std::string prefix, std::string type);
+    CubicDecrease(uint32_t flowId, std::string type);
 
 
-    /**
-     * Perform aggregation for incoming data packets (sum)
-     * @param data
-     * @param dataName
-     */
-    void 
-    Aggregate(const ModelData& data, const uint32_t& seq);
-
-
-    /**
-     * Don't get mean for now, just reformating the data packets, perform aggregation at consumer
-     * @param dataName
-     * @return Data content
-     */
-    ModelData 
-    GetMean(const uint32_t& seq);
-
     //! Updated QueueSize-based CC
 
     /**
      * Based on returned data, update rtt estimation
-     * @param prefix
+     * @param flowId
      * @param resTime unit - us
      */
     void
-    RTTMeasure(std::string prefix, int64_t resTime);
+    RTTMeasure(uint32_t flowId, int64_t resTime);
 
 
     /**
      * Get the data rate and return with correct value from the sliding window
-     * @param prefix flow name
+     * @param flowId Flow id
      */
     double
-    GetDataRate(std::string prefix);
+    GetDataRate(uint32_t flowId);
 
 
     /**
      * Bandwidth estimation
-     * @param prefix flow
+     * @param flowId Flow id
      * @param dataArrivalRate data arrival rate
      */
     void 
-    BandwidthEstimation(std::string prefix);
+    BandwidthEstimation(uint32_t flowId);
 
 
     /**
      * Update each flow's rate limit.
      */
     void
-    RateLimitUpdate(std::string prefix);
+    RateLimitUpdate(uint32_t flowId);
 
 
 
@@ -308,49 +315,40 @@ public:
 
     /**
      * Measure new RTO
-     * @param prefix
+     * @param flowId
      * @param resTime unit - us
      * @return New RTO
      */
     void 
-    RTOMeasure(std::string prefix, int64_t resTime);
+    RTOMeasure(uint32_t flowId, int64_t resTime);
 
     /**
      * Based on RTT of the first iteration, compute their RTT average as threshold, use the threshold for congestion control
      * Apply Exponentially Weighted Moving Average (EWMA) for RTT Threshold Computation
-     * @param prefix
+     * @param flowId
      * @param responseTime
      * @return congestion signal
      */
     bool 
-    CongestionDetection(std::string prefix, int64_t responseTime);
+    CongestionDetection(uint32_t flowId, int64_t responseTime);
 
 
     /**
-     * Intermediate function to parse string, used in aggTreeProcessStrings()
-     * Changed from set into list
-     * @param input
-     * @return Parsed string
+     * When receive "initialization" message (tree construction) from consumer, resolve the node ids
+     * of the reassembled tree message into this aggregator's children and their leaves
+     * @param assignment
+     * @param result Child node info for current aggregator
+     * @return False if the message refers to a node id which doesn't exist
      */
-    std::pair<std::string, std::vector<std::string>> 
-    aggTreeProcessSingleString(const std::string& input);
-
-
-    /**
-     * When receive "initialization" message (tree construction) from consumer, parse the message to get required info
-     * Changed from set into list
-     * @param inputs
-     * @return A map consist child node info for current aggregator
-     */    
-    std::map<std::string, std::vector<std::string>> 
-    aggTreeProcessStrings(const std::vector<std::string>& inputs);
+    bool
+    aggTreeProcessMessage(const TreeAssignment& assignment, std::map<std::string, std::vector<std::string>>& result);
 
     // Utility function
     /**
      * Get data queue of certain flow
      */
     double 
-    getDataQueueSize(std::string prefix);
+    getDataQueueSize(uint32_t flowId);
 
 
     // Logging function
@@ -359,14 +357,14 @@ public:
      * Record window when receiving a new packet
      */
     void 
-    WindowRecorder(std::string prefix);
+    WindowRecorder(uint32_t flowId);
 
 
     /**
      * Record in-flight packets when receiving a new packet
      */
     void 
-    InFlightRecorder(std::string prefix);
+    InFlightRecorder(uint32_t flowId);
 
 
     /**
@@ -374,15 +372,15 @@ public:
      * @param responseTime
      */
     void 
-    ResponseTimeRecorder(Time responseTime, uint32_t seq, std::string prefix);
+    ResponseTimeRecorder(Time responseTime, uint32_t seq, uint32_t flowId);
 
 
     /**
      * Record RTO when receiving data packet
-     * @param prefix
+     * @param flowId
      */
     void 
-    RTORecorder(std::string prefix);
+    RTORecorder(uint32_t flowId);
 
 
     /**
@@ -400,6 +398,14 @@ public:
     InitializeLogFile();
 
 
+    /**
+     * Open the per-flow log files of one child
+     * @param flow
+     */
+    void
+    OpenFlowLogs(FlowState& flow);
+
+
     /**
      * Initialize all parameters
      * Initialize timeout checking mechanism, remove part of SetRetcTimer()'s function to here
@@ -408,12 +414,20 @@ public:
     InitializeParameters();
 
 
+    /**
+     * Initialize window, RTO and QueueSize-based CC state of one child
+     * @param flow
+     */
+    void
+    InitializeFlow(FlowState& flow);
+
+
     /**
      * Check whether the cwnd has been decreased within the last RTT duration
      * @param threshold
      */
     bool 
-    CanDecreaseWindow(std::string prefix, int64_t threshold);
+    CanDecreaseWindow(uint32_t flowId, int64_t threshold);
 
 
     /**
@@ -436,7 +450,7 @@ public:
      * Record queue size based CC info
      */
     void
-    QueueRecorder(std::string prefix, double queueSize);
+    QueueRecorder(uint32_t flowId, double queueSize);
 
 protected:
 
@@ -455,14 +469,7 @@ protected:
 
 
     /**
-     * Check timeout every certain interval
-     */
-    void 
-    CheckRetxTimeout();
-
-
-    /**
-     * Set initial timeout checking interval
+     * Set the retransmission timer, the initial RTO of every flow is derived from it
      * @param retxTimer
      */
     void 
@@ -470,8 +477,8 @@ protected:
 
 
     /**
-     * Get timeout checking interval
-     * @return Timeout checking interval
+     * Get the retransmission timer
+     * @return Retransmission timer
      */
     Time 
     GetRetxTimer() const;
@@ -492,21 +499,17 @@ public:
 
 protected:
     // log file
-    std::string folderPath = "src/ndnSIM/results/logs/agg";
+    std::string folderPath = SimulationConfig::Instance().GetResultsDir() + "/agg";
 
     // All logs start to write after synchronization, make sure only the chosen aggregators will generate log files; those aren't chosen will disable this function
-    std::map<std::string, std::string> RTO_recorder;
-    std::map<std::string, std::string> window_recorder;
-    std::map<std::string, std::string> responseTime_recorder;
-    std::map<std::string, std::string> inFlight_recorder;
-    std::map<std::string, std::string> qsNew_recorder; //! Updated queue size CC
     std::string aggTable_recorder;
-    std::string aggregateTime_recorder;
+    utils::LogFile* aggregateTime_recorder = nullptr;
 
     int suspiciousPacketCount; // Record the number of timeout
     int downstreamRetxCount; // Record the number of retransmission interests from downstream
     int interestOverflow; // Record the number of interest overflow within interest queue
     int dataOverflow; // Record the number of data overflow within data queue
+    uint32_t dataOverflowIteration; // Latest iteration counted in dataOverflow
     int nackCount; // Record the number of NACK
 
     // Local throughput measurement
@@ -520,11 +523,8 @@ protected:
 
     // Congestion control, measure RTT threshold to detect congestion
     int numChild; // Start congestion control after 3 iterations
-    std::map<std::string, int> RTT_count; // How many RTT packets this node has received, used to estimate how many iterations have passed
     
     //? The following is new design for windowed average RTT
-    std::map<std::string, std::deque<int64_t>> RTT_windowed_queue; // Store windowed average RTT for each flow
-    std::map<std::string, int64_t> RTT_historical_estimation; // Historical RTT estimation    
     int m_smooth_window_size; // Window size for RTT windowed average
 
     // Congestion signal
@@ -533,27 +533,19 @@ protected:
 
     // Basic cwnd management
     uint32_t m_initialWindow;
-    std::map<std::string, double> m_window;
     uint32_t m_minWindow;
-    std::map<std::string, uint32_t> m_inFlight;
-    std::map<std::string, double> m_ssthresh;
     bool m_setInitialWindowOnTimeout;
 
     // Window decrease suppression
-    std::map<std::string, Time> lastWindowDecreaseTime;
     bool isWindowDecreaseSuppressed;
 
     // CUBIC
     static constexpr double m_cubic_c = 0.4;
     static constexpr double m_cubicBeta = 0.7;
     bool m_useCubicFastConv;
-    std::map<std::string, double> m_cubicWmax;
-    std::map<std::string, double> m_cubicLastWmax;
 
 
     // AIMD
-    std::map<std::string, uint32_t> lastCongestionSeq;
-    std::map<std::string, int> successiveCongestion;
     bool m_useCwa;
     double m_alpha; // Timeout decrease factor
     double m_beta; // Local congestion decrease factor
@@ -565,12 +557,19 @@ protected:
     int m_interestQueue; // Max interest queue size
     int m_dataQueue; // Max data queue size
     int m_dataSize; // Max data size
+    PayloadEncoding m_payloadEncoding; // Encoding of model parameters sent upstream
+    int m_segmentSize; // Max number of model parameters per data packet, 0 for the whole model
+    ModelSegmentation m_segmentation; // Maps the seq of a name to (iteration, segment)
+    IterationPipeline m_pipeline; // Partial sums of the iterations being aggregated
+    int m_pipelineDepth; // Max number of iterations aggregated at once, 0 for DataQueueSize / segments
+    StragglerMode m_stragglerMode; // When a segment finishes before every child contributed
+    double m_completionQuorum; // Fraction of the children a segment needs to finish
+    Time m_completionDeadline; // Time after which an iteration finishes with whatever arrived, 0 to wait
+    LateUpdates m_lateUpdates; // Contributions to finished segments, dropped or folded into the next iteration
     uint32_t m_iteNum;
 
     // TODO:debugging this section now
     // Interest sending rate pacing
-    std::map<std::string, EventId> m_scheduleEvent;
-    std::map<std::string, EventId> m_sendEvent;
     bool firstInterest;
     bool isRTTEstimated;
     int m_initPace;
@@ -583,67 +582,45 @@ protected:
     double m_qsRPFactor;
     int m_qsTimeDuration;
     double m_qsInitRate; // Unit: pgks/ms
-    std::map<std::string, bool> firstData;
-    std::map<std::string, utils::SlidingWindow<double>> m_qsSlidingWindows;
-    std::map<std::string, EventId> m_rateEvent;    
-    std::map<std::string, double> m_rateLimit; // Unit: pkgs/ms
-    std::map<std::string, double> m_estimatedBW; // Unit: pkgs/ms
-    std::map<std::string, int64_t> RTT_estimation_qs; // Unit: ms
-    std::map<std::string, bool> nackSignal; // NACK signal for each flow
-    std::map<std::string, bool> timeoutSignal; // Timeout signal for each flow
-    std::map<std::string, double> m_lastBW;
-    std::map<std::string, std::string> m_ccState;
-    std::map<std::string, double> m_inflightLimit; // Inflight limit for each flow
 
 
 
-    // Interest queue (for each flow), keep tracking about each flow
-    std::map<std::string, std::deque<uint32_t>> interestQueue;
+    // Per-flow state (interest queue, window, RTO, QueueSize-based CC, logs), indexed by flow id
+    FlowTable m_flows;
 
     // Interest splitting - divided interests
-    std::map<std::string, std::string> NameSec0_2;
-    std::map<std::string, uint32_t> SeqMap;
-    std::vector<std::string> vec_iteration; // Store upstream nodes' name
-
-    // Timeout check and RTT measurement
-    std::map<std::string, Time> m_timeoutCheck;
-    std::map<std::string, int64_t> SRTT;
-    std::map<std::string, int64_t> RTTVAR;
-    std::map<std::string, int> roundRTT;
-    std::map<std::string, Time> RTO_threshold;
-    std::map<std::string, int> numTimeout;
+    std::vector<uint32_t> vec_iteration; // Store upstream nodes' flow ids
+
+    // Timeout check and RTT measurement, keyed by (flow id, seq)
+    RetxTimeoutQueue m_timeouts;
 
     // Aggregation list
-    std::map<uint32_t, std::string> m_agg_newDataName; // whole name
-    std::map<uint32_t, std::vector<std::string>> map_agg_oldSeq_newName; // name segments
+    std::map<uint32_t, Name> m_agg_newDataName; // whole name
+    std::set<uint32_t> m_readyUnrequested; // Segments complete before downstream requested them
 
 
 
     // Aggregation variables storage
-    std::map<uint32_t, bool> partialAggResult;
-    std::map<uint32_t, std::vector<double>> sumParameters; // result after performing aggregation(arithmetic add them together)
     std::map<uint32_t, std::vector<std::string>> congestionSignalList; // result after aggregating congestion signal
     std::map<uint32_t, bool> congestionSignal; // congestion signal for current node
 
     // Response/Aggregation time measurement
-    std::map<std::string, Time> rttStartTime;
-    std::map<std::string, Time> responseTime;
     int64_t totalResponseTime;
     int round;
 
-    std::map<uint32_t, Time> aggregateStartTime;
-    std::map<uint32_t, Time> aggregateTime;
+    std::map<uint32_t, Time> aggregateTime; // Keyed by iteration
     int64_t totalAggregateTime;
     int iterationCount;
+    int failedIterationCount; // Finished with a failed segment, not timed
 
     // Receive aggregation tree from consumer
     std::map<std::string, std::vector<std::string>> aggregationMap;
+    TreeMessageAssembler m_treeMessage; // Chunks of the latest tree message
 
 
     uint32_t m_seq;      ///< @brief currently requested sequence number
     uint32_t m_seqMax;   ///< @brief maximum number of sequence number
     Time m_retxTimer;    ///< @brief Currently estimated retransmission timer
-    EventId m_retxEvent; ///< @brief Event to check whether or not retransmission should be performed
     Ptr<RttEstimator> m_rtt; ///< @brief RTT estimator
     Time m_offTime;          ///< \brief Time interval between packets
     Name m_interestName;     ///< \brief NDN Name of the Interest (use Name)
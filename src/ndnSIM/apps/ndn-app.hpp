@@ -31,6 +31,7 @@
 #include <optional>
 
 #include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/apps/simulation-config.hpp"
 #include "ns3/ndnSIM/model/ndn-app-link-service.hpp"
 #include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
 
@@ -141,9 +142,9 @@ public:
     std::map<std::string, std::vector<std::string>> m_linkInfo;
 
     // Throughput/aggregation tree log file
-    std::string throughput_recorder = "src/ndnSIM/results/logs/throughput.txt"; // "totalInterestThroughput", "totalDataThroughput", "total time"
-    std::string aggTree_recorder = "src/ndnSIM/results/logs/aggTree.txt";
-    std::string result_recorder = "src/ndnSIM/results/logs/result.txt";
+    std::string throughput_recorder = SimulationConfig::Instance().GetResultsDir() + "/throughput.txt"; // "totalInterestThroughput", "totalDataThroughput", "total time"
+    std::string aggTree_recorder = SimulationConfig::Instance().GetResultsDir() + "/aggTree.txt";
+    std::string result_recorder = SimulationConfig::Instance().GetResultsDir() + "/result.txt";
 
 protected:
 
@@ -96,10 +96,10 @@ void
 ConsumerINA::SendInterest(shared_ptr<Name> newName)
 {
 /*     // Get the prefix of the interest, which is the flow name
-    std::string flow = newName->get(0).toUri();
+    uint32_t flowId = m_flows.Find(*newName);
 
     // Record inFlight for congestion control
-    m_inFlight[flow]++; */
+    m_flows[flowId].inFlight++; */
 
     Consumer::SendInterest(newName);
 }
@@ -107,17 +107,23 @@ ConsumerINA::SendInterest(shared_ptr<Name> newName)
 
 
 void
-ConsumerINA::ScheduleNextPacket(std::string prefix)
+ConsumerINA::ScheduleNextPacket(uint32_t flowId)
 {
-    if (interestQueue.find(prefix) == interestQueue.end()) {
-        NS_LOG_DEBUG("Flow " << prefix << " is not found in the interest queue.");
+    if (flowId >= m_flows.size()) {
+        NS_LOG_DEBUG("Flow " << flowId << " is not found in the flow table.");
         Simulator::Stop();
         return;
     }
 
+    FlowState& flow = m_flows[flowId];
+    if (!flow.active) {
+        NS_LOG_DEBUG("Flow " << flow.prefix << " was removed from the tree, stop scheduling it.");
+        return;
+    }
+
     //? Check whether interest queue is null, if so, split new interests...
     // Interest splitting
-    if (interestQueue[prefix].empty()) {
+    if (flow.interestQueue.empty()) {
         // Reach the last iteration, stop scheduling new packets for current flow
         if (globalSeq == m_iteNum) {
             NS_LOG_INFO("All iterations have been finished, no need to schedule new interests.");
@@ -129,26 +135,26 @@ ConsumerINA::ScheduleNextPacket(std::string prefix)
             //? Fail to split new interests, schedule this flow later
             NS_LOG_DEBUG("Other flows' queue is full, schedule this flow later.");
         } else {
-            if (m_sendEvent[prefix].IsRunning()) {
-                Simulator::Remove(m_sendEvent[prefix]);
+            if (flow.sendEvent.IsRunning()) {
+                Simulator::Remove(flow.sendEvent);
                 NS_LOG_DEBUG("Suspicious, remove the previous event.");
             } 
             
-            m_sendEvent[prefix] = Simulator::ScheduleNow(&Consumer::SendPacket, this, prefix);
+            flow.sendEvent = Simulator::ScheduleNow(&Consumer::SendPacket, this, flowId);
         }
     } else {
-        if (m_sendEvent[prefix].IsRunning()) {
-            Simulator::Remove(m_sendEvent[prefix]);
+        if (flow.sendEvent.IsRunning()) {
+            Simulator::Remove(flow.sendEvent);
             NS_LOG_DEBUG("Suspicious, remove the previous event.");
         } 
             
-        m_sendEvent[prefix] = Simulator::ScheduleNow(&Consumer::SendPacket, this, prefix);
+        flow.sendEvent = Simulator::ScheduleNow(&Consumer::SendPacket, this, flowId);
     }
 
     // Schdule next scheduling event
-    double nextTime = 1/m_rateLimit[prefix]; // Unit: us
-    NS_LOG_INFO("Flow " << prefix << " -> Schedule next sending event after " << nextTime / 1000 << " ms.");
-    m_scheduleEvent[prefix] = Simulator::Schedule(MicroSeconds(nextTime), &ConsumerINA::ScheduleNextPacket, this, prefix);
+    double nextTime = 1/flow.rateLimit; // Unit: us
+    NS_LOG_INFO("Flow " << flow.prefix << " -> Schedule next sending event after " << nextTime / 1000 << " ms.");
+    flow.scheduleEvent = Simulator::Schedule(MicroSeconds(nextTime), &ConsumerINA::ScheduleNextPacket, this, flowId);
 }
 
 
@@ -178,9 +184,9 @@ ConsumerINA::OnData(shared_ptr<const Data> data)
 
 
 void
-ConsumerINA::OnTimeout(std::string nameString)
+ConsumerINA::OnTimeout(uint32_t flowId, uint32_t seq)
 {
-    Consumer::OnTimeout(nameString);
+    Consumer::OnTimeout(flowId, seq);
 }
 
 
@@ -202,26 +208,27 @@ ConsumerINA::GetWindow() const
 
 
 void
-ConsumerINA::WindowIncrease(std::string prefix)
+ConsumerINA::WindowIncrease(uint32_t flowId)
 {
+    FlowState& flow = m_flows[flowId];
     if (m_ccAlgorithm == CcAlgorithm::AIMD) {
         // If cwnd is larger than 8, check whether current bottleneck is because of downstream slow interest, if so, stop increasing cwnd
-/*         if (m_window[prefix] > 8.0 && m_window[prefix] - m_inFlight[prefix] > 30.0){
+/*         if (flow.window > 8.0 && flow.window - flow.inFlight > 30.0){
             NS_LOG_DEBUG("Current bottleneck is downstream slow interest, stop increasing cwnd.");
         } else  */
         if (m_useWIS){
-            if (m_window[prefix] < m_ssthresh[prefix]) {
-                m_window[prefix] += 1.0;
+            if (flow.window < flow.ssthresh) {
+                flow.window += 1.0;
             } else {
-                m_window[prefix] += (1.0 / m_window[prefix]);
+                flow.window += (1.0 / flow.window);
             }
-            NS_LOG_DEBUG("Window size of flow '" << prefix << "' is increased to " << m_window[prefix]);        
+            NS_LOG_DEBUG("Window size of flow '" << flow.prefix << "' is increased to " << flow.window);        
         } else {
-            m_window[prefix] += 1.0;
-            NS_LOG_DEBUG("Window size of flow '" << prefix << "' is increased to " << m_window[prefix]);
+            flow.window += 1.0;
+            NS_LOG_DEBUG("Window size of flow '" << flow.prefix << "' is increased to " << flow.window);
         }        
     } else if (m_ccAlgorithm == CcAlgorithm::CUBIC) {
-            CubicIncerase(prefix);
+            CubicIncerase(flowId);
     } else {
         NS_LOG_DEBUG("CC alogrithm can't be recognized, please check!");
         Simulator::Stop();
@@ -231,28 +238,29 @@ ConsumerINA::WindowIncrease(std::string prefix)
 
 
 void
-ConsumerINA::WindowDecrease(std::string prefix, std::string type)
+ConsumerINA::WindowDecrease(uint32_t flowId, std::string type)
 {
+    FlowState& flow = m_flows[flowId];
     // Track last window decrease time
-    lastWindowDecreaseTime[prefix] = Simulator::Now();
+    flow.lastWindowDecreaseTime = Simulator::Now();
 
     // AIMD for timeout
     if (m_ccAlgorithm == CcAlgorithm::AIMD) {
         if (type == "timeout") {
-            m_ssthresh[prefix] = m_window[prefix] * m_alpha;
-            m_window[prefix] = m_ssthresh[prefix];
+            flow.ssthresh = flow.window * m_alpha;
+            flow.window = flow.ssthresh;
         }
         else if (type == "nack") {
-            m_ssthresh[prefix] = m_window[prefix] * m_alpha;
-            m_window[prefix] = m_ssthresh[prefix];
+            flow.ssthresh = flow.window * m_alpha;
+            flow.window = flow.ssthresh;
         }
         else if (type == "ConsumerCongestion") {
-            m_ssthresh[prefix] = m_window[prefix] * m_beta;
-            m_window[prefix] = m_ssthresh[prefix];
+            flow.ssthresh = flow.window * m_beta;
+            flow.window = flow.ssthresh;
         }
         else if (type == "RemoteCongestion") {
-            m_ssthresh[prefix] = m_window[prefix] * m_gamma;
-            m_window[prefix] = m_ssthresh[prefix];
+            flow.ssthresh = flow.window * m_gamma;
+            flow.window = flow.ssthresh;
         }
         else {
             NS_LOG_INFO("Unknown congestion type, please check!");
@@ -261,15 +269,15 @@ ConsumerINA::WindowDecrease(std::string prefix, std::string type)
     }
     else if (m_ccAlgorithm == CcAlgorithm::CUBIC) {
         if (type == "timeout") {
-            m_ssthresh[prefix] = m_window[prefix] * m_alpha;
-            m_window[prefix] = m_ssthresh[prefix];
+            flow.ssthresh = flow.window * m_alpha;
+            flow.window = flow.ssthresh;
         }
         else if (type == "nack") {
-            m_ssthresh[prefix] = m_window[prefix] * m_alpha;
-            m_window[prefix] = m_ssthresh[prefix];
+            flow.ssthresh = flow.window * m_alpha;
+            flow.window = flow.ssthresh;
         }        
         else if (type == "ConsumerCongestion") {
-            CubicDecrease(prefix, type);
+            CubicDecrease(flowId, type);
         }
         else if (type == "RemoteCongestion") {
             // Do nothing, currently disabled
@@ -285,29 +293,30 @@ ConsumerINA::WindowDecrease(std::string prefix, std::string type)
 
 
     // Window size can't be reduced below 1
-    if (m_window[prefix] < m_minWindow) {
-        m_window[prefix] = m_minWindow;
+    if (flow.window < m_minWindow) {
+        flow.window = m_minWindow;
     }
 
-    NS_LOG_DEBUG("Flow: " << prefix << ". Window size decreased to " << m_window[prefix] << ". Reason: " << type);
+    NS_LOG_DEBUG("Flow: " << flow.prefix << ". Window size decreased to " << flow.window << ". Reason: " << type);
 }
 
 
 
 void
-ConsumerINA::CubicIncerase(std::string prefix) 
+ConsumerINA::CubicIncerase(uint32_t flowId) 
 {
+    FlowState& flow = m_flows[flowId];
     // 1. Time since last congestion event in Seconds
-    const double t = (Simulator::Now().GetMicroSeconds() - lastWindowDecreaseTime[prefix].GetMicroSeconds()) / 1e6;
+    const double t = (Simulator::Now().GetMicroSeconds() - flow.lastWindowDecreaseTime.GetMicroSeconds()) / 1e6;
     NS_LOG_DEBUG("Time since last congestion event: " << t);
 
     // 2. Time it takes to increase the window to cubic_wmax
     // K = cubic_root(W_max*(1-beta_cubic)/C) (Eq. 2)
-    const double k = std::cbrt(m_cubicWmax[prefix] * (1 - m_cubicBeta) / m_cubic_c);
+    const double k = std::cbrt(flow.cubicWmax * (1 - m_cubicBeta) / m_cubic_c);
     NS_LOG_DEBUG("K value: " << k);
 
     // 3. Target: W_cubic(t) = C*(t-K)^3 + W_max (Eq. 1)
-    const double w_cubic = m_cubic_c * std::pow(t - k, 3) + m_cubicWmax[prefix];
+    const double w_cubic = m_cubic_c * std::pow(t - k, 3) + flow.cubicWmax;
     NS_LOG_DEBUG("Cubic increase target: " << w_cubic);
 
     // 4. Estimate of Reno Increase (Currently Disabled)
@@ -318,12 +327,12 @@ ConsumerINA::CubicIncerase(std::string prefix)
     //constexpr double w_est = 0.0;
 
     //? Original cubic increase
-/*     if (m_cubicWmax[prefix] <= 0) {
+/*     if (flow.cubicWmax <= 0) {
         NS_LOG_DEBUG("Error! Wmax is less than 0, check cubic increase!");
         Simulator::Stop();
     }
 
-    double cubic_increment = std::max(w_cubic, 0.0) - m_window[prefix];
+    double cubic_increment = std::max(w_cubic, 0.0) - flow.window;
     // Cubic increment must be positive:
     // Note: This change is not part of the RFC, but I added it to improve performance.
     if (cubic_increment < 0) {
@@ -331,19 +340,19 @@ ConsumerINA::CubicIncerase(std::string prefix)
     }
 
     NS_LOG_DEBUG("Cubic increment: " << cubic_increment);
-    m_window[prefix] += cubic_increment / m_window[prefix]; */
+    flow.window += cubic_increment / flow.window; */
 
     //? Customized cubic increase
-    if (m_window[prefix] < m_ssthresh[prefix]) {
-        m_window[prefix] += 1.0;
+    if (flow.window < flow.ssthresh) {
+        flow.window += 1.0;
     }
     else {
-        if (m_cubicWmax[prefix] <= 0) {
+        if (flow.cubicWmax <= 0) {
             NS_LOG_DEBUG("Error! Wmax is less than 0, check cubic increase!");
             Simulator::Stop();
         }
 
-        double cubic_increment = std::max(w_cubic, 0.0) - m_window[prefix];
+        double cubic_increment = std::max(w_cubic, 0.0) - flow.window;
         // Cubic increment must be positive:
         // Note: This change is not part of the RFC, but I added it to improve performance.
         if (cubic_increment < 0) {
@@ -351,22 +360,23 @@ ConsumerINA::CubicIncerase(std::string prefix)
         }
 
         NS_LOG_DEBUG("Cubic increment: " << cubic_increment);
-        m_window[prefix] += cubic_increment / m_window[prefix];
+        flow.window += cubic_increment / flow.window;
     }
 
-    NS_LOG_DEBUG("Window size of flow '" << prefix << "' is increased to " << m_window[prefix]);
+    NS_LOG_DEBUG("Window size of flow '" << flow.prefix << "' is increased to " << flow.window);
 }
 
 
 
 void
-ConsumerINA::CubicDecrease(std::string prefix, std::string type)
+ConsumerINA::CubicDecrease(uint32_t flowId, std::string type)
 {
+    FlowState& flow = m_flows[flowId];
     // Traditional cubic window decrease
-    m_cubicWmax[prefix] = m_window[prefix];
-    m_ssthresh[prefix] = m_window[prefix] * m_cubicBeta;
-    m_ssthresh[prefix] = std::max<double>(m_ssthresh[prefix], m_minWindow);
-    m_window[prefix] = m_window[prefix] * m_cubicBeta;
+    flow.cubicWmax = flow.window;
+    flow.ssthresh = flow.window * m_cubicBeta;
+    flow.ssthresh = std::max<double>(flow.ssthresh, m_minWindow);
+    flow.window = flow.window * m_cubicBeta;
 
     // Cubic with fast convergence
 /*     const double FAST_CONV_DIFF = 1.0; // In percent
@@ -391,19 +401,15 @@ ConsumerINA::CubicDecrease(std::string prefix, std::string type)
 
 
 void
-ConsumerINA::WindowRecorder(std::string prefix)
+ConsumerINA::WindowRecorder(uint32_t flowId)
 {
-    // Open file; on first call, truncate it to delete old content
-    std::ofstream file(windowRecorder[prefix], std::ios::app);
-
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << windowRecorder[prefix] << std::endl;
+    FlowState& flow = m_flows[flowId];
+    utils::LogFile* file = flow.windowLog;
+    if (file == nullptr) {
         return;
     }
 
-    file << ns3::Simulator::Now().GetMicroSeconds() << " " << m_window[prefix] << " " << m_ssthresh[prefix] << " " << interestQueue[prefix].size() << std::endl;
-
-    file.close();
+    file->Write(ns3::Simulator::Now().GetMicroSeconds(), flow.window, flow.ssthresh, flow.interestQueue.size());
 }
 
 
@@ -422,16 +428,16 @@ ConsumerINA::InitializeParameter()
     //Consumer::InitializeParameter();
 
 /*     // Initialize cwnd
-    for (const auto& round : globalTreeRound) {
-        for (const auto& flow : round) {
-            m_window[flow] = m_initialWindow;
-            m_inFlight[flow] = 0;
-            m_ssthresh[flow] = std::numeric_limits<double>::max();
+    for (auto& flow : m_flows) {
+        {
+            flow.window = m_initialWindow;
+            flow.inFlight = 0;
+            flow.ssthresh = std::numeric_limits<double>::max();
 
             // Initialize CUBIC factor
-            m_cubicLastWmax[flow] = m_initialWindow;
-            m_cubicWmax[flow] = m_initialWindow;
-            lastWindowDecreaseTime[flow] = Simulator::Now();
+            flow.cubicLastWmax = m_initialWindow;
+            flow.cubicWmax = m_initialWindow;
+            flow.lastWindowDecreaseTime = Simulator::Now();
         }
 
     } */
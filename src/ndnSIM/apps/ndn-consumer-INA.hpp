@@ -90,10 +90,11 @@ public:
 
     /**
      * Multiplicative decrease cwnd when timeout
-     * @param nameString
+     * @param flowId
+     * @param seq
      */
     virtual void
-    OnTimeout(std::string nameString) override;
+    OnTimeout(uint32_t flowId, uint32_t seq) override;
 
 
     /**
@@ -108,10 +109,10 @@ public:
      * Based on cwnd, schedule whether sends packet or not
      * Currently is called by each flow individually
      * Note that it's only activated after initialization, initialization process is controlled individually
-     * @param prefix
+     * @param flowId
      */
     virtual void
-    ScheduleNextPacket(std::string prefix);
+    ScheduleNextPacket(uint32_t flowId);
 
 private:
 
@@ -119,7 +120,7 @@ private:
      * Increase cwnd
      */
     void
-    WindowIncrease(std::string prefix);
+    WindowIncrease(uint32_t flowId);
 
 
     /**
@@ -127,24 +128,24 @@ private:
      * @param type
      */
     void
-    WindowDecrease(std::string prefix, std::string type);
+    WindowDecrease(uint32_t flowId, std::string type);
 
 
     /**
      * Cubic increase
-     * @param prefix Flow name
+     * @param flowId Flow id
      */
     void 
-    CubicIncerase(std::string prefix);
+    CubicIncerase(uint32_t flowId);
 
 
     /**
      * Cubic decrease
-     * @param prefix Flow name
+     * @param flowId Flow id
      * @param type Congestion type
      */
     void 
-    CubicDecrease(std::string prefix, std::string type);
+    CubicDecrease(uint32_t flowId, std::string type);
 
 
     /**
@@ -166,7 +167,7 @@ private:
     /**
      * Record window size into file
      */
-    void WindowRecorder(std::string prefix);
+    void WindowRecorder(uint32_t flowId);
 
 
     /**
@@ -43,6 +43,8 @@
 
 #include "utils/ndn-ns3-packet-tag.hpp"
 #include "utils/ndn-rtt-mean-deviation.hpp"
+#include "utils/reduction-kernels.hpp"
+#include "utils/tree-message.hpp"
 
 #include <ndn-cxx/lp/tags.hpp>
 
@@ -142,6 +144,31 @@ Consumer::GetTypeId(void)
                     IntegerValue(5),
                     MakeIntegerAccessor(&Consumer::m_dataQueue),
                     MakeIntegerChecker<int>())
+        .AddAttribute("PipelineDepth",
+                    "Max number of iterations aggregated at once, 0 derives it from DataQueueSize",
+                    IntegerValue(0),
+                    MakeIntegerAccessor(&Consumer::m_pipelineDepth),
+                    MakeIntegerChecker<int>(0))
+        .AddAttribute("StragglerPolicy",
+                    "When a segment is aggregated before every child contributed (wait-all, deadline, quorum)",
+                    EnumValue(STRAGGLER_WAIT_ALL),
+                    MakeEnumAccessor(&Consumer::m_stragglerMode),
+                    MakeEnumChecker(STRAGGLER_WAIT_ALL, "wait-all", STRAGGLER_DEADLINE, "deadline", STRAGGLER_QUORUM, "quorum"))
+        .AddAttribute("CompletionQuorum",
+                    "Quorum policy: fraction of the children a segment waits for, rounded up",
+                    DoubleValue(1.0),
+                    MakeDoubleAccessor(&Consumer::m_completionQuorum),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+        .AddAttribute("CompletionDeadline",
+                    "Deadline and quorum policies: time after the start of an iteration at which it's aggregated with what arrived, 0 disables it",
+                    StringValue("0s"),
+                    MakeTimeAccessor(&Consumer::m_completionDeadline),
+                    MakeTimeChecker())
+        .AddAttribute("LateUpdates",
+                    "Contributions arriving after their segment was aggregated are dropped, or folded into the next iteration",
+                    EnumValue(LATE_UPDATES_DROP),
+                    MakeEnumAccessor(&Consumer::m_lateUpdates),
+                    MakeEnumChecker(LATE_UPDATES_DROP, "drop", LATE_UPDATES_FOLD, "fold"))
         .AddAttribute("Constraint",
                     "Constraint of aggregation tree construction",
                     IntegerValue(5),
@@ -157,6 +184,11 @@ Consumer::GetTypeId(void)
                     IntegerValue(150),
                     MakeIntegerAccessor(&Consumer::m_dataSize),
                     MakeIntegerChecker<int>())    
+        .AddAttribute("SegmentSize",
+                    "Max number of model parameters per data packet, 0 sends the whole model in one packet",
+                    IntegerValue(0),
+                    MakeIntegerAccessor(&Consumer::m_segmentSize),
+                    MakeIntegerChecker<int>(0))
         .AddAttribute("InitPace",
                     "Initial size of the interest sending pace, default is 2 ms",
                     IntegerValue(2),
@@ -191,7 +223,12 @@ Consumer::GetTypeId(void)
                     "QueueSize-based CC's initial interest sending rate",
                     DoubleValue(0.5),
                     MakeDoubleAccessor(&Consumer::m_qsInitRate),
-                    MakeDoubleChecker<double>());                    
+                    MakeDoubleChecker<double>())
+        .AddAttribute("TreeChunkSize",
+                    "Max size in bytes of the tree message carried by one initialization interest, larger trees are chunked",
+                    IntegerValue(1024),
+                    MakeIntegerAccessor(&Consumer::m_treeChunkSize),
+                    MakeIntegerChecker<int>(16));                    
     return tid;
 }
 
@@ -200,6 +237,7 @@ Consumer::GetTypeId(void)
 Consumer::Consumer()
     : suspiciousPacketCount(0)
     , dataOverflow(0)
+    , dataOverflowIteration(0)
     , nackCount(0)
     , totalInterestThroughput(0)
     , totalDataThroughput(0)
@@ -214,9 +252,12 @@ Consumer::Consumer()
     , round(0)
     , totalAggregateTime(0)
     , iterationCount(0)
+    , failedIterationCount(0)
     , m_minWindow(1)
 {
     m_rtt = CreateObject<RttMeanDeviation>();
+    m_timeouts.SetCallbacks([this] (uint32_t flowId) { return m_flows[flowId].rtoThreshold; },
+                            [this] (uint32_t flowId, uint32_t seq) { OnTimeout(flowId, seq); });
 }
 
 
@@ -232,29 +273,219 @@ Consumer::TreeBroadcast()
             continue;
         }
 
-        std::string nameWithType;
-        std::string nameType = "initialization";
-        nameWithType += "/" + parentNode;
-        auto result = getLeafNodes(parentNode, broadcastTree);
+        SendTreeMessage(parentNode, broadcastTree);
+    }
+    initSeq++;
+}
 
-        // Construct nameWithType variable for tree broadcast
-        for (const auto& [childNode, leaves] : result) {
-            std::string name_indication;
-            name_indication += childNode + ".";
-            for (const auto& leaf : leaves) {
-                name_indication += leaf + ".";
-            }
-            name_indication.resize(name_indication.size() - 1);
-            nameWithType += "/" + name_indication;
+
+
+void
+Consumer::SendTreeMessage(const std::string& parentNode, const std::map<std::string, std::vector<std::string>>& tree)
+{
+    // Children and leaves travel as node ids in the interest's parameters, the name only addresses the aggregator
+    TreeAssignment assignment;
+    for (const auto& [childNode, leaves] : getLeafNodes(parentNode, tree)) {
+        std::vector<uint32_t>& leafIds = assignment[treeNodeId(childNode)];
+        for (const auto& leaf : leaves) {
+            leafIds.push_back(treeNodeId(leaf));
         }
-        nameWithType += "/" + nameType;
+    }
+    for (const auto& [childId, leafIds] : assignment) {
+        if (childId == TREE_NODE_INVALID || std::find(leafIds.begin(), leafIds.end(), TREE_NODE_INVALID) != leafIds.end()) {
+            NS_LOG_DEBUG("Tree of node " << parentNode << " has a node which isn't registered in ns-3, please check!");
+            Simulator::Stop();
+            return;
+        }
+    }
 
-        std::cout << "Node " << parentNode << "'s name is: " << nameWithType << std::endl;
-        shared_ptr<Name> newName = make_shared<Name>(nameWithType);
+    std::vector<std::vector<uint8_t>> chunks = encodeTreeMessage(assignment, m_treeChunkSize);
+    NS_LOG_INFO("Node " << parentNode << "'s tree message: " << assignment.size() << " children in " << chunks.size() << " chunk(s)");
+    m_initChunksLeft[parentNode] = chunks.size();
+    for (const auto& chunk : chunks) {
+        shared_ptr<Name> newName = make_shared<Name>("/" + parentNode + "/initialization");
         newName->appendSequenceNumber(initSeq);
-        SendInterest(newName);
+        SendInitInterest(newName, chunk);
+    }
+}
+
+
+
+TreeMaintenance*
+Consumer::GetTreeMaintenance()
+{
+    if (aggregationTree.empty()) {
+        NS_LOG_DEBUG("Aggregation tree isn't constructed yet, nothing to repair.");
+        return nullptr;
+    }
+
+    // Costs and spare aggregators are only computed once the tree changes for the first time
+    if (!m_treeMaintenance) {
+        m_treeMaintenance = std::make_unique<TreeMaintenance>(filename, m_nodeprefix, m_constraint, aggregationTree[0]);
+    }
+    return m_treeMaintenance.get();
+}
+
+
+
+void
+Consumer::RemoveProducer(std::string producer)
+{
+    NS_LOG_INFO("Producer " << producer << " leaves the aggregation tree.");
+    if (TreeMaintenance* tree = GetTreeMaintenance()) {
+        ApplyTreeDiff(tree->removeProducer(producer));
+    }
+}
+
+
+
+void
+Consumer::RemoveAggregator(std::string aggregator)
+{
+    NS_LOG_INFO("Aggregator " << aggregator << " is removed from the aggregation tree.");
+    if (TreeMaintenance* tree = GetTreeMaintenance()) {
+        ApplyTreeDiff(tree->removeAggregator(aggregator));
+    }
+}
+
+
+
+void
+Consumer::RemoveLink(std::string node1, std::string node2)
+{
+    NS_LOG_INFO("Link " << node1 << " - " << node2 << " failed, repair the aggregation tree.");
+    if (TreeMaintenance* tree = GetTreeMaintenance()) {
+        ApplyTreeDiff(tree->removeLink(node1, node2));
+    }
+}
+
+
+
+void
+Consumer::ApplyTreeDiff(const TreeDiff& diff)
+{
+    producerCount -= static_cast<int>(diff.leftProducers.size());
+    if (diff.empty()) {
+        NS_LOG_INFO("Aggregation tree is unchanged.");
+        return;
+    }
+
+    // Aggregators are shared by all rounds, the consumer's own children only belong to the main tree
+    for (auto& tree : aggregationTree) {
+        for (const auto& parent : diff.removed) {
+            tree.erase(parent);
+        }
+        for (const auto& [parent, children] : diff.changed) {
+            if (parent != m_nodeprefix) {
+                tree[parent] = children;
+            }
+        }
+    }
+    auto root = diff.changed.find(m_nodeprefix);
+    if (root != diff.changed.end()) {
+        aggregationTree[0][m_nodeprefix] = root->second;
+        globalTreeRound[0] = root->second;
+    }
+
+    linkCount = 0;
+    for (const auto& round : globalTreeRound) {
+        linkCount += static_cast<int>(round.size());
+    }
+
+    UpdateFlows();
+
+    // Only the aggregators whose assignment changed learn about the repair
+    for (const auto& [parent, children] : diff.changed) {
+        if (parent == m_nodeprefix) {
+            continue;
+        }
+
+        SendTreeMessage(parent, aggregationTree[0]);
+        broadcastList.insert(parent);
+    }
+
+    // Removed aggregators get an empty assignment, which stops their flows; nothing waits for them
+    for (const auto& aggregator : diff.removed) {
+        SendTreeMessage(aggregator, {});
     }
     initSeq++;
+
+    // Nothing to wait for, new children start right away
+    if (broadcastSync && broadcastList.empty()) {
+        for (uint32_t flowId : m_pendingFlows) {
+            m_flows[flowId].scheduleEvent = Simulator::ScheduleNow(&Consumer::ScheduleNextPacket, this, flowId);
+        }
+        m_pendingFlows.clear();
+    }
+}
+
+
+
+void
+Consumer::UpdateFlows()
+{
+    std::vector<uint32_t> previous = vec_iteration;
+    uint32_t knownFlows = m_flows.size();
+    InterestGenerator();
+
+    // Seqs queued but not opened yet, every child takes part in them
+    std::vector<uint32_t> openSeqs = m_pipeline.OpenUnits();
+    std::set<uint32_t> queuedSeqs;
+    for (const auto& flow : m_flows) {
+        if (flow.active) {
+            queuedSeqs.insert(flow.interestQueue.begin(), flow.interestQueue.end());
+        }
+    }
+    for (uint32_t seq : openSeqs) {
+        queuedSeqs.erase(seq);
+    }
+
+    // New children join first, a segment only waiting for a removed child must not be emitted without its
+    // replacement. They fetch the queued seqs, and the open ones none of their producers was summed into yet
+    for (uint32_t flowId : vec_iteration) {
+        FlowState& flow = m_flows[flowId];
+        if (std::find(previous.begin(), previous.end(), flowId) != previous.end() && flow.active) {
+            continue;
+        }
+
+        NS_LOG_INFO("Flow " << flow.prefix << " joins the aggregation tree.");
+        if (flowId >= knownFlows) {
+            OpenFlowLogs(flow);
+        }
+        InitializeFlow(flow);
+        flow.active = true;
+        std::set<uint32_t> seqs = queuedSeqs;
+        for (uint32_t seq : m_pipeline.AddChild(flowId, flow.leaves)) {
+            seqs.insert(seq);
+        }
+        flow.interestQueue.assign(seqs.begin(), seqs.end());
+        if (broadcastSync) {
+            m_pendingFlows.push_back(flowId);
+        }
+    }
+
+    // Removed children, none of their seqs is expected anymore
+    std::vector<uint32_t> finished;
+    for (uint32_t flowId : previous) {
+        if (std::find(vec_iteration.begin(), vec_iteration.end(), flowId) != vec_iteration.end()) {
+            continue;
+        }
+
+        FlowState& flow = m_flows[flowId];
+        NS_LOG_INFO("Flow " << flow.prefix << " is removed from the aggregation tree.");
+        flow.active = false;
+        Simulator::Cancel(flow.scheduleEvent);
+        Simulator::Cancel(flow.sendEvent);
+        Simulator::Cancel(flow.rateEvent);
+        flow.interestQueue.clear();
+        std::vector<uint32_t> ready = m_pipeline.RemoveChild(flowId);
+        finished.insert(finished.end(), ready.begin(), ready.end());
+    }
+
+    // Segments which only waited for removed children are done
+    for (uint32_t seq : finished) {
+        SegmentAggregated(seq);
+    }
 }
 
 
@@ -507,6 +738,11 @@ Consumer::ConstructAggregationTree()
                     std::cout << leaves << " ";
                 }
                 globalTreeRound.push_back(leavesRound); // Initialize "globalTreeRound"
+
+                // Intern the leaves into flow ids, all per-flow state is indexed by them
+                for (const auto& leaves : leavesRound) {
+                    m_flows.Add(leaves);
+                }
                 std::cout << std::endl;
             }
         }
@@ -528,6 +764,17 @@ void
 Consumer::StartApplication() // Called at time specified by Start
 {
     App::StartApplication();
+    m_segmentation = ModelSegmentation(m_dataSize, m_segmentSize);
+
+    // By default as many iterations as the data queue holds segments
+    uint32_t depth = m_pipelineDepth > 0 ? m_pipelineDepth : m_dataQueue / m_segmentation.GetSegmentCount();
+    StragglerPolicy policy;
+    policy.mode = m_stragglerMode;
+    policy.quorum = m_completionQuorum;
+    policy.deadline = m_completionDeadline;
+    policy.lateUpdates = m_lateUpdates;
+    m_pipeline.Configure(m_segmentation, depth, policy,
+                         [this] (uint32_t seq) { SegmentAggregated(seq); });
 
     // Construct the tree
     ConstructAggregationTree();
@@ -551,6 +798,11 @@ Consumer::StopApplication() // Called at time specified by Stop
     NS_LOG_FUNCTION_NOARGS();
     // cancel periodic packet generation
     //Simulator::Cancel(m_sendEvent);
+    m_timeouts.Clear();
+    for (auto& [name, event] : m_initTimeouts) {
+        Simulator::Cancel(event);
+    }
+    m_initTimeouts.clear();
     App::StopApplication();
 }
 
@@ -573,31 +825,78 @@ Consumer::findRoundIndex(const std::string& target)
 
 
 double 
-Consumer::getDataQueueSize(std::string prefix)
+Consumer::getDataQueueSize(uint32_t flowId)
 {
-    double queueSize = 0.0;
-    for (const auto& [seq, aggList] : map_agg_oldSeq_newName) {
-        if (std::find(aggList.begin(), aggList.end(), prefix) == aggList.end()) {
-            queueSize += 1.0;
-        }
-    }
+    FlowState& flow = m_flows[flowId];
+    // Open segments the flow already answered, they're waiting for other flows
+    double queueSize = static_cast<double>(m_pipeline.ContributedCount(flowId));
 
-    NS_LOG_DEBUG("Flow: " << prefix << " -> Data queue size: " << queueSize);
+    NS_LOG_DEBUG("Flow: " << flow.prefix << " -> Data queue size: " << queueSize);
     return queueSize;
 }
 
 
 
 void
-Consumer::Aggregate(const ModelData& data, const uint32_t& seq)
+Consumer::SegmentAggregated(uint32_t seq)
 {
-    // first initialization
-    if (sumParameters.find(seq) == sumParameters.end()){
-        sumParameters[seq] = std::vector<double>(m_dataSize, 0.0f);
+    uint32_t iteration = m_segmentation.GetIteration(seq);
+    NS_LOG_INFO("Aggregation of iteration " << iteration << " segment " << m_segmentation.GetSegment(seq) << " finished!");
+
+    // Get aggregation result and store them, a failed segment has nothing to average
+    if (m_pipeline.IsFailed(seq)) {
+        NS_LOG_INFO("Segment " << seq << " finished without any contribution, no aggregation result for it!");
+    } else {
+        aggregationResult[seq] = getMean(seq);
+    }
+
+    // Mark the map that current segment has finished
+    m_agg_finished[seq] = true;
+
+    // Release the segment, the iteration has finished once all its segments have
+    Time iterationStart;
+    bool iterationFailed = false;
+    bool iterationDone = m_pipeline.Close(seq, &iterationStart, &iterationFailed);
+    if (iterationDone && iterationFailed) {
+        NS_LOG_INFO("Aggregation of iteration " << iteration << " failed, its aggregation time isn't recorded!");
+        std::cout << "Aggregation of iteration " << iteration << " failed!" << std::endl;
+        failedIterationCount++;
+    } else if (iterationDone) {
+        NS_LOG_INFO("Aggregation of iteration " << iteration << " finished!");
+        std::cout << "Aggregation of iteration " << iteration << " finished!" << std::endl;
+
+        // Measure aggregation time
+        aggregateTime[iteration] = Simulator::Now() - iterationStart;
+        AggregateTimeSum(aggregateTime[iteration].GetMicroSeconds());
+        NS_LOG_INFO("Iteration " << iteration << "'s aggregation time is: " << aggregateTime[iteration].GetMilliSeconds() << " ms.");
+
+        // Record aggregation time
+        AggregateTimeRecorder(aggregateTime[iteration], iteration);
+
+        // Clear aggregation time mapping for current iteration
+        aggregateTime.erase(iteration);
     }
 
-    // Aggregate data
-    std::transform(sumParameters[seq].begin(), sumParameters[seq].end(), data.parameters.begin(), sumParameters[seq].begin(), std::plus<double>());
+    // Stop simulation after the last iteration
+    if (iterationCount + failedIterationCount == m_iteNum) {
+        stopSimulation = Simulator::Now();
+
+        NS_LOG_DEBUG("Reach " << m_iteNum << " iterations, stop!");
+        NS_LOG_INFO("Timeout is triggered " << suspiciousPacketCount << " times.");
+        //NS_LOG_INFO("Total interest throughput is: " << totalInterestThroughput << " bytes.");
+        //NS_LOG_INFO("Total data throughput is: " << totalDataThroughput << " bytes.");
+        NS_LOG_INFO("The average aggregation time of Consumer in " << iterationCount << " iteration is: " << GetAggregateTimeAverage() << " ms");
+
+        // Record throughput into file
+        //ThroughputRecorder(totalInterestThroughput, totalDataThroughput, startSimulation, startThroughputMeasurement);
+
+        // Record result into file
+        int64_t totalTime = Simulator::Now().GetMicroSeconds() - 1000000;
+        ResultRecorder(m_iteNum, suspiciousPacketCount, GetAggregateTimeAverage(), totalTime);
+
+        // Stop simulation
+        Simulator::Stop();
+    }
 }
 
 
@@ -606,14 +905,19 @@ std::vector<double>
 Consumer::getMean(const uint32_t& seq)
 {
     std::vector<double> result;
-    if (sumParameters[seq].empty() || producerCount == 0) {
+    if (!m_pipeline.IsOpen(seq) || producerCount == 0) {
         NS_LOG_DEBUG("Error when calculating average model, please check!");
         return result;
     }
 
-    for (auto value : sumParameters[seq]) {
-        result.push_back(value / static_cast<double>(producerCount));
-    }
+    // Partial and folded segments don't hold one update per producer, the packets tell how many were summed.
+    // Only senders which don't track contributors leave the count at 0, their sum is assumed to cover
+    // every producer; a segment nothing was summed into is failed and never averaged
+    NS_ASSERT_MSG(!m_pipeline.IsFailed(seq), "Segment " << seq << " has nothing to average");
+    const std::vector<double>& sum = m_pipeline.Sum(seq);
+    uint32_t contributors = m_pipeline.Contributors(seq).count;
+    result.resize(sum.size());
+    utils::Mean(result.data(), sum.data(), sum.size(), static_cast<double>(contributors > 0 ? contributors : producerCount));
 
     return result;
 }
@@ -672,12 +976,18 @@ Consumer::OnNack(shared_ptr<const lp::Nack> nack)
     App::OnNack(nack);
     NS_LOG_INFO("NACK received for: " << nack->getInterest().getName() << ", reason: " << nack->getReason());
 
-    std::string dataName = nack->getInterest().getName().toUri();
-    std::string name_sec0 = nack->getInterest().getName().get(0).toUri();
-    uint32_t seq = nack->getInterest().getName().get(-1).toSequenceNumber();
+    uint32_t flowId = m_flows.Find(nack->getInterest().getName());
+    uint32_t seq = m_segmentation.ParseUnit(nack->getInterest().getName());
+
+    if (flowId == FlowTable::INVALID) {
+        NS_LOG_DEBUG("NACK of unknown flow, please exit and check!");
+        Simulator::Stop();
+        return;
+    }
+    FlowState& flow = m_flows[flowId];
 
-    if (m_inFlight[name_sec0] > 0) {
-        m_inFlight[name_sec0]--;
+    if (flow.inFlight > 0) {
+        flow.inFlight--;
     } else {
         NS_LOG_DEBUG("InFlight number error, please exit and check!");
         Simulator::Stop();
@@ -685,45 +995,67 @@ Consumer::OnNack(shared_ptr<const lp::Nack> nack)
     }    
 
     // Handle nack
-    interestQueue[name_sec0].push_front(seq);
-    nackSignal[name_sec0] = true;
+    flow.interestQueue.push_front(seq);
+    flow.nackSignal = true;
 
     // Stop tracing rtt and timeout
-    rttStartTime.erase(dataName);
-    m_timeoutCheck.erase(dataName);
+    m_timeouts.Remove(flowId, seq);
     nackCount++;    
 }
 
 
 
 void
-Consumer::OnTimeout(std::string nameString)
+Consumer::OnTimeout(uint32_t flowId, uint32_t seq)
 {
-    NS_LOG_INFO("Timeout triggered for: " << nameString);
-    shared_ptr<Name> name = make_shared<Name>(nameString);
-    std::string name_sec0 = name->get(0).toUri();
-    uint32_t seq = name->get(-1).toSequenceNumber();
-
-    if (m_inFlight[name_sec0] > 0) {
-        m_inFlight[name_sec0]--;
-    } else if (m_inFlight[name_sec0] < 0) {
-        NS_LOG_DEBUG("InFlight number error, please exit and check!");
-        Simulator::Stop();
+    FlowState& flow = m_flows[flowId];
+    NS_LOG_INFO("Timeout triggered for flow " << flow.prefix << ", seq " << seq);
+    flow.numTimeout++;
+
+    if (flow.inFlight > 0) {
+        flow.inFlight--;
+    }
+
+    // The child was removed from the tree, the seq isn't expected from it anymore
+    if (!flow.active) {
+        return;
+    }
+
+    // The segment was aggregated without this child (straggler tolerance), no need to retransmit
+    if (m_agg_finished.find(seq) != m_agg_finished.end()) {
+        NS_LOG_DEBUG("Segment " << seq << " already finished, drop the timeout of flow " << flow.prefix);
         return;
     }
 
     // Handle timeout on next CC round
     // QueueSize-based CC
-    timeoutSignal[name_sec0] = true;
+    flow.timeoutSignal = true;
+    flow.interestQueue.push_front(seq);
 
-    if (interestQueue.find(name_sec0) == interestQueue.end()) {
-        NS_LOG_DEBUG("Error when timeout, please exit and check!");
-        Simulator::Stop();
+    suspiciousPacketCount++;
+}
+
+
+
+void
+Consumer::OnInitTimeout(std::string nameString)
+{
+    m_initTimeouts.erase(nameString);
+
+    // A removed aggregator may be cut off by the failure which removed it, stopping it is best effort
+    std::string node = Name(nameString).get(0).toUri();
+    bool isRemoved = std::none_of(aggregationTree.begin(), aggregationTree.end(), [&node] (const auto& tree) {
+        return tree.find(node) != tree.end();
+    });
+    if (isRemoved) {
+        NS_LOG_DEBUG("Tree message " << nameString << " to removed aggregator " << node << " timeout.");
+        m_initChunksLeft.erase(node);
         return;
     }
-    interestQueue[name_sec0].push_front(seq);
 
+    NS_LOG_DEBUG("Tree broadcasting interest " << nameString << " timeout, please exit and check!");
     suspiciousPacketCount++;
+    Simulator::Stop();
 }
 
 
@@ -732,13 +1064,6 @@ void
 Consumer::SetRetxTimer(Time retxTimer)
 {
     m_retxTimer = retxTimer;
-    if (m_retxEvent.IsRunning()) {
-        Simulator::Remove(m_retxEvent); // slower, but better for memory
-    }
-
-    // Schedule timeout check event
-    NS_LOG_DEBUG("Next interval to check timeout is: " << m_retxTimer.GetMilliSeconds() << " ms");
-    m_retxEvent = Simulator::Schedule(m_retxTimer, &Consumer::CheckRetxTimeout, this);
 }
 
 
@@ -752,59 +1077,23 @@ Consumer::GetRetxTimer() const
 
 
 void
-Consumer::CheckRetxTimeout()
-{
-    Time now = Simulator::Now();
-
-    for (auto it = m_timeoutCheck.begin(); it != m_timeoutCheck.end();){
-        // Parse the string and extract the first segment, e.g. "agg0", then find out its round
-        std::string type = make_shared<Name>(it->first)->get(-2).toUri();
-
-        // For "initialization", check timeout by 3 * m_retxTimer
-        if (type == "initialization") {
-            if (now - it->second > (3 * m_retxTimer)) {
-                std::string name = it->first;
-                it = m_timeoutCheck.erase(it);
-                OnTimeout(name);
-            } else {
-                ++it;
-            }
-        } 
-        // For "data", check timeout based on measured RTO
-        else if (type == "data") {
-            std::string name = it->first;
-            std::string prefix = make_shared<Name>(name)->get(0).toUri();
-
-            if (now - it->second > RTO_threshold[prefix]) {
-                it = m_timeoutCheck.erase(it);
-                numTimeout[prefix]++;
-                OnTimeout(name);
-            } else {
-                ++it;
-            }
-        }
-    }
-    m_retxEvent = Simulator::Schedule(m_retxTimer, &Consumer::CheckRetxTimeout, this);
-}
-
-
-
-void
-Consumer::RTOMeasure(int64_t resTime, std::string prefix)
+Consumer::RTOMeasure(int64_t resTime, uint32_t flowId)
 {
-    if (!initRTO[prefix]) {
-        RTTVAR[prefix] = resTime / 2;
-        SRTT[prefix] = resTime;
-        NS_LOG_DEBUG("Initialize RTO for flow: " << prefix);
-        initRTO[prefix] = true;
+    FlowState& flow = m_flows[flowId];
+    if (!flow.initRTO) {
+        flow.rttvar = resTime / 2;
+        flow.srtt = resTime;
+        NS_LOG_DEBUG("Initialize RTO for flow: " << flow.prefix);
+        flow.initRTO = true;
     } else {
-        RTTVAR[prefix] = 0.75 * RTTVAR[prefix] + 0.25 * std::abs(SRTT[prefix] - resTime); // RTTVAR = (1 - b) * RTTVAR + b * |SRTT - RTTsample|, where b = 0.25
-        SRTT[prefix] = 0.875 * SRTT[prefix] + 0.125 * resTime; // SRTT = (1 - a) * SRTT + a * RTTsample, where a = 0.125
+        flow.rttvar = 0.75 * flow.rttvar + 0.25 * std::abs(flow.srtt - resTime); // RTTVAR = (1 - b) * RTTVAR + b * |SRTT - RTTsample|, where b = 0.25
+        flow.srtt = 0.875 * flow.srtt + 0.125 * resTime; // SRTT = (1 - a) * SRTT + a * RTTsample, where a = 0.125
     }
-    int64_t RTO = SRTT[prefix] + 4 * RTTVAR[prefix]; // RTO = SRTT + K * RTTVAR, where K = 4
+    int64_t RTO = flow.srtt + 4 * flow.rttvar; // RTO = SRTT + K * RTTVAR, where K = 4
 
-    //RTO_threshold[prefix] = MicroSeconds(4 * RTO);
-    RTO_threshold[prefix] = MicroSeconds(2 * RTO);
+    //flow.rtoThreshold = MicroSeconds(4 * RTO);
+    flow.rtoThreshold = MicroSeconds(2 * RTO);
+    m_timeouts.UpdateTimeout(flowId);
 }
 
 
@@ -821,21 +1110,25 @@ Consumer::InterestGenerator()
         objectProducer.push_back(token);
     }
 
+    vec_iteration.clear();
     for (const auto& aggTree : aggregationTree) {
         auto initialAllocation = getLeafNodes(m_nodeprefix, aggTree); // example - {agg0: [pro0, pro1]}
 
         for (const auto& [child, leaves] : initialAllocation) {
-            std::string name_sec0_2;
             std::string name_sec1;
 
             for (const auto& leaf : leaves) {
                 name_sec1 += leaf + ".";
             }
             name_sec1.resize(name_sec1.size() - 1);
-            name_sec0_2 = "/" + child + "/" + name_sec1 + "/data";
-            NameSec0_2[child] = name_sec0_2;
+            uint32_t flowId = m_flows.Add(child);
+            m_flows[flowId].dataPrefix = AggregationNameCodec::MakeDataPrefix(child, name_sec1);
+            m_flows[flowId].leaves.clear();
+            for (const auto& leaf : leaves) {
+                m_flows[flowId].leaves.push_back(treeNodeId(leaf));
+            }
 
-            vec_iteration.push_back(child); // Will be added to aggregation map later
+            vec_iteration.push_back(flowId); // Will be added to aggregation map later
         }
     }        
 }
@@ -846,18 +1139,23 @@ bool
 Consumer::InterestSplitting()
 {   
     bool canSplit = true;
-    for (const auto& [prefix, queue] : interestQueue) {
-        if (queue.size() >= m_interestQueue) {
+    for (const auto& flow : m_flows) {
+        if (flow.active && flow.interestQueue.size() >= m_interestQueue) {
             canSplit = false;
             break;
         }
     }
 
     if (canSplit) {
-        // Update seq
+        // Update seq, one interest per segment of the new iteration
         globalSeq++;
-        for (auto& [prefix, queue] : interestQueue) {
-            queue.push_back(globalSeq);
+        for (auto& flow : m_flows) {
+            if (!flow.active) {
+                continue;
+            }
+            for (uint32_t segment = 0; segment < m_segmentation.GetSegmentCount(); ++segment) {
+                flow.interestQueue.push_back(m_segmentation.ToUnit(globalSeq, segment));
+            }
         }
     } else {
         NS_LOG_INFO("Interest queue is full.");
@@ -870,30 +1168,45 @@ Consumer::InterestSplitting()
 
 
 void
-Consumer::SendPacket(std::string prefix)
+Consumer::SendPacket(uint32_t flowId)
 {
+    FlowState& flow = m_flows[flowId];
     // Error handling for queue
-    if (interestQueue[prefix].empty()) {
-        NS_LOG_INFO("No more Interests to send - prefix " << prefix);
+    if (flow.interestQueue.empty()) {
+        NS_LOG_INFO("No more Interests to send - prefix " << flow.prefix);
         Simulator::Stop();
         return;  // Early return if the queue is empty to avoid popping from an empty deque
     }
 
-    uint32_t seq = interestQueue[prefix].front();
-    interestQueue[prefix].pop_front();
-    SeqMap[prefix] = seq;
-
-    shared_ptr<Name> newName = make_shared<Name>(NameSec0_2[prefix]);
-    newName->appendSequenceNumber(seq);
-    NS_LOG_INFO("Sending packet - " << newName->toUri());
+    // Segments aggregated without this flow (straggler tolerance) aren't requested anymore
+    while (!flow.interestQueue.empty() && m_agg_finished.find(flow.interestQueue.front()) != m_agg_finished.end()) {
+        flow.interestQueue.pop_front();
+    }
+    if (flow.interestQueue.empty()) {
+        return;
+    }
 
-    SendInterest(newName);
+    uint32_t seq = flow.interestQueue.front();
+    uint32_t iteration = m_segmentation.GetIteration(seq);
 
-    // Check whether it's the start of a new iteration
-    if (aggregateStartTime.find(seq) == aggregateStartTime.end()) {
-        aggregateStartTime[seq] = Simulator::Now();
-        map_agg_oldSeq_newName[seq] = vec_iteration;
+    // The first interest of an iteration opens it, it waits while the pipeline is full
+    if (!m_pipeline.Open(iteration, vec_iteration)) {
+        NS_LOG_INFO("Pipeline is full, flow " << flow.prefix << " waits before starting iteration " << iteration);
+        // Every flow retries on each pacing tick, the iteration is counted once
+        if (iteration > dataOverflowIteration) {
+            dataOverflowIteration = iteration;
+            dataOverflow++;
+        }
+        return;
     }
+
+    flow.interestQueue.pop_front();
+    flow.seq = seq;
+
+    shared_ptr<Name> newName = make_shared<Name>(AggregationNameCodec::MakeDataName(flow.dataPrefix, seq, m_segmentation));
+    NS_LOG_INFO("Sending packet - " << *newName);
+
+    SendInterest(newName);
 }
 
 
@@ -904,26 +1217,50 @@ Consumer::SendInterest(shared_ptr<Name> newName)
     if (!m_active)
         return;
 
-    std::string nameWithSeq = newName->toUri();
-    std::string name_sec0 = newName->get(0).toUri();
+    uint32_t flowId = m_flows.Find(*newName);
+
+    // Trace timeout, the entry also holds the send time for response time measurement
+    if (flowId != FlowTable::INVALID) {
+        m_timeouts.Add(flowId, m_segmentation.ParseUnit(*newName));
+    }
+
+    shared_ptr<Interest> interest = make_shared<Interest>();
+    interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    interest->setName(*newName);
+    interest->setCanBePrefix(false);
+    time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+    interest->setInterestLifetime(interestLifeTime);
+    NS_LOG_INFO("Sending interest >>>>" << *newName);
+    m_transmittedInterests(interest, this, m_face);
+    m_appLink->onReceiveInterest(*interest);
+
+    if (flowId != FlowTable::INVALID) {
+        m_flows[flowId].inFlight++;
+    }
+}
 
-    // Trace timeout
-    m_timeoutCheck[nameWithSeq] = Simulator::Now();
 
 
-    rttStartTime[nameWithSeq] = Simulator::Now();
+void
+Consumer::SendInitInterest(shared_ptr<Name> newName, const std::vector<uint8_t>& chunk)
+{
+    if (!m_active)
+        return;
 
     shared_ptr<Interest> interest = make_shared<Interest>();
     interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
     interest->setName(*newName);
     interest->setCanBePrefix(false);
+    interest->setApplicationParameters(chunk);
     time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
     interest->setInterestLifetime(interestLifeTime);
-    NS_LOG_INFO("Sending interest >>>>" << nameWithSeq);
+
+    // The parameters digest appended to the name tells the chunks of one seq apart
+    std::string nameWithDigest = interest->getName().toUri();
+    m_initTimeouts[nameWithDigest] = Simulator::Schedule(3 * m_retxTimer, &Consumer::OnInitTimeout, this, nameWithDigest);
+    NS_LOG_INFO("Sending tree message >>>>" << nameWithDigest << " (" << chunk.size() << " bytes)");
     m_transmittedInterests(interest, this, m_face);
     m_appLink->onReceiveInterest(*interest);
-
-    m_inFlight[name_sec0]++;
 }
 
 ///////////////////////////////////////////////////
@@ -936,181 +1273,135 @@ Consumer::OnData(shared_ptr<const Data> data)
         return;
 
     App::OnData(data); // tracing inside
-    std::string type = data->getName().get(-2).toUri();
-    std::string name_sec0 = data->getName().get(0).toUri();
-    uint32_t seq = data->getName().at(-1).toSequenceNumber();
-    std::string dataName = data->getName().toUri();
+    const Name& dataName = data->getName();
+    AggregationName parsed = AggregationNameCodec::Parse(dataName, m_flows, m_segmentation); // Parsed once, everything below works on the ids
+    uint32_t flowId = parsed.flowId;
+    uint32_t seq = parsed.seq; // Init seqs aren't units
+    bool isData = parsed.type == AggregationPacketType::DATA;
     int dataSize = data->wireEncode().size();
     NS_LOG_INFO("Received content object: " << boost::cref(*data));
 
-    // Check whether this's duplicate data packet
-    if (m_agg_finished.find(seq) != m_agg_finished.end()) {
+    // Late data of a child removed from the tree, its share isn't expected anymore
+    if (isData && flowId != FlowTable::INVALID && !m_flows[flowId].active) {
+        m_timeouts.Remove(flowId, seq);
+        if (m_flows[flowId].inFlight > 0) {
+            m_flows[flowId].inFlight--;
+        }
+        NS_LOG_DEBUG("Data packet of removed flow " << m_flows[flowId].prefix << ", drop it - " << dataName);
+        return;
+    }
+
+    // Check whether this's duplicate data packet, late data is expected when segments may finish early
+    if (isData && m_agg_finished.find(seq) != m_agg_finished.end() && !m_pipeline.IsStragglerTolerant()) {
         NS_LOG_DEBUG("This data packet is duplicate, stop and check!");
         Simulator::Stop();
     }
-    
-    //? Currently pause the interest sending for 5 * current period
-    // Check partial aggregation table
-    if (sumParameters.find(seq) == sumParameters.end()) {
-        // New iteration, currently not exist in the partial agg result
-        if (partialAggResult.size() >= m_dataQueue) {
-            // Exceed max data size
-            NS_LOG_INFO("Exceeding the max partial aggregation table, stop interest sending for flow " << name_sec0);
-            NS_LOG_INFO("Current partial aggregation table size is: " << partialAggResult.size());
-            dataOverflow++;
-            
-            // Schdule next event after 5 * current period
-            if (m_scheduleEvent[name_sec0].IsRunning()) {
-                Simulator::Remove(m_scheduleEvent[name_sec0]);
-            }
-            
-            double nextTime = 5*1/m_rateLimit[name_sec0]; // Unit: us
-            NS_LOG_INFO("Flow " << name_sec0 << " -> Schedule next sending event after " << nextTime / 1000 << " ms.");
-            m_scheduleEvent[name_sec0] = Simulator::Schedule(MicroSeconds(nextTime), &Consumer::ScheduleNextPacket, this, name_sec0);
-        }
-        partialAggResult[seq] = true;
-    }
 
     // Erase timeout
-    if (m_timeoutCheck.find(dataName) != m_timeoutCheck.end())
-        m_timeoutCheck.erase(dataName);
-    else {
+    Time sentTime;
+    bool isTracked = false;
+    if (parsed.type == AggregationPacketType::INITIALIZATION) {
+        auto initTimeout = m_initTimeouts.find(dataName.toUri()); // Rare tree messages, keyed by their full URI
+        if (initTimeout != m_initTimeouts.end()) {
+            Simulator::Cancel(initTimeout->second);
+            m_initTimeouts.erase(initTimeout);
+            isTracked = true;
+        }
+    } else {
+        isTracked = m_timeouts.Remove(flowId, seq, &sentTime);
+    }
+    if (!isTracked) {
         NS_LOG_DEBUG("Suspicious data packet, not exists in timeout list.");
         Simulator::Stop();
         return;
     }
 
-    if (m_inFlight[name_sec0] > 0) {
-        m_inFlight[name_sec0]--;
+    if (isData && flowId != FlowTable::INVALID && m_flows[flowId].inFlight > 0) {
+        m_flows[flowId].inFlight--;
     }
 
 
-    if (type == "data") {
-        ModelData modelData;
+    if (isData) {
+        if (flowId == FlowTable::INVALID) {
+            NS_LOG_DEBUG("Data packet of unknown flow - " << dataName);
+            Simulator::Stop();
+            return;
+        }
+        FlowState& flow = m_flows[flowId];
+        ModelDataView modelData;
 
-        auto data_agg = map_agg_oldSeq_newName.find(seq);
-        if (data_agg != map_agg_oldSeq_newName.end()) {
-            // Aggregation starts
-            auto& aggVec = data_agg->second;
-            auto aggVecIt = std::find(aggVec.begin(), aggVec.end(), name_sec0);
-            std::vector<uint8_t> oldbuffer(data->getContent().value(), data->getContent().value() + data->getContent().value_size());
+        if (!modelData.parse(data->getContent())) {
+            NS_LOG_DEBUG("Error when deserializing data packet, please check!");
+            Simulator::Stop();
+            return;
+        }
 
-            if (deserializeModelData(oldbuffer, modelData)) {
-                if (aggVecIt != aggVec.end())
-                {
-                    Aggregate(modelData, seq);
-                    aggVec.erase(aggVecIt);
-                } 
-                else
-                {
-                    NS_LOG_INFO("This data packet is duplicate, error!");
-                    Simulator::Stop();
-                    return;
-                }                
+        IterationPipeline::Result result = m_pipeline.Contribute(seq, flowId, modelData);
+        if (result == IterationPipeline::UNKNOWN) {
+            if (m_pipeline.IsStragglerTolerant()) {
+                NS_LOG_DEBUG("Late data packet of a segment already finished, drop it - " << dataName);
             } else {
-                NS_LOG_DEBUG("Error when deserializing data packet, please check!");
+                NS_LOG_DEBUG("Suspicious data packet, not exist in aggregation map.");
                 Simulator::Stop();
-                return;
             }
+            return;
+        }
+        if (result == IterationPipeline::DUPLICATE) {
+            NS_LOG_INFO("This data packet is duplicate, error!");
+            Simulator::Stop();
+            return;
+        }
+        if (result == IterationPipeline::FOLDED) {
+            NS_LOG_DEBUG("Late data packet folded into the next iteration - " << dataName);
+            return;
+        }
 
+        // RTT measurement
+        Time responseTime = Simulator::Now() - sentTime;
+        ResponseTimeSum(responseTime.GetMicroSeconds());
+        NS_LOG_INFO("Consumer's response time of sequence " << dataName << " is: " << responseTime.GetMilliSeconds() << " ms.");
 
-            // RTT measurement
-            if (rttStartTime.find(dataName) != rttStartTime.end()){
-                responseTime[dataName] = Simulator::Now() - rttStartTime[dataName];
-                ResponseTimeSum(responseTime[dataName].GetMicroSeconds());
-                rttStartTime.erase(dataName);
-                NS_LOG_INFO("Consumer's response time of sequence " << dataName << " is: " << responseTime[dataName].GetMilliSeconds() << " ms.");
-            }
-
-            // RTO/RTT measure
-            RTOMeasure(responseTime[dataName].GetMicroSeconds(), name_sec0);
-            RTTMeasure(name_sec0, responseTime[dataName].GetMicroSeconds());
-
-            // Update estimated bandwidth
-            BandwidthEstimation(name_sec0);
-
-            // Init rate limit update
-            if (firstData.at(name_sec0)) {
-                NS_LOG_DEBUG("Init rate limit update for flow " << name_sec0);
-                m_rateEvent[name_sec0] = Simulator::ScheduleNow(&Consumer::RateLimitUpdate, this, name_sec0);
-                firstData[name_sec0] = false;
-            }
-
-            // Record QueueSize-based CC info
-            QueueRecorder(name_sec0, getDataQueueSize(name_sec0));
-
-            // Record RTT
-            ResponseTimeRecorder(name_sec0, seq, responseTime[dataName]);
-
-            // Record RTO
-            RTORecorder(name_sec0);
-
-            InFlightRecorder(name_sec0);
-
-            // Check whether the aggregation iteration has finished
-            if (aggVec.empty()) {
-                NS_LOG_INFO("Aggregation of iteration " << seq << " finished!");
-                std::cout << "Aggregation of iteration " << seq << " finished!" << std::endl;
-
-                // Measure aggregation time
-                if (aggregateStartTime.find(seq) != aggregateStartTime.end()) {
-                    aggregateTime[seq] = Simulator::Now() - aggregateStartTime[seq];
-                    AggregateTimeSum(aggregateTime[seq].GetMicroSeconds());
-                    NS_LOG_INFO("Iteration " << seq << "'s aggregation time is: " << aggregateTime[seq].GetMilliSeconds() << " ms.");
-                    aggregateStartTime.erase(seq);
-                } else {
-                    NS_LOG_DEBUG("Error when calculating aggregation time, no reference found for seq " << seq);
-                }
-
-                // Record aggregation time
-                AggregateTimeRecorder(aggregateTime[seq], seq);
-
-                // Get aggregation result and store them
-                aggregationResult[seq] = getMean(seq);
-
-                // Mark the map that current iteration has finished
-                m_agg_finished[seq] = true;
+        // RTO/RTT measure
+        RTOMeasure(responseTime.GetMicroSeconds(), flowId);
+        RTTMeasure(flowId, responseTime.GetMicroSeconds());
 
-                // Clear aggregation time mapping for current iteration
-                aggregateTime.erase(seq);                
+        // Update estimated bandwidth
+        BandwidthEstimation(flowId);
 
-                // Remove seq from aggMap
-                map_agg_oldSeq_newName.erase(seq);
-                partialAggResult.erase(seq);
-            }
+        // Init rate limit update
+        if (flow.firstData) {
+            NS_LOG_DEBUG("Init rate limit update for flow " << flow.prefix);
+            flow.rateEvent = Simulator::ScheduleNow(&Consumer::RateLimitUpdate, this, flowId);
+            flow.firstData = false;
+        }
 
-            // Stop simulation
-            if (iterationCount == m_iteNum) {
-                stopSimulation = Simulator::Now();
+        // Record QueueSize-based CC info
+        QueueRecorder(flowId, getDataQueueSize(flowId));
 
-                NS_LOG_DEBUG("Reach " << m_iteNum << " iterations, stop!");
-                NS_LOG_INFO("Timeout is triggered " << suspiciousPacketCount << " times.");
-                //NS_LOG_INFO("Total interest throughput is: " << totalInterestThroughput << " bytes.");
-                //NS_LOG_INFO("Total data throughput is: " << totalDataThroughput << " bytes.");
-                NS_LOG_INFO("The average aggregation time of Consumer in " << iterationCount << " iteration is: " << GetAggregateTimeAverage() << " ms");
+        // Record RTT
+        ResponseTimeRecorder(flowId, seq, responseTime);
 
-                // Record throughput into file
-                //ThroughputRecorder(totalInterestThroughput, totalDataThroughput, startSimulation, startThroughputMeasurement);
+        // Record RTO
+        RTORecorder(flowId);
 
-                // Record result into file
-                int64_t totalTime = Simulator::Now().GetMicroSeconds() - 1000000;
-                ResultRecorder(m_iteNum, suspiciousPacketCount, GetAggregateTimeAverage(), totalTime);
+        InFlightRecorder(flowId);
 
-                // Stop simulation
-                Simulator::Stop();
-                return;
-            }
+        // Check whether the aggregation of current segment has finished
+        if (result == IterationPipeline::READY) {
+            SegmentAggregated(seq);
+        }
 
-            // Clear rtt mapping of this packet
-            rttStartTime.erase(dataName);
-            responseTime.erase(dataName);
-        } else {
-            NS_LOG_DEBUG("Suspicious data packet, not exist in aggregation map.");
-            Simulator::Stop();
+    } else if (parsed.type == AggregationPacketType::INITIALIZATION) {
+        // Update synchronization info, an aggregator is done once every chunk of its tree message is acknowledged
+        std::string name_sec0 = data->getName().get(0).toUri();
+        auto chunksLeft = m_initChunksLeft.find(name_sec0);
+        if (chunksLeft != m_initChunksLeft.end() && --chunksLeft->second > 0) {
+            NS_LOG_DEBUG("Node " << name_sec0 << " still misses " << chunksLeft->second << " chunk(s) of its tree message");
+            return;
+        }
+        if (chunksLeft != m_initChunksLeft.end()) {
+            m_initChunksLeft.erase(chunksLeft);
         }
-        
-    } else if (type == "initialization") {
-        // Update synchronization info
         auto it = std::find(broadcastList.begin(), broadcastList.end(), name_sec0);
         if (it != broadcastList.end()) {
             broadcastList.erase(it);
@@ -1118,21 +1409,28 @@ Consumer::OnData(shared_ptr<const Data> data)
         }
 
         // Tree broadcasting synchronization is done
-        if (broadcastList.empty()) {
+        if (broadcastList.empty() && !broadcastSync) {
             broadcastSync = true;
             NS_LOG_DEBUG("Synchronization of tree broadcasting finished!");
 
             // Record aggregation tree into file
             AggTreeRecorder();
-        }
 
-        //* Schedule all flows together after synchronization
-        if (broadcastSync) {
+            //* Schedule all flows together after synchronization
             for (const auto& vec_round : globalTreeRound) {
-                for (const auto& flow : vec_round) {
-                    m_scheduleEvent[flow] = Simulator::ScheduleNow(&Consumer::ScheduleNextPacket, this, flow);
+                for (const auto& prefix : vec_round) {
+                    uint32_t id = m_flows.Find(prefix);
+                    m_flows[id].scheduleEvent = Simulator::ScheduleNow(&Consumer::ScheduleNextPacket, this, id);
                 }
             }
+        } else if (broadcastList.empty()) {
+            NS_LOG_DEBUG("Tree repair acknowledged by all changed aggregators.");
+
+            // Children which joined with the repair start now that their subtree knows its assignment
+            for (uint32_t id : m_pendingFlows) {
+                m_flows[id].scheduleEvent = Simulator::ScheduleNow(&Consumer::ScheduleNextPacket, this, id);
+            }
+            m_pendingFlows.clear();
         }
     }
 }
@@ -1140,32 +1438,33 @@ Consumer::OnData(shared_ptr<const Data> data)
 
 
 bool
-Consumer::CongestionDetection(std::string prefix, int64_t responseTime)
+Consumer::CongestionDetection(uint32_t flowId, int64_t responseTime)
 {
+    FlowState& flow = m_flows[flowId];
     //* Normal usage is "push_back" "pop_front"
     // Update RTT windowed queue and historical estimation
-    RTT_windowed_queue[prefix].push_back(responseTime);
-    RTT_count[prefix]++;
+    flow.rttWindowedQueue.push_back(responseTime);
+    flow.rttCount++;
 
-    if (RTT_windowed_queue[prefix].size() > m_smooth_window_size) {
-        int64_t transitionValue = RTT_windowed_queue[prefix].front();
-        RTT_windowed_queue[prefix].pop_front();
+    if (flow.rttWindowedQueue.size() > m_smooth_window_size) {
+        int64_t transitionValue = flow.rttWindowedQueue.front();
+        flow.rttWindowedQueue.pop_front();
 
-        if (RTT_historical_estimation[prefix] == 0) {
-            RTT_historical_estimation[prefix] = transitionValue;
+        if (flow.rttHistoricalEstimation == 0) {
+            flow.rttHistoricalEstimation = transitionValue;
         } else {
-            RTT_historical_estimation[prefix] = m_EWMAFactor * transitionValue + (1 - m_EWMAFactor) * RTT_historical_estimation[prefix];
+            flow.rttHistoricalEstimation = m_EWMAFactor * transitionValue + (1 - m_EWMAFactor) * flow.rttHistoricalEstimation;
         }
     }
     else {
         NS_LOG_DEBUG("m_smooth_window_size: " << m_smooth_window_size);
-        NS_LOG_DEBUG("RTT_windowed_queue size: " << RTT_windowed_queue[prefix].size());
+        NS_LOG_DEBUG("RTT_windowed_queue size: " << flow.rttWindowedQueue.size());
     }
 
     // Detect congestion
-    if (RTT_count[prefix] >= 2 * m_smooth_window_size) {
+    if (flow.rttCount >= 2 * m_smooth_window_size) {
         int64_t pastRTTAverage = 0;
-        for (int64_t pastRTT : RTT_windowed_queue[prefix]) {
+        for (int64_t pastRTT : flow.rttWindowedQueue) {
             pastRTTAverage += pastRTT;
         }
         pastRTTAverage /= m_smooth_window_size;
@@ -1173,7 +1472,7 @@ Consumer::CongestionDetection(std::string prefix, int64_t responseTime)
         // Enable RTT-estimation for scheduler
         isRTTEstimated = true;
         
-        int64_t rtt_threshold = m_thresholdFactor * RTT_historical_estimation[prefix];
+        int64_t rtt_threshold = m_thresholdFactor * flow.rttHistoricalEstimation;
         if (rtt_threshold < pastRTTAverage) {
             return true;
         } else {
@@ -1181,7 +1480,7 @@ Consumer::CongestionDetection(std::string prefix, int64_t responseTime)
         }
     }
     else {
-        NS_LOG_DEBUG("RTT_count: " << RTT_count[prefix]);
+        NS_LOG_DEBUG("RTT_count: " << flow.rttCount);
         return false;
     }
 }
@@ -1189,60 +1488,40 @@ Consumer::CongestionDetection(std::string prefix, int64_t responseTime)
 
 
 void
-Consumer::RTORecorder(std::string prefix)
+Consumer::RTORecorder(uint32_t flowId)
 {
-    // Open the file using fstream in append mode
-    std::ofstream file(RTO_recorder[prefix], std::ios::app);
-
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << RTO_recorder[prefix] << std::endl;
+    FlowState& flow = m_flows[flowId];
+    utils::LogFile* file = flow.rtoLog;
+    if (file == nullptr) {
         return;
     }
 
-    // Write the response_time to the file, followed by a newline
-    file << Simulator::Now().GetMilliSeconds() << " " << RTO_threshold[prefix].GetMilliSeconds() << std::endl;
-
-    // Close the file
-    file.close();
+    file->Write(Simulator::Now().GetMilliSeconds(), flow.rtoThreshold.GetMilliSeconds());
 }
 
 
 
 void
-Consumer::ResponseTimeRecorder(std::string prefix, uint32_t seq, Time responseTime) {
-    
-    // Open the file using fstream in append mode
-    std::ofstream file(responseTime_recorder[prefix], std::ios::app);
-
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << responseTime_recorder[prefix] << std::endl;
+Consumer::ResponseTimeRecorder(uint32_t flowId, uint32_t seq, Time responseTime) {
+    utils::LogFile* file = m_flows[flowId].responseTimeLog;
+    if (file == nullptr) {
         Simulator::Stop();
         return;
     }
 
-    // Write the response_time to the file, followed by a newline
-    file << Simulator::Now().GetMilliSeconds() << " " << seq  << " " << responseTime.GetMilliSeconds() << std::endl;
-
-    // Close the file
-    file.close();
+    // Buffered by the log sink, written to disk in large blocks
+    file->Write(Simulator::Now().GetMilliSeconds(), seq, responseTime.GetMilliSeconds());
 }
 
 
 
 void
 Consumer::AggregateTimeRecorder(Time aggregateTime, uint32_t seq) {
-    // Open the file using fstream in append mode
-    std::ofstream file(aggregateTime_recorder, std::ios::app);
-
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << aggregateTime_recorder << std::endl;
+    if (aggregateTime_recorder == nullptr) {
         return;
     }
 
-    // Write aggregation time to file, followed by a new line
-    file << Simulator::Now().GetMilliSeconds() << " " << seq << " " << aggregateTime.GetMilliSeconds() << std::endl;
-
-    file.close();
+    aggregateTime_recorder->Write(Simulator::Now().GetMilliSeconds(), seq, aggregateTime.GetMilliSeconds());
 }
 
 
@@ -1255,28 +1534,13 @@ Consumer::InitializeLogFile()
     CheckDirectoryExist(fwdFolderPath);
 
     // Open the file and clear all contents for all log files
-    for (int roundIndex = 0; roundIndex < globalTreeRound.size(); roundIndex++) {
-        for (int i = 0; i < globalTreeRound[roundIndex].size(); i++) {
-            // RTT/RTO recorder
-            responseTime_recorder[globalTreeRound[roundIndex][i]] = conFolderPath + m_prefix.toUri() + "_RTT_" + globalTreeRound[roundIndex][i] + ".txt";
-            RTO_recorder[globalTreeRound[roundIndex][i]] = conFolderPath + m_prefix.toUri() + "_RTO_" + globalTreeRound[roundIndex][i] + ".txt";
-            OpenFile(responseTime_recorder[globalTreeRound[roundIndex][i]]);
-            OpenFile(RTO_recorder[globalTreeRound[roundIndex][i]]);
-        }
-    }
-
-    for (const auto& round : globalTreeRound) {
-        for (const auto& prefix : round) {
-            qsNew_recorder[prefix] = conFolderPath + m_prefix.toUri() + "_queue_" + prefix + ".txt";
-            inFlight_recorder[prefix] = conFolderPath + m_prefix.toUri() + "_inFlight_" + prefix + ".txt";
-            OpenFile(qsNew_recorder[prefix]);
-            OpenFile(inFlight_recorder[prefix]);
-        }
+    for (auto& flow : m_flows) {
+        OpenFlowLogs(flow);
     }
 
     // Aggregation time, AggTree, throughput
-    aggregateTime_recorder = conFolderPath + m_prefix.toUri() + "_aggregationTime.txt";
-    OpenFile(aggregateTime_recorder);
+    utils::LogSink& sink = utils::LogSink::Instance();
+    aggregateTime_recorder = sink.Open(conFolderPath + m_prefix.toUri() + "_aggregationTime.txt", {"Time", "Seq", "AggregationTime"});
     OpenFile(throughput_recorder);
     OpenFile(aggTree_recorder);
 
@@ -1286,40 +1550,30 @@ Consumer::InitializeLogFile()
 
 
 
+void
+Consumer::OpenFlowLogs(FlowState& flow)
+{
+    utils::LogSink& sink = utils::LogSink::Instance();
+
+    // RTT/RTO recorder
+    const std::string& prefix = flow.prefix;
+    flow.responseTimeLog = sink.Open(conFolderPath + m_prefix.toUri() + "_RTT_" + prefix + ".txt", {"Time", "Seq", "RTT"});
+    flow.rtoLog = sink.Open(conFolderPath + m_prefix.toUri() + "_RTO_" + prefix + ".txt", {"Time", "RTO"});
+
+    // QueueSize-based CC info
+    flow.queueLog = sink.Open(conFolderPath + m_prefix.toUri() + "_queue_" + prefix + ".txt",
+                              {"Time", "SendRate", "BW", "Throughput", "Queue", "InFlight", "RTT"});
+    flow.inFlightLog = sink.Open(conFolderPath + m_prefix.toUri() + "_inFlight_" + prefix + ".txt", {"Time", "InFlight"});
+}
+
+
+
 void
 Consumer::InitializeParameter()
 {
-    int i = 0;
-    // Each round
-    for (const auto& round : globalTreeRound) {
-        // Individual flow
-        for (const auto& prefix : round) {
-            //* Initialize RTO and RTT parameters
-            initRTO[prefix] = false;
-            RTO_threshold[prefix] = 5 * m_retxTimer;
-
-            //RTT_threshold[prefix] = 0;
-            RTT_count[prefix] = 0;
-            RTT_historical_estimation[prefix] = 0;
-
-            //* Initialize sequence map, interest queue
-            SeqMap[prefix] = 0;
-            interestQueue[prefix] = std::deque<uint32_t>();
-            m_inFlight[prefix] = 0;
-
-            // Initialize QueueSize-based CC info
-            m_qsSlidingWindows[prefix] = utils::SlidingWindow<double>(MilliSeconds(m_qsTimeDuration));
-            m_estimatedBW[prefix] = 0;
-            m_rateLimit[prefix] = m_qsInitRate;
-            firstData[prefix] = true;
-            RTT_estimation_qs[prefix] = 0;
-            nackSignal[prefix] = false;
-            timeoutSignal[prefix] = false;
-            m_lastBW[prefix] = 0;
-            m_ccState[prefix] = "Startup";
-            m_inflightLimit[prefix] = 0;
-        }
-    i++;
+    // Individual flow, of all rounds
+    for (auto& flow : m_flows) {
+        InitializeFlow(flow);
     }
 
     // Init params for interest sending rate pacing
@@ -1328,10 +1582,42 @@ Consumer::InitializeParameter()
 
 
 
+void
+Consumer::InitializeFlow(FlowState& flow)
+{
+    //* Initialize RTO and RTT parameters
+    flow.initRTO = false;
+    flow.rtoThreshold = 5 * m_retxTimer;
+
+    //RTT_threshold = 0;
+    flow.rttCount = 0;
+    flow.rttHistoricalEstimation = 0;
+
+    //* Initialize sequence map, interest queue
+    flow.seq = 0;
+    flow.interestQueue = std::deque<uint32_t>();
+    flow.inFlight = 0;
+
+    // Initialize QueueSize-based CC info
+    flow.qsSlidingWindow = utils::SlidingWindow<double>(MilliSeconds(m_qsTimeDuration));
+    flow.estimatedBW = 0;
+    flow.rateLimit = m_qsInitRate;
+    flow.firstData = true;
+    flow.rttEstimationQs = 0;
+    flow.nackSignal = false;
+    flow.timeoutSignal = false;
+    flow.lastBW = 0;
+    flow.ccState = "Startup";
+    flow.inflightLimit = 0;
+}
+
+
+
 bool
-Consumer::CanDecreaseWindow(std::string prefix, int64_t threshold)
+Consumer::CanDecreaseWindow(uint32_t flowId, int64_t threshold)
 {
-    if (Simulator::Now().GetMilliSeconds() - lastWindowDecreaseTime[prefix].GetMilliSeconds() > threshold) {
+    FlowState& flow = m_flows[flowId];
+    if (Simulator::Now().GetMilliSeconds() - flow.lastWindowDecreaseTime.GetMilliSeconds() > threshold) {
         return true;
     } else {
         return false;
@@ -1341,19 +1627,15 @@ Consumer::CanDecreaseWindow(std::string prefix, int64_t threshold)
 
 
 void
-Consumer::InFlightRecorder(std::string prefix)
+Consumer::InFlightRecorder(uint32_t flowId)
 {
-    // Open file; on first call, truncate it to delete old content
-    std::ofstream file(inFlight_recorder[prefix], std::ios::app);
-
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << inFlight_recorder[prefix] << std::endl;
+    FlowState& flow = m_flows[flowId];
+    utils::LogFile* file = flow.inFlightLog;
+    if (file == nullptr) {
         return;
     }
 
-    file << Simulator::Now().GetMilliSeconds() << " " << m_inFlight[prefix] << std::endl;
-
-    file.close();
+    file->Write(Simulator::Now().GetMilliSeconds(), flow.inFlight);
 }
 
 
@@ -1433,56 +1715,52 @@ Consumer::ResultRecorder(uint32_t iteNum, int timeoutNum, int64_t aveAggTime, in
     file << "Nack(upstream interest queue overflow) is triggered for " << nackCount << " times" << std::endl;
     file << "Average aggregation time: " << aveAggTime << " ms." << std::endl;
     file << "Total aggregation time: " << totalTime / 1000 << " ms." << std::endl;
+    m_pipeline.GetStats().Write(file, m_pipeline.GetPolicy());
     file << "-----------------------------------" << std::endl;
 }
 
 
 
 void
-Consumer::QueueRecorder(std::string prefix, double queueSize)
+Consumer::QueueRecorder(uint32_t flowId, double queueSize)
 {
-    // Open the file using fstream in append mode
-    std::ofstream file(qsNew_recorder[prefix], std::ios::app);
-
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << qsNew_recorder[prefix] << std::endl;
+    FlowState& flow = m_flows[flowId];
+    utils::LogFile* file = flow.queueLog;
+    if (file == nullptr) {
         return;
     }
 
-    // Write the response_time to the file, followed by a newline
     //* Note that throughput is transferred into Mbps
-    file << Simulator::Now().GetMilliSeconds() << " " 
-         << m_rateLimit[prefix] * 1000 << " "
-         << m_estimatedBW[prefix] * 1000 << " "    
-         << GetDataRate(prefix) * 1000000 * 8 * 8 * m_dataSize / 1000000 << " "  
-         << queueSize << " "
-         << m_inFlight[prefix] << " "
-         << RTT_estimation_qs[prefix] / 1000 << " "  
-         << std::endl;
-
-    // Close the file
-    file.close();
+    file->Write(Simulator::Now().GetMilliSeconds(),
+                flow.rateLimit * 1000,
+                flow.estimatedBW * 1000,
+                GetDataRate(flowId) * 1000000 * 8 * 8 * m_segmentation.GetSegmentLength(0) / 1000000,
+                queueSize,
+                flow.inFlight,
+                flow.rttEstimationQs / 1000);
 }
 
 
 
 void
-Consumer::RTTMeasure(std::string prefix, int64_t resTime)
+Consumer::RTTMeasure(uint32_t flowId, int64_t resTime)
 {
+    FlowState& flow = m_flows[flowId];
     // Update RTT estimation
-    if (RTT_estimation_qs[prefix] == 0) {
-        RTT_estimation_qs[prefix] = resTime;
+    if (flow.rttEstimationQs == 0) {
+        flow.rttEstimationQs = resTime;
     } else {
-        RTT_estimation_qs[prefix] = m_EWMAFactor * RTT_estimation_qs[prefix] + (1 - m_EWMAFactor) * resTime;
+        flow.rttEstimationQs = m_EWMAFactor * flow.rttEstimationQs + (1 - m_EWMAFactor) * resTime;
     }
 }
 
 
 
 double
-Consumer::GetDataRate(std::string prefix)
+Consumer::GetDataRate(uint32_t flowId)
 {
-    double rawDataRate = m_qsSlidingWindows[prefix].GetDataArrivalRate();
+    FlowState& flow = m_flows[flowId];
+    double rawDataRate = flow.qsSlidingWindow.GetDataArrivalRate();
 
     // "0": sliding window size is less than one, keep init rate as data arrival rate; "-1" indicates error
     if (rawDataRate == -1) {
@@ -1500,85 +1778,87 @@ Consumer::GetDataRate(std::string prefix)
 
 
 void
-Consumer::BandwidthEstimation(std::string prefix)
+Consumer::BandwidthEstimation(uint32_t flowId)
 {
+    FlowState& flow = m_flows[flowId];
     Time arrivalTime = Simulator::Now();
     
     // Update info within sliding window
-    double queueSize = getDataQueueSize(prefix);
-    NS_LOG_INFO("Flow: " << prefix << ", Data queue size: " << queueSize);
-    m_qsSlidingWindows[prefix].AddPacket(arrivalTime, queueSize);
+    double queueSize = getDataQueueSize(flowId);
+    NS_LOG_INFO("Flow: " << flow.prefix << ", Data queue size: " << queueSize);
+    flow.qsSlidingWindow.AddPacket(arrivalTime, queueSize);
 
-    double aveQS = m_qsSlidingWindows[prefix].GetAverageQueue();
+    double aveQS = flow.qsSlidingWindow.GetAverageQueue();
     
-    //double dataArrivalRate = m_qsSlidingWindows[prefix].GetDataRate();
-    double dataArrivalRate = GetDataRate(prefix);
+    //double dataArrivalRate = flow.qsSlidingWindow.GetDataRate();
+    double dataArrivalRate = GetDataRate(flowId);
 
     // Update bandwidth estimation
     if (dataArrivalRate == 0) {
         NS_LOG_INFO("Data rate is 0, don't update bandwidth.");
     } else {
         if (aveQS > m_queueThreshold) {
-            m_estimatedBW[prefix] = dataArrivalRate;
+            flow.estimatedBW = dataArrivalRate;
         }
 
-        if (dataArrivalRate > m_estimatedBW[prefix]) {
-            m_estimatedBW[prefix] = dataArrivalRate;
+        if (dataArrivalRate > flow.estimatedBW) {
+            flow.estimatedBW = dataArrivalRate;
         }        
     }  
 
-    NS_LOG_INFO("Flow: " << prefix << 
+    NS_LOG_INFO("Flow: " << flow.prefix << 
                 " - Average data queue size: " << aveQS << 
                 ", Arrival Rate: " << dataArrivalRate * 1000 << 
-                " pkgs/ms, Bandwidth estimation: " << m_estimatedBW[prefix] * 1000 << " pkgs/ms");
+                " pkgs/ms, Bandwidth estimation: " << flow.estimatedBW * 1000 << " pkgs/ms");
 }
 
 
 
 void
-Consumer::RateLimitUpdate(std::string prefix)
+Consumer::RateLimitUpdate(uint32_t flowId)
 {
-    double aveQS = m_qsSlidingWindows[prefix].GetAverageQueue();
-    NS_LOG_INFO("Flow " << prefix << " - data queue size: " << aveQS);
+    FlowState& flow = m_flows[flowId];
+    double aveQS = flow.qsSlidingWindow.GetAverageQueue();
+    NS_LOG_INFO("Flow " << flow.prefix << " - data queue size: " << aveQS);
 
 
     // Congestion control
-    if (m_estimatedBW[prefix] != 0) {
-        if (nackSignal[prefix]) {
-            nackSignal[prefix] = false;
-            m_rateLimit[prefix] = m_estimatedBW[prefix] * m_qsMDFactor;
-            NS_LOG_INFO("Congestion detected. Reason: nack signal detected. Update rate limit: " << m_rateLimit[prefix] * 1000 << " pkgs/ms");
-        } else if (timeoutSignal[prefix]) {
-            timeoutSignal[prefix] = false;
-            m_rateLimit[prefix] = m_estimatedBW[prefix] * m_qsMDFactor;
-            NS_LOG_INFO("Congestion detected. Reason: timeout . Update rate limit: " << m_rateLimit[prefix] * 1000 << " pkgs/ms");
+    if (flow.estimatedBW != 0) {
+        if (flow.nackSignal) {
+            flow.nackSignal = false;
+            flow.rateLimit = flow.estimatedBW * m_qsMDFactor;
+            NS_LOG_INFO("Congestion detected. Reason: nack signal detected. Update rate limit: " << flow.rateLimit * 1000 << " pkgs/ms");
+        } else if (flow.timeoutSignal) {
+            flow.timeoutSignal = false;
+            flow.rateLimit = flow.estimatedBW * m_qsMDFactor;
+            NS_LOG_INFO("Congestion detected. Reason: timeout . Update rate limit: " << flow.rateLimit * 1000 << " pkgs/ms");
         } else if (aveQS > 2 * m_queueThreshold) {
-            m_rateLimit[prefix] = m_estimatedBW[prefix] * m_qsMDFactor;
-            NS_LOG_INFO("Congestion detected. Reason: large data queue. Update rate limit: " << m_rateLimit[prefix] * 1000 << " pkgs/ms");
-        } else if (m_inFlight[prefix] > 1.5 * m_inflightThreshold) {
-            m_rateLimit[prefix] = m_estimatedBW[prefix] * m_qsMDFactor;
-            NS_LOG_INFO("Congestion detected. Reason: inflight interests. Update rate limit: " << m_rateLimit[prefix] * 1000 << " pkgs/ms");
+            flow.rateLimit = flow.estimatedBW * m_qsMDFactor;
+            NS_LOG_INFO("Congestion detected. Reason: large data queue. Update rate limit: " << flow.rateLimit * 1000 << " pkgs/ms");
+        } else if (flow.inFlight > 1.5 * m_inflightThreshold) {
+            flow.rateLimit = flow.estimatedBW * m_qsMDFactor;
+            NS_LOG_INFO("Congestion detected. Reason: inflight interests. Update rate limit: " << flow.rateLimit * 1000 << " pkgs/ms");
         } else {
-            m_rateLimit[prefix] = m_estimatedBW[prefix];
-            NS_LOG_INFO("No congestion. Update rate limit by estimated BW: " << m_rateLimit[prefix] * 1000  << " pkgs/ms");
+            flow.rateLimit = flow.estimatedBW;
+            NS_LOG_INFO("No congestion. Update rate limit by estimated BW: " << flow.rateLimit * 1000  << " pkgs/ms");
         }        
     }
 
     // Rate probing
-    if (aveQS < m_queueThreshold && m_inFlight[prefix] < m_inflightThreshold) {
-        m_rateLimit[prefix] = m_rateLimit[prefix] * m_qsRPFactor;
-        NS_LOG_INFO("Start rate probing. Updated rate limit: " << m_rateLimit[prefix] * 1000  << " pkgs/ms");
+    if (aveQS < m_queueThreshold && flow.inFlight < m_inflightThreshold) {
+        flow.rateLimit = flow.rateLimit * m_qsRPFactor;
+        NS_LOG_INFO("Start rate probing. Updated rate limit: " << flow.rateLimit * 1000  << " pkgs/ms");
     }
     
     // Error handling
-    if (RTT_estimation_qs[prefix] == 0) {
+    if (flow.rttEstimationQs == 0) {
         NS_LOG_INFO("RTT estimation is 0, please check!");
         Simulator::Stop();
         return;
     }
     
-    NS_LOG_INFO("Flow " << prefix << " - Schedule next rate limit update after " << static_cast<double>(RTT_estimation_qs[prefix] / 1000) << " ms");
-    m_rateEvent[prefix] = Simulator::Schedule(MicroSeconds(RTT_estimation_qs[prefix]), &Consumer::RateLimitUpdate, this, prefix);
+    NS_LOG_INFO("Flow " << flow.prefix << " - Schedule next rate limit update after " << static_cast<double>(flow.rttEstimationQs / 1000) << " ms");
+    flow.rateEvent = Simulator::Schedule(MicroSeconds(flow.rttEstimationQs), &Consumer::RateLimitUpdate, this, flowId);
 }
 
 
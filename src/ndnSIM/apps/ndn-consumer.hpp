@@ -26,6 +26,12 @@
 #include "sliding-window.hpp"
 #include "ndn-app.hpp"
 #include "ModelData.hpp"
+#include "model-segmentation.hpp"
+#include "iteration-pipeline.hpp"
+#include "retx-timeout-queue.hpp"
+#include "flow-state.hpp"
+#include "aggregation-name.hpp"
+#include "src/ndnSIM/apps/algorithm/include/TreeMaintenance.hpp"
 
 #include "ns3/random-variable-stream.h"
 #include "ns3/nstime.h"
@@ -34,6 +40,7 @@
 
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 #include "ns3/ndnSIM/utils/ndn-rtt-estimator.hpp"
+#include "ns3/ndnSIM/utils/log-sink.hpp"
 #include "ns3/ptr.h"
 
 #include <set>
@@ -48,6 +55,7 @@
 #include <utility>
 #include <deque>
 #include <functional>
+#include <memory>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/tag.hpp>
@@ -86,6 +94,30 @@ public:
     */
     void TreeBroadcast();
 
+
+    /**
+     * A producer leaves the aggregation, it's pruned from the tree mid-run
+     * Only the aggregators whose assignment changed receive a new initialization interest
+     * @param producer
+     */
+    void RemoveProducer(std::string producer);
+
+
+    /**
+     * An aggregator failed or is congested, the subtree of its parent is re-clustered without it
+     * @param aggregator
+     */
+    void RemoveAggregator(std::string aggregator);
+
+
+    /**
+     * A link failed, the subtrees whose edges got more expensive are re-clustered
+     * Routing has to move off the link as well, see GlobalRoutingHelper::RemoveLink
+     * @param node1
+     * @param node2
+     */
+    void RemoveLink(std::string node1, std::string node2);
+
     
     /**
      * Implement the algorithm to compute aggregation tree
@@ -109,19 +141,27 @@ public:
     OnNack(shared_ptr<const lp::Nack> nack);
 
     /**
-     * Triggered when timeout is triggered, timeout is traced using unique interest/data name
-     * @param nameString
+     * Triggered when the interest of a flow times out, timeout is traced per (flow id, seq)
+     * @param flowId
+     * @param seq
      */
     virtual void
-    OnTimeout(std::string nameString);
+    OnTimeout(uint32_t flowId, uint32_t seq);
+
+    /**
+     * Triggered when a tree broadcasting interest isn't answered within 3 * m_retxTimer
+     * @param nameString
+     */
+    void
+    OnInitTimeout(std::string nameString);
 
     /**
      * This function generates complete interest name, by combining name and seq together, then call SendInterest to send it
      * Need to know whether it's the start of a new iteration
-     * @param prefix
+     * @param flowId
      */
     void
-    SendPacket(std::string prefix);
+    SendPacket(uint32_t flowId);
 
     /**
      * Generate interests for all iterations and push them into queue for further interest sending scheduling
@@ -131,6 +171,36 @@ public:
     void
     InterestGenerator();
 
+    /**
+     * Bring the flows in line with the consumer's children after a tree repair
+     * New children fetch the seqs still in progress none of their producers was summed into yet, removed ones are dropped from the aggregation map
+     */
+    void
+    UpdateFlows();
+
+    /**
+     * Tree repair state, link costs and spare aggregators are computed on the first change
+     * @return Tree maintenance of the main tree, nullptr before the tree is constructed
+     */
+    TreeMaintenance*
+    GetTreeMaintenance();
+
+    /**
+     * Apply a repair to the aggregation tree, then broadcast the changed assignments only
+     * @param diff
+     */
+    void
+    ApplyTreeDiff(const TreeDiff& diff);
+
+    /**
+     * Send one aggregator's assignment as a tree message (tree-message.hpp), chunked over as many
+     * "/<aggregator>/initialization/<initSeq>" interests as needed
+     * @param parentNode
+     * @param tree
+     */
+    void
+    SendTreeMessage(const std::string& parentNode, const std::map<std::string, std::vector<std::string>>& tree);
+
     /**
      * Split interest into new ones and store them into each flow's queue. 
      * If each flow's queue has at least one more space, split and return true; if any one of them is full, return false
@@ -139,11 +209,11 @@ public:
     InterestSplitting();
 
     /**
-     * Perform aggregation (plus all model parameters together) operation, perform average when this iteration is done
-     * @param data
+     * All flows of a segment returned (or were removed from the tree), store its result
+     * Stop the simulation after the last iteration
      * @param seq
      */
-    void Aggregate(const ModelData& data, const uint32_t& seq);
+    void SegmentAggregated(uint32_t seq);
 
 
     /**
@@ -184,11 +254,11 @@ public:
     
     /**
      * Get data queue of certain flow
-     * @param prefix flow name
+     * @param flowId Flow id
      * @return Data queue size
      */
     double 
-    getDataQueueSize(std::string prefix);
+    getDataQueueSize(uint32_t flowId);
 
     //! Updated QueueSize-based CC
 
@@ -196,33 +266,33 @@ public:
      * Based on returned data, update rtt estimation
      */
     void
-    RTTMeasure(std::string prefix, int64_t resTime);
+    RTTMeasure(uint32_t flowId, int64_t resTime);
 
 
     /**
      * Get the data rate and return with correct value from the sliding window
-     * @param prefix flow name
+     * @param flowId Flow id
      * @return Data rate
      */
     double
-    GetDataRate(std::string prefix);
+    GetDataRate(uint32_t flowId);
 
 
     /**
      * Bandwidth estimation
-     * @param prefix flow
+     * @param flowId Flow id
      * @param dataArrivalRate data arrival rate
      */
     void 
-    BandwidthEstimation(std::string prefix);
+    BandwidthEstimation(uint32_t flowId);
 
 
     /**
      * Update each flow's rate limit.
-     * @param prefix flow name
+     * @param flowId Flow id
      */
     void
-    RateLimitUpdate(std::string prefix);
+    RateLimitUpdate(uint32_t flowId);
 
 
     /**
@@ -232,7 +302,7 @@ public:
      * @return Whether congestion is detected
      */
     bool 
-    CongestionDetection(std::string prefix, int64_t responseTime);
+    CongestionDetection(uint32_t flowId, int64_t responseTime);
 
   
     /**
@@ -242,19 +312,19 @@ public:
      * @return New RTO
      */
     void 
-    RTOMeasure(int64_t resTime, std::string prefix);
+    RTOMeasure(int64_t resTime, uint32_t flowId);
 
     /**
      * Record the RTT when receiving data packet
      */
     void 
-    RTORecorder(std::string prefix);
+    RTORecorder(uint32_t flowId);
 
     /**
      * Record in-flight packets when receiving a new packet
      */
     void 
-    InFlightRecorder(std::string prefix);
+    InFlightRecorder(uint32_t flowId);
 
     /**
      * Record the response time for each returned packet within corresponding files (per-flow CC)
@@ -263,7 +333,7 @@ public:
      * @param ECN Whether ECN exist in current packet, type is boolean
      */
     void 
-    ResponseTimeRecorder(std::string prefix, uint32_t seq, Time responseTime);
+    ResponseTimeRecorder(uint32_t flowId, uint32_t seq, Time responseTime);
 
 
     /**
@@ -286,12 +356,26 @@ public:
     void 
     InitializeParameter();
 
+    /**
+     * Open the per-flow log files of one flow
+     * @param flow
+     */
+    void
+    OpenFlowLogs(FlowState& flow);
+
+    /**
+     * Initialize RTO and QueueSize-based CC state of one flow
+     * @param flow
+     */
+    void
+    InitializeFlow(FlowState& flow);
+
     /**
      * Check whether cwnd has been decreased within the last RTT duration
      * @return
      */
     bool 
-    CanDecreaseWindow(std::string prefix, int64_t threshold);
+    CanDecreaseWindow(uint32_t flowId, int64_t threshold);
 
     /**
      * Record the final throughput into file at the end of simulation
@@ -321,7 +405,7 @@ public:
      * Record queue size based CC info
      */
     void
-    QueueRecorder(std::string prefix, double queueSize);
+    QueueRecorder(uint32_t flowId, double queueSize);
 
 public:
     typedef void (*LastRetransmittedInterestDataDelayCallback)(Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount);
@@ -343,7 +427,7 @@ protected:
     StopApplication();
 
     virtual void
-    ScheduleNextPacket(std::string prefix) = 0;
+    ScheduleNextPacket(uint32_t flowId) = 0;
 
 
     /**
@@ -354,21 +438,23 @@ protected:
     SendInterest(shared_ptr<Name> newName);
 
     /**
-     * When invoked, check whether timeout happened for all packets in timeout list
+     * Send one chunk of a tree message in the ApplicationParameters of an initialization interest
+     * @param newName "/<aggregator>/initialization/<seq>", the parameters digest is appended
+     * @param chunk
      */
     void
-    CheckRetxTimeout();
+    SendInitInterest(shared_ptr<Name> newName, const std::vector<uint8_t>& chunk);
 
     /**
-     * Set initial interval on how long to check timeout
+     * Set the retransmission timer, the initial RTO of every flow is derived from it
      * @param retxTimer
      */
     void
     SetRetxTimer(Time retxTimer);
 
     /**
-     * Get timer for timeout check
-     * @return Timer set for timeout checking
+     * Get the retransmission timer
+     * @return Retransmission timer
      */
     Time
     GetRetxTimer() const;
@@ -397,20 +483,15 @@ protected:
     std::string filename;
 
     // Log path
-    std::string conFolderPath = "src/ndnSIM/results/logs/con";
-    std::string fwdFolderPath = "src/ndnSIM/results/logs/fwd";
-    std::map<std::string, std::string> RTO_recorder;
-    std::map<std::string, std::string> responseTime_recorder; // Format: 'Time', 'seq', 'RTT', ‘ECN’, 'isWindowDecreaseSuppressed'
-    std::map<std::string, std::string> windowRecorder; // Format: 'Time', 'cwnd', 'cwnd threshold' (when cwnd is larger than the threshold, cwnd increase will be suppressed)
-    std::map<std::string, std::string> inFlight_recorder; // Format: 'Time', 'inFlight'
-    std::map<std::string, std::string> qsNew_recorder; //! Updated queue size CC
-    std::string aggregateTime_recorder; // Format: 'Time', 'aggTime'
+    std::string conFolderPath = SimulationConfig::Instance().GetResultsDir() + "/con";
+    std::string fwdFolderPath = SimulationConfig::Instance().GetResultsDir() + "/fwd";
+    utils::LogFile* aggregateTime_recorder = nullptr; // Format: 'Time', 'aggTime'
     int suspiciousPacketCount; // When timeout is triggered, add one
     int dataOverflow; // Record the number of data overflow
+    uint32_t dataOverflowIteration; // Latest iteration counted in dataOverflow
     int nackCount; // Record the number of NACK
 
     // Update when WindowDecrease() is called every time, used for CWA algorithm
-    std::map<std::string, Time> lastWindowDecreaseTime;
     bool isWindowDecreaseSuppressed;
 
     // Throughput measurement
@@ -425,11 +506,8 @@ protected:
     // General window design
     uint32_t m_initialWindow;
     uint32_t m_minWindow;
-    std::map<std::string, double> m_window;
-    std::map<std::string, uint32_t> m_inFlight;
 
     // AIMD design
-    std::map<std::string, double> m_ssthresh;
     bool m_useCwa;
     uint32_t m_highData;
     double m_recPoint;
@@ -444,12 +522,8 @@ protected:
     static constexpr double m_cubic_c = 0.4;
     static constexpr double m_cubicBeta = 0.7;
     bool m_useCubicFastConv;
-    std::map<std::string, double> m_cubicWmax;
-    std::map<std::string, double> m_cubicLastWmax;
 
     // Interest sending rate pacing
-    std::map<std::string, EventId> m_scheduleEvent;
-    std::map<std::string, EventId> m_sendEvent;
     bool isRTTEstimated;
     int m_initPace;
 
@@ -460,28 +534,13 @@ protected:
     double m_qsRPFactor;
     int m_qsTimeDuration;
     double m_qsInitRate; // Unit: pgks/ms
-    std::map<std::string, bool> firstData;
-    std::map<std::string, utils::SlidingWindow<double>> m_qsSlidingWindows;
-    std::map<std::string, EventId> m_rateEvent;    
-    std::map<std::string, double> m_rateLimit; // Unit: pkgs/ms
-    std::map<std::string, double> m_estimatedBW; // Unit: pkgs/ms
-    std::map<std::string, int64_t> RTT_estimation_qs; // Unit: ms
-    std::map<std::string, bool> nackSignal; // NACK signal for each flow
-    std::map<std::string, bool> timeoutSignal; // Timeout signal for each flow
-    std::map<std::string, double> m_lastBW;    
-    std::map<std::string, std::string> m_ccState;
-    std::map<std::string, double> m_inflightLimit; // Inflight limit for each flow
     
 
     // Global flow map
     std::vector<std::vector<std::string>> globalTreeRound; // First dimension: round. Second dimension: next-tier leaves, initialized in ConstructAggregationTree()
     int linkCount;
 
-    std::map<std::string, int> RTT_count; // How many RTT packets this node has received, used to estimate how many iterations have passed
-
     //? The following is new design for windowed average RTT
-    std::map<std::string, std::deque<int64_t>> RTT_windowed_queue; // Store windowed average RTT for each flow
-    std::map<std::string, int64_t> RTT_historical_estimation; // Historical RTT estimation    
     int m_smooth_window_size; // Window size for RTT windowed average
 
     //* initSeq is only used once, when broadcasting the aggregation tree
@@ -490,11 +549,9 @@ protected:
     // Track seq of each flow when sending interests
     //? Track the global iteration when interest splitting
     uint32_t globalSeq;
-    //? Track the latest iteration has been sent. Function - determine whether it's the correct time to start aggregation time
-    std::map<std::string, uint32_t> SeqMap; // Key: flow, Value: seq
-    //? Keep a interest queue for each flow
-    std::map<std::string, std::deque<uint32_t>> interestQueue; // Key: flow, Value: queue
 
+    // Per-flow state (interest queue, seq, RTO, QueueSize-based CC, logs), indexed by flow id
+    FlowTable m_flows;
 
 
     // Get producer list, which are used to generate new interests
@@ -507,28 +564,24 @@ protected:
     bool broadcastSync;
     std::set<std::string> broadcastList; // Elements within the set need to be broadcasted, all elements are unique
 
+    // Tree repair, created by GetTreeMaintenance()
+    std::unique_ptr<TreeMaintenance> m_treeMaintenance;
+    std::vector<uint32_t> m_pendingFlows; // New children, scheduled once the changed aggregators acknowledged the update
+
     // Aggregation synchronization
-    std::map<uint32_t, std::vector<std::string>> map_agg_oldSeq_newName; // Manage names for entire iteration
     std::map<uint32_t, bool> m_agg_finished; // Manage whether aggregation is finished for each iteration
 
     // Used inside InterestGenerator
-    std::map<std::string, std::string> NameSec0_2; // Key: flow, Value: first three segments of interest name, e.g. "/agg0/pro0.pro1/data"    
-    std::vector<std::string> vec_iteration; // Store upstream nodes' name
+    std::vector<uint32_t> vec_iteration; // Store upstream nodes' flow ids
 
 
-    // Timeout check/ RTO measurement
-    std::map<std::string, ns3::Time> m_timeoutCheck;
-    std::map<std::string, Time> RTO_threshold;
-    std::map<std::string, int64_t> SRTT;
-    std::map<std::string, int64_t> RTTVAR;
-    std::map<std::string, bool> initRTO;
-    // TODO: Count the number of timeout, testing purpose only
-    std::map<std::string, int> numTimeout;
+    // Timeout check/ RTO measurement, data interests are keyed by (flow id, seq)
+    RetxTimeoutQueue m_timeouts;
+    std::map<std::string, EventId> m_initTimeouts; // Tree broadcasting interests, keyed by name (with parameters digest)
+    std::map<std::string, uint32_t> m_initChunksLeft; // Unacknowledged tree message chunks, per aggregator
 
 
     // Designed for actual aggregation operations
-    std::map<uint32_t, bool> partialAggResult;
-    std::map<uint32_t, std::vector<double>> sumParameters;
     std::map<uint32_t, std::vector<double>> aggregationResult;
     int producerCount;
 
@@ -537,16 +590,14 @@ protected:
     bool ECNRemote;
 
     // defined for response time
-    std::map<std::string, ns3::Time> rttStartTime;
-    std::map<std::string, ns3::Time> responseTime;
     int64_t total_response_time;
     int round;
 
     // defined for aggregation time
-    std::map<uint32_t, ns3::Time> aggregateStartTime;
-    std::map<uint32_t, ns3::Time> aggregateTime;
+    std::map<uint32_t, ns3::Time> aggregateTime; // Keyed by iteration
     int64_t totalAggregateTime;
     int iterationCount;
+    int failedIterationCount; // Finished with a failed segment, not timed
 
     // New defined attribute variables
     std::string m_topologyType;
@@ -556,6 +607,15 @@ protected:
     int m_interestQueue; // Interest queue size
     int m_dataQueue; // Data queue size
     int m_dataSize; // Data size
+    int m_segmentSize; // Max number of model parameters per data packet, 0 for the whole model
+    int m_treeChunkSize; // Max size in bytes of a tree message chunk
+    ModelSegmentation m_segmentation; // Maps the seq of a name to (iteration, segment)
+    IterationPipeline m_pipeline; // Partial sums of the iterations being aggregated
+    int m_pipelineDepth; // Max number of iterations aggregated at once, 0 for DataQueueSize / segments
+    StragglerMode m_stragglerMode; // When a segment finishes before every child contributed
+    double m_completionQuorum; // Fraction of the children a segment needs to finish
+    Time m_completionDeadline; // Time after which an iteration finishes with whatever arrived, 0 to wait
+    LateUpdates m_lateUpdates; // Contributions to finished segments, dropped or folded into the next iteration
     int m_constraint; // Constraint of each sub-tree
     double m_EWMAFactor; // Factor used in EWMA, recommended value is between 0.1 and 0.3
     double m_thresholdFactor; // Factor to compute "RTT_threshold", i.e. "RTT_threshold = Threshold_factor * RTT_measurement"
@@ -566,7 +626,6 @@ protected:
     uint32_t m_seq;      ///< @brief currently requested sequence number
     uint32_t m_seqMax;   ///< @brief maximum number of sequence number
     Time m_retxTimer;    ///< @brief Currently estimated retransmission timer
-    EventId m_retxEvent; ///< @brief Event to check whether or not retransmission should be performed
 
     Ptr<RttEstimator> m_rtt; ///< @brief RTT estimator
 
@@ -34,12 +34,14 @@
 #include "ns3/uinteger.h"
 #include "ns3/integer.h"
 #include "ns3/double.h"
+#include "ns3/enum.h"
 
 #include "model/ndn-l3-protocol.hpp"
 #include "helper/ndn-fib-helper.hpp"
 #include "ModelData.hpp"
 
-#include <random>
+#include <cmath>
+#include <limits>
 #include <vector>
 #include <memory>
 
@@ -97,15 +99,75 @@ Producer::GetTypeId(void)
                     "Define the data content size",
                     IntegerValue(150),
                     MakeIntegerAccessor(&Producer::m_dataSize),
-                    MakeIntegerChecker<int>())                    ;
+                    MakeIntegerChecker<int>())
+      .AddAttribute("PayloadEncoding",
+                    "Encoding of model parameters in data packets (fp64, fp32, fp16, bf16, int8, topk)",
+                    EnumValue(PAYLOAD_FP64),
+                    MakeEnumAccessor(&Producer::m_payloadEncoding),
+                    MakeEnumChecker(PAYLOAD_FP64, "fp64", PAYLOAD_FP32, "fp32", PAYLOAD_FP16, "fp16",
+                                    PAYLOAD_BF16, "bf16", PAYLOAD_INT8, "int8", PAYLOAD_TOPK, "topk"))
+      .AddAttribute("TopKRatio",
+                    "Fraction of model parameters (largest magnitudes) kept by the topk encoding",
+                    DoubleValue(0.1),
+                    MakeDoubleAccessor(&Producer::m_topKRatio),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+      .AddAttribute("SegmentSize",
+                    "Max number of model parameters per data packet, 0 sends the whole model in one packet",
+                    IntegerValue(0),
+                    MakeIntegerAccessor(&Producer::m_segmentSize),
+                    MakeIntegerChecker<int>(0))
+      .AddAttribute("GradientDistribution",
+                    "Distribution of the model parameters sent (uniform, gaussian, sparse, trace)",
+                    EnumValue(GRADIENT_UNIFORM),
+                    MakeEnumAccessor(&Producer::m_gradientDistribution),
+                    MakeEnumChecker(GRADIENT_UNIFORM, "uniform", GRADIENT_GAUSSIAN, "gaussian",
+                                    GRADIENT_SPARSE, "sparse", GRADIENT_TRACE, "trace"))
+      .AddAttribute("GradientMin",
+                    "Lower bound of the uniform distribution",
+                    DoubleValue(0.0),
+                    MakeDoubleAccessor(&Producer::m_gradientMin),
+                    MakeDoubleChecker<double>())
+      .AddAttribute("GradientMax",
+                    "Upper bound of the uniform distribution",
+                    DoubleValue(10.0),
+                    MakeDoubleAccessor(&Producer::m_gradientMax),
+                    MakeDoubleChecker<double>())
+      .AddAttribute("GradientMean",
+                    "Mean of the gaussian and sparse distributions",
+                    DoubleValue(0.0),
+                    MakeDoubleAccessor(&Producer::m_gradientMean),
+                    MakeDoubleChecker<double>())
+      .AddAttribute("GradientStdDev",
+                    "Standard deviation of the gaussian and sparse distributions",
+                    DoubleValue(1.0),
+                    MakeDoubleAccessor(&Producer::m_gradientStdDev),
+                    MakeDoubleChecker<double>(0.0))
+      .AddAttribute("GradientDensity",
+                    "Fraction of non-zero model parameters of the sparse distribution",
+                    DoubleValue(0.1),
+                    MakeDoubleAccessor(&Producer::m_gradientDensity),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+      .AddAttribute("GradientTrace",
+                    "File of real gradients replayed by the trace distribution (text, or raw float64 if *.bin)",
+                    StringValue(""),
+                    MakeStringAccessor(&Producer::m_gradientTrace),
+                    MakeStringChecker());
     return tid;
 }
 
 Producer::Producer()
+  : m_rand(CreateObject<UniformRandomVariable>())
 {
   //NS_LOG_FUNCTION_NOARGS();
 }
 
+int64_t
+Producer::AssignStreams(int64_t stream)
+{
+  m_rand->SetStream(stream);
+  return 1;
+}
+
 // inherited from Application base class.
 void
 Producer::StartApplication()
@@ -113,6 +175,25 @@ Producer::StartApplication()
   //NS_LOG_FUNCTION_NOARGS();
   App::StartApplication();
 
+  m_segmentation = ModelSegmentation(m_dataSize, m_segmentSize);
+
+  // Key drawn from the ns-3 random stream, payloads are reproducible from RngSeed/RngRun
+  uint64_t key = (static_cast<uint64_t>(m_rand->GetInteger(0, std::numeric_limits<uint32_t>::max())) << 32)
+                 | m_rand->GetInteger(0, std::numeric_limits<uint32_t>::max());
+  m_generator.SetKey(key);
+  m_generator.SetDistribution(m_gradientDistribution);
+  m_generator.SetRange(m_gradientMin, m_gradientMax);
+  m_generator.SetNormal(m_gradientMean, m_gradientStdDev, m_gradientDensity);
+  m_generator.SetModelSize(m_dataSize);
+  if (m_gradientDistribution == GRADIENT_TRACE && !m_generator.LoadTrace(m_gradientTrace)) {
+    Simulator::Stop();
+    return;
+  }
+
+  // Every Data carries this producer as the only contributor, aggregators merge them on the way up
+  m_contributors = ModelContributors();
+  m_contributors.add(GetNode()->GetId());
+
   FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
 }
 
@@ -141,19 +222,18 @@ Producer::OnInterest(shared_ptr<const Interest> interest)
     data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
 
     // generate new data content
-    // new data format and generate random fix size of model parameters
-    ModelData modelData;
-
-    std::default_random_engine generator(std::random_device{}()); // create random generator
-    std::uniform_real_distribution<double> distribution(0.0f, 10.0f); // define range (0.0, 10.0)
-    modelData.parameters.clear(); // clear the previous result
-    for (int i = 0; i < m_dataSize; ++i){
-        modelData.parameters.push_back(distribution(generator)); // generate random double range (0.0, 10.0)
-    }
+    // only the requested segment of the model, generated straight into the Content block
+    uint32_t unit = m_segmentation.ParseUnit(dataName);
+    uint32_t iteration = m_segmentation.GetIteration(unit);
+    uint32_t segment = m_segmentation.GetSegment(unit);
+    size_t count = m_segmentation.GetSegmentLength(segment);
+    size_t offset = m_segmentation.GetSegmentOffset(segment);
 
-    std::vector<uint8_t> buffer;
-    serializeModelData(modelData, buffer); // serialize data packet
-    data->setContent(make_shared< ::ndn::Buffer>(buffer.begin(), buffer.end()));
+    auto fill = [this, iteration, offset] (double* parameters, size_t n) {
+        m_generator.Fill(parameters, n, iteration, offset);
+    };
+    size_t topK = static_cast<size_t>(std::ceil(m_topKRatio * count));
+    data->setContent(encodeModelDataContent(count, fill, -1.0, {}, m_payloadEncoding, std::max<size_t>(topK, 1), m_contributors));
 
     // end of data content
 
@@ -34,6 +34,10 @@
 
 #include "ns3/nstime.h"
 #include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+#include "ModelData.hpp"
+#include "model-segmentation.hpp"
+#include "gradient-generator.hpp"
 
 namespace ns3 {
 namespace ndn {
@@ -58,6 +62,13 @@ public:
   virtual void
   OnInterest(shared_ptr<const Interest> interest);
 
+  /**
+   * Use a fixed stream for the generator key, so the payload doesn't depend on creation order
+   * @return Number of streams used
+   */
+  int64_t
+  AssignStreams(int64_t stream);
+
 protected:
   // inherited from Application base class.
   virtual void
@@ -75,6 +86,22 @@ private:
   uint32_t m_signature;
   Name m_keyLocator;
   int m_dataSize;
+  PayloadEncoding m_payloadEncoding;
+  double m_topKRatio;
+  int m_segmentSize;
+  ModelSegmentation m_segmentation;
+  ModelContributors m_contributors; // This producer's node id, carried in every Data
+
+  // Synthetic model parameters
+  Ptr<UniformRandomVariable> m_rand; // Draws the generator key
+  GradientGenerator m_generator;
+  GradientDistribution m_gradientDistribution;
+  double m_gradientMin;
+  double m_gradientMax;
+  double m_gradientMean;
+  double m_gradientStdDev;
+  double m_gradientDensity;
+  std::string m_gradientTrace;
 
   uint32_t m_prefixnum; //customized
 };
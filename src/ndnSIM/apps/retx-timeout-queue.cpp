@@ -0,0 +1,182 @@
+#include "retx-timeout-queue.hpp"
+
+#include "ns3/simulator.h"
+
+namespace ns3 {
+namespace ndn {
+
+RetxTimeoutQueue::~RetxTimeoutQueue()
+{
+    Simulator::Cancel(m_event);
+}
+
+
+
+void
+RetxTimeoutQueue::SetCallbacks(TimeoutGetter timeoutOf, ExpireHandler onExpire)
+{
+    m_timeoutOf = std::move(timeoutOf);
+    m_onExpire = std::move(onExpire);
+}
+
+
+
+void
+RetxTimeoutQueue::Add(uint32_t flowId, uint32_t seq)
+{
+    if (flowId >= m_queues.size()) {
+        m_queues.resize(flowId + 1);
+    }
+
+    FlowQueue& queue = m_queues[flowId];
+    Time now = Simulator::Now();
+    auto [it, inserted] = queue.pending.emplace(seq, now);
+    if (inserted) {
+        m_size++;
+    } else {
+        it->second = now; // The older entry in the FIFO is stale from now on
+    }
+    queue.entries.push_back(Entry{seq, now});
+
+    // The head only changes if the flow had nothing outstanding
+    if (!queue.armed) {
+        Arm(flowId);
+        Reschedule();
+    }
+}
+
+
+
+bool
+RetxTimeoutQueue::Remove(uint32_t flowId, uint32_t seq, Time* sentTime)
+{
+    if (flowId >= m_queues.size()) {
+        return false;
+    }
+
+    FlowQueue& queue = m_queues[flowId];
+    auto it = queue.pending.find(seq);
+    if (it == queue.pending.end()) {
+        return false;
+    }
+
+    if (sentTime != nullptr) {
+        *sentTime = it->second;
+    }
+    queue.pending.erase(it);
+    m_size--;
+
+    if (queue.pending.empty()) {
+        queue.entries.clear();
+    }
+    // Otherwise the deadline is left as is, a stale head is skipped once it's reached
+    return true;
+}
+
+
+
+void
+RetxTimeoutQueue::UpdateTimeout(uint32_t flowId)
+{
+    if (flowId < m_queues.size() && m_queues[flowId].armed) {
+        Arm(flowId);
+        Reschedule();
+    }
+}
+
+
+
+void
+RetxTimeoutQueue::Clear()
+{
+    Simulator::Cancel(m_event);
+    m_queues.clear();
+    m_deadlines.clear();
+    m_size = 0;
+}
+
+
+
+void
+RetxTimeoutQueue::Arm(uint32_t flowId)
+{
+    FlowQueue& queue = m_queues[flowId];
+    if (queue.armed) {
+        m_deadlines.erase(std::make_pair(queue.deadline, flowId));
+        queue.armed = false;
+    }
+
+    while (!queue.entries.empty()) {
+        const Entry& head = queue.entries.front();
+        auto it = queue.pending.find(head.seq);
+        if (it != queue.pending.end() && it->second == head.sent) {
+            break;
+        }
+        queue.entries.pop_front();
+    }
+
+    if (!queue.entries.empty()) {
+        queue.deadline = queue.entries.front().sent + m_timeoutOf(flowId);
+        m_deadlines.emplace(queue.deadline, flowId);
+        queue.armed = true;
+    }
+}
+
+
+
+void
+RetxTimeoutQueue::Reschedule()
+{
+    if (m_deadlines.empty()) {
+        Simulator::Cancel(m_event);
+        return;
+    }
+
+    Time earliest = m_deadlines.begin()->first;
+    if (m_event.IsRunning() && m_eventTime == earliest) {
+        return;
+    }
+
+    Simulator::Cancel(m_event);
+    Time now = Simulator::Now();
+    m_eventTime = earliest;
+    m_event = Simulator::Schedule(earliest > now ? earliest - now : Time(0), &RetxTimeoutQueue::Expire, this);
+}
+
+
+
+void
+RetxTimeoutQueue::Expire()
+{
+    Time now = Simulator::Now();
+
+    while (!m_deadlines.empty() && m_deadlines.begin()->first <= now) {
+        uint32_t flowId = m_deadlines.begin()->second;
+
+        // The head may have been answered meanwhile, look at the live one
+        Arm(flowId);
+        FlowQueue& queue = m_queues[flowId];
+        if (!queue.armed || queue.deadline > now) {
+            continue;
+        }
+
+        uint32_t seq = queue.entries.front().seq;
+        queue.entries.pop_front();
+        queue.pending.erase(seq);
+        m_size--;
+        m_deadlines.erase(std::make_pair(queue.deadline, flowId));
+        queue.armed = false;
+
+        // The handler may add interests, so the flow is re-armed only afterwards. It may as well
+        // Clear() the queue (app stopping), the flow is looked up again rather than through queue
+        m_onExpire(flowId, seq);
+        if (flowId < m_queues.size() && !m_queues[flowId].armed) {
+            Arm(flowId);
+        }
+    }
+
+    Reschedule();
+}
+
+} // namespace ndn
+} // namespace ns3
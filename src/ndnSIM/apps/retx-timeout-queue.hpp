@@ -0,0 +1,127 @@
+#ifndef RETX_TIMEOUT_QUEUE_HPP
+#define RETX_TIMEOUT_QUEUE_HPP
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * Retransmission timeouts of outstanding interests, keyed by (flow id, seq)
+ *
+ * Interests of a flow are sent in time order and all share the flow's current RTO, so every flow
+ * keeps a FIFO of send times and only its head can be the next to expire. The flow heads are
+ * ordered by deadline and exactly one ns-3 event is kept pending, for the earliest of them. Data
+ * and NACKs only drop the entry from the flow's pending set (stale FIFO entries are skipped when
+ * they reach the head), so the cost of detection grows with the number of expirations rather than
+ * with the number of outstanding interests times a polling rate.
+ *
+ * The deadline is always evaluated with the RTO the flow has now; call UpdateTimeout() whenever it
+ * changes.
+ */
+class RetxTimeoutQueue {
+public:
+    using TimeoutGetter = std::function<Time(uint32_t flowId)>;
+    using ExpireHandler = std::function<void(uint32_t flowId, uint32_t seq)>;
+
+    RetxTimeoutQueue() = default;
+
+    RetxTimeoutQueue(const RetxTimeoutQueue&) = delete;
+
+    RetxTimeoutQueue&
+    operator=(const RetxTimeoutQueue&) = delete;
+
+    ~RetxTimeoutQueue();
+
+    /**
+     * @param timeoutOf Current RTO of a flow
+     * @param onExpire Called once per expired interest, the entry is already removed; it may Add(),
+     *                 Remove() or Clear()
+     */
+    void
+    SetCallbacks(TimeoutGetter timeoutOf, ExpireHandler onExpire);
+
+    /**
+     * Start tracking an interest sent now, replaces the entry of a retransmitted seq
+     */
+    void
+    Add(uint32_t flowId, uint32_t seq);
+
+    /**
+     * Stop tracking an interest
+     * @param sentTime If not null, set to the time the interest was sent
+     * @return False if the interest isn't tracked
+     */
+    bool
+    Remove(uint32_t flowId, uint32_t seq, Time* sentTime = nullptr);
+
+    /**
+     * The RTO of a flow has changed, move its deadline accordingly
+     */
+    void
+    UpdateTimeout(uint32_t flowId);
+
+    /**
+     * Drop every entry and cancel the pending event
+     */
+    void
+    Clear();
+
+    size_t
+    size() const
+    {
+        return m_size;
+    }
+
+private:
+    /**
+     * Skip stale entries at the head of the flow's FIFO and (re)insert its deadline
+     */
+    void
+    Arm(uint32_t flowId);
+
+    /**
+     * Keep the pending event on the earliest deadline
+     */
+    void
+    Reschedule();
+
+    void
+    Expire();
+
+private:
+    struct Entry {
+        uint32_t seq;
+        Time sent;
+    };
+
+    struct FlowQueue {
+        std::deque<Entry> entries; // In send order, may hold stale entries
+        std::unordered_map<uint32_t, Time> pending; // Outstanding seq -> send time
+        Time deadline;
+        bool armed = false; // Whether deadline is in m_deadlines
+    };
+
+    TimeoutGetter m_timeoutOf;
+    ExpireHandler m_onExpire;
+    std::vector<FlowQueue> m_queues; // Indexed by flow id
+    std::set<std::pair<Time, uint32_t>> m_deadlines; // (head deadline, flow id)
+    size_t m_size = 0;
+
+    EventId m_event;
+    Time m_eventTime;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // RETX_TIMEOUT_QUEUE_HPP
@@ -0,0 +1,138 @@
+#include "simulation-config.hpp"
+
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/log.h"
+
+#include <boost/property_tree/ini_parser.hpp>
+#include <boost/algorithm/string/trim.hpp>
+
+#include <iostream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.SimulationConfig");
+
+namespace ns3 {
+namespace ndn {
+
+static GlobalValue g_simulationConfigFile =
+    GlobalValue("SimulationConfigFile",
+                "Path of the CFNAgg simulation settings (config.ini)",
+                StringValue("src/ndnSIM/experiments/simulation_settings/config.ini"),
+                MakeStringChecker());
+
+static const int DEFAULT_DATA_SIZE = 150;
+static const char* const DEFAULT_RESULTS_DIR = "src/ndnSIM/results/logs";
+
+
+
+SimulationConfig&
+SimulationConfig::Instance()
+{
+    static SimulationConfig instance;
+    return instance;
+}
+
+
+
+SimulationConfig::SimulationConfig()
+    : m_dataSize(DEFAULT_DATA_SIZE)
+    , m_resultsDir(DEFAULT_RESULTS_DIR)
+{
+    LoadFromGlobalValue();
+}
+
+
+
+bool
+SimulationConfig::Load(const std::string& filename)
+{
+    boost::property_tree::ptree tree;
+    try {
+        boost::property_tree::ini_parser::read_ini(filename, tree);
+    } catch (const std::exception& e) {
+        std::cerr << "Exception caught when loading " << filename << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    m_tree = std::move(tree);
+    m_fileName = filename;
+    for (const auto& [key, value] : m_overrides) {
+        m_tree.put(key, value);
+    }
+    UpdateCache();
+
+    NS_LOG_INFO("Simulation config loaded from " << filename << " with " << m_overrides.size() << " override(s)");
+    return true;
+}
+
+
+
+bool
+SimulationConfig::LoadFromGlobalValue()
+{
+    StringValue fileName;
+    g_simulationConfigFile.GetValue(fileName);
+    if (fileName.Get() == m_fileName) {
+        return true;
+    }
+
+    return Load(fileName.Get());
+}
+
+
+
+void
+SimulationConfig::Set(const std::string& key, const std::string& value)
+{
+    m_overrides[key] = value;
+    m_tree.put(key, value);
+    UpdateCache();
+
+    NS_LOG_INFO("Override simulation config: " << key << " = " << value);
+}
+
+
+
+bool
+SimulationConfig::SetFromString(std::string assignment)
+{
+    auto pos = assignment.find('=');
+    if (pos == std::string::npos || pos == 0) {
+        std::cerr << "Malformed config override, expect 'Section.Key=Value': " << assignment << std::endl;
+        return false;
+    }
+
+    std::string key = assignment.substr(0, pos);
+    std::string value = assignment.substr(pos + 1);
+    boost::algorithm::trim(key);
+    boost::algorithm::trim(value);
+    Set(key, value);
+    return true;
+}
+
+
+
+bool
+SimulationConfig::Has(const std::string& key) const
+{
+    return static_cast<bool>(m_tree.get_optional<std::string>(key));
+}
+
+
+
+void
+SimulationConfig::UpdateCache()
+{
+    m_dataSize = m_tree.get<int>("General.DataSize", DEFAULT_DATA_SIZE);
+
+    m_resultsDir = m_tree.get<std::string>("General.ResultsDir", "");
+    while (m_resultsDir.size() > 1 && m_resultsDir.back() == '/') {
+        m_resultsDir.pop_back();
+    }
+    if (m_resultsDir.empty()) {
+        m_resultsDir = DEFAULT_RESULTS_DIR;
+    }
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,138 @@
+#ifndef SIMULATION_CONFIG_HPP
+#define SIMULATION_CONFIG_HPP
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <map>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * Process-wide registry of the CFNAgg simulation settings (config.ini)
+ *
+ * The INI file is parsed once, on first access, from the path held by the ns-3 global value
+ * "SimulationConfigFile" (overridable by "--SimulationConfigFile=..." or NS_GLOBAL_VALUE).
+ * Individual keys can be overridden afterwards, e.g. "--Set=General.DataSize=300" in cfnagg,
+ * so a parameter sweep never has to rewrite the file. Hot values (DataSize) are cached as plain
+ * members, nothing on the packet path touches the file system.
+ */
+class SimulationConfig {
+public:
+    /**
+     * Return the singleton, loading the INI file if this is the first access
+     */
+    static SimulationConfig&
+    Instance();
+
+    /**
+     * Parse the given INI file and re-apply all overrides on top of it
+     * @param filename Path of config.ini
+     * @return False if the file can't be parsed, previous content is kept in that case
+     */
+    bool
+    Load(const std::string& filename);
+
+    /**
+     * (Re)load from the path currently held by the "SimulationConfigFile" global value,
+     * no-op if that file is already loaded. Call after CommandLine::Parse()
+     * @return False if the file can't be parsed
+     */
+    bool
+    LoadFromGlobalValue();
+
+    /**
+     * Override one key, e.g. Set("General.DataSize", "300")
+     * @param key Dotted "Section.Key" path
+     * @param value Value in its INI string form
+     */
+    void
+    Set(const std::string& key, const std::string& value);
+
+    /**
+     * Override one key from a "Section.Key=Value" assignment, used as command line callback
+     * @param assignment
+     * @return False if the assignment is malformed
+     */
+    bool
+    SetFromString(std::string assignment);
+
+    /**
+     * Typed access, throws boost::property_tree::ptree_error if the key is missing or malformed
+     * @param key Dotted "Section.Key" path
+     */
+    template<typename T>
+    T
+    Get(const std::string& key) const
+    {
+        return m_tree.get<T>(key);
+    }
+
+    /**
+     * Typed access with fallback value
+     * @param key Dotted "Section.Key" path
+     * @param defaultValue Returned if the key is missing or malformed
+     */
+    template<typename T>
+    T
+    Get(const std::string& key, const T& defaultValue) const
+    {
+        return m_tree.get<T>(key, defaultValue);
+    }
+
+    /**
+     * Whether the key exists (either in the file or as an override)
+     */
+    bool
+    Has(const std::string& key) const;
+
+    /**
+     * Cached General.DataSize, number of model parameters per data packet
+     */
+    int
+    GetDataSize() const
+    {
+        return m_dataSize;
+    }
+
+    /**
+     * Cached General.ResultsDir, folder of the recorder logs (no trailing '/'). Each run of a
+     * parameter sweep gets its own folder
+     */
+    const std::string&
+    GetResultsDir() const
+    {
+        return m_resultsDir;
+    }
+
+    /**
+     * Path of the currently loaded INI file
+     */
+    const std::string&
+    GetFileName() const
+    {
+        return m_fileName;
+    }
+
+private:
+    SimulationConfig();
+
+    /**
+     * Refresh cached members after the tree changed
+     */
+    void
+    UpdateCache();
+
+private:
+    boost::property_tree::ptree m_tree;
+    std::map<std::string, std::string> m_overrides; // Re-applied whenever the file is (re)loaded
+    std::string m_fileName;
+    int m_dataSize;
+    std::string m_resultsDir;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // SIMULATION_CONFIG_HPP
@@ -0,0 +1,107 @@
+#include "straggler-policy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace ns3 {
+namespace ndn {
+
+double
+StragglerPolicy::GetQuorum() const
+{
+    return mode == STRAGGLER_QUORUM ? quorum : 1.0;
+}
+
+
+
+Time
+StragglerPolicy::GetDeadline() const
+{
+    return mode == STRAGGLER_WAIT_ALL ? Time() : deadline;
+}
+
+
+
+std::string
+StragglerPolicy::ToString() const
+{
+    std::ostringstream os;
+    switch (mode) {
+    case STRAGGLER_WAIT_ALL:
+        os << "wait-all";
+        break;
+    case STRAGGLER_DEADLINE:
+        os << "deadline";
+        break;
+    case STRAGGLER_QUORUM:
+        os << "quorum " << quorum;
+        break;
+    }
+    if (mode != STRAGGLER_WAIT_ALL && !deadline.IsZero()) {
+        os << ", deadline " << deadline.GetMilliSeconds() << "ms";
+    }
+    if (IsTolerant()) {
+        os << (lateUpdates == LATE_UPDATES_FOLD ? ", fold" : ", drop");
+    }
+    return os.str();
+}
+
+
+
+void
+CompletionStats::AddIteration(Time completion)
+{
+    m_completions.push_back(completion);
+}
+
+
+
+void
+CompletionStats::AddSegment(uint32_t contributed, uint32_t expected)
+{
+    m_segments++;
+    if (contributed < expected) {
+        m_partialSegments++;
+    }
+    m_coverageSum += expected > 0 ? std::min(1.0, static_cast<double>(contributed) / expected) : 1.0;
+}
+
+
+
+std::vector<Time>
+CompletionStats::GetPercentiles(const std::vector<double>& ps) const
+{
+    std::vector<Time> result(ps.size());
+    if (m_completions.empty()) {
+        return result;
+    }
+
+    std::vector<Time> sorted = m_completions;
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t i = 0; i < ps.size(); ++i) {
+        // Nearest rank: smallest value with at least p percent of the samples at or below it
+        size_t rank = static_cast<size_t>(std::ceil(ps[i] / 100.0 * sorted.size()));
+        result[i] = sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+    }
+    return result;
+}
+
+
+
+void
+CompletionStats::Write(std::ostream& os, const StragglerPolicy& policy) const
+{
+    std::vector<Time> p = GetPercentiles({50, 90, 99, 100});
+    os << "Straggler policy: " << policy.ToString() << std::endl;
+    os << "Iteration completion time p50/p90/p99/max: " << p[0].GetMicroSeconds() / 1000.0 << "/" << p[1].GetMicroSeconds() / 1000.0
+       << "/" << p[2].GetMicroSeconds() / 1000.0 << "/" << p[3].GetMicroSeconds() / 1000.0 << " ms." << std::endl;
+    os << "Partial segments: " << m_partialSegments << " of " << m_segments;
+    if (m_segments > 0) {
+        os << ", average coverage " << 100.0 * m_coverageSum / m_segments << "%";
+    }
+    os << std::endl;
+}
+
+} // namespace ndn
+} // namespace ns3
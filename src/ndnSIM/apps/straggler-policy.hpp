@@ -0,0 +1,112 @@
+#ifndef STRAGGLER_POLICY_HPP
+#define STRAGGLER_POLICY_HPP
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * When a segment may be emitted before every child contributed, selected by the "StragglerPolicy" attribute
+ */
+enum StragglerMode {
+    STRAGGLER_WAIT_ALL = 0, // Wait for every child, quorum and deadline are ignored
+    STRAGGLER_DEADLINE,     // Emit whatever arrived once the iteration's deadline expired
+    STRAGGLER_QUORUM        // Emit once a quorum of the children contributed, the deadline (if any) bounds the wait
+};
+
+/**
+ * What happens to a contribution arriving after its segment was emitted, selected by the "LateUpdates" attribute
+ */
+enum LateUpdates {
+    LATE_UPDATES_DROP = 0,
+    LATE_UPDATES_FOLD       // Summed into the same segment of the next iteration
+};
+
+/**
+ * Straggler mitigation of an aggregating app (consumer or aggregator)
+ */
+struct StragglerPolicy {
+    StragglerMode mode = STRAGGLER_WAIT_ALL;
+    double quorum = 1.0; // Fraction of the children, rounded up
+    Time deadline; // After opening an iteration, zero disables it
+    LateUpdates lateUpdates = LATE_UPDATES_DROP;
+
+    /**
+     * Quorum which applies in this mode, 1 unless quorum mode
+     */
+    double
+    GetQuorum() const;
+
+    /**
+     * Deadline which applies in this mode, zero in wait-all mode
+     */
+    Time
+    GetDeadline() const;
+
+    /**
+     * Whether segments may be emitted before every child contributed
+     */
+    bool
+    IsTolerant() const
+    {
+        return GetQuorum() < 1.0 || !GetDeadline().IsZero();
+    }
+
+    /**
+     * Short description for result files, e.g. "quorum 0.8, deadline 50ms, fold"
+     */
+    std::string
+    ToString() const;
+};
+
+/**
+ * Completion times of the iterations aggregated under a straggler policy, and how partial its segments were
+ */
+class CompletionStats {
+public:
+    void
+    AddIteration(Time completion);
+
+    /**
+     * @param contributed Children (or producers) summed in the segment
+     * @param expected Children (or producers) taking part
+     */
+    void
+    AddSegment(uint32_t contributed, uint32_t expected);
+
+    /**
+     * Nearest-rank percentiles of the iteration completion times, zero if none finished
+     * @param ps Each in [0, 100]
+     */
+    std::vector<Time>
+    GetPercentiles(const std::vector<double>& ps) const;
+
+    size_t
+    GetIterationCount() const
+    {
+        return m_completions.size();
+    }
+
+    /**
+     * Write percentiles and partial segments, one "key: value" line each
+     */
+    void
+    Write(std::ostream& os, const StragglerPolicy& policy) const;
+
+private:
+    std::vector<Time> m_completions; // In completion order
+    uint64_t m_segments = 0;
+    uint64_t m_partialSegments = 0;
+    double m_coverageSum = 0.0; // Sum over segments of contributed / expected
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // STRAGGLER_POLICY_HPP
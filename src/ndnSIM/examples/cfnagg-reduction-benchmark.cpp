@@ -0,0 +1,139 @@
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM/utils/reduction-kernels.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Microbenchmark of the model aggregation kernels, one line per (DataSize, kernel, operation)
+ *
+ *   ./waf --run "cfnagg-reduction-benchmark --MinSize=150 --MaxSize=10000000 --Bytes=2000000000"
+ *
+ * DataSize grows by x10 from MinSize and always ends with MaxSize. Each measurement repeats the
+ * operation until about Bytes bytes of source operand went through it, so small sizes aren't
+ * dominated by timer resolution.
+ */
+
+namespace ns3 {
+
+    using utils::ReductionIsa;
+    using utils::ReductionKernels;
+
+    template<typename Op>
+    double
+    Measure(size_t bytesPerCall, uint64_t targetBytes, Op&& op)
+    {
+        uint64_t calls = std::max<uint64_t>(1, targetBytes / std::max<size_t>(1, bytesPerCall));
+        op(); // Warm up caches and page in the buffers
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < calls; ++i) {
+            op();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / calls;
+    }
+
+
+
+    void
+    Report(size_t n, const ReductionKernels& kernels, const std::string& op, size_t srcBytes, double nsPerCall, double scalarNs)
+    {
+        std::cout << std::setw(10) << n << "  "
+                  << std::setw(7) << kernels.name << "  "
+                  << std::setw(11) << op << "  "
+                  << std::setw(12) << std::fixed << std::setprecision(1) << nsPerCall << "  "
+                  << std::setw(9) << std::setprecision(2) << srcBytes / nsPerCall << "  "
+                  << std::setw(7) << std::setprecision(2) << scalarNs / nsPerCall << "x" << std::endl;
+    }
+
+
+
+    int main(int argc, char* argv[])
+    {
+        uint64_t minSize = 150;
+        uint64_t maxSize = 10000000;
+        uint64_t targetBytes = 2000000000;
+
+        CommandLine cmd;
+        cmd.AddValue("MinSize", "Smallest DataSize (number of parameters)", minSize);
+        cmd.AddValue("MaxSize", "Largest DataSize (number of parameters)", maxSize);
+        cmd.AddValue("Bytes", "Approximate source bytes processed per measurement", targetBytes);
+        cmd.Parse(argc, argv);
+
+        std::vector<size_t> sizes;
+        for (uint64_t n = minSize; n < maxSize; n *= 10) {
+            sizes.push_back(n);
+        }
+        sizes.push_back(maxSize);
+
+        std::vector<const ReductionKernels*> kernelsList;
+        for (ReductionIsa isa : {ReductionIsa::SCALAR, ReductionIsa::SSE2, ReductionIsa::AVX2, ReductionIsa::AVX512}) {
+            if (const ReductionKernels* kernels = utils::GetReductionKernels(isa)) {
+                kernelsList.push_back(kernels);
+            }
+        }
+        std::cout << "Dispatcher selects: " << utils::GetReductionKernels().name << std::endl;
+        std::cout << "  DataSize   kernel           op       ns/call       GB/s  speedup" << std::endl;
+
+        std::mt19937_64 generator(1);
+        std::uniform_real_distribution<double> distribution(0.0, 10.0);
+
+        for (size_t n : sizes) {
+            // +1 byte so the packet-like source operand is misaligned, as it is inside a Data packet
+            std::vector<uint8_t> raw(n * sizeof(double) + 1);
+            std::vector<double> acc(n, 0.0), out(n);
+            std::vector<float> fp32(n);
+            std::vector<uint16_t> fp16(n);
+            std::vector<uint16_t> bf16(n);
+            std::vector<int8_t> int8(n);
+            for (size_t i = 0; i < n; ++i) {
+                double value = distribution(generator);
+                std::memcpy(raw.data() + 1 + i * sizeof(double), &value, sizeof(double));
+                fp32[i] = static_cast<float>(value);
+                fp16[i] = utils::FloatToHalf(fp32[i]);
+                bf16[i] = utils::FloatToBfloat16(fp32[i]);
+                int8[i] = static_cast<int8_t>(value * 12.7);
+            }
+            const double* src = reinterpret_cast<const double*>(raw.data() + 1);
+
+            double scalarNs[7] = {};
+            for (const ReductionKernels* kernels : kernelsList) {
+                double ns[7];
+                ns[0] = Measure(n * sizeof(double), targetBytes, [&] { kernels->sum(acc.data(), src, n); });
+                ns[1] = Measure(n * sizeof(double), targetBytes, [&] { kernels->weightedSum(acc.data(), src, n, 0.5); });
+                ns[2] = Measure(n * sizeof(double), targetBytes, [&] { kernels->divide(out.data(), acc.data(), n, 3.0); });
+                ns[3] = Measure(n * sizeof(float), targetBytes, [&] { kernels->sumFloat(acc.data(), fp32.data(), n); });
+                ns[4] = Measure(n * sizeof(uint16_t), targetBytes, [&] { kernels->sumHalf(acc.data(), fp16.data(), n); });
+                ns[5] = Measure(n * sizeof(uint16_t), targetBytes, [&] { kernels->sumBfloat16(acc.data(), bf16.data(), n); });
+                ns[6] = Measure(n * sizeof(int8_t), targetBytes, [&] { kernels->sumInt8(acc.data(), int8.data(), n, 0.1); });
+
+                if (kernels->isa == ReductionIsa::SCALAR) {
+                    std::copy(ns, ns + 7, scalarNs);
+                }
+
+                Report(n, *kernels, "sum", n * sizeof(double), ns[0], scalarNs[0]);
+                Report(n, *kernels, "weighted", n * sizeof(double), ns[1], scalarNs[1]);
+                Report(n, *kernels, "mean", n * sizeof(double), ns[2], scalarNs[2]);
+                Report(n, *kernels, "sum-fp32", n * sizeof(float), ns[3], scalarNs[3]);
+                Report(n, *kernels, "sum-fp16", n * sizeof(uint16_t), ns[4], scalarNs[4]);
+                Report(n, *kernels, "sum-bf16", n * sizeof(uint16_t), ns[5], scalarNs[5]);
+                Report(n, *kernels, "sum-int8", n * sizeof(int8_t), ns[6], scalarNs[6]);
+            }
+        }
+
+        return 0;
+    }
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+    return ns3::main(argc, argv);
+}
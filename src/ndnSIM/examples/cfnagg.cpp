@@ -3,14 +3,20 @@
 #include "ns3/ndnSIM-module.h"
 #include "ns3/error-model.h"
 #include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM/apps/simulation-config.hpp"
+#include "ns3/ndnSIM/utils/log-sink.hpp"
+#include "ns3/ndnSIM/apps/ndn-consumer.hpp"
+#include "ns3/ndnSIM/helper/ndn-link-control-helper.hpp"
 
-
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/ini_parser.hpp>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <sys/stat.h> // Include the header for mkdir function
 
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
+
 //? MapFacesToNodes function is disabled
 //std::unordered_map<std::pair<std::string, int>, std::string, pair_hash> faceToNodeMap; 
 
@@ -35,8 +41,32 @@ namespace ns3 {
         int ConDataQueue;
         int AggInterestQueue;
         int AggDataQueue;
+        bool ForwarderAggregation;
         int Iteration;
+        std::string TreeChanges;
+        int TreeChunkSize;
         int DataSize;
+        std::string PayloadEncoding;
+        double TopKRatio;
+        std::string GradientDistribution;
+        double GradientDensity;
+        std::string GradientTrace;
+        int SegmentSize;
+        int PipelineDepth;
+        std::string StragglerPolicy;
+        double CompletionQuorum;
+        std::string CompletionDeadline;
+        std::string LateUpdates;
+        std::string LogFormat;
+        std::string RouteCacheFile;
+        std::string Parallel;
+        std::string SchedulerType;
+        std::string SchedulerTrace;
+        std::string CsPolicy;
+        int CsSize;
+        std::string DeadNonceList;
+        int DnlCapacity;
+        double DnlFalsePositiveRate;
         //int QueueThreshold;
         int InFlightThreshold;
         double QSMDFactor;
@@ -48,42 +78,65 @@ namespace ns3 {
     };
 
     /**
-     * Get all required config parameters
+     * Get all required config parameters from the process-wide simulation config
      * @return
      */
     ConfigParams GetConfigParams() {
-        boost::property_tree::ptree pt;
-        boost::property_tree::ini_parser::read_ini("src/ndnSIM/experiments/simulation_settings/config.ini", pt);
+        const ndn::SimulationConfig& config = ndn::SimulationConfig::Instance();
 
         ConfigParams params;
-        params.Topology = pt.get<std::string>("General.TopologyType");
-        params.Constraint = pt.get<int>("General.Constraint");
-        params.Window = pt.get<std::string>("General.Window");
-        params.CcAlgorithm = pt.get<std::string>("General.CcAlgorithm");
-        params.Alpha = pt.get<double>("General.Alpha");
-        params.Beta = pt.get<double>("General.Beta");
-        params.Gamma = pt.get<double>("General.Gamma");
-        params.EWMAFactor = pt.get<double>("General.EWMAFactor");
-        params.ThresholdFactor = pt.get<double>("General.ThresholdFactor");
-        params.UseCwa = pt.get<bool>("General.UseCwa");
-        params.UseWIS = pt.get<bool>("General.UseWIS");
-        params.RTTWindowSize = pt.get<int>("General.RTTWindowSize");
-        params.DataSize = pt.get<int>("General.DataSize");
-        params.ConInterestQueue = pt.get<int>("Consumer.ConInterestQueue");
-        params.ConDataQueue = pt.get<int>("Consumer.ConDataQueue");
-        params.AggInterestQueue = pt.get<int>("Aggregator.AggInterestQueue");
-        params.AggDataQueue = pt.get<int>("Aggregator.AggDataQueue");
-        params.Iteration = pt.get<int>("Consumer.Iteration");
-        params.UseCubicFastConv = pt.get<bool>("General.UseCubicFastConv");
-        params.InitPace = pt.get<int>("General.InitPace");
-        //params.QueueThreshold = pt.get<int>("QS.QueueThreshold");
-        params.QSMDFactor = pt.get<double>("QS.MDFactor");
-        params.QSRPFactor = pt.get<double>("QS.RPFactor");
-        params.QSSlidingWindowDuration = pt.get<int>("QS.SlidingWindow");
-        params.QSInitRate = pt.get<double>("QS.InitRate");
-        params.InFlightThreshold = pt.get<int>("QS.InFlightThreshold");
-        params.ConQueueThreshold = pt.get<int>("Consumer.ConQueueThreshold");
-        params.AggQueueThreshold = pt.get<int>("Aggregator.AggQueueThreshold");
+        params.Topology = config.Get<std::string>("General.TopologyType");
+        params.Constraint = config.Get<int>("General.Constraint");
+        params.Window = config.Get<std::string>("General.Window");
+        params.CcAlgorithm = config.Get<std::string>("General.CcAlgorithm");
+        params.Alpha = config.Get<double>("General.Alpha");
+        params.Beta = config.Get<double>("General.Beta");
+        params.Gamma = config.Get<double>("General.Gamma");
+        params.EWMAFactor = config.Get<double>("General.EWMAFactor");
+        params.ThresholdFactor = config.Get<double>("General.ThresholdFactor");
+        params.UseCwa = config.Get<bool>("General.UseCwa");
+        params.UseWIS = config.Get<bool>("General.UseWIS");
+        params.RTTWindowSize = config.Get<int>("General.RTTWindowSize");
+        params.DataSize = config.Get<int>("General.DataSize");
+        params.PayloadEncoding = config.Get<std::string>("General.PayloadEncoding", "fp64");
+        params.TopKRatio = config.Get<double>("General.TopKRatio", 0.1);
+        params.GradientDistribution = config.Get<std::string>("General.GradientDistribution", "uniform");
+        params.GradientDensity = config.Get<double>("General.GradientDensity", 0.1);
+        params.GradientTrace = config.Get<std::string>("General.GradientTrace", "");
+        params.SegmentSize = config.Get<int>("General.SegmentSize", 0);
+        params.PipelineDepth = config.Get<int>("General.PipelineDepth", 0);
+        params.StragglerPolicy = config.Get<std::string>("General.StragglerPolicy", "wait-all");
+        params.CompletionQuorum = config.Get<double>("General.CompletionQuorum", 1.0);
+        params.CompletionDeadline = config.Get<std::string>("General.CompletionDeadline", "0ms");
+        params.LateUpdates = config.Get<std::string>("General.LateUpdates", "drop");
+        params.LogFormat = config.Get<std::string>("General.LogFormat", "text");
+        params.RouteCacheFile = config.Get<std::string>("General.RouteCacheFile", "");
+        params.Parallel = config.Get<std::string>("General.Parallel", "off");
+        params.SchedulerType = config.Get<std::string>("General.SchedulerType", "ns3::MapScheduler");
+        params.SchedulerTrace = config.Get<std::string>("General.SchedulerTrace", "");
+        params.CsPolicy = config.Get<std::string>("General.CsPolicy", "nfd::cs::lru");
+        params.CsSize = config.Get<int>("General.CsSize", 100);
+        params.DeadNonceList = config.Get<std::string>("General.DeadNonceList", "nfd::dnl::exact");
+        params.DnlCapacity = config.Get<int>("General.DnlCapacity", 65536);
+        params.DnlFalsePositiveRate = config.Get<double>("General.DnlFalsePositiveRate", 1e-4);
+        params.ConInterestQueue = config.Get<int>("Consumer.ConInterestQueue");
+        params.ConDataQueue = config.Get<int>("Consumer.ConDataQueue");
+        params.AggInterestQueue = config.Get<int>("Aggregator.AggInterestQueue");
+        params.AggDataQueue = config.Get<int>("Aggregator.AggDataQueue");
+        params.ForwarderAggregation = config.Get<bool>("Aggregator.ForwarderAggregation", false);
+        params.Iteration = config.Get<int>("Consumer.Iteration");
+        params.TreeChanges = config.Get<std::string>("Consumer.TreeChanges", "");
+        params.TreeChunkSize = config.Get<int>("Consumer.TreeChunkSize", 1024);
+        params.UseCubicFastConv = config.Get<bool>("General.UseCubicFastConv");
+        params.InitPace = config.Get<int>("General.InitPace");
+        //params.QueueThreshold = config.Get<int>("QS.QueueThreshold");
+        params.QSMDFactor = config.Get<double>("QS.MDFactor");
+        params.QSRPFactor = config.Get<double>("QS.RPFactor");
+        params.QSSlidingWindowDuration = config.Get<int>("QS.SlidingWindow");
+        params.QSInitRate = config.Get<double>("QS.InitRate");
+        params.InFlightThreshold = config.Get<int>("QS.InFlightThreshold");
+        params.ConQueueThreshold = config.Get<int>("Consumer.ConQueueThreshold");
+        params.AggQueueThreshold = config.Get<int>("Aggregator.AggQueueThreshold");
 
         return params;
     }
@@ -95,10 +148,7 @@ namespace ns3 {
      * @return
      */
     int GetConstraint() {
-        boost::property_tree::ptree pt;
-        boost::property_tree::ini_parser::read_ini("src/ndnSIM/experiments/simulation_settings/config.ini", pt);
-
-        int constraint = pt.get<int>("General.Constraint");
+        int constraint = ndn::SimulationConfig::Instance().Get<int>("General.Constraint");
         return constraint;
     }
 
@@ -115,6 +165,45 @@ namespace ns3 {
 
 
 
+    /**
+     * Schedule membership/topology changes, the consumer repairs the aggregation tree at each of them
+     * Changes are separated by ';', e.g. "2s producer pro3; 3s aggregator agg2; 4s link pro40 forwarder8"
+     * @param consumer
+     * @param changes
+     * @return False if a change can't be parsed
+     */
+    bool ScheduleTreeChanges(Ptr<ndn::Consumer> consumer, const std::string& changes) {
+        std::istringstream changeStream(changes);
+        std::string change;
+        while (std::getline(changeStream, change, ';')) {
+            std::istringstream fields(change);
+            std::string time, type, node1, node2;
+            if (!(fields >> time)) {
+                continue; // Empty entry
+            }
+            fields >> type >> node1 >> node2;
+
+            Time at(time);
+            if (type == "producer" && !node1.empty()) {
+                Simulator::Schedule(at, &ndn::Consumer::RemoveProducer, consumer, node1);
+            } else if (type == "aggregator" && !node1.empty()) {
+                Simulator::Schedule(at, &ndn::Consumer::RemoveAggregator, consumer, node1);
+            } else if (type == "link" && !node2.empty()) {
+                // Take the link down and route around it first, the repair follows on the same timestamp
+                Simulator::Schedule(at, &ndn::LinkControlHelper::FailLinkByName, node1, node2);
+                Simulator::Schedule(at, &ndn::GlobalRoutingHelper::RemoveLinkByName, node1, node2);
+                Simulator::Schedule(at, &ndn::Consumer::RemoveLink, consumer, node1, node2);
+            } else {
+                std::cerr << "Consumer.TreeChanges: can't parse \"" << change << "\"" << std::endl;
+                return false;
+            }
+            std::cout << "Tree change scheduled at " << at.As(Time::S) << ": " << type << " " << node1 << " " << node2 << std::endl;
+        }
+        return true;
+    }
+
+
+
     /**
      * Create a directory
      * @param path
@@ -175,15 +264,56 @@ void ChangeAccessLayerBandwidth(std::string newBandwidth) {
 
     int main(int argc, char* argv[])
     {
+        // Config file path can be changed by "--SimulationConfigFile=...", single keys by "--Set=Section.Key=Value"
+        CommandLine cmd;
+        cmd.AddValue("Set", "Override one config.ini key, e.g. --Set=General.DataSize=300",
+                     MakeCallback(&ndn::SimulationConfig::SetFromString, &ndn::SimulationConfig::Instance()));
+        cmd.Parse(argc, argv);
+
         // Get constraint from config.ini
+        ndn::SimulationConfig::Instance().LoadFromGlobalValue();
         ConfigParams params = GetConfigParams();
 
-        CommandLine cmd;
-        cmd.Parse(argc, argv);
+        // Recorder logs are buffered and written in large blocks, optionally as binary columns
+        if (!utils::LogSink::Instance().SetFormat(params.LogFormat)) {
+            return 1;
+        }
+
+        // Parallel runs: "mpirun -np <ranks> ./waf --run=cfnagg", nodes are split over the ranks
+        uint32_t partitions = 0;
+        if (params.Parallel != "off") {
+#ifdef NS3_MPI
+            if (params.Parallel == "nullmsg") {
+                GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::NullMessageSimulatorImpl"));
+            } else if (params.Parallel == "distributed") {
+                GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DistributedSimulatorImpl"));
+            } else {
+                std::cerr << "Unknown General.Parallel \"" << params.Parallel
+                          << "\", use off, distributed or nullmsg" << std::endl;
+                return 1;
+            }
+            MpiInterface::Enable(&argc, &argv);
+            partitions = MpiInterface::GetSize();
+#else
+            std::cerr << "General.Parallel needs ns-3 configured with --enable-mpi" << std::endl;
+            return 1;
+#endif
+        }
+
+        // Event scheduler, e.g. ns3::LadderScheduler for dense same-time events. With a trace file set,
+        // its operations are recorded for replay by utils/bench-scheduler
+        if (params.SchedulerTrace.empty()) {
+            GlobalValue::Bind("SchedulerType", StringValue(params.SchedulerType));
+        } else {
+            Config::SetDefault("ns3::ndn::RecordingScheduler::Scheduler", StringValue(params.SchedulerType));
+            Config::SetDefault("ns3::ndn::RecordingScheduler::TraceFile", StringValue(params.SchedulerTrace));
+            GlobalValue::Bind("SchedulerType", StringValue("ns3::ndn::RecordingScheduler"));
+        }
 
         PointToPointHelper p2p;
 
         AnnotatedTopologyReader topologyReader("", 25);
+        topologyReader.SetPartitions(partitions);
         // Choose corresponding network topology
         if (params.Topology == "DCN") {
             topologyReader.SetFileName("src/ndnSIM/examples/topologies/DataCenterTopology.txt");
@@ -209,6 +339,9 @@ void ChangeAccessLayerBandwidth(std::string newBandwidth) {
 
         // Install NDN stack on all nodes
         ndn::StackHelper ndnHelper;
+        ndnHelper.setPolicy(params.CsPolicy);
+        ndnHelper.setCsSize(params.CsSize);
+        ndnHelper.setDeadNonceList(params.DeadNonceList, params.DnlCapacity, params.DnlFalsePositiveRate);
         ndnHelper.InstallAll();
 
         ndn::GlobalRoutingHelper GlobalRoutingHelper;
@@ -224,12 +357,15 @@ void ChangeAccessLayerBandwidth(std::string newBandwidth) {
         for (NodeContainer::Iterator i = NodeList::Begin(); i != NodeList::End(); ++i) {
             Ptr<Node> node = *i;
             std::string nodeName = Names::FindName(node);
+            // Every rank routes over the whole topology, but only runs the apps of its own nodes
+            bool isLocal = node->GetSystemId() == Simulator::GetSystemId();
 
             //! Debugging, add node name as attribute in forwarder
             // Get the NDN Forwarder instance for this node
             Ptr<ndn::L3Protocol> ndn = node->GetObject<ndn::L3Protocol>();
             if (ndn) {
                 ndn->getForwarder()->setNodeName(nodeName); // Set the node name in the forwarder
+                ndn->getForwarder()->setResultsDir(ndn::SimulationConfig::Instance().GetResultsDir());
             }
 
             if (nodeName.find("con") == 0) {
@@ -252,6 +388,13 @@ void ChangeAccessLayerBandwidth(std::string newBandwidth) {
                 consumerHelper.SetAttribute("RTTWindowSize", IntegerValue(params.RTTWindowSize));
                 consumerHelper.SetAttribute("UseWIS", BooleanValue(params.UseWIS));
                 consumerHelper.SetAttribute("DataSize", IntegerValue(params.DataSize));
+                consumerHelper.SetAttribute("SegmentSize", IntegerValue(params.SegmentSize));
+                consumerHelper.SetAttribute("PipelineDepth", IntegerValue(params.PipelineDepth));
+                consumerHelper.SetAttribute("StragglerPolicy", StringValue(params.StragglerPolicy));
+                consumerHelper.SetAttribute("CompletionQuorum", DoubleValue(params.CompletionQuorum));
+                consumerHelper.SetAttribute("CompletionDeadline", StringValue(params.CompletionDeadline));
+                consumerHelper.SetAttribute("LateUpdates", StringValue(params.LateUpdates));
+                consumerHelper.SetAttribute("TreeChunkSize", IntegerValue(params.TreeChunkSize));
                 consumerHelper.SetAttribute("CcAlgorithm", StringValue(params.CcAlgorithm));
                 consumerHelper.SetAttribute("UseCubicFastConv", BooleanValue(params.UseCubicFastConv));
                 consumerHelper.SetAttribute("InitPace", IntegerValue(params.InitPace));
@@ -263,9 +406,21 @@ void ChangeAccessLayerBandwidth(std::string newBandwidth) {
                 consumerHelper.SetAttribute("ConQueueThreshold", IntegerValue(params.ConQueueThreshold));
 
                 // Add consumer prefix in all nodes' routing info
-                auto app1 = consumerHelper.Install(node);
                 GlobalRoutingHelper.Install(node); // Ensure routing is enabled
-                app1.Start(Seconds(1));
+                if (isLocal) {
+                    auto app1 = consumerHelper.Install(node);
+                    app1.Start(Seconds(1));
+
+                    // Tree repairs during the run, only the consumer's rank knows the tree
+                    if (!ScheduleTreeChanges(DynamicCast<ndn::Consumer>(app1.Get(0)), params.TreeChanges)) {
+                        return 1;
+                    }
+                }
+            } else if (nodeName.find("agg") == 0 && params.ForwarderAggregation) {
+                // Aggregate inside the forwarder, no aggregator app on this node
+                ndn->getForwarder()->getReductionTable().setLocalPrefix("/" + nodeName);
+                GlobalRoutingHelper.Install(node); // Ensure routing is enabled
+                GlobalRoutingHelper.AddOrigins("/" + nodeName, node);
             } else if (nodeName.find("agg") == 0) {
                 // Config aggregator's attribute on aggregator class
                 ndn::AppHelper aggregatorHelper("ns3::ndn::Aggregator");
@@ -283,6 +438,13 @@ void ChangeAccessLayerBandwidth(std::string newBandwidth) {
                 aggregatorHelper.SetAttribute("RTTWindowSize", IntegerValue(params.RTTWindowSize));
                 aggregatorHelper.SetAttribute("UseWIS", BooleanValue(params.UseWIS));
                 aggregatorHelper.SetAttribute("DataSize", IntegerValue(params.DataSize));
+                aggregatorHelper.SetAttribute("SegmentSize", IntegerValue(params.SegmentSize));
+                aggregatorHelper.SetAttribute("PipelineDepth", IntegerValue(params.PipelineDepth));
+                aggregatorHelper.SetAttribute("StragglerPolicy", StringValue(params.StragglerPolicy));
+                aggregatorHelper.SetAttribute("CompletionQuorum", DoubleValue(params.CompletionQuorum));
+                aggregatorHelper.SetAttribute("CompletionDeadline", StringValue(params.CompletionDeadline));
+                aggregatorHelper.SetAttribute("LateUpdates", StringValue(params.LateUpdates));
+                aggregatorHelper.SetAttribute("PayloadEncoding", StringValue(params.PayloadEncoding));
                 aggregatorHelper.SetAttribute("CcAlgorithm", StringValue(params.CcAlgorithm));
                 aggregatorHelper.SetAttribute("UseCubicFastConv", BooleanValue(params.UseCubicFastConv));
                 aggregatorHelper.SetAttribute("InitPace", IntegerValue(params.InitPace));
@@ -294,28 +456,39 @@ void ChangeAccessLayerBandwidth(std::string newBandwidth) {
                 aggregatorHelper.SetAttribute("AggQueueThreshold", IntegerValue(params.AggQueueThreshold));
 
                 // Add aggregator prefix in all nodes' routing info
-                auto app2 = aggregatorHelper.Install(node);
                 GlobalRoutingHelper.Install(node); // Ensure routing is enabled
                 GlobalRoutingHelper.AddOrigins("/" + nodeName, node);
-                app2.Start(Seconds(0.75));
+                if (isLocal) {
+                    auto app2 = aggregatorHelper.Install(node);
+                    app2.Start(Seconds(0.75));
+                }
             } else if (nodeName.find("pro") == 0) {
                 // Install Producer on producer nodes
                 ndn::AppHelper producerHelper("ns3::ndn::Producer");
                 producerHelper.SetPrefix("/" + nodeName);
                 producerHelper.SetAttribute("DataSize", IntegerValue(params.DataSize));
+                producerHelper.SetAttribute("SegmentSize", IntegerValue(params.SegmentSize));
+                producerHelper.SetAttribute("PayloadEncoding", StringValue(params.PayloadEncoding));
+                producerHelper.SetAttribute("TopKRatio", DoubleValue(params.TopKRatio));
+                producerHelper.SetAttribute("GradientDistribution", StringValue(params.GradientDistribution));
+                producerHelper.SetAttribute("GradientDensity", DoubleValue(params.GradientDensity));
+                producerHelper.SetAttribute("GradientTrace", StringValue(params.GradientTrace));
 
                 // Add producer prefix in all nodes' routing info
-                auto app3 = producerHelper.Install(node);
                 GlobalRoutingHelper.Install(node); // Ensure routing is enabled
                 GlobalRoutingHelper.AddOrigins("/" + nodeName, node);
-                app3.Start(Seconds(0.75));
+                if (isLocal) {
+                    auto app3 = producerHelper.Install(node);
+                    app3.Start(Seconds(0.75));
+                }
 
                 // Add error rate to producer
                 //Ptr<NetDevice> proDevice = node->GetDevice(0);
                 //proDevice->SetAttribute("ReceiveErrorModel", PointerValue(em));
             }
         }
-        // Calculate and install FIBs
+        // Calculate and install FIBs, runs over the same topology reuse the cached routes
+        ndn::GlobalRoutingHelper::SetRouteCacheFile(params.RouteCacheFile);
         ndn::GlobalRoutingHelper::CalculateRoutes();
 
         // Schedule bandwidth change after 1.5 seconds
@@ -328,8 +501,15 @@ void ChangeAccessLayerBandwidth(std::string newBandwidth) {
         pointToPoint.EnablePcapAll(packetTraceDir); */
 
         Simulator::Run();
+        // Each rank flushes the logs of its own nodes, they all end up in the same results folder
         Simulator::Destroy();
 
+#ifdef NS3_MPI
+        if (MpiInterface::IsEnabled()) {
+            MpiInterface::Disable();
+        }
+#endif
+
         return 0;
     }
 
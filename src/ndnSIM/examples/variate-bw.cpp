@@ -3,10 +3,9 @@
 #include "ns3/ndnSIM-module.h"
 #include "ns3/error-model.h"
 #include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM/apps/simulation-config.hpp"
+#include "ns3/ndnSIM/utils/log-sink.hpp"
 
-
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/ini_parser.hpp>
 #include <iostream>
 #include <string>
 #include <sys/stat.h> // Include the header for mkdir function
@@ -34,6 +33,10 @@ namespace ns3 {
         int AggDataQueue;
         int Iteration;
         int DataSize;
+        std::string PayloadEncoding;
+        double TopKRatio;
+        int SegmentSize;
+        std::string LogFormat;
         int QueueThreshold;
         int InFlightThreshold;
         double QSMDFactor;
@@ -43,40 +46,43 @@ namespace ns3 {
     };
 
     /**
-     * Get all required config parameters
+     * Get all required config parameters from the process-wide simulation config
      * @return
      */
     ConfigParams GetConfigParams() {
-        boost::property_tree::ptree pt;
-        boost::property_tree::ini_parser::read_ini("src/ndnSIM/experiments/simulation_settings/config.ini", pt);
+        const ndn::SimulationConfig& config = ndn::SimulationConfig::Instance();
 
         ConfigParams params;
-        params.Topology = pt.get<std::string>("General.TopologyType");
-        params.Constraint = pt.get<int>("General.Constraint");
-        params.Window = pt.get<std::string>("General.Window");
-        params.CcAlgorithm = pt.get<std::string>("General.CcAlgorithm");
-        params.Alpha = pt.get<double>("General.Alpha");
-        params.Beta = pt.get<double>("General.Beta");
-        params.Gamma = pt.get<double>("General.Gamma");
-        params.EWMAFactor = pt.get<double>("General.EWMAFactor");
-        params.ThresholdFactor = pt.get<double>("General.ThresholdFactor");
-        params.UseCwa = pt.get<bool>("General.UseCwa");
-        params.UseWIS = pt.get<bool>("General.UseWIS");
-        params.RTTWindowSize = pt.get<int>("General.RTTWindowSize");
-        params.DataSize = pt.get<int>("General.DataSize");
-        params.ConInterestQueue = pt.get<int>("Consumer.ConInterestQueue");
-        params.ConDataQueue = pt.get<int>("Consumer.ConDataQueue");
-        params.AggInterestQueue = pt.get<int>("Aggregator.AggInterestQueue");
-        params.AggDataQueue = pt.get<int>("Aggregator.AggDataQueue");
-        params.Iteration = pt.get<int>("Consumer.Iteration");
-        params.UseCubicFastConv = pt.get<bool>("General.UseCubicFastConv");
-        params.InitPace = pt.get<int>("General.InitPace");
-        params.QueueThreshold = pt.get<int>("QS.QueueThreshold");
-        params.QSMDFactor = pt.get<double>("QS.MDFactor");
-        params.QSRPFactor = pt.get<double>("QS.RPFactor");
-        params.QSSlidingWindowDuration = pt.get<int>("QS.SlidingWindow");
-        params.QSInitRate = pt.get<double>("QS.InitRate");
-        params.InFlightThreshold = pt.get<int>("QS.InFlightThreshold");
+        params.Topology = config.Get<std::string>("General.TopologyType");
+        params.Constraint = config.Get<int>("General.Constraint");
+        params.Window = config.Get<std::string>("General.Window");
+        params.CcAlgorithm = config.Get<std::string>("General.CcAlgorithm");
+        params.Alpha = config.Get<double>("General.Alpha");
+        params.Beta = config.Get<double>("General.Beta");
+        params.Gamma = config.Get<double>("General.Gamma");
+        params.EWMAFactor = config.Get<double>("General.EWMAFactor");
+        params.ThresholdFactor = config.Get<double>("General.ThresholdFactor");
+        params.UseCwa = config.Get<bool>("General.UseCwa");
+        params.UseWIS = config.Get<bool>("General.UseWIS");
+        params.RTTWindowSize = config.Get<int>("General.RTTWindowSize");
+        params.DataSize = config.Get<int>("General.DataSize");
+        params.PayloadEncoding = config.Get<std::string>("General.PayloadEncoding", "fp64");
+        params.TopKRatio = config.Get<double>("General.TopKRatio", 0.1);
+        params.SegmentSize = config.Get<int>("General.SegmentSize", 0);
+        params.LogFormat = config.Get<std::string>("General.LogFormat", "text");
+        params.ConInterestQueue = config.Get<int>("Consumer.ConInterestQueue");
+        params.ConDataQueue = config.Get<int>("Consumer.ConDataQueue");
+        params.AggInterestQueue = config.Get<int>("Aggregator.AggInterestQueue");
+        params.AggDataQueue = config.Get<int>("Aggregator.AggDataQueue");
+        params.Iteration = config.Get<int>("Consumer.Iteration");
+        params.UseCubicFastConv = config.Get<bool>("General.UseCubicFastConv");
+        params.InitPace = config.Get<int>("General.InitPace");
+        params.QueueThreshold = config.Get<int>("QS.QueueThreshold");
+        params.QSMDFactor = config.Get<double>("QS.MDFactor");
+        params.QSRPFactor = config.Get<double>("QS.RPFactor");
+        params.QSSlidingWindowDuration = config.Get<int>("QS.SlidingWindow");
+        params.QSInitRate = config.Get<double>("QS.InitRate");
+        params.InFlightThreshold = config.Get<int>("QS.InFlightThreshold");
 
         return params;
     }
@@ -87,10 +93,7 @@ namespace ns3 {
      * @return
      */
     int GetConstraint() {
-        boost::property_tree::ptree pt;
-        boost::property_tree::ini_parser::read_ini("src/ndnSIM/experiments/simulation_settings/config.ini", pt);
-
-        int constraint = pt.get<int>("General.Constraint");
+        int constraint = ndn::SimulationConfig::Instance().Get<int>("General.Constraint");
         return constraint;
     }
 
@@ -160,11 +163,20 @@ namespace ns3 {
 
     int main(int argc, char* argv[])
     {
+        // Config file path can be changed by "--SimulationConfigFile=...", single keys by "--Set=Section.Key=Value"
+        CommandLine cmd;
+        cmd.AddValue("Set", "Override one config.ini key, e.g. --Set=General.DataSize=300",
+                     MakeCallback(&ndn::SimulationConfig::SetFromString, &ndn::SimulationConfig::Instance()));
+        cmd.Parse(argc, argv);
+
         // Get constraint from config.ini
+        ndn::SimulationConfig::Instance().LoadFromGlobalValue();
         ConfigParams params = GetConfigParams();
 
-        CommandLine cmd;
-        cmd.Parse(argc, argv);
+        // Recorder logs are buffered and written in large blocks, optionally as binary columns
+        if (!utils::LogSink::Instance().SetFormat(params.LogFormat)) {
+            return 1;
+        }
 
         PointToPointHelper p2p;
 
@@ -224,6 +236,7 @@ namespace ns3 {
                 consumerHelper.SetAttribute("RTTWindowSize", IntegerValue(params.RTTWindowSize));
                 consumerHelper.SetAttribute("UseWIS", BooleanValue(params.UseWIS));
                 consumerHelper.SetAttribute("DataSize", IntegerValue(params.DataSize));
+                consumerHelper.SetAttribute("SegmentSize", IntegerValue(params.SegmentSize));
                 consumerHelper.SetAttribute("CcAlgorithm", StringValue(params.CcAlgorithm));
                 consumerHelper.SetAttribute("UseCubicFastConv", BooleanValue(params.UseCubicFastConv));
                 consumerHelper.SetAttribute("InitPace", IntegerValue(params.InitPace));
@@ -255,6 +268,8 @@ namespace ns3 {
                 aggregatorHelper.SetAttribute("RTTWindowSize", IntegerValue(params.RTTWindowSize));
                 aggregatorHelper.SetAttribute("UseWIS", BooleanValue(params.UseWIS));
                 aggregatorHelper.SetAttribute("DataSize", IntegerValue(params.DataSize));
+                aggregatorHelper.SetAttribute("SegmentSize", IntegerValue(params.SegmentSize));
+                aggregatorHelper.SetAttribute("PayloadEncoding", StringValue(params.PayloadEncoding));
                 aggregatorHelper.SetAttribute("CcAlgorithm", StringValue(params.CcAlgorithm));
                 aggregatorHelper.SetAttribute("UseCubicFastConv", BooleanValue(params.UseCubicFastConv));
                 aggregatorHelper.SetAttribute("InitPace", IntegerValue(params.InitPace));
@@ -275,6 +290,9 @@ namespace ns3 {
                 ndn::AppHelper producerHelper("ns3::ndn::Producer");
                 producerHelper.SetPrefix("/" + nodeName);
                 producerHelper.SetAttribute("DataSize", IntegerValue(params.DataSize));
+                producerHelper.SetAttribute("SegmentSize", IntegerValue(params.SegmentSize));
+                producerHelper.SetAttribute("PayloadEncoding", StringValue(params.PayloadEncoding));
+                producerHelper.SetAttribute("TopKRatio", DoubleValue(params.TopKRatio));
 
                 // Add producer prefix in all nodes' routing info
                 producerHelper.Install(node);
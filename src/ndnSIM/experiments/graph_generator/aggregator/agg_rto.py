@@ -1,6 +1,7 @@
 import os
 import pandas as pd
 import matplotlib.pyplot as plt
+from utils.utility import read_log
 
 def plot_rto(input_directory, output_directory):
     try:
@@ -20,7 +21,7 @@ def plot_rto(input_directory, output_directory):
                     file_path = os.path.join(input_directory, file)
 
                     # Read RTO data from the file
-                    data = pd.read_csv(file_path, sep="\s+", header=None, names=["Time", "RTO"], usecols=[0, 1])
+                    data = read_log(file_path, names=["Time", "RTO"], usecols=[0, 1])
                     #data['RTO'] = data['RTO'] / 1_000  # Convert to seconds
                     data['Time'] = data['Time'] / 1_000  # Convert to seconds
 
@@ -2,6 +2,7 @@ import os
 import pandas as pd
 import matplotlib.pyplot as plt
 from itertools import cycle
+from utils.utility import read_log
 
 def plot_rtt_and_inflight(input_directory, output_directory):
     try:
@@ -36,8 +37,8 @@ def plot_rtt_and_inflight(input_directory, output_directory):
             rtt_path = os.path.join(input_directory, rtt_file)
             inflight_path = os.path.join(input_directory, inflight_file)
 
-            rtt_data = pd.read_csv(rtt_path, sep="\s+", header=None, names=["Time", "RTT"], usecols=[0, 2])
-            inflight_data = pd.read_csv(inflight_path, sep="\s+", header=None, names=["Time", "InFlight"], usecols=[0, 5])
+            rtt_data = read_log(rtt_path, names=["Time", "RTT"], usecols=[0, 2])
+            inflight_data = read_log(inflight_path, names=["Time", "InFlight"], usecols=[0, 5])
 
             rtt_data['Time'] = rtt_data['Time'] / 1_000  # Convert to seconds
             inflight_data['Time'] = inflight_data['Time'] / 1_000  # Convert to seconds
@@ -116,8 +117,8 @@ def plot_combined_rtt_and_inflight(input_directory, output_directory):
                 rtt_path = os.path.join(input_directory, rtt_file)
                 inflight_path = os.path.join(input_directory, inflight_file)
 
-                rtt_data = pd.read_csv(rtt_path, sep="\s+", header=None, names=["Time", "RTT"], usecols=[0, 2])
-                inflight_data = pd.read_csv(inflight_path, sep="\s+", header=None, names=["Time", "InFlight"], usecols=[0, 5])
+                rtt_data = read_log(rtt_path, names=["Time", "RTT"], usecols=[0, 2])
+                inflight_data = read_log(inflight_path, names=["Time", "InFlight"], usecols=[0, 5])
 
                 rtt_data['Time'] = rtt_data['Time'] / 1_000  # Convert to seconds
                 inflight_data['Time'] = inflight_data['Time'] / 1_000  # Convert to seconds
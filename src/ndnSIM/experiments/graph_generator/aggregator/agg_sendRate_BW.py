@@ -1,6 +1,7 @@
 import os
 import pandas as pd
 import matplotlib.pyplot as plt
+from utils.utility import read_log
 
 def plot_sendRate_and_bw(input_directory, output_directory):
     try:
@@ -18,7 +19,7 @@ def plot_sendRate_and_bw(input_directory, output_directory):
             file_path = os.path.join(input_directory, file)
 
             # Read the file assuming it contains Time, SendRate, BW columns
-            data = pd.read_csv(file_path, sep="\s+", header=None, names=["Time", "SendRate", "Bandwidth"], usecols=[0, 1, 2])
+            data = read_log(file_path, names=["Time", "SendRate", "Bandwidth"], usecols=[0, 1, 2])
 
             data['Time'] = data['Time'] / 1_000  # Convert to seconds
 
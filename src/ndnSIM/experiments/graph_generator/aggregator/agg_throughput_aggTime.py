@@ -1,6 +1,7 @@
 import os
 import pandas as pd
 import matplotlib.pyplot as plt
+from utils.utility import read_log
 
 def plot_throughput_and_agg_time(input_directory, output_directory):
     try:
@@ -18,7 +19,7 @@ def plot_throughput_and_agg_time(input_directory, output_directory):
                 file_path = os.path.join(input_directory, file)
 
                 # Read Throughput data from the file
-                data = pd.read_csv(file_path, sep="\s+", header=None, names=["Time", "Throughput"], usecols=[0, 3])
+                data = read_log(file_path, names=["Time", "Throughput"], usecols=[0, 3])
                 data['Time'] = data['Time'] / 1_000  # Convert time to seconds for uniformity
 
                 # Use a tuple (aggregator, flow) as the key to handle multiple aggregators and flows
@@ -31,7 +32,7 @@ def plot_throughput_and_agg_time(input_directory, output_directory):
                 agg_time_file = os.path.join(input_directory, file)
 
                 # Read the single aggregation time data file
-                agg_data = pd.read_csv(agg_time_file, sep="\s+", header=None, names=["Time", "AggregationTime"], usecols=[0, 2])
+                agg_data = read_log(agg_time_file, names=["Time", "AggregationTime"], usecols=[0, 2])
                 agg_data['Time'] = agg_data['Time'] / 1_000  # Convert time to seconds
                 #agg_data['AggregationTime'] = agg_data['AggregationTime'] / 1_000  # Convert aggregation time to seconds
 
@@ -2,6 +2,7 @@ import os
 import pandas as pd
 import matplotlib.pyplot as plt
 from itertools import cycle
+from utils.utility import read_log
 
 def plot_throughput_and_queue(input_directory, output_directory):
     try:
@@ -19,7 +20,7 @@ def plot_throughput_and_queue(input_directory, output_directory):
             file_path = os.path.join(input_directory, file)
 
             # Read the file assuming it contains Time, Throughput, queue columns
-            data = pd.read_csv(file_path, sep="\s+", header=None, names=["Time", "Throughput", "Queue"], usecols=[0, 3, 4])
+            data = read_log(file_path, names=["Time", "Throughput", "Queue"], usecols=[0, 3, 4])
 
             data['Time'] = data['Time'] / 1_000  # Convert to seconds
 
@@ -77,7 +78,7 @@ def plot_combined_throughput_and_queue(input_directory, output_directory):
             file_path = os.path.join(input_directory, file)
 
             # Read the file assuming it contains Time, Throughput, queue columns
-            data = pd.read_csv(file_path, sep="\s+", header=None, names=["Time", "Throughput", "Queue"], usecols=[0, 3, 4])
+            data = read_log(file_path, names=["Time", "Throughput", "Queue"], usecols=[0, 3, 4])
 
             data['Time'] = data['Time'] / 1_000  # Convert to seconds
 
@@ -1,6 +1,7 @@
 import os
 import pandas as pd
 import matplotlib.pyplot as plt
+from utils.utility import read_log
 
 def inFlight_plot(input_directory, output_directory):
     try:
@@ -16,7 +17,7 @@ def inFlight_plot(input_directory, output_directory):
                 file_path = os.path.join(input_directory, file)
 
                 # Read inFlight data from the file
-                data = pd.read_csv(file_path, sep="\s+", header=None, names=["Time", "InFlight"], usecols=[0, 5])
+                data = read_log(file_path, names=["Time", "InFlight"], usecols=[0, 5])
 
                 # Debug print to check the columns
                 #print(f"Columns in {file}: {data.columns}")
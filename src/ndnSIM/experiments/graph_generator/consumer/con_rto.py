@@ -1,6 +1,7 @@
 import os
 import pandas as pd
 import matplotlib.pyplot as plt
+from utils.utility import read_log
 
 
 def rto_plot(input_directory, output_directory):
@@ -17,7 +18,7 @@ def rto_plot(input_directory, output_directory):
                 file_path = os.path.join(input_directory, file)
 
                 # Read RTO data from the file
-                data = pd.read_csv(file_path, sep=" ", header=None, names=["Time", "RTO"])
+                data = read_log(file_path, names=["Time", "RTO"])
 
                 # Units transformation
                 #data['RTO'] /= 1_000  # Convert to milliseconds
@@ -2,6 +2,7 @@ import os
 import pandas as pd
 import matplotlib.pyplot as plt
 from itertools import cycle
+from utils.utility import read_log
 
 def plot_rtt_and_inflight(input_directory, output_directory):
     try:
@@ -15,7 +16,7 @@ def plot_rtt_and_inflight(input_directory, output_directory):
         for rtt_file in rtt_files:
             flow = rtt_file.split('_')[-1].split('.')[0]
             rtt_path = os.path.join(input_directory, rtt_file)
-            rtt_data = pd.read_csv(rtt_path, sep="\s+", header=None, names=["Time", "RTT"], usecols=[0, 2])
+            rtt_data = read_log(rtt_path, names=["Time", "RTT"], usecols=[0, 2])
             rtt_data['Time'] /= 1_000  # Convert time to seconds
             #rtt_data['RTT'] /= 1_000  # Convert RTT to milliseconds
             if flow not in flow_data:
@@ -25,7 +26,7 @@ def plot_rtt_and_inflight(input_directory, output_directory):
         for inflight_file in inflight_files:
             flow = inflight_file.split('_')[-1].split('.')[0]
             inflight_path = os.path.join(input_directory, inflight_file)
-            inflight_data = pd.read_csv(inflight_path, sep="\s+", header=None, names=["Time", "InFlight"], usecols=[0, 5])
+            inflight_data = read_log(inflight_path, names=["Time", "InFlight"], usecols=[0, 5])
             inflight_data['Time'] /= 1_000  # Convert time to seconds
             #inflight_data['InFlight'] /= 1_000  # Convert inflight to milliseconds
             if flow not in flow_data:
@@ -77,7 +78,7 @@ def plot_combined_rtt_and_inflight(input_directory, output_directory):
         for rtt_file in rtt_files:
             flow = rtt_file.split('_')[-1].split('.')[0]
             rtt_path = os.path.join(input_directory, rtt_file)
-            rtt_data = pd.read_csv(rtt_path, sep="\s+", header=None, names=["Time", "RTT"], usecols=[0, 2])
+            rtt_data = read_log(rtt_path, names=["Time", "RTT"], usecols=[0, 2])
             rtt_data['Time'] /= 1_000  # Convert time to seconds
             if flow not in flow_data:
                 flow_data[flow] = {}
@@ -86,7 +87,7 @@ def plot_combined_rtt_and_inflight(input_directory, output_directory):
         for inflight_file in inflight_files:
             flow = inflight_file.split('_')[-1].split('.')[0]
             inflight_path = os.path.join(input_directory, inflight_file)
-            inflight_data = pd.read_csv(inflight_path, sep="\s+", header=None, names=["Time", "InFlight"], usecols=[0, 5])
+            inflight_data = read_log(inflight_path, names=["Time", "InFlight"], usecols=[0, 5])
             inflight_data['Time'] /= 1_000  # Convert time to seconds
             if flow not in flow_data:
                 flow_data[flow] = {}
@@ -1,6 +1,7 @@
 import os
 import pandas as pd
 import matplotlib.pyplot as plt
+from utils.utility import read_log
 
 def plot_rtt_and_rto(input_directory, output_directory):
     try:
@@ -14,7 +15,7 @@ def plot_rtt_and_rto(input_directory, output_directory):
         for rtt_file in rtt_files:
             flow = rtt_file.split('_')[-1].split('.')[0]
             rtt_path = os.path.join(input_directory, rtt_file)
-            rtt_data = pd.read_csv(rtt_path, sep="\s+", header=None, names=["Time", "RTT"], usecols=[0, 2])
+            rtt_data = read_log(rtt_path, names=["Time", "RTT"], usecols=[0, 2])
             rtt_data['Time'] /= 1_000  # Convert time to seconds
             #rtt_data['RTT'] /= 1_000  # Convert RTT to milliseconds
             if flow not in flow_data:
@@ -24,7 +25,7 @@ def plot_rtt_and_rto(input_directory, output_directory):
         for rto_file in rto_files:
             flow = rto_file.split('_')[-1].split('.')[0]
             rto_path = os.path.join(input_directory, rto_file)
-            rto_data = pd.read_csv(rto_path, sep="\s+", header=None, names=["Time", "RTO"], usecols=[0, 1])
+            rto_data = read_log(rto_path, names=["Time", "RTO"], usecols=[0, 1])
             rto_data['Time'] /= 1_000  # Convert time to seconds
             #rto_data['RTO'] /= 1_000  # Convert RTO to milliseconds
             if flow not in flow_data:
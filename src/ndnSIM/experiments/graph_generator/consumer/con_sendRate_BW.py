@@ -1,6 +1,7 @@
 import os
 import pandas as pd
 import matplotlib.pyplot as plt
+from utils.utility import read_log
 
 def plot_sendrate_and_bw(input_directory, output_directory):
     try:
@@ -13,7 +14,7 @@ def plot_sendrate_and_bw(input_directory, output_directory):
         for queue_file in queue_files:
             flow = queue_file.split('_')[-1].split('.')[0]
             queue_path = os.path.join(input_directory, queue_file)
-            queue_data = pd.read_csv(queue_path, sep="\s+", header=None, names=["Time", "SendRate", "BW"], usecols=[0, 1, 2])
+            queue_data = read_log(queue_path, names=["Time", "SendRate", "BW"], usecols=[0, 1, 2])
             queue_data['Time'] /= 1_000  # Convert time to seconds
             #queue_data['SendRate'] /= 1_000  # Convert sendrate to appropriate units if needed
             #queue_data['BW'] /= 1_000  # Convert bandwidth to appropriate units if needed
@@ -2,6 +2,7 @@ import os
 import pandas as pd
 import matplotlib.pyplot as plt
 from itertools import cycle
+from utils.utility import read_log
 
 def plot_sendrate_and_inflight(input_directory, output_directory):
     try:
@@ -14,7 +15,7 @@ def plot_sendrate_and_inflight(input_directory, output_directory):
         for inflight_file in inflight_files:
             flow = inflight_file.split('_')[-1].split('.')[0]
             inflight_path = os.path.join(input_directory, inflight_file)
-            inflight_data = pd.read_csv(inflight_path, sep="\s+", header=None, names=["Time", "SendRate", "InFlight"], usecols=[0, 1, 5])
+            inflight_data = read_log(inflight_path, names=["Time", "SendRate", "InFlight"], usecols=[0, 1, 5])
             inflight_data['Time'] /= 1_000  # Convert time to seconds
             #inflight_data['SendRate'] /= 1_000  # Convert sendrate to appropriate units if needed
             #inflight_data['InFlight'] /= 1_000  # Convert InFlight to appropriate units if needed
@@ -62,7 +63,7 @@ def plot_combined_sendrate_and_inflight(input_directory, output_directory):
         for inflight_file in inflight_files:
             flow = inflight_file.split('_')[-1].split('.')[0]
             inflight_path = os.path.join(input_directory, inflight_file)
-            inflight_data = pd.read_csv(inflight_path, sep="\s+", header=None, names=["Time", "SendRate", "InFlight"], usecols=[0, 1, 5])
+            inflight_data = read_log(inflight_path, names=["Time", "SendRate", "InFlight"], usecols=[0, 1, 5])
             inflight_data['Time'] /= 1_000  # Convert time to seconds
             flow_data[flow] = inflight_data
 
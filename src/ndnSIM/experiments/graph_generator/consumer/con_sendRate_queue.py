@@ -2,6 +2,7 @@ import os
 import pandas as pd
 import matplotlib.pyplot as plt
 from itertools import cycle
+from utils.utility import read_log
 
 def plot_sendrate_and_queue(input_directory, output_directory):
     try:
@@ -14,7 +15,7 @@ def plot_sendrate_and_queue(input_directory, output_directory):
         for queue_file in queue_files:
             flow = queue_file.split('_')[-1].split('.')[0]
             queue_path = os.path.join(input_directory, queue_file)
-            queue_data = pd.read_csv(queue_path, sep="\s+", header=None, names=["Time", "SendRate", "Queue"], usecols=[0, 1, 4])
+            queue_data = read_log(queue_path, names=["Time", "SendRate", "Queue"], usecols=[0, 1, 4])
             queue_data['Time'] /= 1_000  # Convert time to seconds
             #queue_data['SendRate'] /= 1_000  # Convert sendrate to appropriate units if needed
             #queue_data['Queue'] /= 1_000  # Convert queue to appropriate units if needed
@@ -62,7 +63,7 @@ def plot_combined_sendrate_and_queue(input_directory, output_directory):
         for queue_file in queue_files:
             flow = queue_file.split('_')[-1].split('.')[0]
             queue_path = os.path.join(input_directory, queue_file)
-            queue_data = pd.read_csv(queue_path, sep="\s+", header=None, names=["Time", "SendRate", "Queue"], usecols=[0, 1, 4])
+            queue_data = read_log(queue_path, names=["Time", "SendRate", "Queue"], usecols=[0, 1, 4])
             queue_data['Time'] /= 1_000  # Convert time to seconds
             flow_data[flow] = queue_data
 
@@ -2,6 +2,7 @@ import os
 import pandas as pd
 import matplotlib.pyplot as plt
 from itertools import cycle
+from utils.utility import read_log
 
 def plot_throughput_and_queue(input_directory, output_directory):
     try:
@@ -14,7 +15,7 @@ def plot_throughput_and_queue(input_directory, output_directory):
         for queue_file in queue_files:
             flow = queue_file.split('_')[-1].split('.')[0]
             queue_path = os.path.join(input_directory, queue_file)
-            queue_data = pd.read_csv(queue_path, sep="\s+", header=None, names=["Time", "Throughput", "Queue"], usecols=[0, 3, 4])
+            queue_data = read_log(queue_path, names=["Time", "Throughput", "Queue"], usecols=[0, 3, 4])
             queue_data['Time'] /= 1_000  # Convert time to seconds
             flow_data[flow] = queue_data
 
@@ -59,7 +60,7 @@ def plot_combined_throughput_and_queue(input_directory, output_directory):
         for queue_file in queue_files:
             flow = queue_file.split('_')[-1].split('.')[0]
             queue_path = os.path.join(input_directory, queue_file)
-            queue_data = pd.read_csv(queue_path, sep="\s+", header=None, names=["Time", "Throughput", "Queue"], usecols=[0, 3, 4])
+            queue_data = read_log(queue_path, names=["Time", "Throughput", "Queue"], usecols=[0, 3, 4])
             queue_data['Time'] /= 1_000  # Convert time to seconds
             flow_data[flow] = queue_data
 
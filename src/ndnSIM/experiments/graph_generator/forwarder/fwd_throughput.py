@@ -1,6 +1,7 @@
 import os
 import pandas as pd
 import matplotlib.pyplot as plt
+from utils.utility import read_log
 
 def plot_throughput(input_directory, output_directory):
     try:
@@ -15,9 +16,8 @@ def plot_throughput(input_directory, output_directory):
                 file_path = os.path.join(input_directory, file)
 
                 # Read columns [0, 3] for Time and Throughput
-                data = pd.read_csv(file_path, sep="\s+", header=None,
-                                   names=["Time", "Throughput"],
-                                   usecols=[0, 1])
+                data = read_log(file_path, names=["Time", "Throughput"],
+                                usecols=[0, 1])
                 data["Time"] = data["Time"] / 1000.0  # Convert to seconds
 
                 # Change throughput from pkgs/ms into Mbps, currently using 150 double
@@ -1,4 +1,10 @@
 import os
+import struct
+
+import numpy as np
+import pandas as pd
+
+LOG_MAGIC = b"CFNLOG1\n"
 
 
 def check_and_create_dir(path):
@@ -12,4 +18,41 @@ def check_and_create_dir(path):
         os.makedirs(path)
         print(f"Output directory is created at: {path}")
     else:
-        print(f"Output directory already exists at: {path}")
\ No newline at end of file
+        print(f"Output directory already exists at: {path}")
+
+
+def read_log(path, names=None, usecols=None):
+    """
+    Load a recorder log written by the simulation, in either text or binary (LogFormat = binary) format.
+
+    :param path: Path to the log file, binary logs keep the same file name as text ones.
+    :param names: Column names of the returned DataFrame.
+    :param usecols: Indices of the columns to keep, all columns if None.
+    :return: DataFrame with one row per record.
+    """
+    with open(path, "rb") as f:
+        content = f.read()
+
+    if not content.startswith(LOG_MAGIC):
+        return pd.read_csv(path, sep=r"\s+", header=None, names=names, usecols=usecols)
+
+    # Header: magic, column count, length of the column names; then blocks of (rows, reserved, columns)
+    column_count, names_length = struct.unpack_from("<II", content, len(LOG_MAGIC))
+    if column_count == 0:
+        return pd.DataFrame(columns=names)  # Nothing was recorded
+
+    offset = len(LOG_MAGIC) + 8 + names_length
+    columns = usecols if usecols is not None else range(column_count)
+    chunks = {column: [] for column in columns}
+    while offset < len(content):
+        rows, _ = struct.unpack_from("<II", content, offset)
+        offset += 8
+        for column in range(column_count):
+            if column in chunks:
+                chunks[column].append(np.frombuffer(content, dtype="<f8", count=rows, offset=offset))
+            offset += rows * 8
+
+    data = {column: np.concatenate(values) if values else np.empty(0) for column, values in chunks.items()}
+    frame = pd.DataFrame(data)
+    frame.columns = names if names is not None else content[len(LOG_MAGIC) + 8:len(LOG_MAGIC) + 8 + names_length].rstrip(b"\0").decode().split("\t")
+    return frame
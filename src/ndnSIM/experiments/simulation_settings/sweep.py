@@ -0,0 +1,166 @@
+import os
+import sys
+import csv
+import glob
+import time
+import argparse
+import itertools
+import subprocess
+import configparser
+from concurrent.futures import ThreadPoolExecutor
+
+
+RESULT_FIELDS = {
+    "Total iterations: ": "iterations",
+    "Timeout is triggered for ": "timeouts",
+    "Data queue overflow is triggered for ": "data_overflows",
+    "Nack(upstream interest queue overflow) is triggered for ": "nacks",
+    "Average aggregation time: ": "avg_aggregation_time_ms",
+    "Total aggregation time: ": "total_aggregation_time_ms",
+}
+
+
+def read_grid(grid_file):
+    """
+    Read the sweep settings and the parameter grid
+    :param grid_file: Path of sweep.ini
+    :return: (jobs, replicas, output directory, list of (key, values))
+    """
+    parser = configparser.ConfigParser()
+    parser.optionxform = str  # Keys are "Section.Key" of config.ini, keep their case
+    if not parser.read(grid_file):
+        print(f"Cannot read the sweep grid {grid_file}")
+        sys.exit(1)
+
+    jobs = parser.getint("Sweep", "Jobs", fallback=0) or os.cpu_count()
+    replicas = parser.getint("Sweep", "Replicas", fallback=1)
+    output = parser.get("Sweep", "Output", fallback="src/ndnSIM/results/sweep")
+
+    grid = []
+    for key, values in parser.items("Grid"):
+        grid.append((key, [value.strip() for value in values.split(",") if value.strip()]))
+    return jobs, replicas, output, grid
+
+
+def expand_runs(grid, replicas):
+    """
+    Every combination of the grid values, replicas of the same combination are adjacent
+    :return: List of (run id, replica, {key: value})
+    """
+    keys = [key for key, _ in grid]
+    runs = []
+    for values in itertools.product(*[values for _, values in grid]):
+        for replica in range(replicas):
+            runs.append((len(runs), replica, dict(zip(keys, values))))
+    return runs
+
+
+def find_program():
+    """
+    Locate the cfnagg binary of the current ns-3 build, run from the ns-3 root like cfnagg_run.sh
+    """
+    programs = glob.glob("build/src/ndnSIM/examples/ns3*-cfnagg-*")
+    programs = [program for program in programs if os.access(program, os.X_OK)]
+    if not programs:
+        print("cfnagg binary not found under build/, run './waf build' first")
+        sys.exit(1)
+    return max(programs, key=os.path.getmtime)
+
+
+def parse_result(result_file):
+    """
+    Extract the consumer's summary from result.txt
+    :return: {column: value}, empty if the run didn't finish
+    """
+    result = {}
+    if not os.path.exists(result_file):
+        return result
+
+    with open(result_file) as f:
+        lines = f.read().splitlines()
+    if "Consumer's result" not in lines:
+        return result
+
+    for line in lines[lines.index("Consumer's result") + 1:]:
+        if line.startswith("---"):
+            break
+        for prefix, column in RESULT_FIELDS.items():
+            if line.startswith(prefix):
+                result[column] = line[len(prefix):].split()[0]
+    return result
+
+
+def run_one(program, env, output, run, route_caches):
+    """
+    Run one replica in its own process and results folder
+    :return: Row of the results table
+    """
+    run_id, replica, params = run
+    results_dir = os.path.join(output, "runs", f"{run_id:05d}")
+    os.makedirs(results_dir, exist_ok=True)
+
+    command = [program, f"--RngRun={replica + 1}", f"--Set=General.ResultsDir={results_dir}",
+               f"--Set=General.RouteCacheFile={route_caches[params.get('General.TopologyType')]}"]
+    command += [f"--Set={key}={value}" for key, value in params.items()]
+
+    start = time.time()
+    with open(os.path.join(results_dir, "stdout.txt"), "w") as log:
+        status = subprocess.call(command, stdout=log, stderr=subprocess.STDOUT, env=env)
+    wall = time.time() - start
+
+    row = {"run": run_id, "replica": replica, **params, "status": status, "wall_s": f"{wall:.1f}"}
+    row.update(parse_result(os.path.join(results_dir, "result.txt")))
+    print(f"Run {run_id} (replica {replica}) finished with status {status} in {wall:.1f}s")
+    return row
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Run a parameter grid of cfnagg, one process per replica")
+    parser.add_argument("grid", nargs="?", default="src/ndnSIM/experiments/simulation_settings/sweep.ini",
+                        help="Sweep settings and parameter grid")
+    parser.add_argument("--jobs", type=int, help="Override Sweep.Jobs")
+    args = parser.parse_args()
+
+    jobs, replicas, output, grid = read_grid(args.grid)
+    if args.jobs:
+        jobs = args.jobs
+    runs = expand_runs(grid, replicas)
+
+    program = find_program()
+    env = dict(os.environ)
+    env["LD_LIBRARY_PATH"] = os.pathsep.join(filter(None, [os.path.abspath("build/lib"),
+                                                          env.get("LD_LIBRARY_PATH")]))
+    os.makedirs(output, exist_ok=True)
+
+    # Routes only depend on the topology: the first run of each topology computes and caches them,
+    # every other run of that topology installs them straight from the cache file
+    route_caches = {}
+    first_runs = []
+    for run in runs:
+        topology = run[2].get("General.TopologyType")
+        if topology not in route_caches:
+            route_caches[topology] = os.path.join(output, f"routes_{topology or 'default'}.cache")
+            first_runs.append(run)
+    first_ids = {run[0] for run in first_runs}
+    other_runs = [run for run in runs if run[0] not in first_ids]
+
+    print(f"{len(runs)} runs ({len(runs) // replicas} configurations x {replicas} replicas) on {jobs} workers")
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        rows = list(pool.map(lambda run: run_one(program, env, output, run, route_caches), first_runs))
+        rows += list(pool.map(lambda run: run_one(program, env, output, run, route_caches), other_runs))
+    rows.sort(key=lambda row: row["run"])
+
+    columns = ["run", "replica"] + [key for key, _ in grid] + ["status", "wall_s"] + list(RESULT_FIELDS.values())
+    table = os.path.join(output, "results.csv")
+    with open(table, "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=columns)
+        writer.writeheader()
+        writer.writerows(rows)
+
+    failed = sum(1 for row in rows if row["status"] != 0)
+    print(f"Results of {len(rows)} runs written to {table}, {failed} failed")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -46,18 +46,30 @@
 #include "ns3/node-list.h"
 #include "ns3/channel-list.h"
 #include "ns3/object-factory.h"
+#include "ns3/simulator.h"
 
 #include <boost/lexical_cast.hpp>
 #include <boost/foreach.hpp>
 #include <boost/concept/assert.hpp>
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 
+#include <boost/graph/adjacency_list.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
 
 #include "boost-graph-ndn-global-routing-helper.hpp"
 
 #include <math.h>
 
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
+
 NS_LOG_COMPONENT_DEFINE("ndn.GlobalRoutingHelper");
 
 namespace ns3 {
@@ -214,73 +226,391 @@ GlobalRoutingHelper::AddOriginsForAll()
   }
 }
 
-void
-GlobalRoutingHelper::CalculateRoutes()
+namespace {
+
+/// Threads searching shortest paths, 0 uses one per core
+uint32_t g_routingThreads = 0;
+
+/// Route cache file, empty disables the cache
+std::string g_routeCacheFile;
+
+/// Same "infinite" distance as boost::WeightInf, longer paths are unreachable
+const uint32_t ROUTE_DISTANCE_INF = std::numeric_limits<uint16_t>::max();
+
+/// Metric of the faces disabled by CalculateAllPossibleRoutes
+const uint32_t DISABLED_FACE_METRIC = std::numeric_limits<uint16_t>::max() - 1;
+
+/**
+ * @brief Whether FIBs of the node are installed by this process
+ *
+ * In a distributed simulation every rank knows the whole topology, but only simulates (and
+ * routes from) its own nodes.
+ */
+bool
+IsLocal(const Ptr<Node>& node)
+{
+  return node->GetSystemId() == Simulator::GetSystemId();
+}
+
+/**
+ * @brief Route cache of this process, ranks of a distributed simulation each have their own
+ */
+std::string
+GetRouteCacheFile()
 {
+#ifdef NS3_MPI
+  if (MpiInterface::IsEnabled()) {
+    return g_routeCacheFile + "." + std::to_string(MpiInterface::GetSystemId());
+  }
+#endif
+  return g_routeCacheFile;
+}
+
+struct SnapshotEdge {
+  uint32_t id;
+};
+
+typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS, boost::no_property,
+                              SnapshotEdge> SnapshotGraph;
+
+/**
+ * @brief Plain copy of NdnGlobalRouterGraph which several threads can search at once
+ *
+ * No ns-3 object is touched while searching (Ptr reference counts aren't thread-safe).
+ * Vertices and out edges keep the order of the GlobalRouter graph, so that the boost
+ * Dijkstra breaks ties between equal-cost paths exactly as it does on the original graph.
+ */
+struct RoutingSnapshot {
+  SnapshotGraph graph;
+  std::vector<Ptr<GlobalRouter>> routers; ///< per vertex
+  std::vector<Ptr<Node>> nodes;           ///< per vertex, null for channels
+  std::vector<shared_ptr<Face>> faces;    ///< per edge, null for channel-to-node edges
+  std::vector<uint32_t> weights;          ///< per edge, metric of the face
+  std::vector<size_t> origins;            ///< vertices with local prefixes
+
+  RoutingSnapshot()
+  {
+    boost::NdnGlobalRouterGraph routerGraph;
+    std::unordered_map<GlobalRouter*, size_t> index;
+    for (const auto& router : routerGraph.GetVertices()) {
+      index[PeekPointer(router)] = routers.size();
+      routers.push_back(router);
+      nodes.push_back(router->GetObject<Node>());
+      if (!router->GetLocalPrefixes().empty()) {
+        origins.push_back(routers.size() - 1);
+      }
+    }
+
+    graph = SnapshotGraph(routers.size());
+    for (size_t u = 0; u < routers.size(); ++u) {
+      for (const auto& incidency : routers[u]->GetIncidencies()) {
+        const shared_ptr<Face>& face = std::get<1>(incidency);
+        uint32_t id = static_cast<uint32_t>(faces.size());
+        boost::add_edge(u, index.at(PeekPointer(std::get<2>(incidency))), SnapshotEdge{id}, graph);
+        faces.push_back(face);
+        weights.push_back(face == nullptr ? 0 : static_cast<uint16_t>(face->getMetric()));
+      }
+    }
+  }
+
   /**
-   * Implementation of route calculation is heavily based on Boost Graph Library
-   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
+   * @brief Hash of everything routes depend on: vertices, prefixes, edges, faces and metrics,
+   *        and which of the vertices are local
    */
+  uint64_t
+  Hash(const std::string& algorithm) const
+  {
+    std::ostringstream os;
+    os << algorithm << ' ' << Simulator::GetSystemId() << '\n';
+    for (size_t u = 0; u < routers.size(); ++u) {
+      if (nodes[u] != nullptr) {
+        os << "n" << nodes[u]->GetId() << '@' << nodes[u]->GetSystemId();
+      }
+      else {
+        Ptr<Channel> channel = routers[u]->GetObject<Channel>();
+        os << "c" << (channel != nullptr ? channel->GetId() : 0);
+      }
+      for (const auto& prefix : routers[u]->GetLocalPrefixes()) {
+        os << ' ' << *prefix;
+      }
+      for (auto edges = boost::out_edges(u, graph); edges.first != edges.second; ++edges.first) {
+        uint32_t id = graph[*edges.first].id;
+        os << " >" << boost::target(*edges.first, graph) << ':'
+           << (faces[id] != nullptr ? faces[id]->getId() : 0) << ':' << weights[id];
+      }
+      os << '\n';
+    }
 
-  BOOST_CONCEPT_ASSERT((boost::VertexListGraphConcept<boost::NdnGlobalRouterGraph>));
-  BOOST_CONCEPT_ASSERT((boost::IncidenceGraphConcept<boost::NdnGlobalRouterGraph>));
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : os.str()) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+    }
+    return hash;
+  }
+};
 
-  boost::NdnGlobalRouterGraph graph;
-  // typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
+/**
+ * @brief Tracks, for every vertex, the edge leaving the source on its shortest path
+ *
+ * Same as boost::WeightCombine: the first hop is the first edge of the path which has a face.
+ */
+class FirstHopRecorder : public boost::base_visitor<FirstHopRecorder> {
+public:
+  typedef boost::on_edge_relaxed event_filter;
+
+  FirstHopRecorder(const RoutingSnapshot& snapshot, std::vector<int64_t>& firstHop)
+    : m_snapshot(snapshot)
+    , m_firstHop(firstHop)
+  {
+  }
 
-  // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by
-  // the graph, which
-  // is not obviously how implement in an efficient manner
-  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
-    Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter>();
-    if (source == 0) {
-      NS_LOG_DEBUG("Node " << (*node)->GetId() << " does not export GlobalRouter interface");
-      continue;
-    }
+  void
+  operator()(SnapshotGraph::edge_descriptor edge, const SnapshotGraph& graph)
+  {
+    int64_t viaSource = m_firstHop[boost::source(edge, graph)];
+    uint32_t id = graph[edge].id;
+    m_firstHop[boost::target(edge, graph)] =
+      viaSource >= 0 || m_snapshot.faces[id] == nullptr ? viaSource : id;
+  }
 
-    boost::DistancesMap distances;
+private:
+  const RoutingSnapshot& m_snapshot;
+  std::vector<int64_t>& m_firstHop;
+};
 
-    dijkstra_shortest_paths(graph, source,
-                            // predecessor_map (boost::ref(predecessors))
-                            // .
-                            distance_map(boost::ref(distances))
-                              .distance_inf(boost::WeightInf)
-                              .distance_zero(boost::WeightZero)
-                              .distance_compare(boost::WeightCompare())
-                              .distance_combine(boost::WeightCombine()));
+/**
+ * @brief One shortest-path search: from a source vertex, optionally with all the source's
+ *        faces but one disabled
+ */
+struct RouteJob {
+  size_t source;
+  Face* enabledFace; ///< nullptr keeps every face enabled
+};
 
-    // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
+/**
+ * @brief Route towards the prefixes of an origin vertex
+ */
+struct SnapshotRoute {
+  size_t origin;
+  uint32_t edge; ///< first hop
+  uint32_t distance;
+};
 
-    Ptr<L3Protocol> L3protocol = (*node)->GetObject<L3Protocol>();
-    shared_ptr<nfd::Forwarder> forwarder = L3protocol->getForwarder();
+/**
+ * @brief Searches the jobs, spread over threads, job i's routes end up in routes[i]
+ */
+void
+SearchRoutes(const RoutingSnapshot& snapshot, const std::vector<RouteJob>& jobs,
+             std::vector<std::vector<SnapshotRoute>>& routes)
+{
+  routes.assign(jobs.size(), {});
+  std::atomic<size_t> nextJob(0);
+
+  auto worker = [&] {
+    size_t nVertices = snapshot.routers.size();
+    std::vector<uint32_t> distances(nVertices);
+    std::vector<int64_t> firstHop(nVertices);
+    std::vector<uint32_t> weights = snapshot.weights;
+
+    for (size_t j = nextJob++; j < jobs.size(); j = nextJob++) {
+      const RouteJob& job = jobs[j];
+
+      // disable every face of the source but one, like CalculateAllPossibleRoutes always did
+      auto sourceEdges = boost::out_edges(job.source, snapshot.graph);
+      if (job.enabledFace != nullptr) {
+        for (auto edge = sourceEdges.first; edge != sourceEdges.second; ++edge) {
+          uint32_t id = snapshot.graph[*edge].id;
+          if (snapshot.faces[id].get() != job.enabledFace) {
+            weights[id] = DISABLED_FACE_METRIC;
+          }
+        }
+      }
 
-    NS_LOG_DEBUG("Reachability from Node: " << source->GetObject<Node>()->GetId());
-    for (const auto& dist : distances) {
-      if (dist.first == source)
-        continue;
-      else {
-        // cout << "  Node " << dist.first->GetObject<Node> ()->GetId ();
-        if (std::get<0>(dist.second) == 0) {
-          // cout << " is unreachable" << endl;
+      std::fill(firstHop.begin(), firstHop.end(), -1);
+      boost::dijkstra_shortest_paths(snapshot.graph, job.source,
+                                     boost::weight_map(boost::make_iterator_property_map(
+                                                         weights.begin(),
+                                                         boost::get(&SnapshotEdge::id, snapshot.graph)))
+                                       .distance_map(boost::make_iterator_property_map(
+                                                       distances.begin(),
+                                                       boost::get(boost::vertex_index, snapshot.graph)))
+                                       .distance_inf(ROUTE_DISTANCE_INF)
+                                       .distance_zero(0U)
+                                       .visitor(boost::make_dijkstra_visitor(
+                                                  FirstHopRecorder(snapshot, firstHop))));
+
+      for (size_t origin : snapshot.origins) {
+        if (origin == job.source || firstHop[origin] < 0) {
+          continue; // unreachable
         }
-        else {
-          for (const auto& prefix : dist.first->GetLocalPrefixes()) {
-            NS_LOG_DEBUG(" prefix " << prefix << " reachable via face " << *std::get<0>(dist.second)
-                         << " with distance " << std::get<1>(dist.second) << " with delay "
-                         << std::get<2>(dist.second));
-
-            FibHelper::AddRoute(*node, *prefix, std::get<0>(dist.second),
-                                std::get<1>(dist.second));
-          }
+        uint32_t edge = static_cast<uint32_t>(firstHop[origin]);
+        if (job.enabledFace != nullptr && snapshot.faces[edge].get() != job.enabledFace) {
+          continue; // through a disabled face
+        }
+        routes[j].push_back({origin, edge, distances[origin]});
+      }
+
+      if (job.enabledFace != nullptr) {
+        for (auto edge = sourceEdges.first; edge != sourceEdges.second; ++edge) {
+          uint32_t id = snapshot.graph[*edge].id;
+          weights[id] = snapshot.weights[id];
+        }
+      }
+    }
+  };
+
+  size_t nThreads = g_routingThreads > 0 ? g_routingThreads : std::thread::hardware_concurrency();
+  nThreads = std::max<size_t>(1, std::min(nThreads, jobs.size()));
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < nThreads; ++t) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+struct CachedRoute {
+  uint32_t nodeId;
+  uint32_t faceId;
+  uint32_t metric;
+  std::string prefix;
+};
+
+/**
+ * @brief Install the routes of a cache file written for the same topology hash
+ *
+ * The file is "<algorithm> <hash>", one "<node> <face> <metric> <prefix>" line per route and
+ * an "end <number of routes>" trailer. Routes are only installed once the trailer is checked,
+ * a truncated file is recomputed rather than leaving a partial FIB.
+ *
+ * @return false if there is no usable cache
+ */
+bool
+LoadRouteCache(const std::string& algorithm, uint64_t hash)
+{
+  std::string cacheFile = GetRouteCacheFile();
+  std::ifstream file(cacheFile);
+  if (!file) {
+    return false;
+  }
+
+  std::string fileAlgorithm;
+  uint64_t fileHash = 0;
+  if (!(file >> fileAlgorithm >> std::hex >> fileHash >> std::dec) || fileAlgorithm != algorithm
+      || fileHash != hash) {
+    NS_LOG_INFO("Route cache " << cacheFile << " is for another topology, recomputing");
+    return false;
+  }
+
+  std::vector<CachedRoute> routes;
+  std::string token;
+  size_t nExpected = 0;
+  bool hasTrailer = false;
+  while (file >> token) {
+    if (token == "end") {
+      hasTrailer = static_cast<bool>(file >> nExpected);
+      break;
+    }
+    CachedRoute route;
+    try {
+      route.nodeId = boost::lexical_cast<uint32_t>(token);
+    }
+    catch (const boost::bad_lexical_cast&) {
+      break;
+    }
+    if (!(file >> route.faceId >> route.metric >> route.prefix)) {
+      break;
+    }
+    routes.push_back(std::move(route));
+  }
+  if (!hasTrailer || nExpected != routes.size()) {
+    NS_LOG_WARN("Route cache " << cacheFile << " is incomplete, recomputing");
+    return false;
+  }
+
+  for (const auto& route : routes) {
+    FibHelper::AddRoute(NodeList::GetNode(route.nodeId), Name(route.prefix), route.faceId, route.metric);
+  }
+  NS_LOG_INFO("Installed " << routes.size() << " routes from cache " << cacheFile);
+  return true;
+}
+
+/**
+ * @brief Install routes in job order from a single thread, and write them to the cache if enabled
+ */
+void
+InstallRoutes(const RoutingSnapshot& snapshot, const std::string& algorithm, uint64_t hash,
+              const std::vector<RouteJob>& jobs,
+              const std::vector<std::vector<SnapshotRoute>>& routes)
+{
+  // Written aside and renamed once complete, runs sharing the cache never see a partial file
+  std::ofstream cache;
+  std::string cacheFile;
+  std::string tmpFile;
+  if (!g_routeCacheFile.empty()) {
+    cacheFile = GetRouteCacheFile();
+    tmpFile = cacheFile + ".tmp";
+    cache.open(tmpFile, std::ios::trunc);
+    if (cache) {
+      cache << algorithm << ' ' << std::hex << hash << std::dec << '\n';
+    }
+    else {
+      NS_LOG_WARN("Cannot write route cache " << tmpFile);
+    }
+  }
+  size_t nCached = 0;
+
+  for (size_t j = 0; j < jobs.size(); ++j) {
+    Ptr<Node> node = snapshot.nodes[jobs[j].source];
+    NS_LOG_DEBUG("Reachability from Node: " << node->GetId() << " (" << Names::FindName(node)
+                                            << ")");
+
+    for (const auto& route : routes[j]) {
+      const shared_ptr<Face>& face = snapshot.faces[route.edge];
+      for (const auto& prefix : snapshot.routers[route.origin]->GetLocalPrefixes()) {
+        NS_LOG_DEBUG(" prefix " << *prefix << " reachable via face " << *face
+                     << " with distance " << route.distance);
+
+        FibHelper::AddRoute(node, *prefix, face, route.distance);
+        if (cache) {
+          cache << node->GetId() << ' ' << face->getId() << ' ' << route.distance << ' '
+                << prefix->toUri() << '\n';
+          ++nCached;
         }
       }
     }
   }
+
+  if (!cache.is_open()) {
+    return;
+  }
+  cache << "end " << nCached << '\n';
+  cache.close();
+  if (!cache || std::rename(tmpFile.c_str(), cacheFile.c_str()) != 0) {
+    NS_LOG_WARN("Cannot write route cache " << cacheFile);
+    std::remove(tmpFile.c_str());
+  }
+}
+
+} // namespace
+
+void
+GlobalRoutingHelper::SetThreads(uint32_t threads)
+{
+  g_routingThreads = threads;
 }
 
 void
-GlobalRoutingHelper::CalculateAllPossibleRoutes()
+GlobalRoutingHelper::SetRouteCacheFile(const std::string& filename)
+{
+  g_routeCacheFile = filename;
+}
+
+void
+GlobalRoutingHelper::CalculateRoutes()
 {
   /**
    * Implementation of route calculation is heavily based on Boost Graph Library
@@ -290,100 +620,108 @@ GlobalRoutingHelper::CalculateAllPossibleRoutes()
   BOOST_CONCEPT_ASSERT((boost::VertexListGraphConcept<boost::NdnGlobalRouterGraph>));
   BOOST_CONCEPT_ASSERT((boost::IncidenceGraphConcept<boost::NdnGlobalRouterGraph>));
 
-  boost::NdnGlobalRouterGraph graph;
-  // typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
+  RoutingSnapshot snapshot;
+  uint64_t hash = snapshot.Hash("CalculateRoutes");
+  if (!g_routeCacheFile.empty() && LoadRouteCache("CalculateRoutes", hash)) {
+    return;
+  }
 
-  // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by
-  // the graph, which
-  // is not obviously how implement in an efficient manner
-  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
-    Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter>();
-    if (source == 0) {
-      NS_LOG_DEBUG("Node " << (*node)->GetId() << " does not export GlobalRouter interface");
-      continue;
+  // For now we doing Dijkstra for every node, each one on its own thread.  Can be replaced with
+  // Bellman-Ford or Floyd-Warshall.
+  std::vector<RouteJob> jobs;
+  for (size_t u = 0; u < snapshot.routers.size(); ++u) {
+    if (snapshot.nodes[u] != nullptr && IsLocal(snapshot.nodes[u])) {
+      jobs.push_back({u, nullptr});
     }
+  }
 
-    Ptr<L3Protocol> L3protocol = (*node)->GetObject<L3Protocol>();
-    shared_ptr<nfd::Forwarder> forwarder = L3protocol->getForwarder();
+  std::vector<std::vector<SnapshotRoute>> routes;
+  SearchRoutes(snapshot, jobs, routes);
+  InstallRoutes(snapshot, "CalculateRoutes", hash, jobs, routes);
+}
 
-    NS_LOG_DEBUG("Reachability from Node: " << source->GetObject<Node>()->GetId() << " ("
-                                            << Names::FindName(source->GetObject<Node>()) << ")");
+void
+GlobalRoutingHelper::RemoveLink(Ptr<Node> node1, Ptr<Node> node2)
+{
+  NS_LOG_FUNCTION(node1 << node2);
 
-    Ptr<L3Protocol> l3 = source->GetObject<L3Protocol>();
-    NS_ASSERT(l3 != 0);
+  Ptr<GlobalRouter> gr1 = node1->GetObject<GlobalRouter>();
+  Ptr<GlobalRouter> gr2 = node2->GetObject<GlobalRouter>();
+  NS_ASSERT_MSG(gr1 != 0 && gr2 != 0, "GlobalRouter should be installed on both nodes");
+  gr1->RemoveIncidency(gr2);
+  gr2->RemoveIncidency(gr1);
 
-    // remember interface statuses
-    std::list<nfd::FaceId> faceIds;
-    std::unordered_map<nfd::FaceId, uint16_t> originalMetrics;
-    for (auto& nfdFace : l3->getFaceTable()) {
-      faceIds.push_back(nfdFace.getId());
-      originalMetrics[nfdFace.getId()] = nfdFace.getMetric();
-      nfdFace.setMetric(std::numeric_limits<uint16_t>::max() - 1);
-      // value std::numeric_limits<uint16_t>::max () MUST NOT be used (reserved)
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    Ptr<L3Protocol> l3 = (*node)->GetObject<L3Protocol>();
+    if (l3 == 0 || !IsLocal(*node)) {
+      continue;
     }
 
-    for (auto& faceId : faceIds) {
-      auto* face = l3->getFaceTable().get(faceId);
-      NS_ASSERT(face != nullptr);
-      auto transport = dynamic_cast<NetDeviceTransport*>(face->getTransport());
-      if (transport == nullptr) {
-        NS_LOG_DEBUG("Skipping non ndnSIM-specific transport face");
-        continue;
+    std::vector<std::pair<Name, shared_ptr<Face>>> routes;
+    for (const auto& entry : l3->getForwarder()->getFib()) {
+      for (const auto& nextHop : entry.getNextHops()) {
+        Face& face = nextHop.getFace();
+        if (dynamic_cast<NetDeviceTransport*>(face.getTransport()) != nullptr) {
+          routes.emplace_back(entry.getPrefix(), face.shared_from_this());
+        }
       }
+    }
+    for (const auto& route : routes) {
+      FibHelper::RemoveRoute(*node, route.first, route.second);
+    }
+  }
 
-      // enabling only faceId
-      face->setMetric(originalMetrics[faceId]);
-
-      boost::DistancesMap distances;
+  std::string routeCacheFile;
+  std::swap(routeCacheFile, g_routeCacheFile);
+  CalculateRoutes();
+  std::swap(routeCacheFile, g_routeCacheFile);
+}
 
-      NS_LOG_DEBUG("-----------");
+void
+GlobalRoutingHelper::RemoveLinkByName(const std::string& node1, const std::string& node2)
+{
+  RemoveLink(Names::Find<Node>(node1), Names::Find<Node>(node2));
+}
 
-      dijkstra_shortest_paths(graph, source,
-                              // predecessor_map (boost::ref(predecessors))
-                              // .
-                              distance_map(boost::ref(distances))
-                                .distance_inf(boost::WeightInf)
-                                .distance_zero(boost::WeightZero)
-                                .distance_compare(boost::WeightCompare())
-                                .distance_combine(boost::WeightCombine()));
+void
+GlobalRoutingHelper::CalculateAllPossibleRoutes()
+{
+  /**
+   * Implementation of route calculation is heavily based on Boost Graph Library
+   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
+   */
 
-      // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
+  BOOST_CONCEPT_ASSERT((boost::VertexListGraphConcept<boost::NdnGlobalRouterGraph>));
+  BOOST_CONCEPT_ASSERT((boost::IncidenceGraphConcept<boost::NdnGlobalRouterGraph>));
 
-      for (const auto& dist : distances) {
-        if (dist.first == source)
-          continue;
-        else {
-          // cout << "  Node " << dist.first->GetObject<Node> ()->GetId ();
-          if (std::get<0>(dist.second) == 0) {
-            // cout << " is unreachable" << endl;
-          }
-          else {
-            for (const auto& prefix : dist.first->GetLocalPrefixes()) {
-              NS_LOG_DEBUG(" prefix " << *prefix << " reachable via face "
-                           << *std::get<0>(dist.second)
-                           << " with distance " << std::get<1>(dist.second)
-                           << " with delay " << std::get<2>(dist.second));
-
-              if (std::get<0>(dist.second)->getMetric() == std::numeric_limits<uint16_t>::max() - 1)
-                continue;
-
-              FibHelper::AddRoute(*node, *prefix, std::get<0>(dist.second),
-                                  std::get<1>(dist.second));
-            }
-          }
-        }
-      }
+  RoutingSnapshot snapshot;
+  uint64_t hash = snapshot.Hash("CalculateAllPossibleRoutes");
+  if (!g_routeCacheFile.empty() && LoadRouteCache("CalculateAllPossibleRoutes", hash)) {
+    return;
+  }
 
-      // disabling the face again
-      face->setMetric(std::numeric_limits<uint16_t>::max() - 1);
+  // One Dijkstra for every (node, face): all the node's faces are disabled but this one, so that
+  // every face gets the routes for which it's the best way out
+  std::vector<RouteJob> jobs;
+  for (size_t u = 0; u < snapshot.routers.size(); ++u) {
+    if (snapshot.nodes[u] == nullptr || !IsLocal(snapshot.nodes[u])) {
+      continue;
     }
 
-    // recover original interface statuses
-    for (auto& i : originalMetrics) {
-      l3->getFaceTable().get(i.first)->setMetric(i.second);
+    Ptr<L3Protocol> l3 = snapshot.routers[u]->GetObject<L3Protocol>();
+    NS_ASSERT(l3 != 0);
+    for (auto& face : l3->getFaceTable()) {
+      if (dynamic_cast<NetDeviceTransport*>(face.getTransport()) == nullptr) {
+        NS_LOG_DEBUG("Skipping non ndnSIM-specific transport face");
+        continue;
+      }
+      jobs.push_back({u, &face});
     }
   }
+
+  std::vector<std::vector<SnapshotRoute>> routes;
+  SearchRoutes(snapshot, jobs, routes);
+  InstallRoutes(snapshot, "CalculateAllPossibleRoutes", hash, jobs, routes);
 }
 
 } // namespace ndn
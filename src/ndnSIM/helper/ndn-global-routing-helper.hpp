@@ -96,10 +96,53 @@ public:
 
   /**
    * @brief Calculate for every node shortest path trees and install routes to all prefix origins
+   *
+   * Shortest paths are searched in parallel on a snapshot of the topology, routes are then
+   * installed from the calling thread. In a distributed (MPI) simulation only the nodes of the
+   * local rank get routes.
    */
   static void
   CalculateRoutes();
 
+  /**
+   * @brief Take the link between two nodes out of the routing graph and calculate the routes again
+   *
+   * Meant to follow LinkControlHelper::FailLink, which only drops the packets of the link. Routes
+   * through network faces are removed from every node, application faces keep theirs, then
+   * CalculateRoutes runs on the remaining topology. The route cache is neither read nor
+   * rewritten, it keeps the routes of the full topology.
+   */
+  static void
+  RemoveLink(Ptr<Node> node1, Ptr<Node> node2);
+
+  /**
+   * @brief Same as above, nodes are looked up by name
+   */
+  static void
+  RemoveLinkByName(const std::string& node1, const std::string& node2);
+
+  /**
+   * @brief Set the number of threads searching shortest paths in CalculateRoutes and
+   *        CalculateAllPossibleRoutes
+   * @param threads 0 (default) uses one thread per core
+   */
+  static void
+  SetThreads(uint32_t threads);
+
+  /**
+   * @brief Cache the routes of CalculateRoutes and CalculateAllPossibleRoutes in a file
+   *
+   * The file is keyed by a hash of the topology (nodes, channels, faces, metrics and origin
+   * prefixes). When it matches, routes are installed from the file without any computation,
+   * otherwise they're computed and the file is rewritten: written to "<filename>.tmp" and
+   * renamed once complete. A file missing its route count trailer is ignored. Ranks of a
+   * distributed simulation use "<filename>.<rank>".
+   *
+   * @param filename Cache file, empty (default) disables the cache
+   */
+  static void
+  SetRouteCacheFile(const std::string& filename);
+
   /**
    * @brief Calculates a set of loop-free multipath routes.
    *
@@ -43,6 +43,8 @@
 #include "ns3/ndnSIM/NFD/daemon/face/generic-link-service.hpp"
 #include "ns3/ndnSIM/NFD/daemon/table/cs-policy-priority-fifo.hpp"
 #include "ns3/ndnSIM/NFD/daemon/table/cs-policy-lru.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/cs-policy-hashed.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/dead-nonce-filter.hpp"
 
 NS_LOG_COMPONENT_DEFINE("ndn.StackHelper");
 
@@ -58,6 +60,8 @@ StackHelper::StackHelper()
 
   m_csPolicies.insert({"nfd::cs::lru", [] { return make_unique<nfd::cs::LruPolicy>(); }});
   m_csPolicies.insert({"nfd::cs::priority_fifo", [] () { return make_unique<nfd::cs::PriorityFifoPolicy>(); }});
+  m_csPolicies.insert({"nfd::cs::hashed_lru", [] { return make_unique<nfd::cs::HashedLruPolicy>(); }});
+  m_csPolicies.insert({"nfd::cs::hashed_fifo", [] { return make_unique<nfd::cs::HashedFifoPolicy>(); }});
 
   m_csPolicyCreationFunc = m_csPolicies["nfd::cs::lru"];
 
@@ -132,6 +136,25 @@ StackHelper::setPolicy(const std::string& policy)
   }
 }
 
+void
+StackHelper::setDeadNonceList(const std::string& type, size_t capacity,
+                              double falsePositiveRate, size_t nGenerations)
+{
+  if (type == "nfd::dnl::exact") {
+    m_dnlCreationFunc = [] { return make_unique<nfd::DeadNonceList>(); };
+  }
+  else if (type == "nfd::dnl::cuckoo") {
+    nfd::DeadNonceFilter::Options options;
+    options.capacity = capacity;
+    options.falsePositiveRate = falsePositiveRate;
+    options.nGenerations = nGenerations;
+    m_dnlCreationFunc = [options] { return make_unique<nfd::DeadNonceFilter>(options); };
+  }
+  else {
+    NS_FATAL_ERROR("Dead Nonce List " << type << " not found");
+  }
+}
+
 void
 StackHelper::Install(const NodeContainer& c) const
 {
@@ -176,6 +199,10 @@ StackHelper::doInstall(Ptr<Node> node) const
 
   ndn->setCsReplacementPolicy(m_csPolicyCreationFunc);
 
+  if (m_dnlCreationFunc != nullptr) {
+    ndn->setDeadNonceList(m_dnlCreationFunc);
+  }
+
   // Aggregate L3Protocol on node (must be after setting ndnSIM CS)
   node->AggregateObject(ndn);
 
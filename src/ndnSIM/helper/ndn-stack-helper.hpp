@@ -31,6 +31,7 @@
 #include "ndn-strategy-choice-helper.hpp"
 
 namespace nfd {
+class DeadNonceTable;
 namespace cs {
 class Policy;
 } // namespace cs
@@ -81,10 +82,26 @@ public:
 
   /**
    * @brief Set the cache replacement policy for NFD's Content Store
+   *
+   * "nfd::cs::lru" (default), "nfd::cs::priority_fifo", or "nfd::cs::hashed_lru" and
+   * "nfd::cs::hashed_fifo", which index Data names by hash for faster exact-match lookups
+   * in large Content Stores
    */
   void
   setPolicy(const std::string& policy);
 
+  /**
+   * @brief Set the Dead Nonce List of NFD's forwarder
+   *
+   * "nfd::dnl::exact" (default) stores a 64-bit hash of each dead Nonce and adapts its capacity.
+   * "nfd::dnl::cuckoo" stores short fingerprints in @p nGenerations rotating cuckoo filters sized
+   * for @p capacity Nonces per lifetime: memory stays bounded, and a non-looping Interest is
+   * considered looping with probability at most @p falsePositiveRate
+   */
+  void
+  setDeadNonceList(const std::string& type, size_t capacity = 65536,
+                   double falsePositiveRate = 1e-4, size_t nGenerations = 4);
+
   typedef Callback<shared_ptr<Face>, Ptr<Node>, Ptr<L3Protocol>, Ptr<NetDevice>>
     FaceCreateCallback;
 
@@ -262,6 +279,9 @@ private:
 
   std::map<std::string, PolicyCreationCallback> m_csPolicies;
 
+  typedef std::function<std::unique_ptr<nfd::DeadNonceTable>()> DeadNonceListCreationCallback;
+  DeadNonceListCreationCallback m_dnlCreationFunc;
+
   typedef std::list<std::pair<TypeId, FaceCreateCallback>> NetDeviceCallbackList;
   NetDeviceCallbackList m_netDeviceCallbacks;
 };
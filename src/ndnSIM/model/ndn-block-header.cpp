@@ -19,16 +19,11 @@
 
 #include "ndn-block-header.hpp"
 
-#include <iosfwd>
-#include <boost/iostreams/concepts.hpp>
-#include <boost/iostreams/stream.hpp>
-
 #include <ndn-cxx/encoding/tlv.hpp>
 #include <ndn-cxx/interest.hpp>
 #include <ndn-cxx/data.hpp>
 #include <ndn-cxx/lp/packet.hpp>
 
-namespace io = boost::iostreams;
 namespace nfdFace = nfd::face;
 
 namespace ns3 {
@@ -73,37 +68,59 @@ BlockHeader::Serialize(ns3::Buffer::Iterator start) const
   start.Write(m_block.wire(), m_block.size());
 }
 
-class Ns3BufferIteratorSource : public io::source {
-public:
-  Ns3BufferIteratorSource(ns3::Buffer::Iterator& is)
-    : m_is(is)
-  {
+/**
+ * @brief Read a TLV-TYPE or TLV-LENGTH number, false if the buffer ends before it's complete
+ */
+static bool
+readVarNumber(ns3::Buffer::Iterator& i, uint64_t& number)
+{
+  if (i.GetRemainingSize() < 1) {
+    return false;
   }
 
-  std::streamsize
-  read(char* buf, std::streamsize nMaxRead)
-  {
-    std::streamsize i = 0;
-    for (; i < nMaxRead && !m_is.IsEnd(); ++i) {
-      buf[i] = m_is.ReadU8();
-    }
-    if (i == 0) {
-      return -1;
-    }
-    else {
-      return i;
-    }
+  uint8_t first = i.ReadU8();
+  size_t size = first < 253 ? 0 : first == 253 ? 2 : first == 254 ? 4 : 8;
+  if (i.GetRemainingSize() < size) {
+    return false;
   }
 
-private:
-  ns3::Buffer::Iterator& m_is;
-};
+  switch (size) {
+    case 0:
+      number = first;
+      break;
+    case 2:
+      number = i.ReadNtohU16();
+      break;
+    case 4:
+      number = i.ReadNtohU32();
+      break;
+    default:
+      number = i.ReadNtohU64();
+      break;
+  }
+  return true;
+}
 
 uint32_t
 BlockHeader::Deserialize(ns3::Buffer::Iterator start)
 {
-  io::stream<Ns3BufferIteratorSource> is(start);
-  m_block = ::ndn::Block::fromStream(is);
+  // Peek TLV-TYPE and TLV-LENGTH to size the block, then copy it in one go: no per-byte stream
+  // and a single allocation, whatever the packet size
+  ns3::Buffer::Iterator peek = start;
+  uint64_t type = 0;
+  uint64_t length = 0;
+  if (!readVarNumber(peek, type) || !readVarNumber(peek, length)) {
+    NDN_THROW(::ndn::tlv::Error("Incomplete TLV header in ns3::Packet"));
+  }
+
+  uint64_t headerSize = peek.GetDistanceFrom(start);
+  if (length > start.GetRemainingSize() - headerSize) {
+    NDN_THROW(::ndn::tlv::Error("Not enough data in ns3::Packet to fully parse TLV"));
+  }
+
+  auto buffer = std::make_shared<::ndn::Buffer>(headerSize + length);
+  start.Read(buffer->data(), static_cast<uint32_t>(buffer->size()));
+  m_block = Block(std::move(buffer));
   return m_block.size();
 }
 
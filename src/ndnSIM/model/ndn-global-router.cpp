@@ -76,6 +76,14 @@ GlobalRouter::AddIncidency(shared_ptr<Face> face, Ptr<GlobalRouter> gr)
   m_incidencies.push_back(std::make_tuple(this, face, gr));
 }
 
+void
+GlobalRouter::RemoveIncidency(Ptr<GlobalRouter> gr)
+{
+  m_incidencies.remove_if([gr] (const Incidency& incidency) {
+    return std::get<2>(incidency) == gr;
+  });
+}
+
 GlobalRouter::IncidencyList&
 GlobalRouter::GetIncidencies()
 {
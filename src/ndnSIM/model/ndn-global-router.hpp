@@ -95,6 +95,13 @@ public:
   void
   AddIncidency(shared_ptr<Face> face, Ptr<GlobalRouter> ndn);
 
+  /**
+   * @brief Remove the edges to another node, e.g. after their link failed
+   * @param ndn GlobalRouter of the other node
+   */
+  void
+  RemoveIncidency(Ptr<GlobalRouter> ndn);
+
   /**
    * @brief Get list of edges that are connected to this node
    */
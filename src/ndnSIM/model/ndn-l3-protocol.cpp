@@ -194,6 +194,7 @@ private:
   nfd::ConfigSection m_config;
 
   PolicyCreationCallback m_policy;
+  DeadNonceListCreationCallback m_deadNonceList;
 };
 
 L3Protocol::L3Protocol()
@@ -212,6 +213,9 @@ L3Protocol::initialize()
 {
   m_impl->m_faceTable = make_unique<::nfd::FaceTable>();
   m_impl->m_forwarder = make_shared<::nfd::Forwarder>(*m_impl->m_faceTable);
+  if (m_impl->m_deadNonceList != nullptr) {
+    m_impl->m_forwarder->setDeadNonceList(m_impl->m_deadNonceList());
+  }
   m_impl->m_faceSystem = make_unique<::nfd::face::FaceSystem>(*m_impl->m_faceTable, nullptr);
 
   initializeManagement();
@@ -254,6 +258,12 @@ L3Protocol::setCsReplacementPolicy(const PolicyCreationCallback& policy)
   m_impl->m_policy = policy;
 }
 
+void
+L3Protocol::setDeadNonceList(const DeadNonceListCreationCallback& dnl)
+{
+  m_impl->m_deadNonceList = dnl;
+}
+
 void
 L3Protocol::initializeManagement()
 {
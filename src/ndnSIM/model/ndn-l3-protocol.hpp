@@ -37,6 +37,7 @@ class Forwarder;
 class FibManager;
 class FaceTable;
 class StrategyChoiceManager;
+class DeadNonceTable;
 typedef boost::property_tree::ptree ConfigSection;
 namespace pit {
 class Entry;
@@ -174,6 +175,16 @@ public:
   void
   setCsReplacementPolicy(const PolicyCreationCallback& policy);
 
+  typedef std::function<std::unique_ptr<nfd::DeadNonceTable>()> DeadNonceListCreationCallback;
+
+  /**
+   * \brief Set the Dead Nonce List of NFD's forwarder
+   *
+   * If not set, the forwarder keeps its default nfd::DeadNonceList
+   */
+  void
+  setDeadNonceList(const DeadNonceListCreationCallback& dnl);
+
 public: // Workaround for python bindings
   static Ptr<L3Protocol>
   getL3Protocol(Ptr<Object> node);
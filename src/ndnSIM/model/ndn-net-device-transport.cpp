@@ -132,11 +132,9 @@ NetDeviceTransport::receiveFromNetDevice(Ptr<NetDevice> device,
 {
   NS_LOG_FUNCTION(device << p << protocol << from << to << packetType);
 
-  // Convert NS3 packet to NFD packet
-  Ptr<ns3::Packet> packet = p->Copy();
-
+  // Convert NS3 packet to NFD packet, the header is read in place, the packet isn't copied
   BlockHeader header;
-  packet->RemoveHeader(header);
+  p->PeekHeader(header);
 
   this->receive(std::move(header.getBlock()));
 }
@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "apps/aggregation-name.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+class AggregationNameFixture : public CleanupFixture
+{
+public:
+  AggregationNameFixture()
+  {
+    flows.Add("agg0");
+    flows.Add("pro2");
+  }
+
+public:
+  FlowTable flows;
+};
+
+BOOST_FIXTURE_TEST_SUITE(AppsAggregationName, AggregationNameFixture)
+
+BOOST_AUTO_TEST_CASE(SingleSegment)
+{
+  ModelSegmentation segmentation(100, 0);
+  Name prefix = AggregationNameCodec::MakeDataPrefix("agg0", "pro0.pro1");
+  BOOST_CHECK_EQUAL(prefix, Name("/agg0/pro0.pro1/data"));
+  BOOST_CHECK(prefix.hasWire());
+
+  // The segment component is omitted for single-segment models
+  Name name = AggregationNameCodec::MakeDataName(prefix, 5, segmentation);
+  BOOST_CHECK_EQUAL(name, Name("/agg0/pro0.pro1/data").appendSequenceNumber(5));
+
+  AggregationName parsed = AggregationNameCodec::Parse(name, flows, segmentation);
+  BOOST_CHECK(parsed.type == AggregationPacketType::DATA);
+  BOOST_CHECK_EQUAL(parsed.flowId, 0);
+  BOOST_CHECK_EQUAL(parsed.seq, 5);
+}
+
+BOOST_AUTO_TEST_CASE(MultiSegment)
+{
+  ModelSegmentation segmentation(100, 30);
+  BOOST_REQUIRE_EQUAL(segmentation.GetSegmentCount(), 4);
+  Name prefix = AggregationNameCodec::MakeDataPrefix("pro2", "pro2");
+
+  // Unit 7 is the third segment of the second iteration
+  Name name = AggregationNameCodec::MakeDataName(prefix, 7, segmentation);
+  BOOST_CHECK_EQUAL(name, Name("/pro2/pro2/data").appendSequenceNumber(2).appendSegment(2));
+
+  AggregationName parsed = AggregationNameCodec::Parse(name, flows, segmentation);
+  BOOST_CHECK(parsed.type == AggregationPacketType::DATA);
+  BOOST_CHECK_EQUAL(parsed.flowId, 1);
+  BOOST_CHECK_EQUAL(parsed.seq, 7);
+
+  // Interests carrying ApplicationParameters end with a digest, which is skipped
+  Interest interest(name);
+  interest.setApplicationParameters(std::vector<uint8_t>{1, 2, 3});
+  BOOST_REQUIRE(interest.getName().get(-1).isParametersSha256Digest());
+  parsed = AggregationNameCodec::Parse(interest.getName(), flows, segmentation);
+  BOOST_CHECK(parsed.type == AggregationPacketType::DATA);
+  BOOST_CHECK_EQUAL(parsed.seq, 7);
+}
+
+BOOST_AUTO_TEST_CASE(Initialization)
+{
+  ModelSegmentation segmentation(100, 30);
+  Name name("/agg0/initialization");
+  name.appendSequenceNumber(3);
+
+  AggregationName parsed = AggregationNameCodec::Parse(name, flows, segmentation);
+  BOOST_CHECK(parsed.type == AggregationPacketType::INITIALIZATION);
+  BOOST_CHECK_EQUAL(parsed.flowId, 0);
+  BOOST_CHECK_EQUAL(parsed.seq, 0);
+  BOOST_CHECK_EQUAL(ModelSegmentation::ParseInitSeq(name), 3);
+}
+
+BOOST_AUTO_TEST_CASE(Unknown)
+{
+  ModelSegmentation segmentation(100, 0);
+
+  // Too short
+  AggregationName parsed = AggregationNameCodec::Parse(Name("/agg0/data"), flows, segmentation);
+  BOOST_CHECK(parsed.type == AggregationPacketType::UNKNOWN);
+  BOOST_CHECK_EQUAL(parsed.flowId, FlowTable::INVALID);
+
+  // Unknown type, the flow is still resolved
+  parsed = AggregationNameCodec::Parse(Name("/agg0/pro0/model").appendSequenceNumber(1), flows, segmentation);
+  BOOST_CHECK(parsed.type == AggregationPacketType::UNKNOWN);
+  BOOST_CHECK_EQUAL(parsed.flowId, 0);
+  BOOST_CHECK_EQUAL(parsed.seq, 0);
+
+  // Type component must be generic
+  Name typed("/agg0/pro0");
+  typed.append(name::Component(::ndn::tlv::KeywordNameComponent, reinterpret_cast<const uint8_t*>("data"), 4));
+  typed.appendSequenceNumber(1);
+  parsed = AggregationNameCodec::Parse(typed, flows, segmentation);
+  BOOST_CHECK(parsed.type == AggregationPacketType::UNKNOWN);
+
+  // Data of a node which isn't a child
+  parsed = AggregationNameCodec::Parse(Name("/agg9/pro0/data").appendSequenceNumber(1), flows, segmentation);
+  BOOST_CHECK(parsed.type == AggregationPacketType::DATA);
+  BOOST_CHECK_EQUAL(parsed.flowId, FlowTable::INVALID);
+  BOOST_CHECK_EQUAL(parsed.seq, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "apps/flow-state.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_FIXTURE_TEST_SUITE(AppsFlowTable, CleanupFixture)
+
+BOOST_AUTO_TEST_CASE(Intern)
+{
+  FlowTable flows;
+  BOOST_CHECK(flows.empty());
+
+  // Ids are dense, in the order the flows are added, whatever the order of the prefixes
+  BOOST_CHECK_EQUAL(flows.Add("pro1"), 0);
+  BOOST_CHECK_EQUAL(flows.Add("agg0"), 1);
+  BOOST_CHECK_EQUAL(flows.Add("pro0"), 2);
+  BOOST_CHECK_EQUAL(flows.Add("agg0"), 1);
+  BOOST_CHECK_EQUAL(flows.size(), 3);
+
+  BOOST_CHECK_EQUAL(flows[0].prefix, "pro1");
+  BOOST_CHECK_EQUAL(flows[1].prefix, "agg0");
+  BOOST_CHECK_EQUAL(flows[2].prefix, "pro0");
+
+  flows[2].seq = 7;
+  BOOST_CHECK_EQUAL(flows[flows.Find(std::string("pro0"))].seq, 7);
+
+  size_t n = 0;
+  for (const FlowState& flow : flows) {
+    BOOST_CHECK_EQUAL(flows.Find(flow.prefix), n++);
+  }
+  BOOST_CHECK_EQUAL(n, 3);
+}
+
+BOOST_AUTO_TEST_CASE(Find)
+{
+  FlowTable flows;
+  flows.Add("agg0");
+  flows.Add("pro0");
+
+  BOOST_CHECK_EQUAL(flows.Find(std::string("agg0")), 0);
+  BOOST_CHECK_EQUAL(flows.Find(std::string("pro0")), 1);
+  BOOST_CHECK_EQUAL(flows.Find(std::string("pro")), FlowTable::INVALID);
+  BOOST_CHECK_EQUAL(flows.Find(std::string("pro00")), FlowTable::INVALID);
+  BOOST_CHECK_EQUAL(flows.Find(std::string()), FlowTable::INVALID);
+
+  // Names are resolved by their first component only
+  BOOST_CHECK_EQUAL(flows.Find(Name("/pro0/pro0/data/%FE%01")), 1);
+  BOOST_CHECK_EQUAL(flows.Find(Name("/agg0")), 0);
+  BOOST_CHECK_EQUAL(flows.Find(Name("/agg1/agg0")), FlowTable::INVALID);
+  BOOST_CHECK_EQUAL(flows.Find(Name()), FlowTable::INVALID);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
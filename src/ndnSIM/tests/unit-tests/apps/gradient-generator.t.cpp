@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "apps/gradient-generator.hpp"
+
+#include "../tests-common.hpp"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+class GradientGeneratorFixture : public CleanupFixture
+{
+public:
+  ~GradientGeneratorFixture()
+  {
+    SetPhiloxAvx2(true);
+  }
+
+  /**
+   * Philox block of one counter {c0, c1, c2, c3}
+   */
+  static std::vector<uint32_t>
+  philox(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t k0, uint32_t k1)
+  {
+    const uint32_t key[2] = {k0, k1};
+    std::vector<uint32_t> block(4);
+    PhiloxBlocks(block.data(), 1, (static_cast<uint64_t>(c1) << 32) | c0,
+                 (static_cast<uint64_t>(c3) << 32) | c2, key);
+    return block;
+  }
+
+  /**
+   * The model of an iteration generated in pieces of the given sizes, starting at offset 0
+   */
+  std::vector<double>
+  fillInPieces(size_t modelSize, uint64_t iteration, size_t pieceSize) const
+  {
+    std::vector<double> model(modelSize);
+    for (size_t offset = 0; offset < modelSize; offset += pieceSize) {
+      generator.Fill(model.data() + offset, std::min(pieceSize, modelSize - offset), iteration, offset);
+    }
+    return model;
+  }
+
+public:
+  GradientGenerator generator;
+};
+
+BOOST_FIXTURE_TEST_SUITE(AppsGradientGenerator, GradientGeneratorFixture)
+
+// Known answers of Philox4x32-10 from the Random123 distribution, with both kernels
+BOOST_AUTO_TEST_CASE(PhiloxKnownAnswers)
+{
+  for (bool avx2 : {true, false}) {
+    BOOST_TEST_MESSAGE("AVX2 kernel: " << SetPhiloxAvx2(avx2));
+
+    BOOST_CHECK(philox(0, 0, 0, 0, 0, 0) ==
+                (std::vector<uint32_t>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    BOOST_CHECK(philox(0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff) ==
+                (std::vector<uint32_t>{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    BOOST_CHECK(philox(0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344, 0xa4093822, 0x299f31d0) ==
+                (std::vector<uint32_t>{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+  }
+}
+
+// Blocks computed several at a time, including a partial group of lanes, equal blocks computed one
+// by one, and the kernels agree
+BOOST_AUTO_TEST_CASE(PhiloxBatches)
+{
+  const uint32_t key[2] = {0x01234567, 0x89abcdef};
+  const size_t blocks = 29;
+  const uint64_t first = 0xfffffffffffffff0; // the counter wraps around within the batch
+
+  std::vector<uint32_t> batch(4 * blocks);
+  PhiloxBlocks(batch.data(), blocks, first, 7, key);
+  for (size_t b = 0; b < blocks; ++b) {
+    uint32_t block[4];
+    PhiloxBlocks(block, 1, first + b, 7, key);
+    BOOST_CHECK(std::equal(block, block + 4, batch.begin() + 4 * b));
+  }
+
+  SetPhiloxAvx2(false);
+  std::vector<uint32_t> scalar(4 * blocks);
+  PhiloxBlocks(scalar.data(), blocks, first, 7, key);
+  BOOST_CHECK(scalar == batch);
+}
+
+// A model is the same whatever the segmentation, the kernel and the order its pieces are generated in
+BOOST_AUTO_TEST_CASE(FillIndependence)
+{
+  const size_t modelSize = 1000;
+  generator.SetKey(0x5eed5eed5eedULL);
+
+  for (auto distribution : {GRADIENT_UNIFORM, GRADIENT_GAUSSIAN, GRADIENT_SPARSE}) {
+    BOOST_TEST_MESSAGE("distribution " << distribution);
+    generator.SetDistribution(distribution);
+    generator.SetNormal(0.5, 2.0, 0.25);
+
+    SetPhiloxAvx2(true);
+    std::vector<double> whole(modelSize);
+    generator.Fill(whole.data(), modelSize, 3, 0);
+
+    // odd piece sizes start pieces in the middle of a Philox block and of a fill chunk
+    for (size_t pieceSize : {1, 3, 127, 129, 500, 999}) {
+      BOOST_CHECK(fillInPieces(modelSize, 3, pieceSize) == whole);
+    }
+
+    std::vector<double> tail(modelSize - 333);
+    generator.Fill(tail.data(), tail.size(), 3, 333);
+    BOOST_CHECK(std::equal(tail.begin(), tail.end(), whole.begin() + 333));
+
+    SetPhiloxAvx2(false);
+    std::vector<double> scalar(modelSize);
+    generator.Fill(scalar.data(), modelSize, 3, 0);
+    BOOST_CHECK(scalar == whole);
+    BOOST_CHECK(fillInPieces(modelSize, 3, 129) == whole);
+
+    // another iteration is another model
+    std::vector<double> next(modelSize);
+    generator.Fill(next.data(), modelSize, 4, 0);
+    BOOST_CHECK(next != whole);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
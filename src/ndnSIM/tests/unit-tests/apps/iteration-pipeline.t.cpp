@@ -0,0 +1,267 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "apps/iteration-pipeline.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+class IterationPipelineFixture : public CleanupFixture
+{
+public:
+  IterationPipelineFixture()
+  {
+    pipeline.Configure(ModelSegmentation(4, 0), 2, StragglerPolicy(), [] (uint32_t) {});
+  }
+
+  /**
+   * Contribution of child flowId, every parameter set to value, summing the given producers
+   */
+  IterationPipeline::Result
+  contribute(uint32_t unit, uint32_t flowId, double value, const std::vector<uint32_t>& leaves,
+             size_t size = 4)
+  {
+    std::vector<double> parameters(size, value);
+    ModelContributors contributors;
+    for (uint32_t leaf : leaves) {
+      contributors.add(leaf);
+    }
+    ::ndn::Block content = encodeModelDataContent(parameters.data(), parameters.size(), 0, {},
+                                                  PAYLOAD_FP64, 0, contributors);
+    ModelDataView view;
+    BOOST_REQUIRE(view.parse(content));
+    return pipeline.Contribute(unit, flowId, view);
+  }
+
+  /**
+   * Straggler tolerant pipeline, segments made ready by the deadline are recorded
+   */
+  void
+  configure(const ModelSegmentation& segmentation, StragglerMode mode, double quorum, Time deadline,
+            LateUpdates lateUpdates = LATE_UPDATES_DROP)
+  {
+    StragglerPolicy policy;
+    policy.mode = mode;
+    policy.quorum = quorum;
+    policy.deadline = deadline;
+    policy.lateUpdates = lateUpdates;
+    pipeline.Configure(segmentation, 2, policy, [this] (uint32_t unit) {
+      expired.emplace_back(Simulator::Now().GetMilliSeconds(), unit);
+    });
+  }
+
+  /**
+   * Run the simulation until the given time
+   */
+  static void
+  advanceTo(int64_t ms)
+  {
+    Simulator::Stop(MilliSeconds(ms) - Simulator::Now());
+    Simulator::Run();
+  }
+
+public:
+  IterationPipeline pipeline;
+  std::vector<std::pair<int64_t, uint32_t>> expired; // (ms, unit)
+};
+
+BOOST_FIXTURE_TEST_SUITE(AppsIterationPipeline, IterationPipelineFixture)
+
+// Aggregator 0 (producers 1 and 2) and producer 3 are the children, aggregator 0 is removed and
+// its producers are re-parented under aggregator 4
+
+BOOST_AUTO_TEST_CASE(RemoveAggregatorBeforeItDelivered)
+{
+  BOOST_REQUIRE(pipeline.Open(1, {0, 3}));
+  BOOST_CHECK_EQUAL(contribute(1, 3, 1.0, {3}), IterationPipeline::ACCEPTED);
+
+  // The new aggregator joins before the old one leaves, the segment keeps waiting
+  std::vector<uint32_t> units = pipeline.AddChild(4, {1, 2});
+  BOOST_CHECK(units == std::vector<uint32_t>{1});
+  BOOST_CHECK(pipeline.RemoveChild(0).empty());
+
+  BOOST_CHECK_EQUAL(contribute(1, 4, 2.0, {1, 2}), IterationPipeline::READY);
+  BOOST_CHECK_EQUAL(pipeline.Sum(1)[0], 3.0);
+  BOOST_CHECK_EQUAL(pipeline.Contributors(1).population(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(RemoveAggregatorAfterItDelivered)
+{
+  BOOST_REQUIRE(pipeline.Open(1, {0, 3}));
+  BOOST_CHECK_EQUAL(contribute(1, 0, 2.0, {1, 2}), IterationPipeline::ACCEPTED);
+
+  // The segment already has producers 1 and 2, the new aggregator isn't asked for it
+  BOOST_CHECK(pipeline.AddChild(4, {1, 2}).empty());
+  BOOST_CHECK(pipeline.RemoveChild(0).empty());
+  BOOST_CHECK_EQUAL(contribute(1, 4, 2.0, {1, 2}), IterationPipeline::DUPLICATE);
+
+  BOOST_CHECK_EQUAL(contribute(1, 3, 1.0, {3}), IterationPipeline::READY);
+  BOOST_CHECK_EQUAL(pipeline.Sum(1)[0], 3.0);
+  BOOST_CHECK_EQUAL(pipeline.Contributors(1).count, 3);
+}
+
+BOOST_AUTO_TEST_CASE(RemoveAggregatorMidIteration)
+{
+  pipeline.Configure(ModelSegmentation(4, 2), 2, StragglerPolicy(), [] (uint32_t) {});
+  BOOST_REQUIRE(pipeline.Open(1, {0, 3}));
+  // Aggregator 0 only delivered the first segment
+  BOOST_CHECK_EQUAL(contribute(1, 0, 2.0, {1, 2}), IterationPipeline::ACCEPTED);
+
+  std::vector<uint32_t> units = pipeline.AddChild(4, {1, 2});
+  BOOST_CHECK(units == std::vector<uint32_t>{2});
+  BOOST_CHECK(pipeline.RemoveChild(0).empty());
+
+  BOOST_CHECK_EQUAL(contribute(2, 4, 2.0, {1, 2}), IterationPipeline::ACCEPTED);
+  BOOST_CHECK_EQUAL(contribute(1, 3, 1.0, {3}), IterationPipeline::READY);
+  BOOST_CHECK_EQUAL(contribute(2, 3, 1.0, {3}), IterationPipeline::READY);
+  BOOST_CHECK_EQUAL(pipeline.Sum(1)[0], 3.0);
+  BOOST_CHECK_EQUAL(pipeline.Sum(2)[0], 3.0);
+
+  // Iterations opened later wait for the new aggregator only
+  BOOST_REQUIRE(pipeline.Open(2, {3, 4}));
+  BOOST_CHECK_EQUAL(contribute(3, 0, 2.0, {1, 2}), IterationPipeline::DUPLICATE);
+}
+
+BOOST_AUTO_TEST_CASE(Quorum)
+{
+  configure(ModelSegmentation(4, 0), STRAGGLER_QUORUM, 0.5, Time());
+  BOOST_REQUIRE(pipeline.IsStragglerTolerant());
+  BOOST_REQUIRE(pipeline.Open(1, {0, 3, 4, 5}));
+
+  // 2 of the 4 children
+  BOOST_CHECK_EQUAL(contribute(1, 0, 2.0, {1, 2}), IterationPipeline::ACCEPTED);
+  BOOST_CHECK_EQUAL(contribute(1, 0, 2.0, {1, 2}), IterationPipeline::DUPLICATE);
+  BOOST_CHECK_EQUAL(contribute(1, 3, 1.0, {3}), IterationPipeline::READY);
+  BOOST_CHECK_EQUAL(pipeline.Sum(1)[0], 3.0);
+  BOOST_CHECK_EQUAL(pipeline.Contributors(1).population(), 3);
+  BOOST_CHECK(!pipeline.IsFailed(1));
+
+  // Late contributions are dropped
+  BOOST_CHECK_EQUAL(contribute(1, 4, 1.0, {4}), IterationPipeline::UNKNOWN);
+  BOOST_CHECK_EQUAL(pipeline.Sum(1)[0], 3.0);
+
+  bool failed = true;
+  BOOST_CHECK(pipeline.Close(1, nullptr, &failed));
+  BOOST_CHECK(!failed);
+  BOOST_CHECK(!pipeline.IsOpen(1));
+  BOOST_CHECK_EQUAL(contribute(1, 5, 1.0, {5}), IterationPipeline::UNKNOWN);
+  BOOST_CHECK_EQUAL(pipeline.GetStats().GetIterationCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(QuorumNeedsParameters)
+{
+  configure(ModelSegmentation(4, 0), STRAGGLER_QUORUM, 0.5, Time());
+  BOOST_REQUIRE(pipeline.Open(1, {0, 3}));
+
+  // A contribution without parameters counts towards the quorum, but there's nothing to average
+  BOOST_CHECK_EQUAL(contribute(1, 0, 0.0, {}, 0), IterationPipeline::ACCEPTED);
+  BOOST_CHECK_EQUAL(contribute(1, 3, 1.0, {3}), IterationPipeline::READY);
+  BOOST_CHECK_EQUAL(pipeline.Sum(1)[0], 1.0);
+  BOOST_CHECK(!pipeline.IsFailed(1));
+}
+
+BOOST_AUTO_TEST_CASE(FailedSegment)
+{
+  configure(ModelSegmentation(4, 2), STRAGGLER_QUORUM, 0.5, Time());
+  BOOST_REQUIRE(pipeline.Open(1, {0, 3}));
+  BOOST_CHECK_EQUAL(contribute(1, 0, 2.0, {1, 2}), IterationPipeline::READY);
+  BOOST_CHECK(pipeline.RemoveChild(0).empty());
+  BOOST_CHECK(!pipeline.Close(1));
+
+  // No child is left to wait for, the second segment is ready with nothing summed
+  BOOST_CHECK_EQUAL(contribute(2, 3, 0.0, {}, 0), IterationPipeline::READY);
+  BOOST_CHECK(pipeline.IsFailed(2));
+
+  Time start = Seconds(1);
+  bool failed = false;
+  BOOST_CHECK(pipeline.Close(2, &start, &failed));
+  BOOST_CHECK_EQUAL(start, Time());
+  BOOST_CHECK(failed);
+  BOOST_CHECK_EQUAL(pipeline.GetStats().GetIterationCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Deadline)
+{
+  configure(ModelSegmentation(4, 2), STRAGGLER_DEADLINE, 0.5, MilliSeconds(10));
+  BOOST_REQUIRE(pipeline.IsStragglerTolerant());
+  BOOST_REQUIRE(pipeline.Open(1, {0, 3}));
+
+  // The quorum doesn't apply in deadline mode
+  BOOST_CHECK_EQUAL(contribute(1, 0, 2.0, {1, 2}), IterationPipeline::ACCEPTED);
+
+  // The first segment is emitted with what it has, the second has nothing and waits for the next deadline
+  advanceTo(15);
+  BOOST_CHECK(expired == (std::vector<std::pair<int64_t, uint32_t>>{{10, 1}}));
+  BOOST_CHECK_EQUAL(pipeline.Sum(1)[0], 2.0);
+  BOOST_CHECK_EQUAL(contribute(1, 3, 1.0, {3}), IterationPipeline::UNKNOWN);
+  BOOST_CHECK(!pipeline.Close(1));
+
+  BOOST_CHECK_EQUAL(contribute(2, 3, 1.0, {3}), IterationPipeline::ACCEPTED);
+  advanceTo(100);
+  BOOST_CHECK(expired == (std::vector<std::pair<int64_t, uint32_t>>{{10, 1}, {20, 2}}));
+  BOOST_CHECK_EQUAL(pipeline.Sum(2)[0], 1.0);
+  BOOST_CHECK(!pipeline.IsFailed(2));
+
+  Time start = Seconds(1);
+  BOOST_CHECK(pipeline.Close(2, &start));
+  BOOST_CHECK_EQUAL(start, Time());
+  BOOST_CHECK_EQUAL(pipeline.GetStats().GetIterationCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(DeadlineCancelled)
+{
+  configure(ModelSegmentation(4, 0), STRAGGLER_QUORUM, 1.0, MilliSeconds(10));
+  BOOST_REQUIRE(pipeline.Open(1, {0, 3}));
+  BOOST_CHECK_EQUAL(contribute(1, 0, 2.0, {1, 2}), IterationPipeline::ACCEPTED);
+  BOOST_CHECK_EQUAL(contribute(1, 3, 1.0, {3}), IterationPipeline::READY);
+  BOOST_CHECK(pipeline.Close(1));
+
+  advanceTo(100);
+  BOOST_CHECK(expired.empty());
+}
+
+BOOST_AUTO_TEST_CASE(FoldLateUpdates)
+{
+  configure(ModelSegmentation(4, 0), STRAGGLER_QUORUM, 0.5, Time(), LATE_UPDATES_FOLD);
+  BOOST_REQUIRE(pipeline.Open(1, {0, 3}));
+  BOOST_CHECK_EQUAL(contribute(1, 0, 2.0, {1, 2}), IterationPipeline::READY);
+  BOOST_CHECK(pipeline.Close(1));
+
+  // Held until the next iteration is opened, then it starts its sum
+  BOOST_CHECK_EQUAL(contribute(1, 3, 1.0, {3}), IterationPipeline::FOLDED);
+  BOOST_REQUIRE(pipeline.Open(2, {0, 3}));
+  BOOST_CHECK_EQUAL(contribute(2, 0, 4.0, {1, 2}), IterationPipeline::READY);
+  BOOST_CHECK_EQUAL(pipeline.Sum(2)[0], 5.0);
+  BOOST_CHECK_EQUAL(pipeline.Contributors(2).population(), 3);
+
+  // Folded straight into an open iteration, unless it's ready already
+  BOOST_REQUIRE(pipeline.Open(3, {0, 3}));
+  BOOST_CHECK_EQUAL(contribute(2, 3, 1.0, {3}), IterationPipeline::FOLDED);
+  BOOST_CHECK(pipeline.Close(2));
+  BOOST_CHECK_EQUAL(contribute(3, 3, 2.0, {3}), IterationPipeline::READY);
+  BOOST_CHECK_EQUAL(pipeline.Sum(3)[0], 3.0);
+  BOOST_CHECK_EQUAL(contribute(2, 0, 1.0, {1, 2}), IterationPipeline::UNKNOWN);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "apps/retx-timeout-queue.hpp"
+
+#include "../tests-common.hpp"
+
+#include <map>
+#include <tuple>
+
+namespace ns3 {
+namespace ndn {
+
+class RetxTimeoutQueueFixture : public CleanupFixture
+{
+public:
+  using Expiration = std::tuple<int64_t, uint32_t, uint32_t>; // (ms, flow id, seq)
+
+  RetxTimeoutQueueFixture()
+  {
+    queue.SetCallbacks([this] (uint32_t flowId) { return timeouts[flowId]; },
+                       [this] (uint32_t flowId, uint32_t seq) {
+                         expired.emplace_back(Simulator::Now().GetMilliSeconds(), flowId, seq);
+                         if (onExpire) {
+                           onExpire(flowId, seq);
+                         }
+                       });
+  }
+
+  /**
+   * Run the simulation until the given time
+   */
+  static void
+  advanceTo(int64_t ms)
+  {
+    Simulator::Stop(MilliSeconds(ms) - Simulator::Now());
+    Simulator::Run();
+  }
+
+public:
+  RetxTimeoutQueue queue;
+  std::map<uint32_t, Time> timeouts;
+  std::vector<Expiration> expired;
+  std::function<void(uint32_t flowId, uint32_t seq)> onExpire;
+};
+
+BOOST_FIXTURE_TEST_SUITE(AppsRetxTimeoutQueue, RetxTimeoutQueueFixture)
+
+BOOST_AUTO_TEST_CASE(ExpireInDeadlineOrder)
+{
+  timeouts[0] = MilliSeconds(100);
+  timeouts[1] = MilliSeconds(50);
+
+  queue.Add(0, 1);
+  advanceTo(10);
+  queue.Add(0, 2);
+  queue.Add(0, 3);
+  advanceTo(20);
+  queue.Add(1, 7);
+  BOOST_CHECK_EQUAL(queue.size(), 4);
+
+  // Answered interests never expire, the send time is reported
+  advanceTo(30);
+  Time sent;
+  BOOST_CHECK(queue.Remove(0, 1, &sent));
+  BOOST_CHECK_EQUAL(sent, MilliSeconds(0));
+  BOOST_CHECK(queue.Remove(0, 3));
+  BOOST_CHECK(!queue.Remove(0, 3));
+  BOOST_CHECK(!queue.Remove(5, 1));
+  BOOST_CHECK_EQUAL(queue.size(), 2);
+
+  advanceTo(1000);
+  BOOST_CHECK(expired == (std::vector<Expiration>{{70, 1, 7}, {110, 0, 2}}));
+  BOOST_CHECK_EQUAL(queue.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Retransmission)
+{
+  timeouts[0] = MilliSeconds(100);
+
+  // A retransmitted seq expires once, a timeout after it was sent again
+  queue.Add(0, 5);
+  queue.Add(0, 6);
+  advanceTo(50);
+  queue.Add(0, 5);
+  BOOST_CHECK_EQUAL(queue.size(), 2);
+
+  advanceTo(1000);
+  BOOST_CHECK(expired == (std::vector<Expiration>{{100, 0, 6}, {150, 0, 5}}));
+}
+
+BOOST_AUTO_TEST_CASE(UpdateTimeout)
+{
+  timeouts[0] = MilliSeconds(100);
+  queue.Add(0, 1);
+  advanceTo(10);
+  queue.Add(0, 2);
+
+  // The deadlines follow the current RTO of the flow
+  timeouts[0] = MilliSeconds(20);
+  queue.UpdateTimeout(0);
+  advanceTo(25);
+  BOOST_CHECK(expired == (std::vector<Expiration>{{20, 0, 1}}));
+
+  timeouts[0] = MilliSeconds(200);
+  queue.UpdateTimeout(0);
+  advanceTo(1000);
+  BOOST_CHECK(expired == (std::vector<Expiration>{{20, 0, 1}, {210, 0, 2}}));
+}
+
+BOOST_AUTO_TEST_CASE(HandlerRetransmitsAndClears)
+{
+  timeouts[0] = MilliSeconds(100);
+  timeouts[1] = MilliSeconds(100);
+
+  // The handler retransmits twice, then the app stops
+  onExpire = [this] (uint32_t flowId, uint32_t seq) {
+    if (expired.size() < 3) {
+      queue.Add(flowId, seq);
+    }
+    else {
+      queue.Clear();
+    }
+  };
+  queue.Add(0, 1);
+  advanceTo(50);
+  queue.Add(1, 1);
+
+  advanceTo(1000);
+  BOOST_CHECK(expired == (std::vector<Expiration>{{100, 0, 1}, {150, 1, 1}, {200, 0, 1}}));
+  BOOST_CHECK_EQUAL(queue.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -186,6 +186,55 @@ BOOST_AUTO_TEST_CASE(CalculateRoutesBasedOnLinkDelay)
   }
 }
 
+BOOST_AUTO_TEST_CASE(RemoveLink)
+{
+  ofstream file1(TEST_TOPO_TXT.string().c_str());
+  file1 << "router\n\n"
+        << "#node city  y x mpi-partition\n"
+        << "A4  NA  1 1 1\n"
+        << "B4  NA  80  -40 1\n"
+        << "C4  NA  80  40  1\n\n"
+        << "link\n\n"
+        << "# from  to  capacity  metric  delay queue\n"
+        << "A4      B4  10Mbps    100 1ms 100\n"
+        << "A4      C4  10Mbps    50  1ms 100\n"
+        << "B4      C4  10Mbps    1 1ms 100\n";
+  file1.close();
+
+  AnnotatedTopologyReader topologyReader("");
+  topologyReader.SetFileName(TEST_TOPO_TXT.string().c_str());
+  topologyReader.Read();
+
+  // Install NDN stack on all nodes
+  ndn::StackHelper ndnHelper;
+  ndnHelper.InstallAll();
+
+  topologyReader.ApplyOspfMetric();
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll();
+
+  ndnGlobalRoutingHelper.AddOrigins("/prefix", Names::Find<Node>("C4"));
+  ndn::GlobalRoutingHelper::CalculateRoutes();
+
+  // A4 reaches C4 directly until the link fails, then only through B4
+  BOOST_CHECK_NO_THROW(ndn::GlobalRoutingHelper::RemoveLinkByName("A4", "C4"));
+
+  auto ndn = Names::Find<Node>("A4")->GetObject<ndn::L3Protocol>();
+  size_t nNextHops = 0;
+  for (const auto& entry : ndn->getForwarder()->getFib()) {
+    for (auto& nextHop : entry.getNextHops()) {
+      auto& face = nextHop.getFace();
+      auto transport = dynamic_cast<NetDeviceTransport*>(face.getTransport());
+      if (transport == nullptr)
+        continue;
+      BOOST_CHECK_EQUAL(Names::FindName(transport->GetNetDevice()->GetChannel()->GetDevice(1)->GetNode()), "B4");
+      ++nNextHops;
+    }
+  }
+  BOOST_CHECK_EQUAL(nNextHops, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
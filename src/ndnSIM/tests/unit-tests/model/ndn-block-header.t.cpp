@@ -161,6 +161,36 @@ BOOST_AUTO_TEST_CASE(PrintLpPacket)
   }
 }
 
+BOOST_AUTO_TEST_CASE(Deserialize)
+{
+  // 1, 3 and 5-octet TLV-LENGTH
+  for (size_t contentSize : {10, 1024, 70000}) {
+    Data data("/other/prefix");
+    data.setContent(std::make_shared< ::ndn::Buffer>(contentSize));
+    ndn::StackHelper::getKeyChain().sign(data);
+    lp::Packet lpPacket(data.wireEncode());
+    BlockHeader header(lpPacket.wireEncode());
+
+    Ptr<Packet> packet = Create<Packet>();
+    packet->AddHeader(header);
+
+    BlockHeader peeked;
+    BOOST_CHECK_EQUAL(packet->PeekHeader(peeked), header.GetSerializedSize());
+    BOOST_CHECK_EQUAL(peeked.getBlock(), header.getBlock());
+
+    BlockHeader removed;
+    BOOST_CHECK_EQUAL(packet->RemoveHeader(removed), header.GetSerializedSize());
+    BOOST_CHECK_EQUAL(removed.getBlock(), header.getBlock());
+    BOOST_CHECK_EQUAL(packet->GetSize(), 0);
+  }
+
+  // TLV-LENGTH larger than the packet
+  const uint8_t truncated[] = {0x06, 0x05, 0x01, 0x02, 0x03, 0x04};
+  Ptr<Packet> packet = Create<Packet>(truncated, sizeof(truncated));
+  BlockHeader header;
+  BOOST_CHECK_THROW(packet->PeekHeader(header), ::ndn::tlv::Error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
@@ -0,0 +1,228 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/model-data-codec.hpp"
+#include "utils/reduction-kernels.hpp"
+
+#include "../tests-common.hpp"
+
+#include <cmath>
+
+namespace ns3 {
+namespace ndn {
+
+class ModelDataCodecFixture : public CleanupFixture
+{
+public:
+  ModelDataCodecFixture()
+  {
+    // Three INT8 blocks, the last one partial, and a zero entry for TOPK to skip
+    for (size_t i = 0; i < 150; ++i) {
+      parameters.push_back(std::ldexp(static_cast<double>(i % 17) - 8.0, -static_cast<int>(i % 5)));
+    }
+    parameters[40] = 0.0;
+  }
+
+  /**
+   * Encode the parameters and parse the result, the block must outlive the view
+   */
+  ModelDataView
+  roundTrip(PayloadEncoding encoding, size_t topK = 0,
+            const ModelContributors& contributors = ModelContributors(),
+            const std::vector<std::string>& congestedNodes = {})
+  {
+    block = encodeModelDataContent(parameters.data(), parameters.size(), 0.25, congestedNodes,
+                                   encoding, topK, contributors);
+    ModelDataView view;
+    BOOST_REQUIRE(view.parse(block));
+    BOOST_CHECK_EQUAL(view.encoding(), encoding);
+    BOOST_CHECK_EQUAL(view.size(), parameters.size());
+    BOOST_CHECK_EQUAL(view.qsf(), 0.25);
+    return view;
+  }
+
+  /**
+   * Decoded parameters through operator[], copyTo() and accumulateInto() agree
+   */
+  static std::vector<double>
+  decode(const ModelDataView& view)
+  {
+    std::vector<double> indexed(view.size());
+    for (size_t i = 0; i < view.size(); ++i) {
+      indexed[i] = view[i];
+    }
+    std::vector<double> copied(view.size());
+    view.copyTo(copied.data(), copied.size());
+    BOOST_CHECK(copied == indexed);
+
+    std::vector<double> summed(view.size(), 1.0);
+    view.accumulateInto(summed.data(), summed.size());
+    for (size_t i = 0; i < view.size(); ++i) {
+      BOOST_CHECK_EQUAL(summed[i], 1.0 + indexed[i]);
+    }
+    return indexed;
+  }
+
+public:
+  std::vector<double> parameters;
+  ::ndn::Block block;
+};
+
+BOOST_FIXTURE_TEST_SUITE(UtilsModelDataCodec, ModelDataCodecFixture)
+
+BOOST_AUTO_TEST_CASE(Fp64)
+{
+  parameters[1] = 0.1;
+  ModelDataView view = roundTrip(PAYLOAD_FP64);
+  BOOST_CHECK(decode(view) == parameters);
+
+  // Parameters are 8-byte aligned in the block, so they can be summed in place
+  BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(block.value() + MODEL_DATA_HEADER_SIZE) % alignof(double), 0);
+
+  // Parameters generated in place encode the same
+  ::ndn::Block filled = encodeModelDataContent(parameters.size(), [this] (double* out, size_t count) {
+    std::copy(parameters.begin(), parameters.begin() + count, out);
+  }, 0.25, {});
+  BOOST_CHECK(filled == block);
+}
+
+BOOST_AUTO_TEST_CASE(Fp32)
+{
+  parameters[1] = 0.1;
+  std::vector<double> decoded = decode(roundTrip(PAYLOAD_FP32));
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    BOOST_CHECK_EQUAL(decoded[i], static_cast<double>(static_cast<float>(parameters[i])));
+  }
+  BOOST_CHECK_NE(decoded[1], 0.1);
+}
+
+BOOST_AUTO_TEST_CASE(Fp16)
+{
+  parameters[1] = 65504.0; // largest half
+  parameters[2] = std::ldexp(1.0, -24); // smallest subnormal half
+  parameters[3] = 1.0 / 3.0;
+  std::vector<double> decoded = decode(roundTrip(PAYLOAD_FP16));
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    if (i == 3) {
+      continue;
+    }
+    BOOST_CHECK_EQUAL(decoded[i], parameters[i]);
+  }
+  BOOST_CHECK_CLOSE(decoded[3], 1.0 / 3.0, 0.05);
+}
+
+BOOST_AUTO_TEST_CASE(Bf16)
+{
+  parameters[1] = 3.0e38; // fp32 range
+  std::vector<double> decoded = decode(roundTrip(PAYLOAD_BF16));
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    BOOST_CHECK_EQUAL(decoded[i], static_cast<double>(utils::Bfloat16ToFloat(utils::FloatToBfloat16(static_cast<float>(parameters[i])))));
+  }
+  BOOST_CHECK_CLOSE(decoded[1], 3.0e38, 0.5);
+}
+
+BOOST_AUTO_TEST_CASE(Int8)
+{
+  std::vector<double> decoded = decode(roundTrip(PAYLOAD_INT8));
+  for (size_t begin = 0; begin < parameters.size(); begin += MODEL_DATA_INT8_BLOCK_SIZE) {
+    size_t end = std::min(begin + MODEL_DATA_INT8_BLOCK_SIZE, parameters.size());
+    double maxAbs = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+      maxAbs = std::max(maxAbs, std::fabs(parameters[i]));
+    }
+    // Within half a quantization step of the block, whose largest entry is exact up to fp32
+    for (size_t i = begin; i < end; ++i) {
+      BOOST_CHECK_LE(std::fabs(decoded[i] - parameters[i]), maxAbs / 127.0 / 2.0 * (1.0 + 1e-6));
+    }
+  }
+  BOOST_CHECK_EQUAL(decoded[40], 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(TopK)
+{
+  // Every non-zero entry is kept, lossless up to fp32
+  std::vector<double> decoded = decode(roundTrip(PAYLOAD_TOPK));
+  BOOST_CHECK(decoded == parameters);
+
+  // Only the largest magnitudes, ties broken by the lower index
+  parameters.assign(10, 0.0);
+  parameters[2] = -5.0;
+  parameters[4] = 3.0;
+  parameters[6] = 1.0;
+  parameters[8] = 3.0;
+  decoded = decode(roundTrip(PAYLOAD_TOPK, 2));
+  BOOST_CHECK(decoded == (std::vector<double>{0, 0, -5.0, 0, 3.0, 0, 0, 0, 0, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(Contributors)
+{
+  ModelContributors contributors;
+  contributors.add(0);
+  contributors.add(9);
+  contributors.add(100);
+  BOOST_CHECK_EQUAL(contributors.count, 3);
+  BOOST_CHECK_EQUAL(contributors.population(), 3);
+  BOOST_CHECK(contributors.has(9));
+  BOOST_CHECK(!contributors.has(8));
+  BOOST_CHECK(!contributors.has(1000));
+
+  ModelContributors other;
+  other.add(9);
+  other.add(10);
+  contributors.merge(other);
+  BOOST_CHECK_EQUAL(contributors.count, 5); // the update of producer 9 is summed twice
+  BOOST_CHECK_EQUAL(contributors.population(), 4);
+
+  for (auto encoding : {PAYLOAD_FP64, PAYLOAD_FP16, PAYLOAD_TOPK}) {
+    ModelDataView view = roundTrip(encoding, 0, contributors, {"agg0", "rtr-12"});
+    BOOST_CHECK_EQUAL(view.contributorCount(), 5);
+    BOOST_CHECK(view.congestedNodes() == (std::vector<std::string>{"agg0", "rtr-12"}));
+
+    ModelContributors merged;
+    merged.add(1);
+    view.mergeContributorsInto(merged);
+    BOOST_CHECK_EQUAL(merged.count, 6);
+    BOOST_CHECK_EQUAL(merged.population(), 5);
+    for (uint32_t id : {0, 1, 9, 10, 100}) {
+      BOOST_CHECK(merged.has(id));
+    }
+  }
+
+  contributors.clear();
+  BOOST_CHECK_EQUAL(contributors.count, 0);
+  BOOST_CHECK_EQUAL(contributors.population(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Malformed)
+{
+  roundTrip(PAYLOAD_INT8);
+  std::vector<uint8_t> value(block.value(), block.value() + block.value_size());
+  ModelDataView view;
+  BOOST_CHECK(view.parse(value.data(), value.size()));
+  BOOST_CHECK(!view.parse(value.data(), MODEL_DATA_HEADER_SIZE + 10));
+  BOOST_CHECK(!view.parse(value.data(), 3));
+
+  value[0] = MODEL_DATA_VERSION + 1;
+  BOOST_CHECK(!view.parse(value.data(), value.size()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/reduction-kernels.hpp"
+
+#include "../tests-common.hpp"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace ns3 {
+namespace utils {
+
+using ndn::CleanupFixture;
+
+class ReductionKernelsFixture : public CleanupFixture
+{
+public:
+  ReductionKernelsFixture()
+  {
+    // Odd size so that every vector kernel has a tail, values of very different magnitudes
+    for (size_t i = 0; i < N + 1; ++i) {
+      double value = std::ldexp(std::sin(static_cast<double>(i) * 1.7), static_cast<int>(i % 23) - 11);
+      doubles.push_back(value);
+      floats.push_back(static_cast<float>(value));
+      halves.push_back(FloatToHalf(static_cast<float>(value)));
+      bfloats.push_back(FloatToBfloat16(static_cast<float>(value)));
+      int8s.push_back(static_cast<int8_t>(static_cast<int>(i * 37 % 255) - 127));
+      accumulator.push_back(std::cos(static_cast<double>(i)));
+    }
+  }
+
+  /**
+   * Every kernel of the table on operands starting one element in, so that none is aligned
+   */
+  std::vector<std::vector<double>>
+  run(const ReductionKernels& kernels) const
+  {
+    std::vector<std::vector<double>> results(7, std::vector<double>(accumulator.begin() + 1, accumulator.end()));
+    kernels.sum(results[0].data(), doubles.data() + 1, N);
+    kernels.weightedSum(results[1].data(), doubles.data() + 1, N, 0.3);
+    kernels.divide(results[2].data(), results[2].data(), N, 3.0);
+    kernels.sumFloat(results[3].data(), floats.data() + 1, N);
+    kernels.sumHalf(results[4].data(), halves.data() + 1, N);
+    kernels.sumBfloat16(results[5].data(), bfloats.data() + 1, N);
+    kernels.sumInt8(results[6].data(), int8s.data() + 1, N, 0.01);
+    return results;
+  }
+
+public:
+  static constexpr size_t N = 1037;
+  std::vector<double> doubles;
+  std::vector<float> floats;
+  std::vector<uint16_t> halves;
+  std::vector<uint16_t> bfloats;
+  std::vector<int8_t> int8s;
+  std::vector<double> accumulator;
+};
+
+BOOST_FIXTURE_TEST_SUITE(UtilsReductionKernels, ReductionKernelsFixture)
+
+BOOST_AUTO_TEST_CASE(ScalarKernels)
+{
+  const ReductionKernels* scalar = GetReductionKernels(ReductionIsa::SCALAR);
+  BOOST_REQUIRE(scalar != nullptr);
+  auto results = run(*scalar);
+  for (size_t i = 0; i < N; ++i) {
+    double acc = accumulator[i + 1];
+    BOOST_CHECK_EQUAL(results[0][i], acc + doubles[i + 1]);
+    BOOST_CHECK_EQUAL(results[1][i], acc + 0.3 * doubles[i + 1]);
+    BOOST_CHECK_EQUAL(results[2][i], acc / 3.0);
+    BOOST_CHECK_EQUAL(results[3][i], acc + static_cast<double>(floats[i + 1]));
+    BOOST_CHECK_EQUAL(results[4][i], acc + static_cast<double>(HalfToFloat(halves[i + 1])));
+    BOOST_CHECK_EQUAL(results[5][i], acc + static_cast<double>(Bfloat16ToFloat(bfloats[i + 1])));
+    BOOST_CHECK_EQUAL(results[6][i], acc + 0.01 * static_cast<double>(int8s[i + 1]));
+  }
+}
+
+// Every instruction set the CPU supports gives bit-identical results
+BOOST_AUTO_TEST_CASE(VectorKernels)
+{
+  auto expected = run(*GetReductionKernels(ReductionIsa::SCALAR));
+  for (auto isa : {ReductionIsa::SSE2, ReductionIsa::AVX2, ReductionIsa::AVX512}) {
+    const ReductionKernels* kernels = GetReductionKernels(isa);
+    if (kernels == nullptr) {
+      BOOST_TEST_MESSAGE("instruction set " << static_cast<int>(isa) << " unavailable");
+      continue;
+    }
+    BOOST_TEST_MESSAGE("kernels " << kernels->name);
+    auto results = run(*kernels);
+    for (size_t k = 0; k < results.size(); ++k) {
+      BOOST_CHECK_MESSAGE(results[k] == expected[k], kernels->name << " kernel " << k);
+    }
+  }
+  BOOST_CHECK(run(GetReductionKernels()) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(HalfConversions)
+{
+  BOOST_CHECK_EQUAL(FloatToHalf(1.0f), 0x3c00);
+  BOOST_CHECK_EQUAL(FloatToHalf(-2.0f), 0xc000);
+  BOOST_CHECK_EQUAL(FloatToHalf(65504.0f), 0x7bff);
+  BOOST_CHECK_EQUAL(FloatToHalf(65520.0f), 0x7c00); // rounds up to Inf
+  BOOST_CHECK_EQUAL(FloatToHalf(std::ldexp(1.0f, -24)), 0x0001);
+  BOOST_CHECK_EQUAL(FloatToHalf(std::ldexp(1.0f, -26)), 0x0000);
+  // ties to even
+  BOOST_CHECK_EQUAL(FloatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3c00);
+  BOOST_CHECK_EQUAL(FloatToHalf(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3c02);
+  BOOST_CHECK(std::isnan(HalfToFloat(FloatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+  BOOST_CHECK(std::isinf(HalfToFloat(0xfc00)));
+
+  // every half survives a round trip through float
+  for (uint32_t h = 0; h < 0x10000; ++h) {
+    if ((h & 0x7c00) == 0x7c00 && (h & 0x3ff) != 0) {
+      continue; // NaN payloads are not kept
+    }
+    BOOST_REQUIRE_EQUAL(FloatToHalf(HalfToFloat(static_cast<uint16_t>(h))), h);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Bfloat16Conversions)
+{
+  BOOST_CHECK_EQUAL(FloatToBfloat16(1.0f), 0x3f80);
+  BOOST_CHECK_EQUAL(Bfloat16ToFloat(0xc040), -3.0f);
+  // ties to even
+  BOOST_CHECK_EQUAL(FloatToBfloat16(1.0f + std::ldexp(1.0f, -8)), 0x3f80);
+  BOOST_CHECK_EQUAL(FloatToBfloat16(1.0f + 3 * std::ldexp(1.0f, -8)), 0x3f82);
+  BOOST_CHECK(std::isnan(Bfloat16ToFloat(FloatToBfloat16(std::numeric_limits<float>::quiet_NaN()))));
+  BOOST_CHECK(std::isinf(Bfloat16ToFloat(FloatToBfloat16(std::numeric_limits<float>::infinity()))));
+}
+
+BOOST_AUTO_TEST_CASE(Means)
+{
+  std::vector<double> sum{3.0, 6.0, 1.0};
+  std::vector<double> mean(sum.size());
+  Mean(mean.data(), sum.data(), sum.size(), 3.0);
+  BOOST_CHECK(mean == (std::vector<double>{1.0, 2.0, 1.0 / 3.0}));
+  WeightedMean(sum.data(), sum.data(), sum.size(), 1.5);
+  BOOST_CHECK(sum == (std::vector<double>{2.0, 4.0, 1.0 / 1.5}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace utils
+} // namespace ns3
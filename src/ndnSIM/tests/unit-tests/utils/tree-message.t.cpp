@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/tree-message.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+class TreeMessageFixture : public CleanupFixture
+{
+public:
+  TreeMessageAssembler::Result
+  add(uint64_t seq, const std::vector<uint8_t>& chunk)
+  {
+    return assembler.add(seq, chunk.data(), chunk.size());
+  }
+
+public:
+  TreeMessageAssembler assembler;
+};
+
+BOOST_FIXTURE_TEST_SUITE(UtilsTreeMessage, TreeMessageFixture)
+
+BOOST_AUTO_TEST_CASE(Leb128)
+{
+  TreeAssignment assignment{{3, {127, 128, 300}}, {70000, {0}}};
+  std::vector<std::vector<uint8_t>> chunks = encodeTreeMessage(assignment, 1000);
+  BOOST_REQUIRE_EQUAL(chunks.size(), 1);
+
+  std::vector<uint8_t> expected{
+    TREE_MESSAGE_VERSION, 0x00, 0x01,             // version, chunk 0 of 1
+    0x03, 0x03, 0x7f, 0x80, 0x01, 0xac, 0x02,     // child 3, leaves 127 128 300
+    0xf0, 0xa2, 0x04, 0x01, 0x00,                 // child 70000, leaf 0
+  };
+  BOOST_CHECK_EQUAL_COLLECTIONS(chunks[0].begin(), chunks[0].end(), expected.begin(), expected.end());
+
+  BOOST_CHECK_EQUAL(add(1, chunks[0]), TreeMessageAssembler::COMPLETE);
+  BOOST_CHECK(assembler.assignment() == assignment);
+}
+
+BOOST_AUTO_TEST_CASE(Chunking)
+{
+  TreeAssignment assignment;
+  for (uint32_t child = 0; child < 20; ++child) {
+    for (uint32_t leaf = 0; leaf < 30; ++leaf) {
+      assignment[child * 1000].push_back(child * 1000 + leaf);
+    }
+  }
+
+  // Children are spread over several chunks, none of which exceeds the size
+  std::vector<std::vector<uint8_t>> chunks = encodeTreeMessage(assignment, 64);
+  BOOST_REQUIRE_GT(chunks.size(), 10);
+  for (const std::vector<uint8_t>& chunk : chunks) {
+    BOOST_CHECK_LE(chunk.size(), 64);
+  }
+
+  // Out of order and repeated chunks
+  for (size_t i = chunks.size() - 1; i > 0; --i) {
+    BOOST_CHECK_EQUAL(add(4, chunks[i]), TreeMessageAssembler::PENDING);
+    BOOST_CHECK_EQUAL(add(4, chunks[i]), TreeMessageAssembler::DUPLICATE);
+  }
+  BOOST_CHECK_EQUAL(add(4, chunks[0]), TreeMessageAssembler::COMPLETE);
+  BOOST_CHECK(assembler.assignment() == assignment);
+}
+
+BOOST_AUTO_TEST_CASE(TinyChunks)
+{
+  // A chunk holds at least one leaf even if it doesn't fit
+  TreeAssignment assignment{{1, {2, 3}}, {4, {5}}};
+  std::vector<std::vector<uint8_t>> chunks = encodeTreeMessage(assignment, 1);
+  BOOST_REQUIRE_EQUAL(chunks.size(), 3);
+
+  BOOST_CHECK_EQUAL(add(1, chunks[2]), TreeMessageAssembler::PENDING);
+  BOOST_CHECK_EQUAL(add(1, chunks[0]), TreeMessageAssembler::PENDING);
+  BOOST_CHECK_EQUAL(add(1, chunks[1]), TreeMessageAssembler::COMPLETE);
+  BOOST_CHECK(assembler.assignment() == assignment);
+}
+
+BOOST_AUTO_TEST_CASE(Seq)
+{
+  TreeAssignment first{{1, {10, 11, 12, 13}}, {2, {20, 21, 22, 23}}};
+  TreeAssignment second{{1, {10}}, {3, {30}}};
+  std::vector<std::vector<uint8_t>> firstChunks = encodeTreeMessage(first, 17);
+  std::vector<std::vector<uint8_t>> secondChunks = encodeTreeMessage(second, 1000);
+  BOOST_REQUIRE_EQUAL(firstChunks.size(), 2);
+  BOOST_REQUIRE_EQUAL(secondChunks.size(), 1);
+
+  // A newer seq drops the chunks of the previous one
+  BOOST_CHECK_EQUAL(add(1, firstChunks[0]), TreeMessageAssembler::PENDING);
+  BOOST_CHECK_EQUAL(add(2, secondChunks[0]), TreeMessageAssembler::COMPLETE);
+  BOOST_CHECK(assembler.assignment() == second);
+
+  // Older seq
+  BOOST_CHECK_EQUAL(add(1, firstChunks[1]), TreeMessageAssembler::DUPLICATE);
+  BOOST_CHECK(assembler.assignment() == second);
+
+  BOOST_CHECK_EQUAL(add(3, firstChunks[1]), TreeMessageAssembler::PENDING);
+  BOOST_CHECK_EQUAL(add(3, firstChunks[0]), TreeMessageAssembler::COMPLETE);
+  BOOST_CHECK(assembler.assignment() == first);
+}
+
+BOOST_AUTO_TEST_CASE(Invalid)
+{
+  std::vector<std::vector<uint8_t>> chunks = encodeTreeMessage({{1, {2, 3}}, {4, {5, 6}}}, 15);
+  BOOST_REQUIRE_EQUAL(chunks.size(), 2);
+
+  BOOST_CHECK_EQUAL(add(1, {}), TreeMessageAssembler::INVALID);
+  BOOST_CHECK_EQUAL(add(1, {2, 0x00, 0x01}), TreeMessageAssembler::INVALID); // Unknown version
+  BOOST_CHECK_EQUAL(add(1, {1, 0x01, 0x01}), TreeMessageAssembler::INVALID); // Index out of range
+  BOOST_CHECK_EQUAL(add(1, {1, 0x80}), TreeMessageAssembler::INVALID); // Truncated varint
+  BOOST_CHECK_EQUAL(add(1, {1, 0xff, 0xff, 0xff, 0xff, 0x7f, 0x01}), TreeMessageAssembler::INVALID); // Over 32 bits
+
+  // Truncated chunk leaves no trace
+  std::vector<uint8_t> truncated(chunks[0].begin(), chunks[0].end() - 1);
+  BOOST_CHECK_EQUAL(add(1, truncated), TreeMessageAssembler::INVALID);
+  BOOST_CHECK_EQUAL(add(1, chunks[0]), TreeMessageAssembler::PENDING);
+
+  // Number of chunks differs from the other chunks of the seq
+  BOOST_CHECK_EQUAL(add(1, {1, 0x01, 0x03, 0x07, 0x01, 0x08}), TreeMessageAssembler::INVALID);
+
+  BOOST_CHECK_EQUAL(add(1, chunks[1]), TreeMessageAssembler::COMPLETE);
+  BOOST_CHECK(assembler.assignment() == (TreeAssignment{{1, {2, 3}}, {4, {5, 6}}}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
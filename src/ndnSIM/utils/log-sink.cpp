@@ -0,0 +1,323 @@
+#include "log-sink.hpp"
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.LogSink");
+
+namespace ns3 {
+namespace utils {
+
+static const char LOG_MAGIC[8] = {'C', 'F', 'N', 'L', 'O', 'G', '1', '\n'};
+static const size_t LOG_BLOCK_SIZE = 64 * 1024; // Per file, bounds memory with thousands of flows
+
+
+
+/**
+ * Append a little-endian value to a binary block
+ */
+template<typename T>
+static void
+AppendLittleEndian(std::string& out, T value)
+{
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    std::reverse(bytes, bytes + sizeof(T));
+#endif
+    out.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+
+
+LogFile::LogFile(LogSink& sink, const std::string& path, LogFormat format,
+                 const std::vector<std::string>& columns, size_t blockSize)
+    : m_sink(sink)
+    , m_path(path)
+    , m_format(format)
+    , m_blockSize(blockSize)
+    , m_columnCount(columns.size())
+{
+    if (m_format != LogFormat::BINARY) {
+        m_text.reserve(m_blockSize + 256);
+        return;
+    }
+
+    // Header goes out with the first block, the column count may still come from the first record
+    m_columns.resize(m_columnCount);
+    std::string names;
+    for (const auto& column : columns) {
+        names += (names.empty() ? "" : "\t") + column;
+    }
+    names.resize((names.size() + 7) / 8 * 8, '\0');
+
+    std::string header(LOG_MAGIC, sizeof(LOG_MAGIC));
+    AppendLittleEndian<uint32_t>(header, static_cast<uint32_t>(m_columnCount));
+    AppendLittleEndian<uint32_t>(header, static_cast<uint32_t>(names.size()));
+    header += names;
+    m_text = std::move(header);
+}
+
+
+
+void
+LogFile::AppendDouble(double value)
+{
+    // Same output as std::ostream's default formatting
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%g ", value);
+    m_text.append(buffer, length);
+}
+
+
+
+void
+LogFile::AppendInteger(int64_t value)
+{
+    char buffer[24];
+    int length = std::snprintf(buffer, sizeof(buffer), "%lld ", static_cast<long long>(value));
+    m_text.append(buffer, length);
+}
+
+
+
+void
+LogFile::AppendUnsigned(uint64_t value)
+{
+    char buffer[24];
+    int length = std::snprintf(buffer, sizeof(buffer), "%llu ", static_cast<unsigned long long>(value));
+    m_text.append(buffer, length);
+}
+
+
+
+void
+LogFile::AppendRow(const double* values, size_t count)
+{
+    if (m_columnCount == 0) {
+        // No column names given, the first record decides; patch the header written in the constructor
+        m_columnCount = count;
+        m_columns.resize(count);
+        std::string countBytes;
+        AppendLittleEndian<uint32_t>(countBytes, static_cast<uint32_t>(count));
+        m_text.replace(sizeof(LOG_MAGIC), countBytes.size(), countBytes);
+    }
+
+    if (count != m_columnCount) {
+        std::cerr << "Log " << m_path << " expects " << m_columnCount << " columns, got " << count << std::endl;
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        m_columns[i].push_back(values[i]);
+    }
+}
+
+
+
+size_t
+LogFile::PendingBytes() const
+{
+    if (m_format == LogFormat::TEXT) {
+        return m_text.size();
+    }
+    return m_columns.empty() ? 0 : m_columns[0].size() * m_columnCount * sizeof(double);
+}
+
+
+
+void
+LogFile::Submit()
+{
+    if (m_format == LogFormat::BINARY && !m_columns.empty() && !m_columns[0].empty()) {
+        size_t rows = m_columns[0].size();
+        m_text.reserve(m_text.size() + 8 + rows * m_columnCount * sizeof(double));
+        AppendLittleEndian<uint32_t>(m_text, static_cast<uint32_t>(rows));
+        AppendLittleEndian<uint32_t>(m_text, 0);
+        for (auto& column : m_columns) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            for (double value : column) {
+                AppendLittleEndian<double>(m_text, value);
+            }
+#else
+            m_text.append(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(double));
+#endif
+            column.clear();
+        }
+    }
+
+    if (m_text.empty()) {
+        return;
+    }
+
+    std::string block;
+    block.reserve(m_blockSize + 256);
+    block.swap(m_text);
+    m_sink.Enqueue(m_path, std::move(block));
+}
+
+
+
+LogSink&
+LogSink::Instance()
+{
+    static LogSink instance;
+    return instance;
+}
+
+
+
+LogSink::LogSink()
+    : m_format(LogFormat::TEXT)
+    , m_destroyScheduled(false)
+    , m_writing(false)
+    , m_stop(false)
+    , m_writer(&LogSink::WriterLoop, this)
+{
+}
+
+
+
+LogSink::~LogSink()
+{
+    CloseAll();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeWriter.notify_one();
+    m_writer.join();
+}
+
+
+
+void
+LogSink::SetFormat(LogFormat format)
+{
+    m_format = format;
+}
+
+
+
+bool
+LogSink::SetFormat(const std::string& format)
+{
+    if (format == "text") {
+        SetFormat(LogFormat::TEXT);
+    } else if (format == "binary") {
+        SetFormat(LogFormat::BINARY);
+    } else {
+        std::cerr << "Unknown log format: " << format << ", expected text or binary" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+
+LogFile*
+LogSink::Open(const std::string& path, std::initializer_list<const char*> columns)
+{
+    auto it = m_files.find(path);
+    if (it != m_files.end()) {
+        return it->second.get();
+    }
+
+    // Truncate now, blocks are appended by the writer thread which opens the file for each of them
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        NS_FATAL_ERROR("Failed to create the log file: " << path);
+    }
+    std::fclose(file);
+
+    if (!m_destroyScheduled) {
+        Simulator::ScheduleDestroy(&LogSink::CloseAll, this);
+        m_destroyScheduled = true;
+    }
+
+    std::vector<std::string> names(columns.begin(), columns.end());
+    LogFile* logFile = new LogFile(*this, path, m_format, names, LOG_BLOCK_SIZE);
+    m_files[path].reset(logFile);
+    NS_LOG_DEBUG("Open " << path << (m_format == LogFormat::BINARY ? " (binary)" : ""));
+    return logFile;
+}
+
+
+
+void
+LogSink::Flush()
+{
+    for (auto& [path, file] : m_files) {
+        file->Submit();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_jobs.empty() && !m_writing; });
+}
+
+
+
+void
+LogSink::CloseAll()
+{
+    Flush();
+    m_files.clear();
+    m_destroyScheduled = false;
+}
+
+
+
+void
+LogSink::Enqueue(const std::string& path, std::string block)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(Job{path, std::move(block)});
+    }
+    m_wakeWriter.notify_one();
+}
+
+
+
+void
+LogSink::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wakeWriter.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+        if (m_jobs.empty()) {
+            return; // Stopping with nothing left to write
+        }
+
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_writing = true;
+        lock.unlock();
+
+        // Short-lived handle, thousands of logs must not hold thousands of descriptors
+        std::FILE* file = std::fopen(job.path.c_str(), "ab");
+        if (file == nullptr) {
+            NS_FATAL_ERROR("Failed to open the log file: " << job.path);
+        }
+        // Blocks are already large, skip stdio's own buffering
+        std::setvbuf(file, nullptr, _IONBF, 0);
+        size_t written = std::fwrite(job.block.data(), 1, job.block.size(), file);
+        if (std::fclose(file) != 0 || written != job.block.size()) {
+            NS_FATAL_ERROR("Failed to write " << job.block.size() << " bytes of log to " << job.path);
+        }
+
+        lock.lock();
+        m_writing = false;
+        if (m_jobs.empty()) {
+            m_idle.notify_all();
+        }
+    }
+}
+
+} // namespace utils
+} // namespace ns3
@@ -0,0 +1,223 @@
+#ifndef LOG_SINK_HPP
+#define LOG_SINK_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ns3 {
+namespace utils {
+
+/**
+ * On-disk format of the recorder logs
+ *
+ * TEXT     One line per record, columns separated by a space (the historical format)
+ * BINARY   Columnar blocks of float64, see LogSink. File names are unchanged, so the graph generator
+ *          finds the same files and tells both formats apart by the magic at the start of the file
+ */
+enum class LogFormat {
+    TEXT = 0,
+    BINARY
+};
+
+class LogSink;
+
+/**
+ * One buffered log file, owned by LogSink
+ *
+ * Records are appended to an in-memory buffer on the simulation thread; full buffers are handed to
+ * the sink's writer thread, so the simulation never waits on the file system. No file descriptor is
+ * held between blocks, the writer opens the file for each block it appends
+ */
+class LogFile {
+public:
+    /**
+     * Append one record, every column is an arithmetic value
+     */
+    template<typename... Columns>
+    void
+    Write(Columns... columns)
+    {
+        static_assert(sizeof...(Columns) > 0, "A record needs at least one column");
+        if (m_format == LogFormat::TEXT) {
+            int dummy[] = {(AppendText(columns), 0)...};
+            (void)dummy;
+            m_text.back() = '\n'; // Replace the trailing separator
+        } else {
+            double values[] = {static_cast<double>(columns)...};
+            AppendRow(values, sizeof...(Columns));
+        }
+        if (PendingBytes() >= m_blockSize) {
+            Submit();
+        }
+    }
+
+    const std::string&
+    GetPath() const
+    {
+        return m_path;
+    }
+
+private:
+    friend class LogSink;
+
+    LogFile(LogSink& sink, const std::string& path, LogFormat format,
+            const std::vector<std::string>& columns, size_t blockSize);
+
+    template<typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    AppendText(T value)
+    {
+        AppendDouble(static_cast<double>(value));
+    }
+
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    AppendText(T value)
+    {
+        AppendInteger(static_cast<int64_t>(value));
+    }
+
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+    AppendText(T value)
+    {
+        AppendUnsigned(static_cast<uint64_t>(value));
+    }
+
+    void
+    AppendDouble(double value);
+
+    void
+    AppendInteger(int64_t value);
+
+    void
+    AppendUnsigned(uint64_t value);
+
+    void
+    AppendRow(const double* values, size_t count);
+
+    size_t
+    PendingBytes() const;
+
+    /**
+     * Hand the buffered records to the writer thread
+     */
+    void
+    Submit();
+
+private:
+    LogSink& m_sink;
+    std::string m_path;
+    LogFormat m_format;
+    size_t m_blockSize;
+    size_t m_columnCount; // BINARY, fixed by the column names or the first record
+    std::string m_text; // TEXT, pending lines
+    std::vector<std::vector<double>> m_columns; // BINARY, pending values per column
+};
+
+/**
+ * Process-wide registry of the recorder logs, replaces opening the file once per record by opening it
+ * once per block, so the number of logs isn't bounded by the open file limit
+ *
+ * A binary log starts with a 16 byte header: magic "CFNLOG1\n", uint32 number of columns, uint32
+ * length of the column names that follow (joined by '\t', zero-padded to 8 bytes). Then come
+ * blocks of: uint32 number of rows R, uint32 reserved, and for each column R float64 values; all
+ * little-endian. experiments/graph_generator/utils/utility.py:read_log() loads both formats.
+ *
+ * Every file is flushed on Simulator::Destroy() (or on exit), a new run can reopen it.
+ */
+class LogSink {
+public:
+    static LogSink&
+    Instance();
+
+    /**
+     * Format of the files opened from now on, default TEXT
+     */
+    void
+    SetFormat(LogFormat format);
+
+    /**
+     * @param format "text" or "binary"
+     * @return False if the name is unknown, the format is left unchanged in that case
+     */
+    bool
+    SetFormat(const std::string& format);
+
+    LogFormat
+    GetFormat() const
+    {
+        return m_format;
+    }
+
+    /**
+     * Create (truncate) a log file, or return the already open one with the same path
+     * @param path
+     * @param columns Column names, stored in the binary header
+     *
+     * Aborts the run if the file can't be created, recorders would otherwise lose every record
+     */
+    LogFile*
+    Open(const std::string& path, std::initializer_list<const char*> columns = {});
+
+    /**
+     * Write every buffered record and wait until the writer thread is done with them
+     */
+    void
+    Flush();
+
+    /**
+     * Flush and forget all files
+     */
+    void
+    CloseAll();
+
+    ~LogSink();
+
+private:
+    LogSink();
+
+    friend class LogFile;
+
+    /**
+     * Queue a block for the writer thread
+     */
+    void
+    Enqueue(const std::string& path, std::string block);
+
+    void
+    WriterLoop();
+
+private:
+    struct Job {
+        std::string path;
+        std::string block;
+    };
+
+    LogFormat m_format;
+    std::map<std::string, std::unique_ptr<LogFile>> m_files;
+    bool m_destroyScheduled;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeWriter;
+    std::condition_variable m_idle;
+    std::deque<Job> m_jobs;
+    bool m_writing;
+    bool m_stop;
+    std::thread m_writer;
+};
+
+} // namespace utils
+} // namespace ns3
+
+#endif // LOG_SINK_HPP
@@ -0,0 +1,661 @@
+#include "model-data-codec.hpp"
+#include "reduction-kernels.hpp"
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/encoding/tlv.hpp>
+#include <boost/endian/conversion.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/callback.h"
+
+void
+ModelContributors::add(uint32_t nodeId)
+{
+    if (bitmap.size() <= nodeId / 8) {
+        bitmap.resize(nodeId / 8 + 1, 0);
+    }
+    bitmap[nodeId / 8] |= static_cast<uint8_t>(1 << (nodeId % 8));
+    ++count;
+}
+
+
+
+void
+ModelContributors::merge(const ModelContributors& other)
+{
+    if (bitmap.size() < other.bitmap.size()) {
+        bitmap.resize(other.bitmap.size(), 0);
+    }
+    for (size_t i = 0; i < other.bitmap.size(); ++i) {
+        bitmap[i] |= other.bitmap[i];
+    }
+    count += other.count;
+}
+
+
+
+bool
+ModelContributors::has(uint32_t nodeId) const
+{
+    return nodeId / 8 < bitmap.size() && (bitmap[nodeId / 8] & (1 << (nodeId % 8)));
+}
+
+
+
+size_t
+ModelContributors::population() const
+{
+    size_t n = 0;
+    for (uint8_t byte : bitmap) {
+        n += __builtin_popcount(byte);
+    }
+    return n;
+}
+
+
+
+void
+ModelContributors::clear()
+{
+    count = 0;
+    std::fill(bitmap.begin(), bitmap.end(), 0); // Keeps the capacity, accumulators are reused
+}
+
+
+
+ModelDataView::ModelDataView()
+: m_params(nullptr)
+, m_scales(nullptr)
+, m_bitmap(nullptr)
+, m_trailer(nullptr)
+, m_end(nullptr)
+, m_count(0)
+, m_blockSize(0)
+, m_entries(0)
+, m_bitmapSize(0)
+, m_contributorCount(0)
+, m_qsf(-1.0)
+, m_encoding(PAYLOAD_FP64)
+{
+}
+
+
+
+static inline uint16_t
+loadUint16(const uint8_t* p)
+{
+    uint16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return boost::endian::little_to_native(v);
+}
+
+
+
+static inline uint32_t
+loadUint32(const uint8_t* p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return boost::endian::little_to_native(v);
+}
+
+
+
+static inline float
+loadFloat(const uint8_t* p)
+{
+    uint32_t bits = loadUint32(p);
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+
+
+static inline double
+loadDouble(const uint8_t* p)
+{
+    uint64_t bits;
+    std::memcpy(&bits, p, sizeof(bits));
+    bits = boost::endian::little_to_native(bits);
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+
+
+static inline uint8_t*
+storeUint16(uint8_t* p, uint16_t v)
+{
+    v = boost::endian::native_to_little(v);
+    std::memcpy(p, &v, sizeof(v));
+    return p + sizeof(v);
+}
+
+
+
+static inline uint8_t*
+storeUint32(uint8_t* p, uint32_t v)
+{
+    v = boost::endian::native_to_little(v);
+    std::memcpy(p, &v, sizeof(v));
+    return p + sizeof(v);
+}
+
+
+
+static inline uint8_t*
+storeFloat(uint8_t* p, float v)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return storeUint32(p, bits);
+}
+
+
+
+static inline uint8_t*
+storeDouble(uint8_t* p, double v)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    bits = boost::endian::native_to_little(bits);
+    std::memcpy(p, &bits, sizeof(bits));
+    return p + sizeof(bits);
+}
+
+
+
+static inline bool
+isLittleEndianHost()
+{
+    return boost::endian::order::native == boost::endian::order::little;
+}
+
+
+
+/**
+ * Parse the header of an encoded ModelData, only the layout is validated, parameters are not touched
+ * @param buffer Start of Content's value
+ * @param size Size of Content's value
+ * @return False if the buffer is truncated or has an unknown version / encoding
+ */
+bool
+ModelDataView::parse(const uint8_t* buffer, size_t size)
+{
+    *this = ModelDataView();
+
+    if (buffer == nullptr || size < MODEL_DATA_HEADER_SIZE) {
+        std::cerr << "Buffer size can't hold ModelData header!" << std::endl;
+        return false;
+    }
+    if (buffer[0] != MODEL_DATA_VERSION) {
+        std::cerr << "Unknown ModelData version: " << static_cast<int>(buffer[0]) << std::endl;
+        return false;
+    }
+
+    size_t count = loadUint32(buffer + 4);
+    const uint8_t* payload = buffer + MODEL_DATA_HEADER_SIZE;
+    size_t available = size - MODEL_DATA_HEADER_SIZE;
+    const uint8_t* trailer = nullptr;
+
+    switch (buffer[1]) {
+    case PAYLOAD_FP64:
+    case PAYLOAD_FP32:
+    case PAYLOAD_FP16:
+    case PAYLOAD_BF16: {
+        size_t width = buffer[1] == PAYLOAD_FP64 ? sizeof(double) : buffer[1] == PAYLOAD_FP32 ? sizeof(float) : sizeof(uint16_t);
+        if (count > available / width) {
+            std::cerr << "Buffer size is smaller than expected!" << std::endl;
+            return false;
+        }
+        m_params = payload;
+        trailer = payload + count * width;
+        break;
+    }
+    case PAYLOAD_INT8: {
+        if (available < sizeof(uint32_t)) {
+            std::cerr << "Buffer size can't hold int8 block size!" << std::endl;
+            return false;
+        }
+        size_t blockSize = loadUint32(payload);
+        if (blockSize == 0) {
+            std::cerr << "Invalid int8 block size!" << std::endl;
+            return false;
+        }
+        size_t blocks = (count + blockSize - 1) / blockSize;
+        available -= sizeof(uint32_t);
+        if (blocks > available / sizeof(float) || count > available - blocks * sizeof(float)) {
+            std::cerr << "Buffer size is smaller than expected!" << std::endl;
+            return false;
+        }
+        m_blockSize = blockSize;
+        m_scales = payload + sizeof(uint32_t);
+        m_params = m_scales + blocks * sizeof(float);
+        trailer = m_params + count;
+        break;
+    }
+    case PAYLOAD_TOPK: {
+        if (available < sizeof(uint32_t)) {
+            std::cerr << "Buffer size can't hold top-k entry count!" << std::endl;
+            return false;
+        }
+        size_t entries = loadUint32(payload);
+        if (entries > count || entries > (available - sizeof(uint32_t)) / (sizeof(uint32_t) + sizeof(float))) {
+            std::cerr << "Buffer size is smaller than expected!" << std::endl;
+            return false;
+        }
+        m_params = payload + sizeof(uint32_t);
+        m_scales = m_params + entries * sizeof(uint32_t);
+        for (size_t k = 0; k < entries; ++k) {
+            if (loadUint32(m_params + k * sizeof(uint32_t)) >= count) {
+                std::cerr << "Top-k index out of range!" << std::endl;
+                *this = ModelDataView();
+                return false;
+            }
+        }
+        m_entries = entries;
+        trailer = m_scales + entries * sizeof(float);
+        break;
+    }
+    default:
+        std::cerr << "Unknown ModelData payload encoding: " << static_cast<int>(buffer[1]) << std::endl;
+        return false;
+    }
+
+    // Contributors, between the payload and the congested nodes
+    const uint8_t* end = buffer + size;
+    if (static_cast<size_t>(end - trailer) < 2 * sizeof(uint32_t)) {
+        std::cerr << "Buffer size can't hold contributors!" << std::endl;
+        *this = ModelDataView();
+        return false;
+    }
+    uint32_t contributorCount = loadUint32(trailer);
+    size_t bitmapSize = loadUint32(trailer + sizeof(uint32_t));
+    trailer += 2 * sizeof(uint32_t);
+    if (static_cast<size_t>(end - trailer) < bitmapSize) {
+        std::cerr << "Buffer size can't hold contributors bitmap!" << std::endl;
+        *this = ModelDataView();
+        return false;
+    }
+    m_contributorCount = contributorCount;
+    m_bitmap = trailer;
+    m_bitmapSize = bitmapSize;
+    trailer += bitmapSize;
+
+    m_encoding = static_cast<PayloadEncoding>(buffer[1]);
+    m_count = count;
+    m_qsf = loadDouble(buffer + 8);
+    m_trailer = trailer;
+    m_end = buffer + size;
+    return true;
+}
+
+
+
+double
+ModelDataView::operator[](size_t i) const
+{
+    switch (m_encoding) {
+    case PAYLOAD_FP64:
+        return loadDouble(m_params + i * sizeof(double));
+    case PAYLOAD_FP32:
+        return static_cast<double>(loadFloat(m_params + i * sizeof(float)));
+    case PAYLOAD_FP16:
+        return static_cast<double>(ns3::utils::HalfToFloat(loadUint16(m_params + i * sizeof(uint16_t))));
+    case PAYLOAD_BF16:
+        return static_cast<double>(ns3::utils::Bfloat16ToFloat(loadUint16(m_params + i * sizeof(uint16_t))));
+    case PAYLOAD_INT8: {
+        double scale = static_cast<double>(loadFloat(m_scales + (i / m_blockSize) * sizeof(float)));
+        return scale * static_cast<double>(static_cast<int8_t>(m_params[i]));
+    }
+    case PAYLOAD_TOPK: {
+        // Indices are ascending, binary search
+        size_t lo = 0, hi = m_entries;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            size_t index = loadUint32(m_params + mid * sizeof(uint32_t));
+            if (index == i) {
+                return static_cast<double>(loadFloat(m_scales + mid * sizeof(float)));
+            }
+            if (index < i) {
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        return 0.0;
+    }
+    }
+    return 0.0;
+}
+
+
+
+void
+ModelDataView::accumulateInto(double* acc, size_t count) const
+{
+    size_t n = std::min(count, m_count);
+
+    if (m_encoding == PAYLOAD_TOPK) {
+        // Sparse, only the K kept entries are touched
+        for (size_t k = 0; k < m_entries; ++k) {
+            size_t index = loadUint32(m_params + k * sizeof(uint32_t));
+            if (index < n) {
+                acc[index] += static_cast<double>(loadFloat(m_scales + k * sizeof(float)));
+            }
+        }
+        return;
+    }
+
+    if (!isLittleEndianHost()) {
+        for (size_t i = 0; i < n; ++i) {
+            acc[i] += (*this)[i];
+        }
+        return;
+    }
+
+    // Kernels use unaligned loads, no need to copy (or decode) the payload out first
+    const ns3::utils::ReductionKernels& kernels = ns3::utils::GetReductionKernels();
+    switch (m_encoding) {
+    case PAYLOAD_FP64:
+        kernels.sum(acc, reinterpret_cast<const double*>(m_params), n);
+        break;
+    case PAYLOAD_FP32:
+        kernels.sumFloat(acc, reinterpret_cast<const float*>(m_params), n);
+        break;
+    case PAYLOAD_FP16:
+        kernels.sumHalf(acc, reinterpret_cast<const uint16_t*>(m_params), n);
+        break;
+    case PAYLOAD_BF16:
+        kernels.sumBfloat16(acc, reinterpret_cast<const uint16_t*>(m_params), n);
+        break;
+    case PAYLOAD_INT8:
+        for (size_t begin = 0; begin < n; begin += m_blockSize) {
+            size_t length = std::min(m_blockSize, n - begin);
+            double scale = static_cast<double>(loadFloat(m_scales + (begin / m_blockSize) * sizeof(float)));
+            kernels.sumInt8(acc + begin, reinterpret_cast<const int8_t*>(m_params) + begin, length, scale);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+
+
+void
+ModelDataView::copyTo(double* out, size_t count) const
+{
+    size_t n = std::min(count, m_count);
+    if (m_encoding == PAYLOAD_FP64 && isLittleEndianHost()) {
+        std::memcpy(out, m_params, n * sizeof(double));
+        return;
+    }
+
+    std::fill(out, out + n, 0.0);
+    accumulateInto(out, n);
+}
+
+
+
+void
+ModelDataView::mergeContributorsInto(ModelContributors& contributors) const
+{
+    if (contributors.bitmap.size() < m_bitmapSize) {
+        contributors.bitmap.resize(m_bitmapSize, 0);
+    }
+    for (size_t i = 0; i < m_bitmapSize; ++i) {
+        contributors.bitmap[i] |= m_bitmap[i];
+    }
+    contributors.count += m_contributorCount;
+}
+
+
+
+std::vector<std::string>
+ModelDataView::congestedNodes() const
+{
+    std::vector<std::string> nodes;
+    const uint8_t* p = m_trailer;
+    while (p != nullptr && p < m_end) {
+        if (static_cast<size_t>(m_end - p) < sizeof(uint32_t)) {
+            std::cerr << "Buffer size can't hold string length!" << std::endl;
+            break;
+        }
+        uint32_t strLength = loadUint32(p);
+        p += sizeof(uint32_t);
+
+        if (static_cast<size_t>(m_end - p) < strLength) {
+            std::cerr << "Buffer size can't hold string content!" << std::endl;
+            break;
+        }
+        nodes.emplace_back(reinterpret_cast<const char*>(p), strLength);
+        p += strLength;
+    }
+    return nodes;
+}
+
+
+
+/**
+ * Write the (non FP64) payload of the given encoding
+ * @param out Output, payload bytes as laid out on the wire
+ * @param parameters Model parameters
+ * @param count Number of model parameters
+ * @param encoding Payload encoding
+ * @param topK TOPK only, number of entries to keep, 0 keeps every non-zero entry
+ */
+static void
+encodePayload(std::vector<uint8_t>& out, const double* parameters, size_t count, PayloadEncoding encoding, size_t topK)
+{
+    out.clear();
+    switch (encoding) {
+    case PAYLOAD_FP32: {
+        out.resize(count * sizeof(float));
+        uint8_t* p = out.data();
+        for (size_t i = 0; i < count; ++i) {
+            p = storeFloat(p, static_cast<float>(parameters[i]));
+        }
+        break;
+    }
+    case PAYLOAD_FP16:
+    case PAYLOAD_BF16: {
+        out.resize(count * sizeof(uint16_t));
+        uint8_t* p = out.data();
+        for (size_t i = 0; i < count; ++i) {
+            float value = static_cast<float>(parameters[i]);
+            p = storeUint16(p, encoding == PAYLOAD_FP16 ? ns3::utils::FloatToHalf(value) : ns3::utils::FloatToBfloat16(value));
+        }
+        break;
+    }
+    case PAYLOAD_INT8: {
+        size_t blocks = (count + MODEL_DATA_INT8_BLOCK_SIZE - 1) / MODEL_DATA_INT8_BLOCK_SIZE;
+        out.resize(sizeof(uint32_t) + blocks * sizeof(float) + count);
+        uint8_t* scales = storeUint32(out.data(), static_cast<uint32_t>(MODEL_DATA_INT8_BLOCK_SIZE));
+        int8_t* codes = reinterpret_cast<int8_t*>(scales + blocks * sizeof(float));
+        for (size_t begin = 0; begin < count; begin += MODEL_DATA_INT8_BLOCK_SIZE) {
+            size_t end = std::min(begin + MODEL_DATA_INT8_BLOCK_SIZE, count);
+            double maxAbs = 0.0;
+            for (size_t i = begin; i < end; ++i) {
+                maxAbs = std::max(maxAbs, std::fabs(parameters[i]));
+            }
+            // Quantize with the scale as it travels (fp32), so the receiver decodes exactly what was meant
+            float scale = static_cast<float>(maxAbs / 127.0);
+            scales = storeFloat(scales, scale);
+            for (size_t i = begin; i < end; ++i) {
+                double code = scale > 0.0f ? std::nearbyint(parameters[i] / static_cast<double>(scale)) : 0.0;
+                codes[i] = static_cast<int8_t>(std::max(-127.0, std::min(127.0, code)));
+            }
+        }
+        break;
+    }
+    case PAYLOAD_TOPK: {
+        std::vector<uint32_t> indices;
+        indices.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (parameters[i] != 0.0) {
+                indices.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        if (topK != 0 && topK < indices.size()) {
+            // Largest magnitudes first, ties broken by index so every run picks the same entries
+            auto larger = [parameters] (uint32_t a, uint32_t b) {
+                double x = std::fabs(parameters[a]), y = std::fabs(parameters[b]);
+                return x > y || (x == y && a < b);
+            };
+            std::nth_element(indices.begin(), indices.begin() + topK, indices.end(), larger);
+            indices.resize(topK);
+            std::sort(indices.begin(), indices.end());
+        }
+
+        out.resize(sizeof(uint32_t) + indices.size() * (sizeof(uint32_t) + sizeof(float)));
+        uint8_t* p = storeUint32(out.data(), static_cast<uint32_t>(indices.size()));
+        uint8_t* values = p + indices.size() * sizeof(uint32_t);
+        for (uint32_t index : indices) {
+            p = storeUint32(p, index);
+            values = storeFloat(values, static_cast<float>(parameters[index]));
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+
+
+/**
+ * Lay a Content block out in one exactly sized buffer: TLV header, ModelData header, payload, trailer.
+ * The value is written in place into the back reserve of the EncodingBuffer, rather than prepended from
+ * a copy, so FP64 parameters can be generated straight into the packet; the TLV header is then prepended
+ * into the front reserve, which leaves a few padding bytes so that the parameters are 8-byte aligned
+ * @param count Number of model parameters
+ * @param qsf Meta data
+ * @param congestedNodes Meta data
+ * @param contributors Meta data
+ * @param encoding Payload encoding
+ * @param payloadSize Size of the payload in bytes
+ * @param writePayload Writes the payload at the given address, straight into the block's buffer
+ * @return Content block
+ */
+template<typename WritePayload>
+static ::ndn::Block
+layoutModelDataContent(size_t count, double qsf, const std::vector<std::string>& congestedNodes,
+                       const ModelContributors& contributors, PayloadEncoding encoding, size_t payloadSize,
+                       WritePayload writePayload)
+{
+    size_t trailerSize = 2 * sizeof(uint32_t) + contributors.bitmap.size();
+    for (const auto& str : congestedNodes) {
+        trailerSize += sizeof(uint32_t) + str.size();
+    }
+    size_t valueSize = MODEL_DATA_HEADER_SIZE + payloadSize + trailerSize;
+    size_t tlvHeaderSize = ::ndn::tlv::sizeOfVarNumber(::ndn::tlv::Content) + ::ndn::tlv::sizeOfVarNumber(valueSize);
+    size_t padding = (alignof(double) - tlvHeaderSize % alignof(double)) % alignof(double);
+
+    ::ndn::EncodingBuffer encoder(padding + tlvHeaderSize + valueSize, valueSize);
+    uint8_t* p = &*encoder.end();
+    p[0] = MODEL_DATA_VERSION;
+    p[1] = static_cast<uint8_t>(encoding);
+    storeUint32(p + 4, static_cast<uint32_t>(count));
+    storeDouble(p + 8, qsf);
+    p += MODEL_DATA_HEADER_SIZE;
+
+    writePayload(p);
+    p += payloadSize;
+
+    p = storeUint32(p, contributors.count);
+    p = storeUint32(p, static_cast<uint32_t>(contributors.bitmap.size()));
+    if (!contributors.bitmap.empty()) {
+        std::memcpy(p, contributors.bitmap.data(), contributors.bitmap.size());
+        p += contributors.bitmap.size();
+    }
+
+    for (const auto& str : congestedNodes) {
+        p = storeUint32(p, static_cast<uint32_t>(str.size()));
+        std::memcpy(p, str.data(), str.size());
+        p += str.size();
+    }
+
+    encoder.prependVarNumber(valueSize);
+    encoder.prependVarNumber(::ndn::tlv::Content);
+    return ::ndn::Block(encoder.getBuffer(), encoder.begin(), encoder.getBuffer()->end());
+}
+
+
+
+/**
+ * Encode ModelData into a Content block, the TLV is written once into an exactly sized buffer
+ * @param parameters Model parameters
+ * @param count Number of model parameters
+ * @param qsf Meta data
+ * @param congestedNodes Meta data
+ * @param encoding Payload encoding
+ * @param topK TOPK only, number of entries to keep, 0 keeps every non-zero entry
+ * @param contributors Meta data
+ * @return Content block
+ */
+::ndn::Block
+encodeModelDataContent(const double* parameters, size_t count, double qsf,
+                       const std::vector<std::string>& congestedNodes,
+                       PayloadEncoding encoding, size_t topK, const ModelContributors& contributors)
+{
+    // FP64 is written straight from the parameters, other encodings are converted first
+    if (encoding != PAYLOAD_FP64) {
+        std::vector<uint8_t> payload;
+        encodePayload(payload, parameters, count, encoding, topK);
+        return layoutModelDataContent(count, qsf, congestedNodes, contributors, encoding, payload.size(), [&payload] (uint8_t* p) {
+            std::memcpy(p, payload.data(), payload.size());
+        });
+    }
+
+    return layoutModelDataContent(count, qsf, congestedNodes, contributors, encoding, count * sizeof(double), [parameters, count] (uint8_t* p) {
+        if (isLittleEndianHost()) {
+            std::memcpy(p, parameters, count * sizeof(double));
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            p = storeDouble(p, parameters[i]);
+        }
+    });
+}
+
+
+
+/**
+ * Encode parameters produced on the fly, FP64 parameters are generated in place in the block's buffer
+ * @param count Number of model parameters
+ * @param fill Writes count parameters at the given (8-byte aligned) address
+ * @param qsf Meta data
+ * @param congestedNodes Meta data
+ * @param encoding Payload encoding
+ * @param topK TOPK only, number of entries to keep, 0 keeps every non-zero entry
+ * @param contributors Meta data
+ * @return Content block
+ */
+::ndn::Block
+encodeModelDataContent(size_t count, const ModelDataFill& fill, double qsf,
+                       const std::vector<std::string>& congestedNodes,
+                       PayloadEncoding encoding, size_t topK, const ModelContributors& contributors)
+{
+    if (encoding != PAYLOAD_FP64) {
+        std::vector<double> parameters(count);
+        fill(parameters.data(), count);
+        return encodeModelDataContent(parameters.data(), count, qsf, congestedNodes, encoding, topK, contributors);
+    }
+
+    return layoutModelDataContent(count, qsf, congestedNodes, contributors, encoding, count * sizeof(double), [&fill, count] (uint8_t* p) {
+        double* parameters = reinterpret_cast<double*>(p);
+        fill(parameters, count);
+        if (!isLittleEndianHost()) {
+            for (size_t i = 0; i < count; ++i) {
+                storeDouble(p + i * sizeof(double), parameters[i]);
+            }
+        }
+    });
+}
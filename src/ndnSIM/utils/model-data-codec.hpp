@@ -0,0 +1,212 @@
+#ifndef MODEL_DATA_CODEC_HPP
+#define MODEL_DATA_CODEC_HPP
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/callback.h"
+#include <ndn-cxx/encoding/block.hpp>
+#include <functional>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Producers whose updates are summed in a model update: set by the producer, merged at every aggregation hop
+ */
+struct ModelContributors {
+    uint32_t count = 0; // Number of producer updates summed, an update folded into a later iteration counts again
+    std::vector<uint8_t> bitmap; // Bit i % 8 of byte i / 8 is set if the producer with node id i contributed
+
+    void
+    add(uint32_t nodeId);
+
+    /**
+     * Union of the bitmaps, sum of the counts
+     */
+    void
+    merge(const ModelContributors& other);
+
+    bool
+    has(uint32_t nodeId) const;
+
+    /**
+     * Number of distinct producers in the bitmap
+     */
+    size_t
+    population() const;
+
+    void
+    clear();
+};
+
+
+/**
+ * Payload encoding of the model parameters, selected per app by the "PayloadEncoding" attribute
+ */
+enum PayloadEncoding {
+    PAYLOAD_FP64 = 0, // Raw doubles, lossless
+    PAYLOAD_FP32,     // IEEE single precision
+    PAYLOAD_FP16,     // IEEE half precision
+    PAYLOAD_BF16,     // bfloat16, fp32 range with 8 bit mantissa
+    PAYLOAD_INT8,     // Symmetric int8 with one fp32 scale per block of MODEL_DATA_INT8_BLOCK_SIZE
+    PAYLOAD_TOPK      // Sparse (index, fp32 value) pairs of the largest magnitudes
+};
+
+/**
+ * Wire format (version 2) of ModelData inside a Data packet's Content, all fields little-endian
+ *
+ *   offset 0   uint8   version (MODEL_DATA_VERSION)
+ *   offset 1   uint8   payload encoding (PayloadEncoding)
+ *   offset 2   uint16  reserved
+ *   offset 4   uint32  number of parameters N
+ *   offset 8   double  qsf
+ *   offset 16  payload, depends on encoding
+ *                FP64        double[N], 8-byte aligned relative to the start of Content's value
+ *                FP32        float[N]
+ *                FP16, BF16  uint16[N]
+ *                INT8        uint32 block size B, float scale[ceil(N / B)], int8[N]
+ *                TOPK        uint32 K, uint32 index[K] (ascending), float value[K]
+ *   ...        uint32 contributor count, uint32 bitmap size L, uint8 bitmap[L] (ModelContributors)
+ *   ...        (uint32 length, bytes) for each congested node, until the end of the value
+ */
+static constexpr uint8_t MODEL_DATA_VERSION = 2;
+static constexpr size_t MODEL_DATA_HEADER_SIZE = 16;
+static constexpr size_t MODEL_DATA_INT8_BLOCK_SIZE = 64;
+
+/**
+ * Read-only view over an encoded ModelData, usually the Content block of a received Data packet
+ * Nothing is copied when parsing, parameters are read (or summed) straight from the packet buffer
+ * The view doesn't own the memory, the Data packet must outlive it
+ */
+class ModelDataView {
+public:
+    ModelDataView();
+
+    /**
+     * Parse the header and validate the layout of an encoded ModelData
+     * @param buffer Start of Content's value
+     * @param size Size of Content's value
+     * @return False if the buffer is truncated or has an unknown version
+     */
+    bool
+    parse(const uint8_t* buffer, size_t size);
+
+    /**
+     * Parse Content block of a Data packet
+     */
+    bool
+    parse(const ::ndn::Block& content)
+    {
+        return parse(content.value(), content.value_size());
+    }
+
+    /**
+     * Number of model parameters, whatever the encoding
+     */
+    size_t
+    size() const
+    {
+        return m_count;
+    }
+
+    double
+    qsf() const
+    {
+        return m_qsf;
+    }
+
+    PayloadEncoding
+    encoding() const
+    {
+        return m_encoding;
+    }
+
+    /**
+     * Decode parameter i, handles unaligned storage and host byte order; O(K) for TOPK
+     */
+    double
+    operator[](size_t i) const;
+
+    /**
+     * acc[i] += parameters[i] for the first min(count, size()) parameters, reduced straight from
+     * the encoded payload (no decoded copy); TOPK only touches its K entries
+     */
+    void
+    accumulateInto(double* acc, size_t count) const;
+
+    /**
+     * out[i] = parameters[i] for the first min(count, size()) parameters
+     */
+    void
+    copyTo(double* out, size_t count) const;
+
+    /**
+     * Number of producer updates summed in the payload, 0 if the sender didn't track them
+     */
+    uint32_t
+    contributorCount() const
+    {
+        return m_contributorCount;
+    }
+
+    /**
+     * Merge the contributors carried behind the payload, the bitmap is OR-ed straight from the buffer
+     */
+    void
+    mergeContributorsInto(ModelContributors& contributors) const;
+
+    /**
+     * Decode the congested node list carried behind the payload
+     */
+    std::vector<std::string>
+    congestedNodes() const;
+
+private:
+    const uint8_t* m_params;  // FP64/FP32/FP16/BF16 values, INT8 codes, TOPK indices
+    const uint8_t* m_scales;  // INT8 block scales, TOPK values
+    const uint8_t* m_bitmap;  // Contributors bitmap
+    const uint8_t* m_trailer;
+    const uint8_t* m_end;
+    size_t m_count;
+    size_t m_blockSize;       // INT8 block size
+    size_t m_entries;         // TOPK number of entries
+    size_t m_bitmapSize;
+    uint32_t m_contributorCount;
+    double m_qsf;
+    PayloadEncoding m_encoding;
+};
+
+/**
+ * Encode parameters straight into a Content block backed by one exactly sized ndn::Buffer, padded in
+ * front so that FP64 parameters are 8-byte aligned
+ * @param parameters Model parameters
+ * @param count Number of model parameters
+ * @param qsf Meta data
+ * @param congestedNodes Meta data
+ * @param encoding Payload encoding
+ * @param topK TOPK only, number of largest-magnitude entries to keep, 0 keeps every non-zero entry (lossless)
+ * @param contributors Producers summed in the parameters
+ * @return Content block which can be passed to Data::setContent() without another copy
+ */
+::ndn::Block encodeModelDataContent(const double* parameters, size_t count, double qsf,
+                                    const std::vector<std::string>& congestedNodes,
+                                    PayloadEncoding encoding = PAYLOAD_FP64, size_t topK = 0,
+                                    const ModelContributors& contributors = ModelContributors());
+
+
+/**
+ * Writes count model parameters at the given address
+ */
+using ModelDataFill = std::function<void(double* parameters, size_t count)>;
+
+/**
+ * Same as above, but parameters are produced by fill: with FP64 they're generated in place, straight
+ * into the Content block's buffer, nothing is copied
+ */
+::ndn::Block encodeModelDataContent(size_t count, const ModelDataFill& fill, double qsf,
+                                    const std::vector<std::string>& congestedNodes,
+                                    PayloadEncoding encoding = PAYLOAD_FP64, size_t topK = 0,
+                                    const ModelContributors& contributors = ModelContributors());
+
+#endif // MODEL_DATA_CODEC_HPP
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-recording-scheduler.hpp"
+
+#include "ns3/object-factory.h"
+#include "ns3/string.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE("ndn.RecordingScheduler");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(RecordingScheduler);
+
+TypeId
+RecordingScheduler::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::RecordingScheduler")
+      .SetParent<Scheduler>()
+      .SetGroupName("Ndn")
+      .AddConstructor<RecordingScheduler>()
+      .AddAttribute("Scheduler", "TypeId of the recorded scheduler",
+                    TypeId::ATTR_CONSTRUCT, StringValue("ns3::MapScheduler"),
+                    MakeStringAccessor(&RecordingScheduler::SetScheduler),
+                    MakeStringChecker())
+      .AddAttribute("TraceFile", "File the operations are written to, nothing is recorded if empty",
+                    TypeId::ATTR_CONSTRUCT, StringValue(""),
+                    MakeStringAccessor(&RecordingScheduler::SetTraceFile),
+                    MakeStringChecker());
+  return tid;
+}
+
+RecordingScheduler::RecordingScheduler()
+{
+}
+
+RecordingScheduler::~RecordingScheduler()
+{
+}
+
+void
+RecordingScheduler::SetScheduler(const std::string& type)
+{
+  NS_LOG_FUNCTION(this << type);
+  NS_ABORT_MSG_IF(m_scheduler != nullptr && !m_scheduler->IsEmpty(),
+                  "Cannot replace a scheduler holding events");
+
+  ObjectFactory factory(type);
+  m_scheduler = factory.Create<Scheduler>();
+}
+
+void
+RecordingScheduler::SetTraceFile(const std::string& path)
+{
+  NS_LOG_FUNCTION(this << path);
+  if (m_trace.is_open()) {
+    m_trace.close();
+  }
+  if (path.empty()) {
+    return;
+  }
+
+  m_trace.open(path.c_str(), std::ios_base::out | std::ios_base::trunc);
+  NS_ABORT_MSG_IF(!m_trace.is_open(), "Cannot open scheduler trace " << path);
+}
+
+void
+RecordingScheduler::Insert(const Event& ev)
+{
+  if (m_trace.is_open()) {
+    m_trace << "i " << ev.key.m_ts << ' ' << ev.key.m_uid << '\n';
+  }
+  m_scheduler->Insert(ev);
+}
+
+bool
+RecordingScheduler::IsEmpty() const
+{
+  return m_scheduler->IsEmpty();
+}
+
+Scheduler::Event
+RecordingScheduler::PeekNext() const
+{
+  return m_scheduler->PeekNext();
+}
+
+Scheduler::Event
+RecordingScheduler::RemoveNext()
+{
+  if (m_trace.is_open()) {
+    m_trace << "n\n";
+  }
+  return m_scheduler->RemoveNext();
+}
+
+void
+RecordingScheduler::Remove(const Event& ev)
+{
+  if (m_trace.is_open()) {
+    m_trace << "r " << ev.key.m_ts << ' ' << ev.key.m_uid << '\n';
+  }
+  m_scheduler->Remove(ev);
+}
+
+} // namespace ndn
+} // namespace ns3
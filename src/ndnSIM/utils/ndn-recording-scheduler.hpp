@@ -0,0 +1,87 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_RECORDING_SCHEDULER_H
+#define NDN_RECORDING_SCHEDULER_H
+
+#include "ns3/scheduler.h"
+#include "ns3/ptr.h"
+
+#include <fstream>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn
+ * @brief Scheduler recording the operations of another scheduler into a trace file
+ *
+ * Each operation is written on its own line:
+ *
+ *     i <ts> <uid>    Insert
+ *     n               RemoveNext
+ *     r <ts> <uid>    Remove
+ *
+ * Timestamps are in simulator time units.  utils/bench-scheduler replays such a trace
+ * on each ns-3 scheduler, to pick the fastest for a scenario's event pattern.
+ *
+ * Selected with the "SchedulerType" global value, the recorded scheduler and the file
+ * being set through Config::SetDefault before the simulator is created.
+ */
+class RecordingScheduler : public Scheduler {
+public:
+  static TypeId
+  GetTypeId();
+
+  RecordingScheduler();
+
+  virtual ~RecordingScheduler();
+
+  virtual void
+  Insert(const Event& ev);
+
+  virtual bool
+  IsEmpty() const;
+
+  virtual Event
+  PeekNext() const;
+
+  virtual Event
+  RemoveNext();
+
+  virtual void
+  Remove(const Event& ev);
+
+private:
+  void
+  SetScheduler(const std::string& type);
+
+  void
+  SetTraceFile(const std::string& path);
+
+private:
+  Ptr<Scheduler> m_scheduler; // Recorded scheduler, holds the events
+  std::ofstream m_trace;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_RECORDING_SCHEDULER_H
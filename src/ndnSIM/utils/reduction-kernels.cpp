@@ -0,0 +1,501 @@
+#include "reduction-kernels.hpp"
+
+#include "ns3/log.h"
+
+#include <cstring>
+#include <initializer_list>
+
+// Keep mul + add as two roundings, AVX-512 targets would otherwise contract them into FMA
+// and the weighted kernels would stop matching the other instruction sets bit for bit
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define REDUCTION_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+NS_LOG_COMPONENT_DEFINE("ndn.ReductionKernels");
+
+namespace ns3 {
+namespace utils {
+
+/**
+ * Unaligned loads for the scalar paths, compiles to a plain load
+ */
+template<typename T>
+static inline T
+loadScalar(const T* p)
+{
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+
+
+float
+HalfToFloat(uint16_t h)
+{
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1f;
+    uint32_t mantissa = h & 0x3ff;
+    uint32_t bits;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        }
+        else {
+            // Subnormal, normalize it
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400) == 0) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            mantissa &= 0x3ff;
+            bits = sign | (exponent << 23) | (mantissa << 13);
+        }
+    }
+    else if (exponent == 0x1f) {
+        bits = sign | 0x7f800000 | (mantissa << 13); // Inf or NaN
+    }
+    else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+
+
+uint16_t
+FloatToHalf(float f)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t exponent = (bits >> 23) & 0xff;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    if (exponent == 0xff) {
+        return sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0); // Inf or NaN
+    }
+
+    int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+    if (halfExponent >= 0x1f) {
+        return sign | 0x7c00; // Overflow to Inf
+    }
+
+    if (halfExponent <= 0) {
+        if (halfExponent < -10) {
+            return sign; // Underflow to zero
+        }
+        // Subnormal half
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+        uint32_t halfMantissa = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (halfMantissa & 1))) {
+            ++halfMantissa;
+        }
+        return sign | static_cast<uint16_t>(halfMantissa);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+        ++half; // May carry into the exponent, which correctly rounds up to the next binade / Inf
+    }
+    return sign | static_cast<uint16_t>(half);
+}
+
+
+
+uint16_t
+FloatToBfloat16(float f)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    if ((bits & 0x7fffffff) > 0x7f800000) {
+        return static_cast<uint16_t>((bits >> 16) | 0x40); // Keep NaN quiet, rounding could turn it into Inf
+    }
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return static_cast<uint16_t>(bits >> 16);
+}
+
+
+
+// Scalar kernels, also used for the tails of the vector kernels
+
+static void
+sumScalar(double* acc, const double* src, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        acc[i] += loadScalar(src + i);
+    }
+}
+
+static void
+weightedSumScalar(double* acc, const double* src, size_t n, double weight)
+{
+    for (size_t i = 0; i < n; ++i) {
+        acc[i] += weight * loadScalar(src + i);
+    }
+}
+
+static void
+divideScalar(double* out, const double* src, size_t n, double divisor)
+{
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = loadScalar(src + i) / divisor;
+    }
+}
+
+static void
+sumFloatScalar(double* acc, const float* src, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        acc[i] += static_cast<double>(loadScalar(src + i));
+    }
+}
+
+static void
+sumHalfScalar(double* acc, const uint16_t* src, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        acc[i] += static_cast<double>(HalfToFloat(loadScalar(src + i)));
+    }
+}
+
+static void
+sumBfloat16Scalar(double* acc, const uint16_t* src, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        acc[i] += static_cast<double>(Bfloat16ToFloat(loadScalar(src + i)));
+    }
+}
+
+static void
+sumInt8Scalar(double* acc, const int8_t* src, size_t n, double scale)
+{
+    for (size_t i = 0; i < n; ++i) {
+        acc[i] += scale * static_cast<double>(src[i]);
+    }
+}
+
+static const ReductionKernels s_scalarKernels = {
+    ReductionIsa::SCALAR, "scalar",
+    sumScalar, weightedSumScalar, divideScalar, sumFloatScalar, sumHalfScalar, sumBfloat16Scalar, sumInt8Scalar
+};
+
+
+
+#ifdef REDUCTION_KERNELS_X86
+
+// SSE2, baseline on x86-64. No fp16/bf16/int8 widening instructions, those reuse the scalar kernels
+
+__attribute__((target("sse2"))) static void
+sumSse2(double* acc, const double* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(acc + i, _mm_add_pd(_mm_loadu_pd(acc + i), _mm_loadu_pd(src + i)));
+    }
+    sumScalar(acc + i, src + i, n - i);
+}
+
+__attribute__((target("sse2"))) static void
+weightedSumSse2(double* acc, const double* src, size_t n, double weight)
+{
+    __m128d w = _mm_set1_pd(weight);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d product = _mm_mul_pd(w, _mm_loadu_pd(src + i));
+        _mm_storeu_pd(acc + i, _mm_add_pd(_mm_loadu_pd(acc + i), product));
+    }
+    weightedSumScalar(acc + i, src + i, n - i, weight);
+}
+
+__attribute__((target("sse2"))) static void
+divideSse2(double* out, const double* src, size_t n, double divisor)
+{
+    __m128d d = _mm_set1_pd(divisor);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_div_pd(_mm_loadu_pd(src + i), d));
+    }
+    divideScalar(out + i, src + i, n - i, divisor);
+}
+
+__attribute__((target("sse2"))) static void
+sumFloatSse2(double* acc, const float* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 f = _mm_loadu_ps(src + i);
+        __m128d lo = _mm_cvtps_pd(f);
+        __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(f, f));
+        _mm_storeu_pd(acc + i, _mm_add_pd(_mm_loadu_pd(acc + i), lo));
+        _mm_storeu_pd(acc + i + 2, _mm_add_pd(_mm_loadu_pd(acc + i + 2), hi));
+    }
+    sumFloatScalar(acc + i, src + i, n - i);
+}
+
+static const ReductionKernels s_sse2Kernels = {
+    ReductionIsa::SSE2, "sse2",
+    sumSse2, weightedSumSse2, divideSse2, sumFloatSse2, sumHalfScalar, sumBfloat16Scalar, sumInt8Scalar
+};
+
+
+
+// AVX2 (+F16C for fp16 payloads)
+
+__attribute__((target("avx2"))) static void
+sumAvx2(double* acc, const double* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d a0 = _mm256_add_pd(_mm256_loadu_pd(acc + i), _mm256_loadu_pd(src + i));
+        __m256d a1 = _mm256_add_pd(_mm256_loadu_pd(acc + i + 4), _mm256_loadu_pd(src + i + 4));
+        _mm256_storeu_pd(acc + i, a0);
+        _mm256_storeu_pd(acc + i + 4, a1);
+    }
+    sumScalar(acc + i, src + i, n - i);
+}
+
+__attribute__((target("avx2"))) static void
+weightedSumAvx2(double* acc, const double* src, size_t n, double weight)
+{
+    __m256d w = _mm256_set1_pd(weight);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d product = _mm256_mul_pd(w, _mm256_loadu_pd(src + i));
+        _mm256_storeu_pd(acc + i, _mm256_add_pd(_mm256_loadu_pd(acc + i), product));
+    }
+    weightedSumScalar(acc + i, src + i, n - i, weight);
+}
+
+__attribute__((target("avx2"))) static void
+divideAvx2(double* out, const double* src, size_t n, double divisor)
+{
+    __m256d d = _mm256_set1_pd(divisor);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_loadu_pd(src + i), d));
+    }
+    divideScalar(out + i, src + i, n - i, divisor);
+}
+
+__attribute__((target("avx2"))) static void
+sumFloatAvx2(double* acc, const float* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d widened = _mm256_cvtps_pd(_mm_loadu_ps(src + i));
+        _mm256_storeu_pd(acc + i, _mm256_add_pd(_mm256_loadu_pd(acc + i), widened));
+    }
+    sumFloatScalar(acc + i, src + i, n - i);
+}
+
+__attribute__((target("avx2,f16c"))) static void
+sumHalfAvx2(double* acc, const uint16_t* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 f = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(f));
+        __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1));
+        _mm256_storeu_pd(acc + i, _mm256_add_pd(_mm256_loadu_pd(acc + i), lo));
+        _mm256_storeu_pd(acc + i + 4, _mm256_add_pd(_mm256_loadu_pd(acc + i + 4), hi));
+    }
+    sumHalfScalar(acc + i, src + i, n - i);
+}
+
+__attribute__((target("avx2"))) static void
+sumBfloat16Avx2(double* acc, const uint16_t* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i widened = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        __m256 f = _mm256_castsi256_ps(_mm256_slli_epi32(widened, 16));
+        __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(f));
+        __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1));
+        _mm256_storeu_pd(acc + i, _mm256_add_pd(_mm256_loadu_pd(acc + i), lo));
+        _mm256_storeu_pd(acc + i + 4, _mm256_add_pd(_mm256_loadu_pd(acc + i + 4), hi));
+    }
+    sumBfloat16Scalar(acc + i, src + i, n - i);
+}
+
+__attribute__((target("avx2"))) static void
+sumInt8Avx2(double* acc, const int8_t* src, size_t n, double scale)
+{
+    __m256d s = _mm256_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32_t packed;
+        std::memcpy(&packed, src + i, sizeof(packed));
+        __m256d widened = _mm256_cvtepi32_pd(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(packed)));
+        _mm256_storeu_pd(acc + i, _mm256_add_pd(_mm256_loadu_pd(acc + i), _mm256_mul_pd(s, widened)));
+    }
+    sumInt8Scalar(acc + i, src + i, n - i, scale);
+}
+
+static const ReductionKernels s_avx2Kernels = {
+    ReductionIsa::AVX2, "avx2",
+    sumAvx2, weightedSumAvx2, divideAvx2, sumFloatAvx2, sumHalfAvx2, sumBfloat16Avx2, sumInt8Avx2
+};
+
+
+
+// AVX-512F (+F16C for fp16 payloads, present on every AVX-512 CPU)
+// GCC 12's avx512fintrin.h trips -Wmaybe-uninitialized on its own _mm512_undefined_pd() at -O2
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx512f"))) static void
+sumAvx512(double* acc, const double* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d a0 = _mm512_add_pd(_mm512_loadu_pd(acc + i), _mm512_loadu_pd(src + i));
+        __m512d a1 = _mm512_add_pd(_mm512_loadu_pd(acc + i + 8), _mm512_loadu_pd(src + i + 8));
+        _mm512_storeu_pd(acc + i, a0);
+        _mm512_storeu_pd(acc + i + 8, a1);
+    }
+    sumScalar(acc + i, src + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static void
+weightedSumAvx512(double* acc, const double* src, size_t n, double weight)
+{
+    __m512d w = _mm512_set1_pd(weight);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d product = _mm512_mul_pd(w, _mm512_loadu_pd(src + i));
+        _mm512_storeu_pd(acc + i, _mm512_add_pd(_mm512_loadu_pd(acc + i), product));
+    }
+    weightedSumScalar(acc + i, src + i, n - i, weight);
+}
+
+__attribute__((target("avx512f"))) static void
+divideAvx512(double* out, const double* src, size_t n, double divisor)
+{
+    __m512d d = _mm512_set1_pd(divisor);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, _mm512_div_pd(_mm512_loadu_pd(src + i), d));
+    }
+    divideScalar(out + i, src + i, n - i, divisor);
+}
+
+__attribute__((target("avx512f"))) static void
+sumFloatAvx512(double* acc, const float* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d widened = _mm512_cvtps_pd(_mm256_loadu_ps(src + i));
+        _mm512_storeu_pd(acc + i, _mm512_add_pd(_mm512_loadu_pd(acc + i), widened));
+    }
+    sumFloatScalar(acc + i, src + i, n - i);
+}
+
+__attribute__((target("avx512f,f16c"))) static void
+sumHalfAvx512(double* acc, const uint16_t* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 f = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        _mm512_storeu_pd(acc + i, _mm512_add_pd(_mm512_loadu_pd(acc + i), _mm512_cvtps_pd(f)));
+    }
+    sumHalfScalar(acc + i, src + i, n - i);
+}
+
+__attribute__((target("avx512f,avx2"))) static void
+sumBfloat16Avx512(double* acc, const uint16_t* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i widened = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        __m256 f = _mm256_castsi256_ps(_mm256_slli_epi32(widened, 16));
+        _mm512_storeu_pd(acc + i, _mm512_add_pd(_mm512_loadu_pd(acc + i), _mm512_cvtps_pd(f)));
+    }
+    sumBfloat16Scalar(acc + i, src + i, n - i);
+}
+
+__attribute__((target("avx512f,avx2"))) static void
+sumInt8Avx512(double* acc, const int8_t* src, size_t n, double scale)
+{
+    __m512d s = _mm512_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+        __m512d widened = _mm512_cvtepi32_pd(_mm256_cvtepi8_epi32(packed));
+        _mm512_storeu_pd(acc + i, _mm512_add_pd(_mm512_loadu_pd(acc + i), _mm512_mul_pd(s, widened)));
+    }
+    sumInt8Scalar(acc + i, src + i, n - i, scale);
+}
+
+static const ReductionKernels s_avx512Kernels = {
+    ReductionIsa::AVX512, "avx512",
+    sumAvx512, weightedSumAvx512, divideAvx512, sumFloatAvx512, sumHalfAvx512, sumBfloat16Avx512, sumInt8Avx512
+};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // REDUCTION_KERNELS_X86
+
+
+
+const ReductionKernels*
+GetReductionKernels(ReductionIsa isa)
+{
+    switch (isa) {
+    case ReductionIsa::SCALAR:
+        return &s_scalarKernels;
+#ifdef REDUCTION_KERNELS_X86
+    case ReductionIsa::SSE2:
+        return __builtin_cpu_supports("sse2") ? &s_sse2Kernels : nullptr;
+    case ReductionIsa::AVX2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c") ? &s_avx2Kernels : nullptr;
+    case ReductionIsa::AVX512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c")
+               ? &s_avx512Kernels : nullptr;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+
+
+const ReductionKernels&
+GetReductionKernels()
+{
+    static const ReductionKernels* selected = [] {
+        const ReductionKernels* kernels = &s_scalarKernels;
+        for (ReductionIsa isa : {ReductionIsa::AVX512, ReductionIsa::AVX2, ReductionIsa::SSE2}) {
+            if (const ReductionKernels* candidate = GetReductionKernels(isa)) {
+                kernels = candidate;
+                break;
+            }
+        }
+        NS_LOG_INFO("Model aggregation uses " << kernels->name << " reduction kernels");
+        return kernels;
+    }();
+    return *selected;
+}
+
+} // namespace utils
+} // namespace ns3
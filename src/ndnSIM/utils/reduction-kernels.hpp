@@ -0,0 +1,135 @@
+#ifndef REDUCTION_KERNELS_HPP
+#define REDUCTION_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ns3 {
+namespace utils {
+
+/**
+ * Instruction set of a reduction kernel table
+ */
+enum class ReductionIsa {
+    SCALAR = 0,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+/**
+ * Element-wise reduction kernels used to aggregate model parameters
+ *
+ * Every kernel only touches element i of each operand to produce element i of the result,
+ * and none of them uses FMA, so all instruction sets return bit-identical results and a
+ * simulation stays reproducible whichever machine it runs on. Source operands need no
+ * particular alignment, they usually point into a received packet buffer.
+ */
+struct ReductionKernels {
+    ReductionIsa isa;
+    const char* name;
+
+    /**
+     * acc[i] += src[i]
+     */
+    void (*sum)(double* acc, const double* src, size_t n);
+
+    /**
+     * acc[i] += weight * src[i]
+     */
+    void (*weightedSum)(double* acc, const double* src, size_t n, double weight);
+
+    /**
+     * out[i] = src[i] / divisor, out may equal src. A true division rather than a multiplication
+     * by the reciprocal, so means match the former per-element division exactly
+     */
+    void (*divide)(double* out, const double* src, size_t n, double divisor);
+
+    /**
+     * acc[i] += (double) src[i], fp32 payload
+     */
+    void (*sumFloat)(double* acc, const float* src, size_t n);
+
+    /**
+     * acc[i] += (double) half_to_float(src[i]), IEEE fp16 payload
+     */
+    void (*sumHalf)(double* acc, const uint16_t* src, size_t n);
+
+    /**
+     * acc[i] += (double) bfloat16_to_float(src[i]), bfloat16 payload
+     */
+    void (*sumBfloat16)(double* acc, const uint16_t* src, size_t n);
+
+    /**
+     * acc[i] += scale * src[i], symmetric int8 payload
+     */
+    void (*sumInt8)(double* acc, const int8_t* src, size_t n, double scale);
+};
+
+/**
+ * Best kernel table supported by the running CPU, selected once on first call
+ */
+const ReductionKernels&
+GetReductionKernels();
+
+/**
+ * Kernel table of a specific instruction set (benchmarks, tests)
+ * @param isa
+ * @return nullptr if the instruction set isn't compiled in or not supported by the running CPU
+ */
+const ReductionKernels*
+GetReductionKernels(ReductionIsa isa);
+
+/**
+ * Convert IEEE 754 binary16 to float, used by scalar paths
+ */
+float
+HalfToFloat(uint16_t h);
+
+/**
+ * Convert float to IEEE 754 binary16, round to nearest even
+ */
+uint16_t
+FloatToHalf(float f);
+
+/**
+ * Convert bfloat16 to float, exact
+ */
+inline float
+Bfloat16ToFloat(uint16_t b)
+{
+    uint32_t bits = static_cast<uint32_t>(b) << 16;
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+/**
+ * Convert float to bfloat16, round to nearest even
+ */
+uint16_t
+FloatToBfloat16(float f);
+
+/**
+ * out[i] = sum[i] / count
+ */
+inline void
+Mean(double* out, const double* sum, size_t n, double count)
+{
+    GetReductionKernels().divide(out, sum, n, count);
+}
+
+/**
+ * out[i] = weightedSum[i] / totalWeight, weightedSum being accumulated with weightedSum()
+ */
+inline void
+WeightedMean(double* out, const double* weightedSum, size_t n, double totalWeight)
+{
+    GetReductionKernels().divide(out, weightedSum, n, totalWeight);
+}
+
+} // namespace utils
+} // namespace ns3
+
+#endif // REDUCTION_KERNELS_HPP
@@ -43,6 +43,7 @@
 #include "ns3/double.h"
 
 #include "model/ndn-l3-protocol.hpp"
+#include "topology-partitioner.hpp"
 
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
@@ -69,6 +70,7 @@ AnnotatedTopologyReader::AnnotatedTopologyReader(const std::string& path, double
   , m_randY(CreateObject<UniformRandomVariable>())
   , m_scale(scale)
   , m_requiredPartitions(1)
+  , m_partitions(0)
 {
   NS_LOG_FUNCTION(this);
 
@@ -100,6 +102,13 @@ AnnotatedTopologyReader::SetMobilityModel(const std::string& model)
   m_mobilityFactory.SetTypeId(model);
 }
 
+void
+AnnotatedTopologyReader::SetPartitions(uint32_t partitions)
+{
+  NS_LOG_FUNCTION(this << partitions);
+  m_partitions = partitions;
+}
+
 AnnotatedTopologyReader::~AnnotatedTopologyReader()
 {
   NS_LOG_FUNCTION(this);
@@ -174,6 +183,14 @@ AnnotatedTopologyReader::Read(void)
     return m_nodes;
   }
 
+  struct NodeLine {
+    string name;
+    double latitude;
+    double longitude;
+    uint32_t systemId;
+  };
+  vector<NodeLine> nodeLines;
+
   while (!topgen.eof()) {
     string line;
     getline(topgen, line);
@@ -191,25 +208,12 @@ AnnotatedTopologyReader::Read(void)
     if (name.empty())
       continue;
 
-    Ptr<Node> node;
-
-    if (abs(latitude) > 0.001 && abs(latitude) > 0.001)
-      node = CreateNode(name, m_scale * longitude, -m_scale * latitude, systemId);
-    else {
-      Ptr<UniformRandomVariable> var = CreateObject<UniformRandomVariable>();
-      node = CreateNode(name, var->GetValue(0, 200), var->GetValue(0, 200), systemId);
-      // node = CreateNode (name, systemId);
-    }
+    nodeLines.push_back({name, latitude, longitude, systemId});
   }
 
-  map<string, set<string>> processedLinks; // to eliminate duplications
-
-  if (topgen.eof()) {
-    NS_LOG_ERROR("Topology file " << GetFileName() << " does not have \"link\" section");
-    return m_nodes;
-  }
+  bool hasLinks = !topgen.eof();
 
-  // SeekToSection ("link");
+  vector<vector<string>> linkLines;
   while (!topgen.eof()) {
     string line;
     getline(topgen, line);
@@ -221,9 +225,59 @@ AnnotatedTopologyReader::Read(void)
     // NS_LOG_DEBUG ("Input: [" << line << "]");
 
     istringstream lineBuffer(line);
-    string from, to, capacity, metric, delay, maxPackets, lossRate;
+    vector<string> fields(7);
+    for (auto& field : fields) {
+      lineBuffer >> field;
+    }
+    linkLines.push_back(fields);
+  }
 
-    lineBuffer >> from >> to >> capacity >> metric >> delay >> maxPackets >> lossRate;
+  // Nodes are created with their rank, so partitions have to be known first
+  if (m_partitions > 0) {
+    TopologyPartitioner partitioner;
+    for (const auto& nodeLine : nodeLines) {
+      partitioner.AddNode(nodeLine.name);
+    }
+    for (const auto& fields : linkLines) {
+      partitioner.AddLink(fields[0], fields[1], fields[4].empty() ? Time(0) : Time(fields[4]));
+    }
+
+    vector<uint32_t> ranks = partitioner.Partition(m_partitions);
+    for (size_t i = 0; i < nodeLines.size(); ++i) {
+      nodeLines[i].systemId = ranks[i];
+    }
+  }
+
+  for (const auto& nodeLine : nodeLines) {
+    Ptr<Node> node;
+
+    if (abs(nodeLine.latitude) > 0.001 && abs(nodeLine.latitude) > 0.001)
+      node = CreateNode(nodeLine.name, m_scale * nodeLine.longitude, -m_scale * nodeLine.latitude,
+                        nodeLine.systemId);
+    else {
+      Ptr<UniformRandomVariable> var = CreateObject<UniformRandomVariable>();
+      node = CreateNode(nodeLine.name, var->GetValue(0, 200), var->GetValue(0, 200),
+                        nodeLine.systemId);
+      // node = CreateNode (name, systemId);
+    }
+  }
+
+  map<string, set<string>> processedLinks; // to eliminate duplications
+
+  if (!hasLinks) {
+    NS_LOG_ERROR("Topology file " << GetFileName() << " does not have \"link\" section");
+    return m_nodes;
+  }
+
+  // SeekToSection ("link");
+  for (const auto& fields : linkLines) {
+    const string& from = fields[0];
+    const string& to = fields[1];
+    const string& capacity = fields[2];
+    const string& metric = fields[3];
+    const string& delay = fields[4];
+    const string& maxPackets = fields[5];
+    const string& lossRate = fields[6];
 
     if (processedLinks[to].size() != 0
         && processedLinks[to].find(from) != processedLinks[to].end()) {
@@ -98,6 +98,14 @@ public:
   virtual void
   SetMobilityModel(const std::string& model);
 
+  /**
+   * \brief Split nodes over \p partitions ranks with TopologyPartitioner
+   *
+   * The rank column of the topology file is ignored then, 0 (default) keeps it.
+   */
+  virtual void
+  SetPartitions(uint32_t partitions);
+
   /**
    * \brief Apply OSPF metric on Ipv4 (if exists) and Ccnx (if exists) stacks
    */
@@ -148,6 +156,7 @@ private:
   double m_scale;
 
   uint32_t m_requiredPartitions;
+  uint32_t m_partitions;
 };
 }
 
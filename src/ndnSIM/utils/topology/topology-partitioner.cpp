@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "topology-partitioner.hpp"
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("TopologyPartitioner");
+
+void
+TopologyPartitioner::AddNode(const std::string& name)
+{
+  bool isNew = m_index.emplace(name, m_names.size()).second;
+  NS_ASSERT_MSG(isNew, name << " node added twice");
+  if (isNew) {
+    m_names.push_back(name);
+  }
+}
+
+void
+TopologyPartitioner::AddLink(const std::string& from, const std::string& to, Time delay)
+{
+  auto fromIt = m_index.find(from);
+  auto toIt = m_index.find(to);
+  NS_ASSERT_MSG(fromIt != m_index.end(), from << " node not found");
+  NS_ASSERT_MSG(toIt != m_index.end(), to << " node not found");
+
+  m_links.push_back({fromIt->second, toIt->second, delay});
+}
+
+std::vector<uint32_t>
+TopologyPartitioner::Partition(uint32_t partitions)
+{
+  size_t nNodes = m_names.size();
+  if (partitions == 0 || partitions > nNodes) {
+    NS_FATAL_ERROR("Cannot split " << nNodes << " nodes in " << partitions << " partitions");
+  }
+
+  std::vector<size_t> degree(nNodes, 0);
+  for (const auto& link : m_links) {
+    ++degree[link.from];
+    ++degree[link.to];
+  }
+
+  std::vector<uint64_t> load(nNodes);
+  for (size_t i = 0; i < nNodes; ++i) {
+    load[i] = 1 + degree[i];
+  }
+  uint64_t capacity = (std::accumulate(load.begin(), load.end(), uint64_t(0)) + partitions - 1)
+                      / partitions;
+
+  // Union-find over the nodes, load holds the load of the whole set at its root
+  std::vector<size_t> parent(nNodes);
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&parent] (size_t i) {
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  };
+
+  std::vector<size_t> order(m_links.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&] (size_t a, size_t b) {
+    const PartitionLink& la = m_links[a];
+    const PartitionLink& lb = m_links[b];
+    if (la.delay != lb.delay) {
+      return la.delay < lb.delay;
+    }
+    return std::min(degree[la.from], degree[la.to]) < std::min(degree[lb.from], degree[lb.to]);
+  });
+
+  for (size_t l : order) {
+    const PartitionLink& link = m_links[l];
+    size_t from = find(link.from);
+    size_t to = find(link.to);
+    if (from == to) {
+      continue;
+    }
+    if (link.delay.IsZero() || load[from] + load[to] <= capacity) {
+      parent[to] = from;
+      load[from] += load[to];
+    }
+  }
+
+  std::vector<size_t> components;
+  for (size_t i = 0; i < nNodes; ++i) {
+    if (find(i) == i) {
+      components.push_back(i);
+    }
+  }
+  if (components.size() < partitions) {
+    NS_FATAL_ERROR("Topology can be split in " << components.size() << " partitions at most, not "
+                   << partitions << " (links without delay can't be cut)");
+  }
+
+  // Largest component first to the least loaded rank
+  std::stable_sort(components.begin(), components.end(),
+                   [&load] (size_t a, size_t b) { return load[a] > load[b]; });
+
+  std::vector<uint64_t> rankLoad(partitions, 0);
+  std::vector<uint32_t> rankOfRoot(nNodes, 0);
+  for (size_t root : components) {
+    uint32_t rank = static_cast<uint32_t>(std::min_element(rankLoad.begin(), rankLoad.end())
+                                          - rankLoad.begin());
+    rankOfRoot[root] = rank;
+    rankLoad[rank] += load[root];
+  }
+
+  std::vector<uint32_t> ranks(nNodes);
+  for (size_t i = 0; i < nNodes; ++i) {
+    ranks[i] = rankOfRoot[find(i)];
+  }
+
+  m_lookahead = Time::Max();
+  m_cutLinks = 0;
+  for (const auto& link : m_links) {
+    if (ranks[link.from] != ranks[link.to]) {
+      m_lookahead = std::min(m_lookahead, link.delay);
+      ++m_cutLinks;
+    }
+  }
+
+  for (uint32_t rank = 0; rank < partitions; ++rank) {
+    NS_LOG_INFO("Partition " << rank << ": load " << rankLoad[rank]);
+  }
+  NS_LOG_INFO(m_cutLinks << " links between partitions, lookahead " << m_lookahead.As(Time::MS));
+
+  return ranks;
+}
+
+} // namespace ns3
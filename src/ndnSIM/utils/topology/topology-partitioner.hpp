@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef TOPOLOGY_PARTITIONER_H
+#define TOPOLOGY_PARTITIONER_H
+
+#include "ns3/nstime.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Splits a topology over the logical processes (MPI ranks) of a parallel simulation
+ *
+ * Links are merged into partitions in increasing order of delay, links touching a leaf node
+ * (producer, consumer) first, as long as the partition stays under its share of the load, then
+ * the partitions are spread over the ranks, largest first. Access links and the subtrees below
+ * the aggregators therefore stay inside a rank, and the links between ranks are the ones with
+ * the highest delay, which is the lookahead of the parallel simulator.
+ *
+ * The load of a node is one plus its number of links, roughly the events it handles per packet.
+ * A zero-delay link can't be cut and is never split.
+ */
+class TopologyPartitioner {
+public:
+  /**
+   * \brief Add a node, each name must be added once
+   */
+  void
+  AddNode(const std::string& name);
+
+  /**
+   * \brief Add a link, both nodes must have been added
+   */
+  void
+  AddLink(const std::string& from, const std::string& to, Time delay);
+
+  /**
+   * \brief Compute the partitions
+   * \return rank of every node, in the order nodes were added
+   *
+   * Every rank gets at least one node, the simulation is aborted if the topology can't be split
+   * in \p partitions
+   */
+  std::vector<uint32_t>
+  Partition(uint32_t partitions);
+
+  /**
+   * \brief Lowest delay of the links between ranks of the last partition
+   */
+  Time
+  GetLookahead() const
+  {
+    return m_lookahead;
+  }
+
+  /**
+   * \brief Number of links between ranks of the last partition
+   */
+  size_t
+  GetCutLinks() const
+  {
+    return m_cutLinks;
+  }
+
+private:
+  struct PartitionLink {
+    size_t from;
+    size_t to;
+    Time delay;
+  };
+
+  std::map<std::string, size_t> m_index;
+  std::vector<std::string> m_names;
+  std::vector<PartitionLink> m_links;
+
+  Time m_lookahead;
+  size_t m_cutLinks = 0;
+};
+
+} // namespace ns3
+
+#endif // TOPOLOGY_PARTITIONER_H
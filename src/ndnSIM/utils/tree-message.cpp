@@ -0,0 +1,198 @@
+#include "tree-message.hpp"
+#include "ns3/names.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+
+namespace ns3 {
+namespace ndn {
+
+// Version byte plus chunk index and count, each up to 5 bytes
+static constexpr size_t TREE_MESSAGE_MAX_HEADER_SIZE = 11;
+
+
+
+static size_t
+varintSize(uint64_t value)
+{
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+
+
+static void
+appendVarint(std::vector<uint8_t>& buffer, uint64_t value)
+{
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<uint8_t>(value));
+}
+
+
+
+static bool
+readVarint(const uint8_t*& p, const uint8_t* end, uint32_t& value)
+{
+    uint64_t result = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            if (result > std::numeric_limits<uint32_t>::max()) {
+                return false;
+            }
+            value = static_cast<uint32_t>(result);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+std::vector<std::vector<uint8_t>>
+encodeTreeMessage(const TreeAssignment& assignment, size_t maxChunkSize)
+{
+    // Entries are packed first, headers are prepended once the number of chunks is known
+    size_t budget = maxChunkSize > TREE_MESSAGE_MAX_HEADER_SIZE ? maxChunkSize - TREE_MESSAGE_MAX_HEADER_SIZE : 0;
+    std::vector<std::vector<uint8_t>> bodies(1);
+
+    for (const auto& [child, leaves] : assignment) {
+        size_t next = 0;
+        do {
+            std::vector<uint8_t>& body = bodies.back();
+            size_t remaining = leaves.size() - next;
+            size_t used = body.size() + varintSize(child) + varintSize(remaining);
+
+            // As many leaves as fit into the current chunk
+            size_t count = 0;
+            while (count < remaining && used + varintSize(leaves[next + count]) <= budget) {
+                used += varintSize(leaves[next + count]);
+                ++count;
+            }
+
+            if (count < remaining && count == 0) {
+                if (!body.empty()) {
+                    bodies.emplace_back();
+                    continue;
+                }
+                count = 1; // Chunk size below a single leaf, oversized chunk
+            }
+
+            appendVarint(body, child);
+            appendVarint(body, count);
+            for (size_t i = next; i < next + count; ++i) {
+                appendVarint(body, leaves[i]);
+            }
+            next += count;
+            if (next < leaves.size()) {
+                bodies.emplace_back();
+            }
+        } while (next < leaves.size());
+    }
+
+    std::vector<std::vector<uint8_t>> chunks;
+    chunks.reserve(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        std::vector<uint8_t> chunk;
+        chunk.reserve(TREE_MESSAGE_MAX_HEADER_SIZE + bodies[i].size());
+        chunk.push_back(TREE_MESSAGE_VERSION);
+        appendVarint(chunk, i);
+        appendVarint(chunk, bodies.size());
+        chunk.insert(chunk.end(), bodies[i].begin(), bodies[i].end());
+        chunks.push_back(std::move(chunk));
+    }
+    return chunks;
+}
+
+
+
+TreeMessageAssembler::Result
+TreeMessageAssembler::add(uint64_t seq, const uint8_t* buffer, size_t size)
+{
+    const uint8_t* p = buffer;
+    const uint8_t* end = buffer + size;
+    uint32_t index = 0;
+    uint32_t count = 0;
+    if (size == 0 || *p++ != TREE_MESSAGE_VERSION || !readVarint(p, end, index) || !readVarint(p, end, count) || index >= count) {
+        return INVALID;
+    }
+
+    if (m_hasSeq && seq < m_seq) {
+        return DUPLICATE;
+    }
+    if (!m_hasSeq || seq > m_seq) {
+        m_hasSeq = true;
+        m_seq = seq;
+        m_chunkCount = count;
+        m_chunks.clear();
+        m_assignment.clear();
+    }
+    if (count != m_chunkCount) {
+        return INVALID;
+    }
+    if (m_chunks.count(index)) {
+        return DUPLICATE;
+    }
+
+    // Parse the whole chunk before touching the assignment, a truncated chunk leaves no trace
+    TreeAssignment entries;
+    while (p < end) {
+        uint32_t child = 0;
+        uint32_t leafCount = 0;
+        if (!readVarint(p, end, child) || !readVarint(p, end, leafCount)) {
+            return INVALID;
+        }
+        std::vector<uint32_t>& leaves = entries[child];
+        for (uint32_t i = 0; i < leafCount; ++i) {
+            uint32_t leaf = 0;
+            if (!readVarint(p, end, leaf)) {
+                return INVALID;
+            }
+            leaves.push_back(leaf);
+        }
+    }
+
+    m_chunks[index] = std::move(entries);
+    if (m_chunks.size() < m_chunkCount) {
+        return PENDING;
+    }
+
+    // Merged in chunk order, leaves keep the order they were encoded in
+    for (const auto& [chunkIndex, chunk] : m_chunks) {
+        for (const auto& [child, leaves] : chunk) {
+            std::vector<uint32_t>& merged = m_assignment[child];
+            merged.insert(merged.end(), leaves.begin(), leaves.end());
+        }
+    }
+    return COMPLETE;
+}
+
+
+
+uint32_t
+treeNodeId(const std::string& name)
+{
+    Ptr<Node> node = Names::Find<Node>(name);
+    return node ? node->GetId() : TREE_NODE_INVALID;
+}
+
+
+
+std::string
+treeNodeName(uint32_t id)
+{
+    if (id >= NodeList::GetNNodes()) {
+        return std::string();
+    }
+    return Names::FindName(NodeList::GetNode(id));
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * Wire format (version 1) of the aggregation tree sent to an aggregator, carried in the
+ * ApplicationParameters of its initialization interest /<aggregator>/initialization/<seq>
+ * Integers are unsigned LEB128 varints (one byte up to 127), nodes are referred to by ns-3 node id
+ *
+ *   uint8   version (TREE_MESSAGE_VERSION)
+ *   varint  chunk index
+ *   varint  number of chunks
+ *   ...     (varint child, varint N, varint leaf[N]) until the end of the value
+ *
+ * A tree larger than the chunk size is split over several interests of the same seq, each one
+ * acknowledged on its own. A child with many leaves may be spread over several entries (and
+ * chunks), its leaves are concatenated
+ */
+static constexpr uint8_t TREE_MESSAGE_VERSION = 1;
+static constexpr uint32_t TREE_NODE_INVALID = std::numeric_limits<uint32_t>::max();
+
+/**
+ * Children of an aggregator with the leaves (producers) below each of them, as node ids
+ */
+using TreeAssignment = std::map<uint32_t, std::vector<uint32_t>>;
+
+/**
+ * Encode an assignment into chunks of at most maxChunkSize bytes, a chunk holds at least one leaf
+ * even if the size is too small for it
+ * @return ApplicationParameters value of each initialization interest, at least one
+ */
+std::vector<std::vector<uint8_t>> encodeTreeMessage(const TreeAssignment& assignment, size_t maxChunkSize);
+
+/**
+ * Reassembles the chunks of a tree message, chunks may arrive in any order or more than once
+ */
+class TreeMessageAssembler {
+public:
+    enum Result {
+        INVALID,   // Chunk can't be parsed
+        PENDING,   // Chunk stored, others are missing
+        COMPLETE,  // Last missing chunk, assignment() holds the whole tree
+        DUPLICATE  // Chunk already received, or of an older seq
+    };
+
+    /**
+     * Add a chunk of the initialization seq, a newer seq drops the chunks of the previous one
+     * @param buffer ApplicationParameters value
+     */
+    Result
+    add(uint64_t seq, const uint8_t* buffer, size_t size);
+
+    const TreeAssignment&
+    assignment() const
+    {
+        return m_assignment;
+    }
+
+private:
+    bool m_hasSeq = false;
+    uint64_t m_seq = 0;
+    uint32_t m_chunkCount = 0;
+    std::map<uint32_t, TreeAssignment> m_chunks; // Entries of each received chunk of m_seq
+    TreeAssignment m_assignment;
+};
+
+/**
+ * Node id carried in tree messages, the ns-3 id of the node registered under name
+ * @return TREE_NODE_INVALID if no node has that name
+ */
+uint32_t treeNodeId(const std::string& name);
+
+/**
+ * Name of a node id carried in tree messages, empty if there's no such node
+ */
+std::string treeNodeName(uint32_t id);
+
+} // namespace ndn
+} // namespace ns3
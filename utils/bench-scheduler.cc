@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+
+// Output field width
+int g_fwidth = 14;
+
+/// One scheduler operation of a trace
+struct Op
+{
+  char type;     ///< 'i' Insert, 'n' RemoveNext, 'r' Remove
+  uint64_t ts;   ///< Event timestamp, Insert and Remove only
+  uint32_t uid;  ///< Event uid, Insert and Remove only
+};
+
+/**
+ * Read a trace written by ns3::ndn::RecordingScheduler
+ * \param filename the trace file, "-" for standard input
+ * \param [out] ops the operations
+ * \return false if the file can't be read
+ */
+bool
+ReadTrace (std::string filename, std::vector<Op> &ops)
+{
+  std::ifstream file;
+  std::istream *input = &std::cin;
+  if (filename != "-")
+    {
+      file.open (filename.c_str ());
+      if (!file.is_open ())
+        {
+          return false;
+        }
+      input = &file;
+    }
+
+  std::string line;
+  while (std::getline (*input, line))
+    {
+      if (line.empty ())
+        {
+          continue;
+        }
+      Op op = { line[0], 0, 0 };
+      if (op.type == 'i' || op.type == 'r')
+        {
+          std::istringstream is (line.substr (1));
+          if (!(is >> op.ts >> op.uid))
+            {
+              LOGME ("skipping malformed line: " << line);
+              continue;
+            }
+        }
+      else if (op.type != 'n')
+        {
+          LOGME ("skipping malformed line: " << line);
+          continue;
+        }
+      ops.push_back (op);
+    }
+  return true;
+}
+
+/**
+ * Replay a trace on a new scheduler
+ *
+ * Events carry no EventImpl, which schedulers don't dereference.
+ * \param factory the scheduler factory
+ * \param ops the operations
+ * \param [out] checksum of the order events were removed in, the same for all
+ *        schedulers of a consistent trace
+ * \return the replay time, in seconds
+ */
+double
+Replay (ObjectFactory &factory, const std::vector<Op> &ops, uint64_t &checksum)
+{
+  Ptr<Scheduler> scheduler = factory.Create<Scheduler> ();
+  SystemWallClockMs time;
+  checksum = 0;
+
+  time.Start ();
+  for (const Op &op : ops)
+    {
+      Scheduler::Event ev;
+      ev.impl = 0;
+      ev.key.m_ts = op.ts;
+      ev.key.m_uid = op.uid;
+      ev.key.m_context = 0;
+      switch (op.type)
+        {
+        case 'i':
+          scheduler->Insert (ev);
+          break;
+        case 'n':
+          ev = scheduler->RemoveNext ();
+          checksum = checksum * 1000003 + ev.key.m_uid;
+          break;
+        case 'r':
+          scheduler->Remove (ev);
+          break;
+        }
+    }
+  double elapsed = time.End () / 1000.0;
+
+  // Events still scheduled at the end of the run
+  while (!scheduler->IsEmpty ())
+    {
+      scheduler->RemoveNext ();
+    }
+  return elapsed;
+}
+
+
+int main (int argc, char *argv[])
+{
+  std::string filename = "";
+  std::string schedulers = "ns3::MapScheduler,ns3::HeapScheduler,"
+    "ns3::CalendarScheduler,ns3::PriorityQueueScheduler,ns3::LadderScheduler";
+  uint32_t runs = 3;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the schedulers on a recorded event trace.\n"
+             "\n"
+             "The trace is written by ns3::ndn::RecordingScheduler, e.g. by\n"
+             "cfnagg with General.SchedulerTrace set.  Each scheduler replays\n"
+             "the same Insert, RemoveNext and Remove calls, without running\n"
+             "the events, so only the scheduler's cost is measured.");
+  cmd.AddValue ("trace", "scheduler trace file, \"-\" for standard input", filename);
+  cmd.AddValue ("schedulers", "comma separated scheduler TypeIds", schedulers);
+  cmd.AddValue ("runs", "number of runs per scheduler (default 3)", runs);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+
+  if (filename == "")
+    {
+      LOGME ("no trace given, use --trace=<file>");
+      return 1;
+    }
+  std::vector<Op> ops;
+  if (!ReadTrace (filename, ops))
+    {
+      LOGME ("cannot read " << filename);
+      return 1;
+    }
+  LOGME ("operations: " << ops.size ());
+  LOGME ("runs: " << runs);
+
+  LOG ("");
+  LOG (std::left << std::setw (2 * g_fwidth) << "Scheduler" <<
+       std::left << std::setw (g_fwidth) << "Best (s)" <<
+       std::left << std::setw (g_fwidth) << "Mean (s)" <<
+       std::left << std::setw (g_fwidth) << "Rate (op/s)");
+  LOG (std::setfill ('-') << std::setw (5 * g_fwidth) << "" << std::setfill (' '));
+
+  uint64_t reference = 0;
+  bool first = true;
+  std::istringstream list (schedulers);
+  std::string type;
+  while (std::getline (list, type, ','))
+    {
+      ObjectFactory factory (type);
+      double best = 0;
+      double total = 0;
+      for (uint32_t i = 0; i < runs + 1; i++)
+        {
+          uint64_t checksum;
+          double elapsed = Replay (factory, ops, checksum);
+          if (first)
+            {
+              reference = checksum;
+              first = false;
+            }
+          else if (checksum != reference)
+            {
+              LOGME (type << " removed events in a different order");
+            }
+          if (i == 0)
+            {
+              continue; // prime
+            }
+          best = (i == 1 || elapsed < best) ? elapsed : best;
+          total += elapsed;
+        }
+      double mean = runs > 0 ? total / runs : 0;
+      LOG (std::left << std::setw (2 * g_fwidth) << type <<
+           std::left << std::setw (g_fwidth) << best <<
+           std::left << std::setw (g_fwidth) << mean <<
+           std::left << std::setw (g_fwidth) << (best > 0 ? ops.size () / best : 0));
+    }
+
+  LOG ("");
+  return 0;
+}